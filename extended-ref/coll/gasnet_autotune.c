@@ -13,12 +13,27 @@
 #include <myxml/myxml.h>
 #include <myxml/myxml.c>
 
+/*binary tuning databases are mapped rather than parsed*/
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 /*this array is the maximum size of hte log2 array for fanouts*/
 
 
 #define GASNETE_COLL_PRINT_TIMERS 0
 static int gasnete_coll_print_autotuner_timers;
 static int gasnete_coll_print_coll_alg;
+static int gasnete_coll_model_topk;
+static int gasnete_coll_online_arms;
+static int gasnete_coll_online_samples;
+static int gasnete_coll_online_explore;
+static int gasnete_coll_online_epoch;
 
 struct gasnet_coll_tuning_iterator_t_{
   uint32_t num_params;
@@ -177,6 +192,9 @@ gasnete_coll_algorithm_t gasnete_coll_autotune_register_algorithm(gasnet_team_ha
   gasnete_coll_algorithm_t ret;
   int i;
   ret.tree_alg = tree_alg;
+  ret.pshm_only = 0;
+  ret.model_shape = tree_alg ? GASNETE_COLL_MODEL_TREE : GASNETE_COLL_MODEL_NONE;
+  ret.model_radix = 0;
   ret.optype = optype;
   ret.syncflags = syncflags;
   ret.requirements = requirements;
@@ -221,6 +239,8 @@ gasnete_coll_algorithm_t gasnete_coll_autotune_register_algorithm(gasnet_team_ha
     case GASNET_COLL_EXCHANGEM_OP: ret.fn_ptr.exchangeM_fn = (gasnete_coll_exchangeM_fn_ptr_t) coll_fnptr; break;
     case GASNET_COLL_REDUCE_OP: ret.fn_ptr.reduce_fn = (gasnete_coll_reduce_fn_ptr_t) coll_fnptr; break;
     case GASNET_COLL_REDUCEM_OP: ret.fn_ptr.reduceM_fn = (gasnete_coll_reduceM_fn_ptr_t) coll_fnptr; break;
+    case GASNET_COLL_ALLREDUCE_OP: ret.fn_ptr.allreduce_fn = (gasnete_coll_allreduce_fn_ptr_t) coll_fnptr; break;
+    case GASNET_COLL_ALLREDUCEM_OP: ret.fn_ptr.allreduceM_fn = (gasnete_coll_allreduceM_fn_ptr_t) coll_fnptr; break;
     default: gasneti_fatalerror("not implemented yet");
   }
   return ret;
@@ -231,6 +251,17 @@ gasnete_coll_algorithm_t gasnete_coll_autotune_register_algorithm(gasnet_team_ha
 #define GASNETE_COLL_EVERY_SYNC_FLAG GASNETE_COLL_EVERY_IN_SYNC_FLAG | GASNETE_COLL_EVERY_OUT_SYNC_FLAG
 
 #define GASNETE_COLL_MAX_BYTES ((size_t) -1)
+
+#if GASNET_PSHM
+/* Default selection prefers the PSHM algorithms whenever they apply.
+   They synchronize the whole team on entry and exit, which is free only
+   when the caller asked for IN_ALLSYNC and OUT_ALLSYNC anyway. */
+static int gasnete_coll_allow_pshm_algs = 1;
+#define GASNETE_COLL_USE_PSHM_ALG(team, flags, segflag) \
+  (gasnete_coll_allow_pshm_algs && GASNETE_COLL_TEAM_IS_PSHM(team) && \
+   ((flags) & GASNET_COLL_SINGLE) && ((flags) & (segflag)) && \
+   ((flags) & GASNET_COLL_IN_ALLSYNC) && ((flags) & GASNET_COLL_OUT_ALLSYNC))
+#endif
 void gasnete_coll_register_broadcast_collectives(gasnete_coll_autotune_info_t* info, size_t smallest_scratch)  {
   
   /*first register all the broadcast algorithms*/
@@ -252,6 +283,15 @@ void gasnete_coll_register_broadcast_collectives(gasnete_coll_autotune_info_t* i
                                            GASNET_COLL_SRC_IN_SEGMENT | GASNET_COLL_SINGLE, 0,
                                            GASNETE_COLL_MAX_BYTES, 0, 0,
                                            0,NULL,gasnete_coll_bcast_Get, "BROADCAST_GET");
+
+#if GASNET_PSHM
+  info->collective_algorithms[GASNET_COLL_BROADCAST_OP][GASNETE_COLL_BROADCAST_PSHM] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_BROADCAST_OP, GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           GASNET_COLL_SRC_IN_SEGMENT | GASNET_COLL_SINGLE, 0,
+                                           GASNETE_COLL_MAX_BYTES, 0, 0,
+                                           0,NULL,gasnete_coll_bcast_PSHM, "BROADCAST_PSHM");
+  info->collective_algorithms[GASNET_COLL_BROADCAST_OP][GASNETE_COLL_BROADCAST_PSHM].pshm_only = 1;
+#endif
   
   
   
@@ -431,6 +471,15 @@ void gasnete_coll_register_scatter_collectives(gasnete_coll_autotune_info_t* inf
                                            GASNET_COLL_SRC_IN_SEGMENT | GASNET_COLL_SINGLE,  0, 
                                            GASNETE_COLL_MAX_BYTES, 0, 0,
                                            0, NULL, gasnete_coll_scat_Get, "SCATTER_GET");
+
+#if GASNET_PSHM
+  info->collective_algorithms[GASNET_COLL_SCATTER_OP][GASNETE_COLL_SCATTER_PSHM] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_SCATTER_OP, GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           GASNET_COLL_SRC_IN_SEGMENT | GASNET_COLL_SINGLE, 0,
+                                           GASNETE_COLL_MAX_BYTES, 0, 0,
+                                           0,NULL,gasnete_coll_scat_PSHM, "SCATTER_PSHM");
+  info->collective_algorithms[GASNET_COLL_SCATTER_OP][GASNETE_COLL_SCATTER_PSHM].pshm_only = 1;
+#endif
   
   info->collective_algorithms[GASNET_COLL_SCATTER_OP][GASNETE_COLL_SCATTER_PUT] = 
   gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_SCATTER_OP, GASNETE_COLL_EVERY_SYNC_FLAG,
@@ -574,6 +623,15 @@ void gasnete_coll_register_gather_collectives(gasnete_coll_autotune_info_t* info
                                            GASNETE_COLL_MAX_BYTES, 0, 0,
                                            0, NULL, gasnete_coll_gath_Put, "GATHER_PUT");
 
+#if GASNET_PSHM
+  info->collective_algorithms[GASNET_COLL_GATHER_OP][GASNETE_COLL_GATHER_PSHM] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_GATHER_OP, GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           GASNET_COLL_DST_IN_SEGMENT | GASNET_COLL_SINGLE, 0,
+                                           GASNETE_COLL_MAX_BYTES, 0, 0,
+                                           0,NULL,gasnete_coll_gath_PSHM, "GATHER_PSHM");
+  info->collective_algorithms[GASNET_COLL_GATHER_OP][GASNETE_COLL_GATHER_PSHM].pshm_only = 1;
+#endif
+
   info->collective_algorithms[GASNET_COLL_GATHER_OP][GASNETE_COLL_GATHER_TREE_PUT] = 
   gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_GATHER_OP, GASNETE_COLL_EVERY_SYNC_FLAG,
                                            GASNET_COLL_DST_IN_SEGMENT,  0, 
@@ -895,6 +953,17 @@ void gasnete_coll_register_exchange_collectives(gasnete_coll_autotune_info_t* in
                                              GASNETE_COLL_MAX_BYTES, 0, 0,
                                              0, NULL,  gasnete_coll_exchg_Put, "EXCHANGE_PUT");
   }
+#if GASNET_PSHM
+  {
+    info->collective_algorithms[GASNET_COLL_EXCHANGE_OP][GASNETE_COLL_EXCHANGE_PSHM] =
+    gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_EXCHANGE_OP,
+                                             GASNETE_COLL_EVERY_SYNC_FLAG,
+                                             GASNET_COLL_SRC_IN_SEGMENT|GASNET_COLL_SINGLE, 0, 
+                                             GASNETE_COLL_MAX_BYTES, 0, 0,
+                                             0, NULL,  gasnete_coll_exchg_PSHM, "EXCHANGE_PSHM");
+    info->collective_algorithms[GASNET_COLL_EXCHANGE_OP][GASNETE_COLL_EXCHANGE_PSHM].pshm_only = 1;
+  }
+#endif
   {
     info->collective_algorithms[GASNET_COLL_EXCHANGE_OP][GASNETE_COLL_EXCHANGE_RVPUT] =
     gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_EXCHANGE_OP,
@@ -1127,6 +1196,16 @@ void gasnete_coll_register_reduce_collectives(gasnete_coll_autotune_info_t* info
                                            0, 0,
                                            smallest_scratch/info->team->total_ranks, 0, 1,
                                            0,NULL,gasnete_coll_reduce_TreeGet, "REDUCE_TREE_GET");
+
+#if GASNET_PSHM
+  info->collective_algorithms[GASNET_COLL_REDUCE_OP][GASNETE_COLL_REDUCE_PSHM] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_REDUCE_OP, 
+                                           GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           GASNET_COLL_SRC_IN_SEGMENT | GASNET_COLL_SINGLE, 0,
+                                           GASNETE_COLL_MAX_BYTES, 0, 0,
+                                           0,NULL,gasnete_coll_reduce_PSHM, "REDUCE_PSHM");
+  info->collective_algorithms[GASNET_COLL_REDUCE_OP][GASNETE_COLL_REDUCE_PSHM].pshm_only = 1;
+#endif
   
   {
     size_t smallest_seg_size = MIN(MIN(gasnet_AMMaxLongRequest(),smallest_scratch/info->team->total_ranks),GASNET_COLL_MIN_PIPE_SEG_SIZE);
@@ -1140,6 +1219,29 @@ void gasnete_coll_register_reduce_collectives(gasnete_coll_autotune_info_t* info
                                              smallest_seg_size*GASNETE_COLL_MAX_NUM_SEGS, 
                                              smallest_seg_size, 1,
                                              1,tuning_params,gasnete_coll_reduce_TreePutSeg, "REDUCE_TREE_PUT_SEG");
+
+    info->collective_algorithms[GASNET_COLL_REDUCE_OP][GASNETE_COLL_REDUCE_TREE_GET_SEG] = 
+    gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_REDUCE_OP, 
+                                             GASNETE_COLL_EVERY_SYNC_FLAG,
+                                             0, 0,
+                                             smallest_seg_size*GASNETE_COLL_MAX_NUM_SEGS, 
+                                             smallest_seg_size, 1,
+                                             1,tuning_params,gasnete_coll_reduce_TreeGetSeg, "REDUCE_TREE_GET_SEG");
+  }
+
+  {
+    /* each segment of the eager variant must fit in a single p2p eager buffer */
+    size_t smallest_seg_size = MIN(gasnete_coll_p2p_eager_scale,GASNET_COLL_MIN_PIPE_SEG_SIZE);
+    size_t largest_seg_size = gasnete_coll_p2p_eager_scale;
+    GASNETE_COLL_TUNING_PARAMETER(tuning_params, GASNET_COLL_PIPE_SEG_SIZE, smallest_seg_size, largest_seg_size, 2, GASNET_COLL_TUNING_STRIDE_MULTIPLY | GASNET_COLL_TUNING_SIZE_PARAM); 
+
+    info->collective_algorithms[GASNET_COLL_REDUCE_OP][GASNETE_COLL_REDUCE_TREE_EAGER_SEG] = 
+    gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_REDUCE_OP, 
+                                             GASNETE_COLL_EVERY_SYNC_FLAG,
+                                             0, 0,
+                                             smallest_seg_size*GASNETE_COLL_MAX_NUM_SEGS, 
+                                             smallest_seg_size, 1,
+                                             1,tuning_params,gasnete_coll_reduce_TreeEagerSeg, "REDUCE_TREE_EAGER_SEG");
   }
   
   
@@ -1180,9 +1282,179 @@ void gasnete_coll_register_reduce_collectives(gasnete_coll_autotune_info_t* info
                                              smallest_seg_size*GASNETE_COLL_MAX_NUM_SEGS, 
                                              smallest_seg_size, 1,
                                              1,tuning_params,gasnete_coll_reduceM_TreePutSeg, "REDUCEM_TREE_PUT_SEG");
+
+    info->collective_algorithms[GASNET_COLL_REDUCEM_OP][GASNETE_COLL_REDUCEM_TREE_GET_SEG] = 
+    gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_REDUCEM_OP, 
+                                             GASNETE_COLL_EVERY_SYNC_FLAG,
+                                             0, 0,
+                                             smallest_seg_size*GASNETE_COLL_MAX_NUM_SEGS, 
+                                             smallest_seg_size, 1,
+                                             1,tuning_params,gasnete_coll_reduceM_TreeGetSeg, "REDUCEM_TREE_GET_SEG");
+  }
+
+  {
+    /* each segment of the eager variant must fit in a single p2p eager buffer */
+    size_t smallest_seg_size = MIN(gasnete_coll_p2p_eager_scale,GASNET_COLL_MIN_PIPE_SEG_SIZE);
+    size_t largest_seg_size = gasnete_coll_p2p_eager_scale;
+    GASNETE_COLL_TUNING_PARAMETER(tuning_params, GASNET_COLL_PIPE_SEG_SIZE, smallest_seg_size, largest_seg_size, 2, GASNET_COLL_TUNING_STRIDE_MULTIPLY | GASNET_COLL_TUNING_SIZE_PARAM); 
+
+    info->collective_algorithms[GASNET_COLL_REDUCEM_OP][GASNETE_COLL_REDUCEM_TREE_EAGER_SEG] = 
+    gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_REDUCEM_OP, 
+                                             GASNETE_COLL_EVERY_SYNC_FLAG,
+                                             0, 0,
+                                             smallest_seg_size*GASNETE_COLL_MAX_NUM_SEGS, 
+                                             smallest_seg_size, 1,
+                                             1,tuning_params,gasnete_coll_reduceM_TreeEagerSeg, "REDUCEM_TREE_EAGER_SEG");
   }
 }
 
+void gasnete_coll_register_allreduce_collectives(gasnete_coll_autotune_info_t* info, size_t smallest_scratch) {
+  int nphases = 0;
+  size_t rdbl_max, rab_max;
+  
+  while ((2 << nphases) <= info->team->total_ranks) nphases++;
+  /* recursive doubling receives one full vector per phase, plus one for the fold */
+  rdbl_max = MIN(gasnet_AMMaxLongRequest(), smallest_scratch/(nphases+1));
+  /* Rabenseifner needs three vectors (fold, reduce-scatter and allgather) plus one element per phase,
+     which fits in a fourth vector whenever there are at least as many elements as participants */
+  rab_max = MIN(gasnet_AMMaxLongRequest(), smallest_scratch/4);
+
+  info->collective_algorithms[GASNET_COLL_ALLREDUCE_OP] = gasneti_malloc(sizeof(gasnete_coll_algorithm_t)*GASNETE_COLL_ALLREDUCE_NUM_ALGS);
+  
+  info->collective_algorithms[GASNET_COLL_ALLREDUCE_OP][GASNETE_COLL_ALLREDUCE_REC_DBL] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_ALLREDUCE_OP, 
+                                           GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           0, 0,
+                                           rdbl_max, 0, 0,
+                                           0,NULL,gasnete_coll_allreduce_RecDbl, "ALLREDUCE_REC_DBL");
+  
+  info->collective_algorithms[GASNET_COLL_ALLREDUCE_OP][GASNETE_COLL_ALLREDUCE_RABENSEIFNER] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_ALLREDUCE_OP, 
+                                           GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           0, 0,
+                                           rab_max, 0, 0,
+                                           0,NULL,gasnete_coll_allreduce_Rabenseifner, "ALLREDUCE_RABENSEIFNER");
+  
+  info->collective_algorithms[GASNET_COLL_ALLREDUCE_OP][GASNETE_COLL_ALLREDUCE_RED] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_ALLREDUCE_OP, 
+                                           GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           0, 0,
+                                           GASNETE_COLL_MAX_BYTES, 0, 0,
+                                           0,NULL,gasnete_coll_allreduce_Red, "ALLREDUCE_RED");
+  
+  info->collective_algorithms[GASNET_COLL_ALLREDUCEM_OP] = gasneti_malloc(sizeof(gasnete_coll_algorithm_t)*GASNETE_COLL_ALLREDUCEM_NUM_ALGS);
+  
+  info->collective_algorithms[GASNET_COLL_ALLREDUCEM_OP][GASNETE_COLL_ALLREDUCEM_REC_DBL] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_ALLREDUCEM_OP, 
+                                           GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           0, 0,
+                                           rdbl_max, 0, 0,
+                                           0,NULL,gasnete_coll_allreduceM_RecDbl, "ALLREDUCEM_REC_DBL");
+  
+  info->collective_algorithms[GASNET_COLL_ALLREDUCEM_OP][GASNETE_COLL_ALLREDUCEM_RABENSEIFNER] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_ALLREDUCEM_OP, 
+                                           GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           0, 0,
+                                           rab_max, 0, 0,
+                                           0,NULL,gasnete_coll_allreduceM_Rabenseifner, "ALLREDUCEM_RABENSEIFNER");
+  
+  info->collective_algorithms[GASNET_COLL_ALLREDUCEM_OP][GASNETE_COLL_ALLREDUCEM_RED] = 
+  gasnete_coll_autotune_register_algorithm(info->team, GASNET_COLL_ALLREDUCEM_OP, 
+                                           GASNETE_COLL_EVERY_SYNC_FLAG,
+                                           0, 0,
+                                           GASNETE_COLL_MAX_BYTES, 0, 0,
+                                           0,NULL,gasnete_coll_allreduceM_Red, "ALLREDUCEM_RED");
+}
+
+
+/*tell the LogGP model how each of the non-tree algorithms above communicates
+  tree algorithms are modeled from their TREE_TYPE parameter unless listed here*/
+static void gasnete_coll_register_model_shapes(gasnete_coll_autotune_info_t* info) {
+#define GASNETE_COLL_MODEL_SHAPE(OP, ALG, SHAPE, RADIX) do { \
+    info->collective_algorithms[OP][ALG].model_shape = GASNETE_COLL_MODEL_##SHAPE; \
+    info->collective_algorithms[OP][ALG].model_radix = RADIX; \
+  } while (0)
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCAST_OP, GASNETE_COLL_BROADCAST_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCAST_OP, GASNETE_COLL_BROADCAST_GET, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCAST_OP, GASNETE_COLL_BROADCAST_EAGER, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCAST_OP, GASNETE_COLL_BROADCAST_RVOUS, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCAST_OP, GASNETE_COLL_BROADCAST_RVGET, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCASTM_OP, GASNETE_COLL_BROADCASTM_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCASTM_OP, GASNETE_COLL_BROADCASTM_GET, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCASTM_OP, GASNETE_COLL_BROADCASTM_EAGER, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCASTM_OP, GASNETE_COLL_BROADCASTM_RVOUS, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCASTM_OP, GASNETE_COLL_BROADCASTM_RVGET, FLAT_RV, 0);
+
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTER_OP, GASNETE_COLL_SCATTER_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTER_OP, GASNETE_COLL_SCATTER_GET, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTER_OP, GASNETE_COLL_SCATTER_EAGER, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTER_OP, GASNETE_COLL_SCATTER_RVGET, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTER_OP, GASNETE_COLL_SCATTER_RVOUS, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTERM_OP, GASNETE_COLL_SCATTERM_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTERM_OP, GASNETE_COLL_SCATTERM_GET, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTERM_OP, GASNETE_COLL_SCATTERM_EAGER, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTERM_OP, GASNETE_COLL_SCATTERM_RVGET, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTERM_OP, GASNETE_COLL_SCATTERM_RVOUS, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTERM_OP, GASNETE_COLL_SCATTERM_TREE_PUT_SEG, NONE, 0); /* never timed by the search either */
+
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_OP, GASNETE_COLL_GATHER_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_OP, GASNETE_COLL_GATHER_GET, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_OP, GASNETE_COLL_GATHER_EAGER, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_OP, GASNETE_COLL_GATHER_RVPUT, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_OP, GASNETE_COLL_GATHER_RVOUS, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHERM_OP, GASNETE_COLL_GATHERM_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHERM_OP, GASNETE_COLL_GATHERM_GET, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHERM_OP, GASNETE_COLL_GATHERM_EAGER, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHERM_OP, GASNETE_COLL_GATHERM_RVPUT, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHERM_OP, GASNETE_COLL_GATHERM_RVOUS, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHERM_OP, GASNETE_COLL_GATHERM_TREE_PUT_SEG, NONE, 0); /* never timed by the search either */
+
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALL_OP, GASNETE_COLL_GATHER_ALL_DISSEM_EAGER, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALL_OP, GASNETE_COLL_GATHER_ALL_DISSEM, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALL_OP, GASNETE_COLL_GATHER_ALL_DISSEM_NOSCRATCH, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALL_OP, GASNETE_COLL_GATHER_ALL_FLAT_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALL_OP, GASNETE_COLL_GATHER_ALL_FLAT_PUT_EAGER, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALL_OP, GASNETE_COLL_GATHER_ALL_FLAT_GET, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALLM_OP, GASNETE_COLL_GATHER_ALLM_DISSEM, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALLM_OP, GASNETE_COLL_GATHER_ALLM_DISSEM_EAGER, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALLM_OP, GASNETE_COLL_GATHER_ALLM_DISSEM_NOSCRATCH, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALLM_OP, GASNETE_COLL_GATHER_ALLM_DISSEM_NOSCRATCH_SEG, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALLM_OP, GASNETE_COLL_GATHER_ALLM_FLAT_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_ALLM_OP, GASNETE_COLL_GATHER_ALLM_FLAT_PUT_EAGER, FLAT, 0);
+
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGE_OP, GASNETE_COLL_EXCHANGE_DISSEM2, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGE_OP, GASNETE_COLL_EXCHANGE_DISSEM3, DISSEM, 3);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGE_OP, GASNETE_COLL_EXCHANGE_DISSEM4, DISSEM, 4);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGE_OP, GASNETE_COLL_EXCHANGE_DISSEM8, DISSEM, 8);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGE_OP, GASNETE_COLL_EXCHANGE_FLAT_SCRATCH, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGE_OP, GASNETE_COLL_EXCHANGE_PUT, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGE_OP, GASNETE_COLL_EXCHANGE_RVPUT, FLAT_RV, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_DISSEM2, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_DISSEM3, DISSEM, 3);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_DISSEM4, DISSEM, 4);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_DISSEM8, DISSEM, 8);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_DISSEMSEG2, DISSEM, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_DISSEMSEG3, DISSEM, 3);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_DISSEMSEG4, DISSEM, 4);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_DISSEMSEG8, DISSEM, 8);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_FLAT_SCRATCH, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGEM_OP, GASNETE_COLL_EXCHANGEM_FLAT_SCRATCH_SEG, FLAT, 0);
+
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_REDUCE_OP, GASNETE_COLL_REDUCE_EAGER, FLAT, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_ALLREDUCE_OP, GASNETE_COLL_ALLREDUCE_REC_DBL, REC_DBL, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_ALLREDUCE_OP, GASNETE_COLL_ALLREDUCE_RABENSEIFNER, RABENSEIFNER, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_ALLREDUCEM_OP, GASNETE_COLL_ALLREDUCEM_REC_DBL, REC_DBL, 2);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_ALLREDUCEM_OP, GASNETE_COLL_ALLREDUCEM_RABENSEIFNER, RABENSEIFNER, 2);
+
+#if GASNET_PSHM
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_BROADCAST_OP, GASNETE_COLL_BROADCAST_PSHM, PSHM, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_SCATTER_OP, GASNETE_COLL_SCATTER_PSHM, PSHM, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_GATHER_OP, GASNETE_COLL_GATHER_PSHM, PSHM, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_EXCHANGE_OP, GASNETE_COLL_EXCHANGE_PSHM, PSHM, 0);
+  GASNETE_COLL_MODEL_SHAPE(GASNET_COLL_REDUCE_OP, GASNETE_COLL_REDUCE_PSHM, PSHM, 0);
+#endif
+#undef GASNETE_COLL_MODEL_SHAPE
+}
 
 void gasnete_coll_register_collectives(gasnete_coll_autotune_info_t* info, size_t smallest_scratch) {
   gasnete_coll_register_broadcast_collectives(info, smallest_scratch);
@@ -1191,7 +1463,8 @@ void gasnete_coll_register_collectives(gasnete_coll_autotune_info_t* info, size_
   gasnete_coll_register_gather_all_collectives(info, smallest_scratch);
   gasnete_coll_register_exchange_collectives(info, smallest_scratch);
   gasnete_coll_register_reduce_collectives(info, smallest_scratch);
-
+  gasnete_coll_register_allreduce_collectives(info, smallest_scratch);
+  gasnete_coll_register_model_shapes(info);
 }
 
 
@@ -1234,10 +1507,13 @@ gasnete_coll_autotune_info_t* gasnete_coll_autotune_init(gasnet_team_handle_t te
   int i;
   
   ret = gasneti_calloc(1,sizeof(gasnete_coll_autotune_info_t));
+  gasneti_mutex_init(&ret->decision_lock);
   team->autotune_info = ret;
   ret->team = team;
   /* first read the environment variables for tree types*/
-  default_tree_type = gasneti_getenv_withdefault("GASNET_COLL_ROOTED_GEOM", GASNETE_COLL_DEFAULT_TREE_TYPE_STR);
+  default_tree_type = gasneti_getenv_withdefault("GASNET_COLL_ROOTED_GEOM",
+                                                 gasnete_coll_topo_have_groups() ? GASNETE_COLL_DEFAULT_TOPO_TREE_TYPE_STR
+                                                                                 : GASNETE_COLL_DEFAULT_TREE_TYPE_STR);
    
   /* now over-ride the defaults w/ the collective specific tree types in the environment*/
   ret->bcast_tree_type = gasnete_coll_make_tree_type_str(gasneti_getenv_withdefault("GASNET_COLL_BROADCAST_GEOM", default_tree_type));
@@ -1266,6 +1542,7 @@ gasnete_coll_autotune_info_t* gasnete_coll_autotune_init(gasnet_team_handle_t te
   }
   ret->exchange_dissem_limit = MIN(dissem_limit, temp_size);
   ret->exchange_dissem_radix = MIN(gasneti_getenv_int_withdefault("GASNET_COLL_EXCHANGE_DISSEM_RADIX", 2, 0),total_images);
+  ret->allreduce_rdbl_limit = gasneti_getenv_int_withdefault("GASNET_COLL_ALLREDUCE_RDBL_LIMIT", GASNETE_COLL_DEFAULT_ALLREDUCE_RDBL_LIMIT, 1);
 
   if(min_scratch_size < total_images) {
     gasneti_fatalerror("SCRATCH SPACE TOO SMALL Please set it to at least (%"PRIuPTR" bytes) through the GASNET_COLL_SCRATCH_SIZE environment variable", (uintptr_t) total_images);
@@ -1322,11 +1599,25 @@ gasnete_coll_autotune_info_t* gasnete_coll_autotune_init(gasnet_team_handle_t te
     gasnete_coll_team_all_tuning_file = gasneti_getenv_withdefault("GASNET_COLL_TUNING_FILE",NULL);
     gasnete_coll_print_autotuner_timers = gasneti_getenv_yesno_withdefault("GASNET_COLL_PRINT_AUTOTUNE_TIMER", GASNETE_COLL_PRINT_TIMERS);
     gasnete_coll_print_coll_alg = gasneti_getenv_yesno_withdefault("GASNET_COLL_PRINT_COLL_ALG", 0);
+    gasnete_coll_model_topk = gasneti_getenv_int_withdefault("GASNET_COLL_MODEL_TOPK", 1, 0);
+    gasnete_coll_online_arms = gasneti_getenv_int_withdefault("GASNET_COLL_ONLINE_ARMS", 4, 0);
+    gasnete_coll_online_arms = MAX(1, MIN(gasnete_coll_online_arms, GASNETE_COLL_ONLINE_MAX_ARMS));
+    gasnete_coll_online_samples = gasneti_getenv_int_withdefault("GASNET_COLL_ONLINE_SAMPLES", 5, 0);
+    gasnete_coll_online_explore = gasneti_getenv_int_withdefault("GASNET_COLL_ONLINE_EXPLORE", 16, 0);
+    gasnete_coll_online_epoch = gasneti_getenv_int_withdefault("GASNET_COLL_ONLINE_EPOCH", 256, 0);
+#if GASNET_PSHM
+    gasnete_coll_allow_pshm_algs = gasneti_getenv_yesno_withdefault("GASNET_COLL_ALLOW_PSHM_ALGS", gasnete_coll_allow_pshm_algs);
+#endif
   }
   
   ret->autotuner_defaults = NULL;
   ret->search_enabled = gasneti_getenv_yesno_withdefault("GASNET_COLL_ENABLE_SEARCH", 0);
   ret->profile_enabled = gasneti_getenv_yesno_withdefault("GASNET_COLL_ENABLE_PROFILE", 0);
+  ret->model_enabled = gasneti_getenv_yesno_withdefault("GASNET_COLL_ENABLE_MODEL", 0);
+  ret->online_enabled = gasneti_getenv_yesno_withdefault("GASNET_COLL_ENABLE_ONLINE", 0);
+  if(ret->online_enabled) {
+    ret->online = gasneti_calloc(my_images, sizeof(gasnete_coll_online_table_t *));
+  }
   
   return ret;
 }
@@ -1537,6 +1828,15 @@ static char* print_op_str(char *buf, gasnet_coll_optype_t op, int flags) {
     else
       strcpy(buf, "reduceM MULTI/");
     break;
+  case GASNET_COLL_ALLREDUCE_OP:
+    strcpy(buf, "allreduce SINGLE/");
+    break;
+  case GASNET_COLL_ALLREDUCEM_OP:
+    if (flags & GASNETE_COLL_THREAD_LOCAL)
+      strcpy(buf, "allreduceM SINGLE/");
+    else
+      strcpy(buf, "allreduceM MULTI/");
+    break;
     
   default:
     strcpy(buf, "FILLIN");
@@ -1730,6 +2030,11 @@ static gasnet_coll_optype_t get_optype_from_str(char *str) {
   else if(STRINGS_MATCH(str, "reduceM"))
     return GASNET_COLL_REDUCEM_OP;
   
+  else if(STRINGS_MATCH(str, "allreduce"))
+    return GASNET_COLL_ALLREDUCE_OP;
+  else if(STRINGS_MATCH(str, "allreduceM"))
+    return GASNET_COLL_ALLREDUCEM_OP;
+  
   else gasneti_fatalerror("op %s not yet supported\n", str);
   return (gasnet_coll_optype_t)(-1); /* NOT REACHED */
 }
@@ -1761,10 +2066,10 @@ static char * optype_to_str(char *buffer, int op) {
       strcpy(buffer, "gather_allM");
       break;
     case GASNET_COLL_EXCHANGE_OP:
-      strcpy(buffer, "gather_all");
+      strcpy(buffer, "exchange");
       break;
     case GASNET_COLL_EXCHANGEM_OP:
-      strcpy(buffer, "gather_allM");
+      strcpy(buffer, "exchangeM");
       break;
     case GASNET_COLL_REDUCE_OP:
       strcpy(buffer, "reduce");
@@ -1773,6 +2078,12 @@ static char * optype_to_str(char *buffer, int op) {
     case GASNET_COLL_REDUCEM_OP:
       strcpy(buffer, "reduceM");
       break;
+    case GASNET_COLL_ALLREDUCE_OP:
+      strcpy(buffer, "allreduce");
+      break;
+    case GASNET_COLL_ALLREDUCEM_OP:
+      strcpy(buffer, "allreduceM");
+      break;
     default:
       gasneti_fatalerror("unknown op type");
   }
@@ -1974,6 +2285,20 @@ static gasnett_tick_t run_collective_bench(gasnet_team_handle_t team, gasnet_col
         if(fnptr) (*fnptr)(sample_work_arg);
         gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
         break; 
+      case GASNET_COLL_ALLREDUCE_OP:
+        handle = (*((gasnete_coll_allreduce_fn_ptr_t) (impl->fn_ptr)))(team, coll_args.dst[0], coll_args.src[0],
+                                                                       coll_args.elem_size, coll_args.nbytes/coll_args.elem_size,
+                                                                       coll_args.func, coll_args.func_arg, flags, impl, 0 GASNETI_THREAD_PASS);
+        if(fnptr) (*fnptr)(sample_work_arg);
+        gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+        break; 
+      case GASNET_COLL_ALLREDUCEM_OP:
+        handle = (*((gasnete_coll_allreduceM_fn_ptr_t) (impl->fn_ptr)))(team, (void* const*)coll_args.dst, (void* const*)coll_args.src,
+                                                                        coll_args.elem_size, coll_args.nbytes/coll_args.elem_size,
+                                                                        coll_args.func, coll_args.func_arg, flags, impl, 0 GASNETI_THREAD_PASS);
+        if(fnptr) (*fnptr)(sample_work_arg);
+        gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+        break; 
         
       default:
         gasneti_fatalerror("collective not yet implemented");  
@@ -2066,6 +2391,20 @@ static gasnett_tick_t run_collective_bench(gasnet_team_handle_t team, gasnet_col
         if(fnptr) (*fnptr)(sample_work_arg);
         gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
         break; 
+      case GASNET_COLL_ALLREDUCE_OP:
+        handle = (*((gasnete_coll_allreduce_fn_ptr_t) (impl->fn_ptr)))(team, coll_args.dst[0], coll_args.src[0],
+                                                                       coll_args.elem_size, coll_args.nbytes/coll_args.elem_size,
+                                                                       coll_args.func, coll_args.func_arg, flags, impl, 0 GASNETI_THREAD_PASS);
+        if(fnptr) (*fnptr)(sample_work_arg);
+        gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+        break; 
+      case GASNET_COLL_ALLREDUCEM_OP:
+        handle = (*((gasnete_coll_allreduceM_fn_ptr_t) (impl->fn_ptr)))(team, (void* const*)coll_args.dst, (void* const*)coll_args.src,
+                                                                        coll_args.elem_size, coll_args.nbytes/coll_args.elem_size,
+                                                                        coll_args.func, coll_args.func_arg, flags, impl, 0 GASNETI_THREAD_PASS);
+        if(fnptr) (*fnptr)(sample_work_arg);
+        gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+        break; 
       default:
         gasneti_fatalerror("collective not yet implemented");  
     }    
@@ -2201,23 +2540,8 @@ static void do_tuning_loop(gasnet_team_handle_t team, gasnet_coll_optype_t op,
 }
 
 
-void gasnete_coll_tune_generic_op(gasnet_team_handle_t team, gasnet_coll_optype_t op, 
-                                  gasnet_coll_args_t coll_args, int flags,
-                                  gasnet_coll_overlap_sample_work_t fnptr, void *sample_work_arg,
-                                  /*returned by the function*/
-                                  uint32_t *best_algidx, uint32_t *num_params, uint32_t **best_param, char **best_tree GASNETI_THREAD_FARG)  {
-  int algidx = 0;
+static int gasnete_coll_num_algs(gasnet_coll_optype_t op) {
   int num_algs;
-  gasnett_tick_t curr_best_time=GASNETT_TICK_MAX, alg_best_time=GASNETT_TICK_MAX;
-  uint32_t loc_best_param_list[GASNET_COLL_NUM_PARAM_TYPES];
-  uint32_t sync_flags = (flags &  GASNET_COLL_SYNC_FLAG_MASK); /*strip the sync flags off the flags*/
-  uint32_t req_flags = (flags & (~GASNET_COLL_SYNC_FLAG_MASK));
-  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
-  char *loc_best_tree;
-
-  loc_best_tree = gasneti_calloc(1,sizeof(char)*100);
-  
-
   switch (op) {
     case GASNET_COLL_BROADCAST_OP:
       num_algs = GASNETE_COLL_BROADCAST_NUM_ALGS;
@@ -2255,11 +2579,38 @@ void gasnete_coll_tune_generic_op(gasnet_team_handle_t team, gasnet_coll_optype_
     case GASNET_COLL_REDUCEM_OP:
       num_algs = GASNETE_COLL_REDUCEM_NUM_ALGS;
       break;
+    case GASNET_COLL_ALLREDUCE_OP:
+      num_algs = GASNETE_COLL_ALLREDUCE_NUM_ALGS;
+      break;
+    case GASNET_COLL_ALLREDUCEM_OP:
+      num_algs = GASNETE_COLL_ALLREDUCEM_NUM_ALGS;
+      break;
     default:
       num_algs = 0; /* warning suppression */
       gasneti_fatalerror("not yet supported");
       break;
   }
+  return num_algs;
+}
+
+void gasnete_coll_tune_generic_op(gasnet_team_handle_t team, gasnet_coll_optype_t op, 
+                                  gasnet_coll_args_t coll_args, int flags,
+                                  gasnet_coll_overlap_sample_work_t fnptr, void *sample_work_arg,
+                                  /*returned by the function*/
+                                  uint32_t *best_algidx, uint32_t *num_params, uint32_t **best_param, char **best_tree GASNETI_THREAD_FARG)  {
+  int algidx = 0;
+  int num_algs;
+  gasnett_tick_t curr_best_time=GASNETT_TICK_MAX, alg_best_time=GASNETT_TICK_MAX;
+  uint32_t loc_best_param_list[GASNET_COLL_NUM_PARAM_TYPES];
+  uint32_t sync_flags = (flags &  GASNET_COLL_SYNC_FLAG_MASK); /*strip the sync flags off the flags*/
+  uint32_t req_flags = (flags & (~GASNET_COLL_SYNC_FLAG_MASK));
+  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+  char *loc_best_tree;
+
+  loc_best_tree = gasneti_calloc(1,sizeof(char)*100);
+  
+
+  num_algs = gasnete_coll_num_algs(op);
   
   *best_algidx = -1;
   PTHREAD_BARRIER(team, team->my_images);
@@ -2272,14 +2623,17 @@ void gasnete_coll_tune_generic_op(gasnet_team_handle_t team, gasnet_coll_optype_
     /*ensure that the synchronization flags exist in the list of possible synch flags for this algorithm*/
     int sync_flags_ok = ((sync_flags & team->autotune_info->collective_algorithms[op][algidx].syncflags) == sync_flags);
     int nreq_flags_ok = (!(req_flags & team->autotune_info->collective_algorithms[op][algidx].n_requirements));
+    /*ensure that algorithms relying on cross-mapped segments are only used on node-local teams*/
+    int team_ok = (!team->autotune_info->collective_algorithms[op][algidx].pshm_only || GASNETE_COLL_TEAM_IS_PSHM(team));
 #if GASNET_DEBUG
     if(!size_ok){if(td->my_image==0 && gasnete_coll_print_autotuner_timers) fprintf(stderr, "%d> skipping alg: %d (reason: size too large)\n", (int)gasneti_mynode, algidx);continue;}
     if(!req_flags_ok){if(td->my_image==0 && gasnete_coll_print_autotuner_timers) fprintf(stderr, "%d> skipping alg: %d (reason: all req flags are not present)\n", (int)gasneti_mynode, algidx);continue;}
     if(!nreq_flags_ok){if(td->my_image==0 && gasnete_coll_print_autotuner_timers) fprintf(stderr, "%d> skipping alg: %d (reason: one of the nreq flags is present)\n", (int)gasneti_mynode, algidx);continue;}
     if(!sync_flags_ok){if(td->my_image==0 && gasnete_coll_print_autotuner_timers) fprintf(stderr, "%d> skipping alg: %d (reason: not valid for this syncflag)\n", (int)gasneti_mynode, algidx);continue;}
+    if(!team_ok){if(td->my_image==0 && gasnete_coll_print_autotuner_timers) fprintf(stderr, "%d> skipping alg: %d (reason: team is not node-local)\n", (int)gasneti_mynode, algidx);continue;}
     
 #else
-    if(!(size_ok && req_flags_ok && sync_flags_ok &&  nreq_flags_ok/*match!*/)) {
+    if(!(size_ok && req_flags_ok && sync_flags_ok &&  nreq_flags_ok && team_ok/*match!*/)) {
       continue;
     }
 #endif
@@ -2289,6 +2643,8 @@ void gasnete_coll_tune_generic_op(gasnet_team_handle_t team, gasnet_coll_optype_
         (op == GASNET_COLL_BROADCAST_OP   && algidx == GASNETE_COLL_BROADCAST_SCATTERALLGATHER) ||
         (op == GASNET_COLL_EXCHANGEM_OP   && algidx == GASNETE_COLL_EXCHANGEM_GATH) ||
         (op == GASNET_COLL_GATHER_ALLM_OP && algidx == GASNETE_COLL_GATHER_ALLM_GATH) ||
+        (op == GASNET_COLL_ALLREDUCE_OP   && algidx == GASNETE_COLL_ALLREDUCE_RED) ||
+        (op == GASNET_COLL_ALLREDUCEM_OP  && algidx == GASNETE_COLL_ALLREDUCEM_RED) ||
         (op == GASNET_COLL_SCATTERM_OP    && algidx == GASNETE_COLL_SCATTERM_TREE_PUT_SEG) ||
         (op == GASNET_COLL_GATHERM_OP     && algidx == GASNETE_COLL_GATHERM_TREE_PUT_SEG)) {
        if (*best_algidx == -1) {
@@ -2330,6 +2686,28 @@ void gasnete_coll_tune_generic_op(gasnet_team_handle_t team, gasnet_coll_optype_
 /***LOAD THE OPERATIONS***/
 /*************************/
 
+/*****************************/
+/***COMPILED DECISION CACHE***/
+/*****************************/
+
+/* Must only be called while no other image of the team can be looking up an
+   algorithm, i.e. between the PTHREAD_BARRIERs that bracket index updates. */
+static void gasnete_coll_decision_invalidate(gasnete_coll_autotune_info_t *info) {
+  int op, sync, addr;
+  for(op=0; op<GASNET_COLL_NUM_COLL_OPTYPES; op++) {
+    for(sync=0; sync<GASNETE_COLL_NUM_SYNCMODES; sync++) {
+      for(addr=0; addr<GASNETE_COLL_NUM_ADDRMODES; addr++) {
+        gasnete_coll_decision_t *d = info->decisions[op][sync][addr];
+        if(!d) continue;
+        gasneti_free(d->root_class);
+        gasneti_free(d->cells);
+        gasneti_free(d);
+        info->decisions[op][sync][addr] = NULL;
+      }
+    }
+  }
+}
+
 GASNETI_INLINE(search_intervals)
 gasnete_coll_autotune_index_entry_t *search_intervals(gasnete_coll_autotune_index_entry_t *idx, int search_value, int exact_match) {
   gasnete_coll_autotune_index_entry_t *temp = idx;
@@ -2398,6 +2776,331 @@ gasnete_coll_implementation_t search_index(gasnet_coll_optype_t op, gasnete_coll
   return temp->impl;
 }
 
+/* Bucket b holds the sizes [2^b, 2^(b+1)), with bucket 0 also holding 0.
+   Any size list with at most one breakpoint inside the bucket is resolved
+   here exactly as search_intervals() would resolve it for every size. */
+static void gasnete_coll_decision_fill_cell(gasnete_coll_decision_cell_t *cell,
+                                            gasnete_coll_autotune_index_entry_t *sizes,
+                                            int bucket, int exact_match) {
+  const size_t lo = bucket ? ((size_t)1 << bucket) : 0;
+  const size_t hi = ((size_t)2 << bucket) - 1;
+  gasnete_coll_autotune_index_entry_t *temp, *pivot = NULL;
+  int num_pivots = 0;
+
+  gasneti_assert(hi <= INT_MAX);
+  for(temp = sizes; temp; temp = temp->next_interval) {
+    if((size_t)temp->start > hi) break;
+    if((size_t)temp->start > lo || (exact_match && (size_t)temp->start == lo)) {
+      pivot = temp;
+      num_pivots++;
+    }
+  }
+
+  if(num_pivots > 1) {
+    cell->kind = GASNETE_COLL_DECISION_WALK;
+  } else if(exact_match) {
+    cell->kind = num_pivots ? GASNETE_COLL_DECISION_EXACT : GASNETE_COLL_DECISION_CONST;
+    cell->impl_lo = NULL;
+    cell->impl_hi = num_pivots ? pivot->impl : NULL;
+    cell->pivot = num_pivots ? (size_t)pivot->start : 0;
+  } else {
+    temp = sizes ? search_intervals(sizes, (int)lo, 0) : NULL;
+    cell->impl_lo = temp ? temp->impl : NULL;
+    cell->kind = num_pivots ? GASNETE_COLL_DECISION_SPLIT : GASNETE_COLL_DECISION_CONST;
+    cell->impl_hi = num_pivots ? pivot->impl : NULL;
+    cell->pivot = num_pivots ? (size_t)pivot->start : 0;
+  }
+}
+
+/* Flattens the subtree of the index that search_index() would walk for
+   (team, op, syncmode, addrmode).  Roots collapse into classes, one per
+   entry of the root list; roots past the last listed one share its class
+   (or have none for exact matching), so the map only spans the listed roots. */
+static
+gasnete_coll_decision_t *gasnete_coll_decision_compile(gasnete_coll_team_t team, gasnet_coll_optype_t op,
+                                                       gasnete_coll_syncmode_t syncmode,
+                                                       gasnete_coll_addr_mode_t addrmode, int exact_match) {
+  gasnete_coll_decision_t *ret = gasneti_calloc(1, sizeof(gasnete_coll_decision_t));
+  gasnete_coll_autotune_index_entry_t *temp = team->autotune_info->autotuner_defaults;
+  gasnete_coll_autotune_index_entry_t *roots, *curr;
+  uint32_t cls, r;
+  int b;
+
+  ret->root_tail = GASNETE_COLL_DECISION_NOROOT;
+  if(temp) temp = search_intervals(temp, team->total_ranks, exact_match);
+  if(temp) temp = search_intervals(temp->subtree, team->my_images, exact_match);
+  if(temp) temp = search_intervals(temp->subtree, syncmode, 1);
+  if(temp) temp = search_intervals(temp->subtree, addrmode, 1);
+  if(temp) temp = search_intervals(temp->subtree, op, 1);
+  if(!temp || !temp->subtree) return ret; /* no match for any root or size */
+
+  roots = temp->subtree;
+  for(curr = roots; curr->next_interval; curr = curr->next_interval) ret->num_classes++;
+  ret->num_classes++;
+  ret->root_span = (curr->start < 0) ? 0 : (uint32_t)curr->start + 1;
+  ret->root_tail = exact_match ? GASNETE_COLL_DECISION_NOROOT : ret->num_classes - 1;
+
+  ret->root_class = gasneti_malloc(MAX(1,ret->root_span) * sizeof(uint32_t));
+  for(r = 0, cls = 0, curr = roots; r < ret->root_span; r++) {
+    if(exact_match) {
+      while((uint32_t)curr->start < r) { curr = curr->next_interval; cls++; }
+      ret->root_class[r] = ((uint32_t)curr->start == r) ? cls : GASNETE_COLL_DECISION_NOROOT;
+    } else {
+      while(curr->next_interval && (uint32_t)curr->next_interval->start <= r) { curr = curr->next_interval; cls++; }
+      ret->root_class[r] = cls;
+    }
+  }
+
+  ret->cells = gasneti_malloc(ret->num_classes * GASNETE_COLL_DECISION_BUCKETS * sizeof(gasnete_coll_decision_cell_t));
+  for(cls = 0, curr = roots; curr; curr = curr->next_interval, cls++) {
+    for(b = 0; b < GASNETE_COLL_DECISION_BUCKETS; b++) {
+      gasnete_coll_decision_fill_cell(&ret->cells[cls*GASNETE_COLL_DECISION_BUCKETS + b], curr->subtree, b, exact_match);
+    }
+  }
+  return ret;
+}
+
+/* O(1) replacement for search_index() on the per-call path */
+static
+gasnete_coll_implementation_t lookup_decision(gasnet_coll_optype_t op, gasnete_coll_team_t team, uint32_t flags, size_t nbytes, gasnet_image_t rootimg, int exact_match) {
+  gasnete_coll_autotune_info_t *info = team->autotune_info;
+  const gasnete_coll_syncmode_t syncmode = get_syncmode_from_flags(flags);
+  const gasnete_coll_addr_mode_t addrmode = get_addrmode_from_flags(flags);
+  gasnete_coll_decision_t *d;
+  gasnete_coll_decision_cell_t *cell;
+  uint32_t cls;
+
+  if(!info->autotuner_defaults) return NULL;
+  if((unsigned int)syncmode >= GASNETE_COLL_NUM_SYNCMODES ||
+     (unsigned int)addrmode >= GASNETE_COLL_NUM_ADDRMODES ||
+     (unsigned int)op >= GASNET_COLL_NUM_COLL_OPTYPES || nbytes > INT_MAX) {
+    return search_index(op, team, flags, nbytes, rootimg, exact_match);
+  }
+
+  d = info->decisions[op][syncmode][addrmode];
+  if_pf(!d) {
+    gasneti_mutex_lock(&info->decision_lock);
+    d = info->decisions[op][syncmode][addrmode];
+    if(!d) {
+      d = gasnete_coll_decision_compile(team, op, syncmode, addrmode, exact_match);
+      gasneti_sync_writes();
+      info->decisions[op][syncmode][addrmode] = d;
+    }
+    gasneti_mutex_unlock(&info->decision_lock);
+  } else {
+    gasneti_sync_reads();
+  }
+
+  cls = (rootimg < d->root_span) ? d->root_class[rootimg] : d->root_tail;
+  if(cls == GASNETE_COLL_DECISION_NOROOT) return NULL;
+  cell = &d->cells[cls*GASNETE_COLL_DECISION_BUCKETS + (nbytes < 2 ? 0 : fast_log2_32bit((uint32_t)nbytes))];
+  switch(cell->kind) {
+    case GASNETE_COLL_DECISION_CONST: return cell->impl_lo;
+    case GASNETE_COLL_DECISION_SPLIT: return (nbytes < cell->pivot) ? cell->impl_lo : cell->impl_hi;
+    case GASNETE_COLL_DECISION_EXACT: return (nbytes == cell->pivot) ? cell->impl_hi : NULL;
+    default: return search_index(op, team, flags, nbytes, rootimg, exact_match);
+  }
+}
+
+/******************************/
+/***BINARY TUNING DATABASE*****/
+/******************************/
+
+/* returned for leaves that name an algorithm this build does not have */
+static struct gasnete_coll_implementation_t_ gasnete_coll_tunedb_unusable;
+
+/* Validates what the lookup does not check as it walks, so that a lookup
+   only ever touches the pages on its own path through the image. */
+static const char *gasnete_coll_tunedb_check(gasnete_coll_tunedb_t *db) {
+  const gasnete_coll_tunedb_header_t *hdr = (const gasnete_coll_tunedb_header_t *)db->image;
+  const gasnete_coll_tunedb_machine_t *machines;
+  uint32_t i;
+
+  if(db->size < sizeof(gasnete_coll_tunedb_header_t) ||
+     memcmp(hdr->magic, GASNETE_COLL_TUNEDB_MAGIC, sizeof(hdr->magic))) return "not a tuning database";
+  if(hdr->byte_order != GASNETE_COLL_TUNEDB_BYTE_ORDER) return "written on a host of the other byte order";
+  if(hdr->version != GASNETE_COLL_TUNEDB_VERSION) return "of an unsupported version";
+  if(hdr->file_size != (uint64_t)db->size) return "truncated";
+#define GASNETE_COLL_TUNEDB_SECTION_OK(OFFSET, NUM, TYPE)              \
+  ((OFFSET) % GASNETE_COLL_TUNEDB_ALIGN == 0 && (OFFSET) <= db->size &&  \
+   (uint64_t)(NUM) <= (db->size - (OFFSET)) / sizeof(TYPE))
+  if(!GASNETE_COLL_TUNEDB_SECTION_OK(hdr->machines_offset, hdr->num_machines, gasnete_coll_tunedb_machine_t) ||
+     !GASNETE_COLL_TUNEDB_SECTION_OK(hdr->entries_offset, hdr->num_entries, gasnete_coll_tunedb_entry_t) ||
+     !GASNETE_COLL_TUNEDB_SECTION_OK(hdr->leaves_offset, hdr->num_leaves, gasnete_coll_tunedb_leaf_t) ||
+     !GASNETE_COLL_TUNEDB_SECTION_OK(hdr->strings_offset, hdr->strings_size, char)) return "corrupt";
+#undef GASNETE_COLL_TUNEDB_SECTION_OK
+
+  db->hdr = hdr;
+  db->entries = (const gasnete_coll_tunedb_entry_t *)((const char *)db->image + hdr->entries_offset);
+  db->leaves = (const gasnete_coll_tunedb_leaf_t *)((const char *)db->image + hdr->leaves_offset);
+  db->strings = (const char *)db->image + hdr->strings_offset;
+  if(!hdr->strings_size || db->strings[hdr->strings_size-1] != '\0') return "corrupt";
+
+  machines = (const gasnete_coll_tunedb_machine_t *)((const char *)db->image + hdr->machines_offset);
+  for(i=0; i<hdr->num_machines; i++) {
+    if(machines[i].config_str >= hdr->strings_size ||
+       (uint64_t)machines[i].first + machines[i].count > hdr->num_entries) return "corrupt";
+  }
+  return NULL;
+}
+
+/* Every process maps the file itself; nothing is sent over the network */
+static gasnete_coll_tunedb_t *gasnete_coll_tunedb_open(const char *filename, int verbose) {
+  gasnete_coll_tunedb_t *db = gasneti_calloc(1, sizeof(gasnete_coll_tunedb_t));
+  const gasnete_coll_tunedb_machine_t *machines;
+  const char *why;
+  struct stat st;
+  uint32_t i;
+  int fd;
+
+  fd = open(filename, O_RDONLY);
+  if(fd < 0 || fstat(fd, &st)) {
+    gasneti_fatalerror("gasnete_coll_loadTuningState() failed to open the tuning database %s on node %d: %s\n"
+                       "(a tuning database must be readable from every node)",
+                       filename, (int)gasneti_mynode, strerror(errno));
+  }
+  db->size = (size_t)st.st_size;
+#if HAVE_MMAP
+  db->image = db->size ? mmap(NULL, db->size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  if(db->image != MAP_FAILED) {
+    db->mapped = 1;
+  } else
+#endif
+  {
+    size_t done = 0;
+    db->image = gasneti_malloc(MAX(1,db->size));
+    while(done < db->size) {
+      ssize_t rc = read(fd, (char *)db->image + done, db->size - done);
+      if(rc <= 0) gasneti_fatalerror("gasnete_coll_loadTuningState() failed to read the tuning database %s: %s\n",
+                                     filename, rc ? strerror(errno) : "unexpected end of file");
+      done += rc;
+    }
+  }
+  close(fd);
+
+  why = gasnete_coll_tunedb_check(db);
+  if(why) gasneti_fatalerror("gasnete_coll_loadTuningState(): %s is %s\n", filename, why);
+
+  /*use the data collected under this configuration, else warn like the XML loader*/
+  machines = (const gasnete_coll_tunedb_machine_t *)((const char *)db->image + db->hdr->machines_offset);
+  for(i=0; i<db->hdr->num_machines; i++) {
+    if(STRINGS_MATCH(db->strings + machines[i].config_str, GASNET_CONFIG_STRING)) break;
+  }
+  if(i < db->hdr->num_machines) {
+    db->machine = &machines[i];
+  } else if(db->hdr->num_machines) {
+    db->machine = &machines[0];
+    if(verbose) {
+      printf("warning! tuning data's config string: %s does not match current gasnet config string: %s\n",
+             db->strings + machines[0].config_str, GASNET_CONFIG_STRING);
+    }
+  }
+  db->impls = gasneti_calloc(MAX(1,db->hdr->num_leaves), sizeof(gasnete_coll_implementation_t));
+  return db;
+}
+
+/* the implementations are not freed, as with a replaced index they may still be in use */
+static void gasnete_coll_tunedb_close(gasnete_coll_tunedb_t *db) {
+#if HAVE_MMAP
+  if(db->mapped) {
+    munmap(db->image, db->size);
+  } else
+#endif
+  {
+    gasneti_free(db->image);
+  }
+  gasneti_free(db->impls);
+  gasneti_free(db);
+}
+
+/* search_intervals() over one sorted list of the image */
+GASNETI_INLINE(gasnete_coll_tunedb_search)
+const gasnete_coll_tunedb_entry_t *gasnete_coll_tunedb_search(const gasnete_coll_tunedb_t *db, uint32_t first, uint32_t count,
+                                                              uint64_t search_value, int exact_match) {
+  const gasnete_coll_tunedb_entry_t *list;
+  uint32_t lo = 0, hi = count;
+
+  if(!count || (uint64_t)first + count > db->hdr->num_entries) return NULL;
+  list = db->entries + first;
+  /*find the first interval that starts past the value*/
+  while(lo < hi) {
+    const uint32_t mid = lo + (hi - lo)/2;
+    if(list[mid].start <= search_value) lo = mid + 1;
+    else hi = mid;
+  }
+  if(exact_match) return (lo && list[lo-1].start == search_value) ? &list[lo-1] : NULL;
+  /*values below the first interval get the first one*/
+  return lo ? &list[lo-1] : &list[0];
+}
+
+static gasnete_coll_implementation_t gasnete_coll_tunedb_make_impl(gasnete_coll_autotune_info_t *info, gasnet_coll_optype_t op,
+                                                                   const gasnete_coll_tunedb_leaf_t *leaf) {
+  const gasnete_coll_tunedb_t *db = info->tunedb;
+  const uint32_t strings_size = db->hdr->strings_size;
+  gasnete_coll_algorithm_t *alg;
+  gasnete_coll_implementation_t ret;
+
+  /*a database may have been written by a build with other algorithms*/
+  if(leaf->fn_idx >= (uint32_t)gasnete_coll_num_algs(op) ||
+     leaf->num_params > GASNETE_COLL_TUNEDB_MAX_PARAMS || leaf->num_params > GASNET_COLL_NUM_PARAM_TYPES ||
+     (leaf->alg_name != GASNETE_COLL_TUNEDB_NONE && leaf->alg_name >= strings_size) ||
+     (leaf->tree_type != GASNETE_COLL_TUNEDB_NONE && leaf->tree_type >= strings_size)) {
+    return &gasnete_coll_tunedb_unusable;
+  }
+  alg = &info->collective_algorithms[op][leaf->fn_idx];
+  if(!alg->fn_ptr.generic_coll_fn_ptr ||
+     (leaf->alg_name != GASNETE_COLL_TUNEDB_NONE &&
+      (!alg->name_str || !STRINGS_MATCH(db->strings + leaf->alg_name, alg->name_str)))) {
+    return &gasnete_coll_tunedb_unusable;
+  }
+
+  ret = gasnete_coll_get_implementation();
+  ret->fn_ptr = alg->fn_ptr.generic_coll_fn_ptr;
+  ret->fn_idx = leaf->fn_idx;
+  if(leaf->tree_type != GASNETE_COLL_TUNEDB_NONE && db->strings[leaf->tree_type]) {
+    ret->tree_type = gasnete_coll_make_tree_type_str((char *)(db->strings + leaf->tree_type));
+  }
+  ret->num_params = leaf->num_params;
+  GASNETI_MEMCPY_SAFE_EMPTY(ret->param_list, leaf->params, sizeof(uint32_t)*leaf->num_params);
+  return ret;
+}
+
+/* search_index() run directly on the mapped image */
+static
+gasnete_coll_implementation_t gasnete_coll_tunedb_lookup(gasnet_coll_optype_t op, gasnete_coll_team_t team, uint32_t flags, size_t nbytes, gasnet_image_t rootimg, int exact_match) {
+  gasnete_coll_autotune_info_t *info = team->autotune_info;
+  gasnete_coll_tunedb_t *db = info->tunedb;
+  const gasnete_coll_tunedb_entry_t *temp;
+  gasnete_coll_implementation_t ret;
+  uint32_t leaf;
+
+  if(!db->machine) return NULL;
+  temp = gasnete_coll_tunedb_search(db, db->machine->first, db->machine->count, team->total_ranks, exact_match);
+  if(temp) temp = gasnete_coll_tunedb_search(db, temp->first, temp->count, team->my_images, exact_match);
+  if(temp) temp = gasnete_coll_tunedb_search(db, temp->first, temp->count, (uint32_t)get_syncmode_from_flags(flags), 1);
+  if(temp) temp = gasnete_coll_tunedb_search(db, temp->first, temp->count, (uint32_t)get_addrmode_from_flags(flags), 1);
+  if(temp) temp = gasnete_coll_tunedb_search(db, temp->first, temp->count, (uint32_t)op, 1);
+  if(temp) temp = gasnete_coll_tunedb_search(db, temp->first, temp->count, rootimg, exact_match);
+  if(temp) temp = gasnete_coll_tunedb_search(db, temp->first, temp->count, nbytes, exact_match);
+  if(!temp || temp->count || temp->first >= db->hdr->num_leaves) return NULL;
+
+  leaf = temp->first;
+  ret = db->impls[leaf];
+  if_pf(!ret) {
+    gasneti_mutex_lock(&info->decision_lock);
+    ret = db->impls[leaf];
+    if(!ret) {
+      ret = gasnete_coll_tunedb_make_impl(info, op, &db->leaves[leaf]);
+      gasneti_sync_writes();
+      db->impls[leaf] = ret;
+    }
+    gasneti_mutex_unlock(&info->decision_lock);
+  } else {
+    gasneti_sync_reads();
+  }
+  return (ret == &gasnete_coll_tunedb_unusable) ? NULL : ret;
+}
+
 static
 gasnete_coll_autotune_index_entry_t* add_interval(gasnete_coll_autotune_index_entry_t *list, uint32_t value, const char *node_type) {
   gasnete_coll_autotune_index_entry_t *current_head = list;
@@ -2489,6 +3192,7 @@ gasnete_coll_autotune_index_entry_t *add_to_index(gasnet_coll_optype_t op, gasne
   temp = search_intervals(temp->subtree, nbytes, 1);
   gasneti_assert(temp);
   
+  if(!profile_mode) gasnete_coll_decision_invalidate(team->autotune_info);
   return temp;
 
 }
@@ -2525,6 +3229,546 @@ int verify_algorithm(gasnete_coll_team_t team, gasnet_coll_optype_t op, uint32_t
   return (size_ok && req_flags_ok && sync_flags_ok);
 }
 
+/***********************************/
+/***LOGGP MODEL-DRIVEN SELECTION****/
+/***********************************/
+
+/*LogGP parameters in microseconds, measured the way tests/testlogGP.c does*/
+typedef struct {
+  double L; /*one-way latency of a small put: half of the blocking put round trip*/
+  double o; /*initiation overhead of a non-blocking bulk put*/
+  double g; /*gap between back-to-back small non-blocking puts*/
+  double G; /*gap per byte of large non-blocking bulk puts*/
+} gasnete_coll_loggp_t;
+
+/*[0] between supernodes, [1] within a supernode*/
+static gasnete_coll_loggp_t gasnete_coll_loggp[2];
+static int gasnete_coll_loggp_ready = 0;
+
+#define GASNETE_COLL_CALIBRATE_ITERS     100
+#define GASNETE_COLL_CALIBRATE_BIG_ITERS 10
+#define GASNETE_COLL_CALIBRATE_BIG_SIZE  65536
+
+static void gasnete_coll_calibrate_peer(gasnet_node_t peer, void *peer_addr, void *buf, size_t big,
+                                        gasnete_coll_loggp_t *out) {
+  gasnett_tick_t begin, issue = 0;
+  double per_msg;
+  int i;
+
+  gasnet_put(peer, peer_addr, buf, 8); /*warm up the path*/
+  begin = gasnett_ticks_now();
+  for(i=0; i<GASNETE_COLL_CALIBRATE_ITERS; i++) {
+    gasnet_put(peer, peer_addr, buf, 8);
+  }
+  out->L = gasnett_ticks_to_ns(gasnett_ticks_now() - begin) / (2000.0 * GASNETE_COLL_CALIBRATE_ITERS);
+
+  for(i=0; i<GASNETE_COLL_CALIBRATE_ITERS; i++) {
+    gasnet_handle_t h;
+    begin = gasnett_ticks_now();
+    h = gasnet_put_nb_bulk(peer, peer_addr, buf, 8);
+    issue += gasnett_ticks_now() - begin;
+    gasnet_wait_syncnb(h);
+  }
+  out->o = gasnett_ticks_to_ns(issue) / (1000.0 * GASNETE_COLL_CALIBRATE_ITERS);
+
+  begin = gasnett_ticks_now();
+  for(i=0; i<GASNETE_COLL_CALIBRATE_ITERS; i++) {
+    gasnet_put_nbi(peer, peer_addr, buf, 8);
+  }
+  gasnet_wait_syncnbi_puts();
+  out->g = gasnett_ticks_to_ns(gasnett_ticks_now() - begin) / (1000.0 * GASNETE_COLL_CALIBRATE_ITERS);
+
+  begin = gasnett_ticks_now();
+  for(i=0; i<GASNETE_COLL_CALIBRATE_BIG_ITERS; i++) {
+    gasnet_put_nbi_bulk(peer, peer_addr, buf, big);
+  }
+  gasnet_wait_syncnbi_puts();
+  per_msg = gasnett_ticks_to_ns(gasnett_ticks_now() - begin) / (1000.0 * GASNETE_COLL_CALIBRATE_BIG_ITERS);
+  out->G = MAX(0.0, per_msg - out->g) / big;
+}
+
+/*Node 0 measures against one peer outside and one peer inside its supernode,
+  using the (still idle) collective scratch space as the put target, and then
+  writes the results into every node's scratch space.  Every node thus ends up
+  with bit-identical parameters and so makes identical model decisions.*/
+void gasnete_coll_autotune_calibrate(gasnet_seginfo_t *scratch_segs) {
+  if(!GASNET_TEAM_ALL->autotune_info->model_enabled &&
+     !GASNET_TEAM_ALL->autotune_info->online_enabled) return;
+
+  if(gasneti_mynode == 0) {
+    gasnet_node_t n, remote = 0, local = 0;
+    size_t big = GASNETE_COLL_CALIBRATE_BIG_SIZE;
+    void *buf;
+
+    for(n=1; n<gasneti_nodes; n++) {
+      if(gasneti_node2supernode(n) == gasneti_node2supernode(0)) {
+        if(!local) local = n;
+      } else if(!remote) {
+        remote = n;
+      }
+      big = MIN(big, scratch_segs[n].size);
+    }
+    memset(gasnete_coll_loggp, 0, sizeof(gasnete_coll_loggp));
+    buf = gasneti_calloc(1, MAX(big, 8));
+    if(remote) gasnete_coll_calibrate_peer(remote, scratch_segs[remote].addr, buf, big, &gasnete_coll_loggp[0]);
+    if(local) gasnete_coll_calibrate_peer(local, scratch_segs[local].addr, buf, big, &gasnete_coll_loggp[1]);
+    if(!remote) gasnete_coll_loggp[0] = gasnete_coll_loggp[1];
+    if(!local) gasnete_coll_loggp[1] = gasnete_coll_loggp[0];
+    gasneti_free(buf);
+
+    for(n=1; n<gasneti_nodes; n++) {
+      gasnet_put_nbi_bulk(n, scratch_segs[n].addr, gasnete_coll_loggp, sizeof(gasnete_coll_loggp));
+    }
+    gasnet_wait_syncnbi_puts();
+    if(gasnete_coll_print_coll_alg) {
+      fprintf(stderr, "LogGP calibration (us): remote L=%g o=%g g=%g G=%g, local L=%g o=%g g=%g G=%g\n",
+              gasnete_coll_loggp[0].L, gasnete_coll_loggp[0].o, gasnete_coll_loggp[0].g, gasnete_coll_loggp[0].G,
+              gasnete_coll_loggp[1].L, gasnete_coll_loggp[1].o, gasnete_coll_loggp[1].g, gasnete_coll_loggp[1].G);
+    }
+  }
+  gasnet_barrier(0, GASNET_BARRIERFLAG_ANONYMOUS);
+  if(gasneti_mynode != 0) {
+    memcpy(gasnete_coll_loggp, scratch_segs[gasneti_mynode].addr, sizeof(gasnete_coll_loggp));
+  }
+  /*nobody may reuse the scratch space before everyone has read the parameters*/
+  gasnet_barrier(0, GASNET_BARRIERFLAG_ANONYMOUS);
+  gasnete_coll_loggp_ready = 1;
+}
+
+/*time for one node to send k messages of m bytes, until the last one lands*/
+GASNETI_INLINE(gasnete_coll_model_send)
+double gasnete_coll_model_send(const gasnete_coll_loggp_t *p, double k, double m) {
+  if(k <= 0) return 0;
+  return (k-1) * MAX(p->g, m * p->G) + p->L + m * p->G;
+}
+
+/*number of pieces of size seg needed to hold n bytes*/
+GASNETI_INLINE(gasnete_coll_model_pieces)
+double gasnete_coll_model_pieces(double n, double seg) {
+  double pieces = (double)(uint64_t)(n / seg);
+  return (pieces * seg < n) ? pieces + 1 : pieces;
+}
+
+/*rounds needed to cover n nodes when every round multiplies the covered set by radix*/
+static double gasnete_coll_model_rounds(double n, double radix) {
+  double covered = 1, rounds = 0;
+  if(radix < 2) radix = 2;
+  while(covered < n) { covered *= radix; rounds++; }
+  return rounds;
+}
+
+/*depth and per-round fanout of the tree types produced by gasnete_coll_autotune_get_tree_type_idx()*/
+static void gasnete_coll_model_tree_shape(gasnete_coll_tree_type_t tree_type, double nodes,
+                                          double *depth, double *fanout) {
+  int radix = (tree_type->num_params > 0) ? tree_type->params[0] : 2;
+  double level, total;
+
+  switch(tree_type->tree_class) {
+    case GASNETE_COLL_FLAT_TREE:
+      *depth = (nodes > 1);
+      *fanout = nodes - 1;
+      break;
+    case GASNETE_COLL_NARY_TREE:
+      for(*depth = 0, level = 1, total = 1; total < nodes; (*depth)++) {
+        level *= radix;
+        total += level;
+      }
+      *fanout = radix;
+      break;
+    case GASNETE_COLL_KNOMIAL_TREE:
+    default: /*the search space holds no other classes; approximate them as binomial-like*/
+      *depth = gasnete_coll_model_rounds(nodes, radix);
+      *fanout = MAX(radix, 2) - 1;
+      break;
+  }
+}
+
+/*predicted time (us) of one instance of algorithm algidx with the given parameters*/
+static double gasnete_coll_model_cost(gasnete_coll_team_t team, gasnet_coll_optype_t op, uint32_t algidx,
+                                      const uint32_t *param_list, gasnete_coll_tree_type_t tree_type, size_t nbytes) {
+  const gasnete_coll_algorithm_t *alg = &team->autotune_info->collective_algorithms[op][algidx];
+  const gasnete_coll_loggp_t *p = &gasnete_coll_loggp[GASNETE_COLL_TEAM_IS_PSHM(team) ? 1 : 0];
+  const double P = team->total_ranks;
+  const double images = MAX(1, team->total_images / team->total_ranks);
+  double n = nbytes, seg = 0, depth, fanout, rounds;
+  enum {SAME, SPLIT, ALLGATHER, ALLTOALL, ALLREDUCE} volume;
+  uint32_t i;
+
+  switch(op) {
+    case GASNET_COLL_BROADCAST_OP: case GASNET_COLL_BROADCASTM_OP:
+    case GASNET_COLL_REDUCE_OP: case GASNET_COLL_REDUCEM_OP:
+      volume = SAME; break;
+    case GASNET_COLL_SCATTER_OP: case GASNET_COLL_SCATTERM_OP:
+    case GASNET_COLL_GATHER_OP: case GASNET_COLL_GATHERM_OP:
+      volume = SPLIT; break;
+    case GASNET_COLL_GATHER_ALL_OP: case GASNET_COLL_GATHER_ALLM_OP:
+      volume = ALLGATHER; break;
+    case GASNET_COLL_EXCHANGE_OP: case GASNET_COLL_EXCHANGEM_OP:
+      volume = ALLTOALL; break;
+    default:
+      volume = ALLREDUCE; break;
+  }
+  /*the M variants move one block per image, but the model works per node*/
+  if(volume != SAME && volume != ALLREDUCE) n *= images;
+
+  for(i=0; i<alg->num_parameters; i++) {
+    if(alg->parameter_list[i].tuning_param == GASNET_COLL_PIPE_SEG_SIZE) seg = param_list[i];
+  }
+
+  switch(alg->model_shape) {
+    case GASNETE_COLL_MODEL_FLAT_RV:
+    case GASNETE_COLL_MODEL_FLAT:
+      return gasnete_coll_model_send(p, P-1, n) + (alg->model_shape == GASNETE_COLL_MODEL_FLAT_RV ? p->L : 0);
+
+    case GASNETE_COLL_MODEL_TREE:
+      gasnete_coll_model_tree_shape(tree_type, P, &depth, &fanout);
+      if(volume == SPLIT) {
+        /*every byte but the root's own crosses the root's link once*/
+        return depth * gasnete_coll_model_send(p, fanout, 0) + (P-1) * n * p->G +
+               (seg > 0 ? gasnete_coll_model_pieces(n, seg) * p->o : 0);
+      } else if(seg > 0 && n > seg) {
+        /*segments pipeline down the tree*/
+        return (depth + gasnete_coll_model_pieces(n, seg) - 1) * gasnete_coll_model_send(p, fanout, seg);
+      } else {
+        return depth * gasnete_coll_model_send(p, fanout, n);
+      }
+
+    case GASNETE_COLL_MODEL_DISSEM:
+      rounds = gasnete_coll_model_rounds(P, alg->model_radix);
+      if(volume == ALLTOALL) {
+        /*every round forwards 1/radix of the blocks to each of radix-1 peers*/
+        return rounds * gasnete_coll_model_send(p, alg->model_radix-1, n * P / alg->model_radix);
+      }
+      return rounds * gasnete_coll_model_send(p, alg->model_radix-1, 0) + (P-1) * n * p->G;
+
+    case GASNETE_COLL_MODEL_REC_DBL:
+      rounds = gasnete_coll_model_rounds(P, 2);
+      if(team->total_ranks & (team->total_ranks - 1)) rounds += 2; /*fold the excess nodes in and out*/
+      return rounds * (p->L + n * p->G);
+
+    case GASNETE_COLL_MODEL_RABENSEIFNER:
+      rounds = gasnete_coll_model_rounds(P, 2);
+      return 2 * rounds * p->L + 2 * n * p->G * (P-1) / P;
+
+    case GASNETE_COLL_MODEL_PSHM:
+      /*a flag-based synchronization plus copies from one shared buffer*/
+      return 2 * gasnete_coll_model_rounds(P, 2) * p->o +
+             ((volume == ALLGATHER || volume == ALLTOALL) ? P : 1) * n * p->G;
+
+    default:
+      gasneti_fatalerror("no LogGP model for algorithm %s", alg->name_str);
+      return 0; /* NOT REACHED */
+  }
+}
+
+typedef struct {
+  double cost;
+  uint32_t algidx;
+  uint32_t param_list[GASNET_COLL_NUM_PARAM_TYPES];
+} gasnete_coll_model_cand_t;
+
+/*walk the same parameter space as do_tuning_loop(), predicting instead of timing,
+  and keep the num_cands cheapest candidates sorted by cost*/
+static void model_tuning_loop(gasnete_coll_team_t team, gasnet_coll_optype_t op, size_t nbytes,
+                              uint32_t algidx, uint32_t *curr_idx, uint32_t current_param_number,
+                              gasnete_coll_model_cand_t *cands, int num_cands, int *num_found, int verbose) {
+  const gasnete_coll_algorithm_t *alg = &team->autotune_info->collective_algorithms[op][algidx];
+  gasnete_coll_tree_type_t tree_type = NULL;
+  uint32_t i;
+  int pos;
+  double cost;
+
+  if(current_param_number < alg->num_parameters) {
+    struct gasnet_coll_tuning_parameter_t param = alg->parameter_list[current_param_number];
+    uint32_t idx = param.start;
+    gasneti_assert(idx<=param.end);
+    while (1) {
+      if(!(param.flags & GASNET_COLL_TUNING_SIZE_PARAM && idx > nbytes)) {
+        curr_idx[current_param_number] = idx;
+        model_tuning_loop(team, op, nbytes, algidx, curr_idx, current_param_number+1, cands, num_cands, num_found, verbose);
+      }
+      if(param.flags & GASNET_COLL_TUNING_STRIDE_ADD) {
+        idx+=param.stride;
+      } else if(param.flags & GASNET_COLL_TUNING_STRIDE_MULTIPLY) {
+        idx*=param.stride;
+      }
+      if(idx > param.end) break;
+    }
+    return;
+  }
+
+  for(i=0; i<alg->num_parameters; i++) {
+    if(alg->parameter_list[i].flags & GASNET_COLL_TUNING_TREE_SHAPE) {
+      tree_type = gasnete_coll_autotune_get_tree_type_idx(team, curr_idx[i]);
+    }
+  }
+  cost = gasnete_coll_model_cost(team, op, algidx, curr_idx, tree_type, nbytes);
+  if(tree_type) gasnete_coll_free_tree_type(tree_type);
+
+  if(verbose) {
+    char buf1[100];
+    printf("0> %s alg: %s (%d) nbytes: %d params:<", print_op_str(buf1, op, 0),
+           alg->name_str, (int)algidx, (int)nbytes);
+    for(i=0; i<alg->num_parameters; i++) printf(" %d", (int)curr_idx[i]);
+    printf(" > predicted: %g\n", cost);
+  }
+
+  /*strict comparison keeps the earliest registered algorithm on ties, as the search does*/
+  for(pos = *num_found; pos > 0 && cost < cands[pos-1].cost; pos--) {
+    if(pos < num_cands) cands[pos] = cands[pos-1];
+  }
+  if(*num_found < num_cands) (*num_found)++;
+  if(pos < num_cands) {
+    cands[pos].cost = cost;
+    cands[pos].algidx = algidx;
+    GASNETI_MEMCPY_SAFE_EMPTY(cands[pos].param_list, curr_idx, alg->num_parameters*sizeof(uint32_t));
+  }
+}
+
+static gasnete_coll_implementation_t gasnete_coll_model_make_impl(gasnete_coll_team_t team, gasnet_coll_optype_t op, int flags,
+                                                                  const gasnete_coll_model_cand_t *cand) {
+  const gasnete_coll_algorithm_t *alg = &team->autotune_info->collective_algorithms[op][cand->algidx];
+  gasnete_coll_implementation_t impl = gasnete_coll_get_implementation();
+  uint32_t i;
+
+  impl->team = team;
+  impl->optype = op;
+  impl->flags = flags;
+  impl->fn_ptr = alg->fn_ptr.generic_coll_fn_ptr;
+  impl->fn_idx = cand->algidx;
+  impl->num_params = alg->num_parameters;
+  GASNETI_MEMCPY_SAFE_EMPTY(impl->param_list, cand->param_list, impl->num_params*sizeof(uint32_t));
+  for(i=0; i<alg->num_parameters; i++) {
+    if(alg->parameter_list[i].flags & GASNET_COLL_TUNING_TREE_SHAPE) {
+      impl->tree_type = gasnete_coll_autotune_get_tree_type_idx(team, cand->param_list[i]);
+    }
+  }
+  return impl;
+}
+
+/*ranks the modeled algorithms that can run this call, keeping the num_cands
+  cheapest (algorithm, parameters) pairs in cands; returns how many were kept*/
+static int gasnete_coll_model_rank(gasnete_coll_team_t team, gasnet_coll_optype_t op, size_t nbytes, int flags,
+                                   gasnete_coll_model_cand_t *cands, int num_cands, int verbose) {
+  gasnete_coll_autotune_info_t *info = team->autotune_info;
+  const uint32_t sync_flags = (flags & GASNET_COLL_SYNC_FLAG_MASK);
+  const uint32_t req_flags = (flags & (~GASNET_COLL_SYNC_FLAG_MASK));
+  uint32_t curr_idx[GASNET_COLL_NUM_PARAM_TYPES];
+  int algidx, found = 0;
+
+  for(algidx=0; algidx<gasnete_coll_num_algs(op); algidx++) {
+    const gasnete_coll_algorithm_t *alg = &info->collective_algorithms[op][algidx];
+    if(alg->model_shape == GASNETE_COLL_MODEL_NONE) continue;
+    if(!(nbytes <= alg->max_num_bytes && nbytes >= alg->min_num_bytes)) continue;
+    if((req_flags & alg->requirements) != alg->requirements) continue;
+    if((sync_flags & alg->syncflags) != sync_flags) continue;
+    if(req_flags & alg->n_requirements) continue;
+    if(alg->pshm_only && !GASNETE_COLL_TEAM_IS_PSHM(team)) continue;
+    /*the PSHM algorithms synchronize the team, as for the default selection*/
+    if(alg->pshm_only && !((flags & GASNET_COLL_IN_ALLSYNC) && (flags & GASNET_COLL_OUT_ALLSYNC))) continue;
+    model_tuning_loop(team, op, nbytes, algidx, curr_idx, 0, cands, num_cands, &found, verbose);
+  }
+  return found;
+}
+
+/*Picks an algorithm for this call from the calibrated LogGP parameters alone.
+  The result depends only on values every team member shares, so every member
+  picks the same one without communicating.  With GASNET_COLL_MODEL_TOPK > 1
+  (TEAM_ALL only, like the search) the cheapest candidates are timed and the
+  winner at image 0 is broadcast.  Returns NULL if no algorithm is modeled.*/
+static gasnete_coll_implementation_t gasnete_coll_model_select(gasnet_team_handle_t team, gasnet_coll_optype_t op,
+                                                               gasnet_coll_args_t args, int flags GASNETI_THREAD_FARG) {
+  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+  const int verbose = gasnete_coll_print_autotuner_timers && td->my_image == 0;
+  const int num_cands = (team == GASNET_TEAM_ALL) ? MAX(1, gasnete_coll_model_topk) : 1;
+  gasnete_coll_model_cand_t *cands = gasneti_malloc(num_cands * sizeof(gasnete_coll_model_cand_t));
+  gasnete_coll_implementation_t ret = NULL;
+  int i, winner = 0;
+  const int found = gasnete_coll_model_rank(team, op, args.nbytes, flags, cands, num_cands, verbose);
+
+  if(found > 1) {
+    gasnett_tick_t best_time = GASNETT_TICK_MAX;
+    for(i=0; i<found; i++) {
+      gasnete_coll_implementation_t impl = gasnete_coll_model_make_impl(team, op, flags, &cands[i]);
+      gasnett_tick_t t = run_collective_bench(team, op, args, flags, impl, NULL, NULL GASNETI_THREAD_PASS);
+      if(t < best_time) { best_time = t; winner = i; }
+      gasnete_coll_free_implementation(impl);
+    }
+    gasnete_coll_safe_broadcast(team, &winner, &winner, 0, sizeof(int), 0 GASNETI_THREAD_PASS);
+  }
+  if(found) {
+    ret = gasnete_coll_model_make_impl(team, op, flags, &cands[winner]);
+  }
+  gasneti_free(cands);
+  return ret;
+}
+
+/*******************************/
+/***ONLINE (BANDIT) SELECTION***/
+/*******************************/
+
+/*Every image of a team makes the same collective calls in the same order,
+  so the number of calls a cell has seen, and with it the arm played on each
+  call, agrees across the team without any communication.  Only the timings
+  differ between images; the ones at team rank 0 decide, and the decision is
+  handed to the others by one small broadcast per epoch.*/
+
+static gasnete_coll_online_cell_t *gasnete_coll_online_cell_create(gasnete_coll_team_t team, gasnet_coll_optype_t op,
+                                                                   size_t nbytes, int flags) {
+  gasnete_coll_online_cell_t *cell = gasneti_calloc(1, sizeof(gasnete_coll_online_cell_t));
+  gasnete_coll_model_cand_t cands[GASNETE_COLL_ONLINE_MAX_ARMS];
+  int i, found;
+
+  cell->flags = flags;
+  cell->nbytes = nbytes;
+  cell->best = 0;
+  /*ranked for exactly this size, so every arm is valid on every call to the cell*/
+  found = gasnete_coll_model_rank(team, op, nbytes, flags, cands, gasnete_coll_online_arms, 0);
+  for(i=0; i<found; i++) {
+    gasnete_coll_implementation_t impl = gasnete_coll_model_make_impl(team, op, flags, &cands[i]);
+    if(nbytes < team->autotune_info->collective_algorithms[op][impl->fn_idx].min_num_bytes ||
+       !verify_algorithm(team, op, flags, nbytes, impl)) {
+      gasnete_coll_free_implementation(impl);
+      continue;
+    }
+    cell->arms[cell->num_arms++] = impl;
+  }
+  return cell;
+}
+
+/*folds the samples since the last agreement into the estimates and
+  returns the arm that is fastest here*/
+static int gasnete_coll_online_fold(gasnete_coll_online_cell_t *cell) {
+  int i, winner = -1;
+
+  for(i=0; i<cell->num_arms; i++) {
+    if(cell->count[i]) {
+      const double mean = (double)cell->sum[i] / cell->count[i];
+      /*halve the weight of older epochs so the choice follows a changing workload*/
+      cell->est[i] = (cell->est[i] > 0) ? (cell->est[i] + mean) / 2 : mean;
+      cell->sum[i] = 0;
+      cell->count[i] = 0;
+    }
+    if(cell->est[i] > 0 && (winner < 0 || cell->est[i] < cell->est[winner])) winner = i;
+  }
+  return (winner < 0) ? cell->best : winner;
+}
+
+/*adopts the arm that is fastest at team rank 0*/
+static void gasnete_coll_online_agree(gasnete_coll_team_t team, gasnete_coll_online_cell_t *cell GASNETI_THREAD_FARG) {
+  int winner = gasnete_coll_online_fold(cell);
+  gasnete_coll_safe_broadcast(team, &cell->best, &winner, 0, sizeof(int), 0 GASNETI_THREAD_PASS);
+}
+
+/*non-zero if the team must agree on the best arm before the next call*/
+static int gasnete_coll_online_agree_due(const gasnete_coll_online_cell_t *cell, int samples, int epoch) {
+  const uint64_t sweep = (uint64_t)cell->num_arms * samples;
+  if(cell->num_arms == 1 || cell->ncalls < sweep) return 0;
+  return (cell->ncalls == sweep || (epoch && (cell->ncalls - sweep) % epoch == 0));
+}
+
+/*the arm played by the next call, which it counts*/
+static int gasnete_coll_online_next_arm(gasnete_coll_online_cell_t *cell, int samples, int explore) {
+  uint64_t c = cell->ncalls++;
+  int arm;
+
+  if(cell->num_arms == 1) return 0;
+  if(c < (uint64_t)cell->num_arms * samples) {
+    /*initial sweep: every arm in turn*/
+    return c % cell->num_arms;
+  }
+  c -= (uint64_t)cell->num_arms * samples;
+  if(explore > 1 && c % explore == explore - 1) {
+    /*bounded exploration: the other arms in turn, one call in every explore*/
+    arm = (c / explore) % (cell->num_arms - 1);
+    return (arm >= cell->best) ? arm + 1 : arm;
+  }
+  return cell->best;
+}
+
+static void gasnete_coll_online_sample(gasnete_coll_online_cell_t *cell, int arm, gasnett_tick_t elapsed) {
+  if(cell->seen[arm]++ == 0) return; /*the first call of each arm pays for its setup*/
+  cell->sum[arm] += elapsed;
+  cell->count[arm]++;
+}
+
+static gasnete_coll_implementation_t gasnete_coll_online_select(gasnet_team_handle_t team, gasnet_coll_optype_t op,
+                                                                gasnet_coll_args_t args, int flags GASNETI_THREAD_FARG) {
+  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+  gasnete_coll_autotune_info_t *info = team->autotune_info;
+  gasnete_coll_online_table_t *table;
+  gasnete_coll_online_cell_t *cell;
+  int bucket, arm;
+
+  if(args.nbytes > INT_MAX || td->my_local_image >= team->my_images) return NULL;
+  bucket = (args.nbytes < 2) ? 0 : fast_log2_32bit((uint32_t)args.nbytes);
+
+  /*each image only ever touches its own table, so no locking is needed*/
+  table = info->online[td->my_local_image];
+  if_pf(!table) {
+    table = gasneti_calloc(1, sizeof(gasnete_coll_online_table_t));
+    info->online[td->my_local_image] = table;
+  }
+  for(cell = table->cells[op][bucket];
+      cell && (cell->flags != (uint32_t)flags || cell->nbytes != args.nbytes);
+      cell = cell->next) {}
+  if_pf(!cell) {
+    cell = gasnete_coll_online_cell_create(team, op, args.nbytes, flags);
+    cell->next = table->cells[op][bucket];
+    table->cells[op][bucket] = cell;
+  }
+  if(!cell->num_arms) return NULL;
+
+  if(gasnete_coll_online_agree_due(cell, gasnete_coll_online_samples, gasnete_coll_online_epoch)) {
+    gasnete_coll_online_agree(team, cell GASNETI_THREAD_PASS);
+    if (gasnete_coll_print_coll_alg && td->my_image == 0) {
+      fprintf(stderr, "The algorithm agreed on by the online tuner is:\n");
+      gasnete_coll_implementation_print(cell->arms[cell->best], stderr);
+    }
+  }
+  arm = gasnete_coll_online_next_arm(cell, gasnete_coll_online_samples, gasnete_coll_online_explore);
+
+  if(cell->num_arms > 1) {
+    td->online_cell = cell;
+    td->online_arm = arm;
+    td->online_start = gasnett_ticks_now();
+  }
+  return cell->arms[arm];
+}
+
+/*called by a blocking collective once it has completed*/
+void gasnete_coll_online_record(gasnete_coll_threaddata_t *td) {
+  gasnete_coll_online_cell_t *cell = td->online_cell;
+
+  td->online_cell = NULL;
+  gasnete_coll_online_sample(cell, td->online_arm, gasnett_ticks_now() - td->online_start);
+}
+
+/*Runs the online schedule for 'ncalls' calls of a cell whose arms take the
+  given times, with the local choice standing in for the team's agreement.
+  Returns the arm adopted at the end and sets *explored_p to the number of
+  calls after the initial sweep which played another arm.  Used by the
+  internal tests (see gasnet_diagnostic.c).*/
+extern int gasnete_coll_online_simulate(int num_arms, const uint64_t cost[], int ncalls,
+                                        int samples, int explore, int epoch, int *explored_p) {
+  gasnete_coll_online_cell_t *cell = gasneti_calloc(1, sizeof(gasnete_coll_online_cell_t));
+  int i, best;
+
+  gasneti_assert(num_arms > 0 && num_arms <= GASNETE_COLL_ONLINE_MAX_ARMS);
+  cell->num_arms = num_arms;
+  *explored_p = 0;
+  for(i=0; i<ncalls; i++) {
+    int arm;
+    if(gasnete_coll_online_agree_due(cell, samples, epoch)) cell->best = gasnete_coll_online_fold(cell);
+    arm = gasnete_coll_online_next_arm(cell, samples, explore);
+    if(cell->ncalls > (uint64_t)num_arms * samples && arm != cell->best) ++*explored_p;
+    gasnete_coll_online_sample(cell, arm, cost[arm]);
+  }
+  best = cell->best;
+  gasneti_free(cell);
+  return best;
+}
+
 static gasnete_coll_implementation_t autotune_op(gasnet_team_handle_t team, gasnet_coll_optype_t op, gasnet_coll_args_t args, int flags GASNETI_THREAD_FARG) {
   gasnete_coll_implementation_t ret;
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
@@ -2540,7 +3784,8 @@ static gasnete_coll_implementation_t autotune_op(gasnet_team_handle_t team, gasn
   }
 
   /*if a tuning file has been specified for TEAM ALL and hasn't been yet loaded load it now*/
-  if(team == GASNET_TEAM_ALL && gasnete_coll_team_all_tuning_file && !team->autotune_info->autotuner_defaults) {
+  if(team == GASNET_TEAM_ALL && gasnete_coll_team_all_tuning_file &&
+     !team->autotune_info->autotuner_defaults && !team->autotune_info->tunedb) {
     gasnete_coll_loadTuningState(gasnete_coll_team_all_tuning_file, team GASNETI_THREAD_PASS);
   }
   
@@ -2550,8 +3795,16 @@ static gasnete_coll_implementation_t autotune_op(gasnet_team_handle_t team, gasn
     idx->num_calls++;
   }
   
-  if(team->autotune_info->autotuner_defaults  || team->autotune_info->search_enabled) {
-    ret = search_index(op, team, flags, args.nbytes, args.rootimg, team->autotune_info->search_enabled);  
+  if(team->autotune_info->autotuner_defaults || team->autotune_info->tunedb ||
+     team->autotune_info->search_enabled || team->autotune_info->model_enabled) {
+    /*entries added by the search or the model only hold for exactly the size they were made for*/
+    const int exact_match = team->autotune_info->search_enabled || team->autotune_info->model_enabled;
+    ret = lookup_decision(op, team, flags, args.nbytes, args.rootimg, exact_match);
+    gasneti_assert(ret == search_index(op, team, flags, args.nbytes, args.rootimg, exact_match));
+    /*entries tuned in this run take precedence over a loaded database*/
+    if(!ret && team->autotune_info->tunedb) {
+      ret = gasnete_coll_tunedb_lookup(op, team, flags, args.nbytes, args.rootimg, exact_match);
+    }
     /*make sure the returned algortithm can handle the cases*/
     if(verify_algorithm(team, op, flags, args.nbytes, ret)) {
       if (ret->team == NULL) {
@@ -2642,6 +3895,30 @@ static gasnete_coll_implementation_t autotune_op(gasnet_team_handle_t team, gasn
       gasnete_coll_implementation_print(ret, stderr);
     }
 
+    return ret;
+  } else if(team->autotune_info->online_enabled && gasnete_coll_loggp_ready) {
+    /*nothing goes into the index: the choice keeps changing with the measurements*/
+    return gasnete_coll_online_select(team, op, args, flags GASNETI_THREAD_PASS);
+  } else if(team->autotune_info->model_enabled && gasnete_coll_loggp_ready) {
+    /*with one image per node there are no local threads to synchronize with,
+      so the model needs no communication at all (a test uniform across the team)*/
+    const int sync_images = (team->total_images > team->total_ranks);
+
+    ret = gasnete_coll_model_select(team, op, args, flags GASNETI_THREAD_PASS);
+    if(!ret) return NULL;
+
+    /*insert ret into the search index*/
+    if(sync_images) PTHREAD_BARRIER(team, team->my_images);
+    if(td->my_local_image == 0) {
+      gasnete_coll_autotune_index_entry_t *idx = add_to_index(op, team, flags, args.nbytes, args.rootimg, 0);
+      idx->impl = ret;
+    }
+    if(sync_images) PTHREAD_BARRIER(team, team->my_images);
+
+    if (gasnete_coll_print_coll_alg && td->my_image == 0) {
+      fprintf(stderr, "The algorithm picked by the LogGP model is:\n");
+      gasnete_coll_implementation_print(ret, stderr);
+    }
     return ret;
   } else {
 
@@ -2684,6 +3961,13 @@ gasnete_coll_implementation_t gasnete_coll_autotune_get_bcast_algorithm(gasnet_t
                                                        -1,nbytes, flags);
   
   /*for now encode the original decision tree*/
+#if GASNET_PSHM
+  if (GASNETE_COLL_USE_PSHM_ALG(team, flags, GASNET_COLL_SRC_IN_SEGMENT)) {
+    /* Every member is in our supernode: move the data with loads and stores */
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_BROADCAST_OP][GASNETE_COLL_BROADCAST_PSHM].fn_ptr.bcast_fn;
+    ret->fn_idx = GASNETE_COLL_BROADCAST_PSHM;
+  } else
+#endif
   if ((nbytes <= eager_limit) && 
       (flags & (GASNET_COLL_IN_MYSYNC | GASNET_COLL_OUT_MYSYNC | GASNET_COLL_LOCAL))) {
     /* Small enough for Eager, which will eliminate any barriers for *_MYSYNC and
@@ -2867,6 +4151,13 @@ gasnete_coll_autotune_get_scatter_algorithm(gasnet_team_handle_t team, void *dst
                                                         GASNET_COLL_SCATTER_OP, 
                                                         srcimage, nbytes, flags);
   /* Choose algorithm based on arguments */
+#if GASNET_PSHM
+  if (GASNETE_COLL_USE_PSHM_ALG(team, flags, GASNET_COLL_SRC_IN_SEGMENT)) {
+    /* Every member is in our supernode: move the data with loads and stores */
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_SCATTER_OP][GASNETE_COLL_SCATTER_PSHM].fn_ptr.scatter_fn;
+    ret->fn_idx = GASNETE_COLL_SCATTER_PSHM;
+  } else
+#endif
   if ((flags & GASNET_COLL_DST_IN_SEGMENT) && (flags & GASNET_COLL_SRC_IN_SEGMENT)) {
     /* Both ends are in-segment */
     if (nbytes <= eager_limit) {
@@ -3044,6 +4335,13 @@ gasnete_coll_autotune_get_gather_algorithm(gasnet_team_handle_t team,gasnet_imag
   ret->tree_type = gasnete_coll_autotune_get_tree_type(team->autotune_info, 
                                                        GASNET_COLL_GATHER_OP, 
                                                        dstimage, nbytes, flags);
+#if GASNET_PSHM
+  if (GASNETE_COLL_USE_PSHM_ALG(team, flags, GASNET_COLL_DST_IN_SEGMENT)) {
+    /* Every member is in our supernode: move the data with loads and stores */
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_GATHER_OP][GASNETE_COLL_GATHER_PSHM].fn_ptr.gather_fn;
+    ret->fn_idx = GASNETE_COLL_GATHER_PSHM;
+  } else
+#endif
   if ((flags & GASNET_COLL_DST_IN_SEGMENT) && (flags & GASNET_COLL_SRC_IN_SEGMENT)) {
     if (nbytes <= eager_limit) {
       ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_GATHER_OP][GASNETE_COLL_GATHER_TREE_EAGER].fn_ptr.gather_fn;
@@ -3322,6 +4620,13 @@ gasnete_coll_autotune_get_exchange_algorithm(gasnet_team_handle_t team, void *ds
   ret->flags = flags;
   ret->optype = GASNET_COLL_EXCHANGE_OP;
 
+#if GASNET_PSHM
+  if (GASNETE_COLL_USE_PSHM_ALG(team, flags, GASNET_COLL_SRC_IN_SEGMENT)) {
+    /* Every member is in our supernode: move the data with loads and stores */
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_EXCHANGE_OP][GASNETE_COLL_EXCHANGE_PSHM].fn_ptr.exchange_fn;
+    ret->fn_idx = GASNETE_COLL_EXCHANGE_PSHM;
+  } else
+#endif
   if (nbytes <=  gasnete_coll_get_dissem_limit(team->autotune_info, GASNET_COLL_EXCHANGE_OP, flags) &&
       nbytes*team->total_images+(max_dissem_msg_size*2)<= team->smallest_scratch_seg  &&
       max_dissem_msg_size <=  gasnet_AMMaxLongRequest() &&
@@ -3394,11 +4699,27 @@ gasnete_coll_autotune_get_exchangeM_algorithm(gasnet_team_handle_t team, void *
 }
   
 
+/* Default segment size for the segmented tree reduce of (elem_count) elements.
+   Returns zero when the vector fits in a single pipeline segment (or would need
+   more than GASNETE_COLL_MAX_NUM_SEGS of them), in which case the unsegmented
+   tree is used. */
+static size_t gasnete_coll_reduce_default_seg_size(gasnet_team_handle_t team, size_t elem_size, size_t elem_count,
+                                                   uint32_t flags) {
+  size_t nbytes = elem_size*elem_count;
+  size_t seg_size = gasnete_coll_get_pipe_seg_size(team->autotune_info, GASNET_COLL_REDUCE_OP, flags);
+
+  /* segments are cut on element boundaries */
+  seg_size = MAX(elem_size, seg_size - (seg_size % elem_size));
+  if (nbytes <= seg_size || (nbytes+seg_size-1)/seg_size >= GASNETE_COLL_MAX_NUM_SEGS) return 0;
+  return seg_size;
+}
+
 gasnete_coll_implementation_t gasnete_coll_autotune_get_reduce_algorithm(gasnet_team_handle_t team, gasnet_image_t dstimage, void *dst, void * src,
                                                                           size_t src_blksz, size_t src_offset, size_t elem_size, size_t elem_count,
                                                                           gasnet_coll_fn_handle_t func, int func_arg,
                                                                           uint32_t flags GASNETI_THREAD_FARG){
   gasnete_coll_implementation_t ret;
+  size_t seg_size;
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
 
   {
@@ -3428,8 +4749,25 @@ gasnete_coll_implementation_t gasnete_coll_autotune_get_reduce_algorithm(gasnet_
                                                        GASNET_COLL_REDUCE_OP, 
                                                        -1,elem_count*elem_size, flags);
   
-  ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_REDUCE_OP][GASNETE_COLL_REDUCE_TREE_GET].fn_ptr.reduce_fn;
-  ret->fn_idx = GASNETE_COLL_REDUCE_TREE_GET;
+#if GASNET_PSHM
+  if (GASNETE_COLL_USE_PSHM_ALG(team, flags, GASNET_COLL_SRC_IN_SEGMENT)) {
+    /* Every member is in our supernode: the root reduces straight out of the peers' segments */
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_REDUCE_OP][GASNETE_COLL_REDUCE_PSHM].fn_ptr.reduce_fn;
+    ret->fn_idx = GASNETE_COLL_REDUCE_PSHM;
+  } else
+#endif
+  if (!(flags & GASNETE_COLL_SUBORDINATE) &&
+      (seg_size = gasnete_coll_reduce_default_seg_size(team, elem_size, elem_count, flags))) {
+    /* Large vectors are pipelined through the tree in segments, bounding the scratch per level.
+       Subordinates are excluded since their parent reserved only one sequence number for each. */
+    ret->num_params = 1;
+    ret->param_list[0] = seg_size;
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_REDUCE_OP][GASNETE_COLL_REDUCE_TREE_GET_SEG].fn_ptr.reduce_fn;
+    ret->fn_idx = GASNETE_COLL_REDUCE_TREE_GET_SEG;
+  } else {
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_REDUCE_OP][GASNETE_COLL_REDUCE_TREE_GET].fn_ptr.reduce_fn;
+    ret->fn_idx = GASNETE_COLL_REDUCE_TREE_GET;
+  }
 
   if (gasnete_coll_print_coll_alg && td->my_image == 0) {
     fprintf(stderr, "The algorithm for reduce is selected by the default logic.\n");
@@ -3444,6 +4782,7 @@ gasnete_coll_implementation_t gasnete_coll_autotune_get_reduceM_algorithm(gasnet
                                                                           gasnet_coll_fn_handle_t func, int func_arg,
                                                                           uint32_t flags GASNETI_THREAD_FARG){
   gasnete_coll_implementation_t ret;
+  size_t seg_size;
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
 
   {
@@ -3474,8 +4813,16 @@ gasnete_coll_implementation_t gasnete_coll_autotune_get_reduceM_algorithm(gasnet
                                                        GASNET_COLL_REDUCEM_OP, 
                                                        -1,elem_count*elem_size, flags);
   
-  ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_REDUCEM_OP][GASNETE_COLL_REDUCEM_TREE_GET].fn_ptr.reduceM_fn;
-  ret->fn_idx = GASNETE_COLL_REDUCEM_TREE_GET;
+  if (!(flags & GASNETE_COLL_SUBORDINATE) &&
+      (seg_size = gasnete_coll_reduce_default_seg_size(team, elem_size, elem_count, flags))) {
+    ret->num_params = 1;
+    ret->param_list[0] = seg_size;
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_REDUCEM_OP][GASNETE_COLL_REDUCEM_TREE_GET_SEG].fn_ptr.reduceM_fn;
+    ret->fn_idx = GASNETE_COLL_REDUCEM_TREE_GET_SEG;
+  } else {
+    ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_REDUCEM_OP][GASNETE_COLL_REDUCEM_TREE_GET].fn_ptr.reduceM_fn;
+    ret->fn_idx = GASNETE_COLL_REDUCEM_TREE_GET;
+  }
 
   if (gasnete_coll_print_coll_alg && td->my_image == 0) {
     fprintf(stderr, "The algorithm for reduceM is selected by the default logic.\n");
@@ -3486,6 +4833,109 @@ gasnete_coll_implementation_t gasnete_coll_autotune_get_reduceM_algorithm(gasnet
 }
 
 
+/* Shared default logic: recursive doubling for latency-bound sizes, Rabenseifner for
+   bandwidth-bound sizes with enough elements to split, otherwise one reduce per rank */
+static int gasnete_coll_default_allreduce_alg(gasnet_team_handle_t team, gasnet_coll_optype_t op,
+                                              size_t elem_size, size_t elem_count) {
+  const gasnete_coll_algorithm_t *algs = team->autotune_info->collective_algorithms[op];
+  size_t nbytes = elem_size*elem_count;
+  size_t pof2 = 1;
+
+  /* the algorithm indices are the same for both variants */
+  gasneti_assert((int)GASNETE_COLL_ALLREDUCE_REC_DBL == (int)GASNETE_COLL_ALLREDUCEM_REC_DBL);
+  gasneti_assert((int)GASNETE_COLL_ALLREDUCE_RABENSEIFNER == (int)GASNETE_COLL_ALLREDUCEM_RABENSEIFNER);
+  gasneti_assert((int)GASNETE_COLL_ALLREDUCE_RED == (int)GASNETE_COLL_ALLREDUCEM_RED);
+
+  while (2*pof2 <= team->total_ranks) pof2 *= 2;
+  if (nbytes <= team->autotune_info->allreduce_rdbl_limit &&
+      nbytes <= algs[GASNETE_COLL_ALLREDUCE_REC_DBL].max_num_bytes) {
+    return GASNETE_COLL_ALLREDUCE_REC_DBL;
+  } else if (elem_count >= pof2 &&
+             nbytes <= algs[GASNETE_COLL_ALLREDUCE_RABENSEIFNER].max_num_bytes) {
+    return GASNETE_COLL_ALLREDUCE_RABENSEIFNER;
+  } else if (nbytes <= algs[GASNETE_COLL_ALLREDUCE_REC_DBL].max_num_bytes) {
+    return GASNETE_COLL_ALLREDUCE_REC_DBL;
+  } else {
+    return GASNETE_COLL_ALLREDUCE_RED;
+  }
+}
+
+gasnete_coll_implementation_t gasnete_coll_autotune_get_allreduce_algorithm(gasnet_team_handle_t team, void *dst, void *src,
+                                                                             size_t elem_size, size_t elem_count,
+                                                                             gasnet_coll_fn_handle_t func, int func_arg,
+                                                                             uint32_t flags GASNETI_THREAD_FARG){
+  gasnete_coll_implementation_t ret;
+  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+
+  {
+    gasnet_coll_args_t args = GASNET_COLL_ARGS_INITIALIZER;
+    args.dst = (uint8_t**)&dst;
+    args.src = (uint8_t**)&src;
+    args.elem_size = elem_size;
+    args.nbytes = elem_count * elem_size;
+    args.func = func;
+    args.func_arg = func_arg;
+    
+    /*first try to search our gasnet autotuner index to see if we have anything for it*/
+    ret = autotune_op(team, GASNET_COLL_ALLREDUCE_OP, args, flags GASNETI_THREAD_PASS);
+    if(ret) return ret;
+  }
+  
+  ret = gasnete_coll_get_implementation();
+  ret->need_to_free = 1;
+  ret->num_params =0;
+  ret->team = team;
+  ret->flags = flags;
+  ret->optype = GASNET_COLL_ALLREDUCE_OP;
+  ret->fn_idx = gasnete_coll_default_allreduce_alg(team, GASNET_COLL_ALLREDUCE_OP, elem_size, elem_count);
+  ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_ALLREDUCE_OP][ret->fn_idx].fn_ptr.allreduce_fn;
+
+  if (gasnete_coll_print_coll_alg && td->my_image == 0) {
+    fprintf(stderr, "The algorithm for allreduce is selected by the default logic.\n");
+    gasnete_coll_implementation_print(ret, stderr);
+  }
+
+  return ret;
+}
+
+gasnete_coll_implementation_t gasnete_coll_autotune_get_allreduceM_algorithm(gasnet_team_handle_t team, void * const dstlist[], void * const srclist[],
+                                                                              size_t elem_size, size_t elem_count,
+                                                                              gasnet_coll_fn_handle_t func, int func_arg,
+                                                                              uint32_t flags GASNETI_THREAD_FARG){
+  gasnete_coll_implementation_t ret;
+  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+
+  {
+    gasnet_coll_args_t args = GASNET_COLL_ARGS_INITIALIZER;
+    args.dst = (uint8_t**)dstlist;
+    args.src = (uint8_t**)srclist;
+    args.elem_size = elem_size;
+    args.nbytes = elem_count * elem_size;
+    args.func = func;
+    args.func_arg = func_arg;
+    
+    /*first try to search our gasnet autotuner index to see if we have anything for it*/
+    ret = autotune_op(team, GASNET_COLL_ALLREDUCEM_OP, args, flags GASNETI_THREAD_PASS);
+    if(ret) return ret;
+  }
+  
+  ret = gasnete_coll_get_implementation();
+  ret->need_to_free = 1;
+  ret->num_params =0;
+  ret->team = team;
+  ret->flags = flags;
+  ret->optype = GASNET_COLL_ALLREDUCEM_OP;
+  ret->fn_idx = gasnete_coll_default_allreduce_alg(team, GASNET_COLL_ALLREDUCEM_OP, elem_size, elem_count);
+  ret->fn_ptr = team->autotune_info->collective_algorithms[GASNET_COLL_ALLREDUCEM_OP][ret->fn_idx].fn_ptr.allreduceM_fn;
+
+  if (gasnete_coll_print_coll_alg && td->my_image == 0) {
+    fprintf(stderr, "The algorithm for allreduceM is selected by the default logic.\n");
+    gasnete_coll_implementation_print(ret, stderr);
+  }
+  
+  return ret;
+}
+
 static void dump_tuning_state_helper(myxml_node_t *parent, gasnete_coll_autotune_index_entry_t *tuning_root) {
   gasnete_coll_autotune_index_entry_t *temp=tuning_root;
   while(temp!=NULL) {
@@ -3616,25 +5066,39 @@ void gasnete_coll_loadTuningState(char *filename, gasnete_coll_team_t team GASNE
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
   myxml_node_t *nodes;
   gasnet_image_t myrank = team->myrank;
+  const char *path = filename ? filename : "gasnet_coll_tuning_defaults.bin";
   
   PTHREAD_BARRIER(team, team->my_images);
   if(td->my_local_image == 0) {
+    FILE *instream = NULL;
+    int is_tunedb = 0;
+
     if(myrank == 0) {
-      FILE *instream;
-      myxml_bytestream_t file_content;
-      
+      char magic[8];
+
       if(!filename) {
         if(team!=GASNET_TEAM_ALL) {fprintf(stderr, "WARNING: loading tuning output to default filename is not recommended for non-TEAM-ALL teams\n");}
-        instream = fopen("gasnet_coll_tuning_defaults.bin", "r");
-      } else {
-        instream = fopen(filename, "r");
       }
-      
-      /*load the tuning file into a bytestream*/
+      instream = fopen(path, "r");
       if(instream == NULL) {
-        gasneti_fatalerror("gasnete_coll_loadTuningState() failed to open the tuning file %s!\n",
-                           filename ? filename : "gasnet_coll_tuning_defaults.bin");
+        gasneti_fatalerror("gasnete_coll_loadTuningState() failed to open the tuning file %s!\n", path);
       }
+      /*a binary tuning database is recognized by its magic, anything else is read as XML*/
+      is_tunedb = (fread(magic, 1, sizeof(magic), instream) == sizeof(magic) &&
+                   !memcmp(magic, GASNETE_COLL_TUNEDB_MAGIC, sizeof(magic)));
+      rewind(instream);
+    }
+    gasnete_coll_safe_broadcast(team, &is_tunedb, (myrank == 0 ? &is_tunedb : NULL), 0, sizeof(int), 1 GASNETI_THREAD_PASS);
+
+    if(is_tunedb) {
+      /*every process maps the database itself instead of receiving it*/
+      if(instream) fclose(instream);
+      if(team->autotune_info->tunedb) gasnete_coll_tunedb_close(team->autotune_info->tunedb);
+      team->autotune_info->tunedb = gasnete_coll_tunedb_open(path, myrank == 0);
+    } else if(myrank == 0) {
+      myxml_bytestream_t file_content;
+      
+      /*load the tuning file into a bytestream*/
       file_content = myxml_loadFile_into_bytestream(instream);
       
       /*initiate a broadcast to all the other nodes*/
@@ -3653,6 +5117,7 @@ void gasnete_coll_loadTuningState(char *filename, gasnete_coll_team_t team GASNE
       nodes = myxml_loadTreeBYTESTREAM(buffer, nbytes);
       team->autotune_info->autotuner_defaults = gasnete_coll_load_autotuner_defaults(team->autotune_info, nodes);
     }
+    gasnete_coll_decision_invalidate(team->autotune_info);
   }
   PTHREAD_BARRIER(team, team->my_images);
   
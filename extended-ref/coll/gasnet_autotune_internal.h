@@ -18,9 +18,13 @@
 #define __GASNET_AUTOTUNE_INTERNAL_H__ 1
 
 #define GASNETE_COLL_DEFAULT_TREE_TYPE_STR "KNOMIAL_TREE,2"
+/* default when rack/switch groups are described (GASNET_COLL_TOPO_*) */
+#define GASNETE_COLL_DEFAULT_TOPO_TREE_TYPE_STR "HIERARCHICAL_TREE,3,GROUP,HOST:KNOMIAL_TREE,2:KNOMIAL_TREE,2:KNOMIAL_TREE,2"
 #define GASNETE_COLL_DEFAULT_DISSEM_LIMIT_PER_THREAD 1024
+#define GASNETE_COLL_DEFAULT_ALLREDUCE_RDBL_LIMIT 8192
 #include <myxml/myxml.h>
 #include <coll/gasnet_coll.h>
+#include <coll/gasnet_tunedb.h>
 
 /*returns the implementation of the collectives including all the parameters to the algorithm*/
 struct gasnete_coll_implementation_t_{
@@ -167,6 +171,26 @@ typedef gasnet_coll_handle_t
                                   uint32_t sequence
                                   GASNETI_THREAD_FARG);
 
+typedef gasnet_coll_handle_t 
+(*gasnete_coll_allreduce_fn_ptr_t)(gasnet_team_handle_t team,
+                                   void *dst, void *src,
+                                   size_t elem_size, size_t elem_count,
+                                   gasnet_coll_fn_handle_t func, int func_arg,
+                                   int flags, 
+                                   gasnete_coll_implementation_t coll_params,
+                                   uint32_t sequence
+                                   GASNETI_THREAD_FARG);
+
+typedef gasnet_coll_handle_t 
+(*gasnete_coll_allreduceM_fn_ptr_t)(gasnet_team_handle_t team,
+                                    void * const dstlist[], void * const srclist[],
+                                    size_t elem_size, size_t elem_count,
+                                    gasnet_coll_fn_handle_t func, int func_arg,
+                                    int flags, 
+                                    gasnete_coll_implementation_t coll_params,
+                                    uint32_t sequence
+                                    GASNETI_THREAD_FARG);
+
 typedef enum {GASNETE_COLL_BROADCAST_GET=0, 
   GASNETE_COLL_BROADCAST_PUT,
   GASNETE_COLL_BROADCAST_TREE_PUT,
@@ -178,6 +202,9 @@ typedef enum {GASNETE_COLL_BROADCAST_GET=0,
   GASNETE_COLL_BROADCAST_RVOUS,
   GASNETE_COLL_BROADCAST_RVGET,
   GASNETE_COLL_BROADCAST_TREE_RVGET,
+#if GASNET_PSHM
+  GASNETE_COLL_BROADCAST_PSHM,
+#endif
 #ifdef GASNETE_COLL_CONDUIT_BROADCAST_OPS
   /*check to see if the conduits have defined any new ops*/
   GASNETE_COLL_CONDUIT_BROADCAST_OPS ,
@@ -211,6 +238,9 @@ typedef enum {GASNETE_COLL_SCATTER_GET=0,
   GASNETE_COLL_SCATTER_EAGER,
   GASNETE_COLL_SCATTER_RVGET,
   GASNETE_COLL_SCATTER_RVOUS,
+#if GASNET_PSHM
+  GASNETE_COLL_SCATTER_PSHM,
+#endif
 #ifdef GASNETE_COLL_CONDUIT_SCATTER_OPS
   /*check to see if the conduits have defined any new ops*/
   GASNETE_COLL_CONDUIT_SCATTER_OPS ,
@@ -242,6 +272,9 @@ typedef enum {
   GASNETE_COLL_GATHER_EAGER,
   GASNETE_COLL_GATHER_RVPUT,
   GASNETE_COLL_GATHER_RVOUS,
+#if GASNET_PSHM
+  GASNETE_COLL_GATHER_PSHM,
+#endif
 #ifdef GASNETE_COLL_CONDUIT_GATHER_OPS
   GASNETE_COLL_CONDUIT_GATHER_OPS ,
 #endif
@@ -296,6 +329,9 @@ typedef enum {
   GASNETE_COLL_EXCHANGE_PUT,
   GASNETE_COLL_EXCHANGE_RVPUT,
   GASNETE_COLL_EXCHANGE_GATH,
+#if GASNET_PSHM
+  GASNETE_COLL_EXCHANGE_PSHM,
+#endif
 #ifdef GASNETE_COLL_CONDUIT_EXCHANGE_OPS
   GASNETE_COLL_CONDUIT_EXCHANGE_OPS ,
 #endif
@@ -326,6 +362,11 @@ typedef enum {
   GASNETE_COLL_REDUCE_TREE_PUT,
   GASNETE_COLL_REDUCE_TREE_PUT_SEG,
   GASNETE_COLL_REDUCE_TREE_GET,
+  GASNETE_COLL_REDUCE_TREE_GET_SEG,
+  GASNETE_COLL_REDUCE_TREE_EAGER_SEG,
+#if GASNET_PSHM
+  GASNETE_COLL_REDUCE_PSHM,
+#endif
 #ifdef GASNETE_COLL_CONDUIT_REDUCE_OPS
   GASNETE_COLL_CONDUIT_REDUCE_OPS ,
 #endif
@@ -337,12 +378,32 @@ typedef enum {
   GASNETE_COLL_REDUCEM_TREE_PUT,
   GASNETE_COLL_REDUCEM_TREE_PUT_SEG,
   GASNETE_COLL_REDUCEM_TREE_GET,
+  GASNETE_COLL_REDUCEM_TREE_GET_SEG,
+  GASNETE_COLL_REDUCEM_TREE_EAGER_SEG,
 #ifdef GASNETE_COLL_CONDUIT_REDUCEM_OPS
   GASNETE_COLL_CONDUIT_REDUCEM_OPS ,
 #endif
   
   GASNETE_COLL_REDUCEM_NUM_ALGS} gasnete_coll_reduceM_alg_types_t;
 
+typedef enum {
+  GASNETE_COLL_ALLREDUCE_REC_DBL=0,
+  GASNETE_COLL_ALLREDUCE_RABENSEIFNER,
+  GASNETE_COLL_ALLREDUCE_RED,
+#ifdef GASNETE_COLL_CONDUIT_ALLREDUCE_OPS
+  GASNETE_COLL_CONDUIT_ALLREDUCE_OPS ,
+#endif
+  GASNETE_COLL_ALLREDUCE_NUM_ALGS} gasnete_coll_allreduce_alg_types_t;
+
+typedef enum {
+  GASNETE_COLL_ALLREDUCEM_REC_DBL=0,
+  GASNETE_COLL_ALLREDUCEM_RABENSEIFNER,
+  GASNETE_COLL_ALLREDUCEM_RED,
+#ifdef GASNETE_COLL_CONDUIT_ALLREDUCEM_OPS
+  GASNETE_COLL_CONDUIT_ALLREDUCEM_OPS ,
+#endif
+  GASNETE_COLL_ALLREDUCEM_NUM_ALGS} gasnete_coll_allreduceM_alg_types_t;
+
 #ifndef GASNET_COLL_MIN_PIPE_SEG_SIZE
 #define GASNET_COLL_MIN_PIPE_SEG_SIZE 8192
 #endif
@@ -375,6 +436,18 @@ struct gasnet_coll_tuning_parameter_t {
     _name[0].start = _start; \
     _name[0].end   = _end /* no semicolon */
 
+/*how the LogGP model (GASNET_COLL_ENABLE_MODEL) predicts the cost of an algorithm*/
+typedef enum {
+  GASNETE_COLL_MODEL_NONE=0,      /* not modeled, never picked by the model */
+  GASNETE_COLL_MODEL_FLAT,        /* every transfer is a direct message to/from its final peer */
+  GASNETE_COLL_MODEL_FLAT_RV,     /* flat, preceded by a rendezvous handshake */
+  GASNETE_COLL_MODEL_TREE,        /* follows the tree given by its TREE_TYPE parameter */
+  GASNETE_COLL_MODEL_DISSEM,      /* dissemination with model_radix peers per round */
+  GASNETE_COLL_MODEL_REC_DBL,     /* recursive doubling */
+  GASNETE_COLL_MODEL_RABENSEIFNER,/* reduce-scatter followed by allgather */
+  GASNETE_COLL_MODEL_PSHM         /* shared-memory copies within one supernode */
+} gasnete_coll_model_shape_t;
+
 /*contains an entry in the function table*/
 typedef struct gasnete_coll_allgorithm_t_ {
   struct gasnete_coll_allgorithm_t_ *next;
@@ -409,6 +482,13 @@ typedef struct gasnete_coll_allgorithm_t_ {
   
   /*set if this is a tree-based algorithm*/
   uint32_t tree_alg;
+
+  /*set if the algorithm requires every team member to share this node's supernode*/
+  uint32_t pshm_only;
+
+  /*communication shape used by the LogGP model*/
+  gasnete_coll_model_shape_t model_shape;
+  uint32_t model_radix;
   
   struct gasnet_coll_tuning_parameter_t *parameter_list;
   
@@ -426,6 +506,8 @@ typedef struct gasnete_coll_allgorithm_t_ {
     gasnete_coll_exchangeM_fn_ptr_t exchangeM_fn;
     gasnete_coll_reduce_fn_ptr_t reduce_fn;
     gasnete_coll_reduceM_fn_ptr_t reduceM_fn;
+    gasnete_coll_allreduce_fn_ptr_t allreduce_fn;
+    gasnete_coll_allreduceM_fn_ptr_t allreduceM_fn;
   } fn_ptr;
   
   const char *name_str;
@@ -452,6 +534,72 @@ struct gasnete_coll_autotune_index_entry_t_ {
 
 typedef struct gasnete_coll_autotune_index_entry_t_ gasnete_coll_autotune_index_entry_t;
 
+/* A binary tuning database (gasnet_tunedb.h) mapped by this process and
+   searched in place.  Implementations are only built for the leaves that
+   are actually looked up. */
+typedef struct {
+  void *image;
+  size_t size;
+  int mapped;                       /* image came from mmap() rather than malloc() */
+  const gasnete_coll_tunedb_header_t *hdr;
+  const gasnete_coll_tunedb_entry_t *entries;
+  const gasnete_coll_tunedb_leaf_t *leaves;
+  const char *strings;
+  const gasnete_coll_tunedb_machine_t *machine; /* the machine this job matches */
+  gasnete_coll_implementation_t *impls;         /* per leaf, NULL until first use */
+} gasnete_coll_tunedb_t;
+
+/* Compiled form of the index for one (op, syncmode, addrmode) tuple of a team.
+   The ranks and images levels are fixed per team, the root level collapses
+   into a per-image class and the size level into one cell per power of two,
+   so a lookup is two array reads and at most one size comparison. */
+#define GASNETE_COLL_DECISION_BUCKETS 31 /* buckets whose sizes all fit the int-keyed index */
+#define GASNETE_COLL_DECISION_NOROOT  0xffffffff
+
+typedef enum {GASNETE_COLL_DECISION_CONST=0, /* impl_lo for the whole bucket */
+              GASNETE_COLL_DECISION_SPLIT,   /* impl_lo below pivot, impl_hi at or above */
+              GASNETE_COLL_DECISION_EXACT,   /* impl_hi only at pivot, otherwise no match */
+              GASNETE_COLL_DECISION_WALK     /* too many breakpoints: walk the index */
+} gasnete_coll_decision_kind_t;
+
+typedef struct {
+  gasnete_coll_implementation_t impl_lo;
+  gasnete_coll_implementation_t impl_hi;
+  size_t pivot;
+  gasnete_coll_decision_kind_t kind;
+} gasnete_coll_decision_cell_t;
+
+typedef struct {
+  uint32_t *root_class;                /* root_span entries, NOROOT if no match */
+  gasnete_coll_decision_cell_t *cells; /* num_classes * GASNETE_COLL_DECISION_BUCKETS */
+  uint32_t num_classes;
+  uint32_t root_span;                  /* one past the last listed root */
+  uint32_t root_tail;                  /* class of every root >= root_span */
+} gasnete_coll_decision_t;
+
+/* Online tuning state of one image for one (op, flags, size) of a team:
+   a bandit whose arms are the cheapest candidates of the LogGP model for that
+   size.  ncalls and best agree across the team, the timings are local. */
+#define GASNETE_COLL_ONLINE_MAX_ARMS 8
+
+typedef struct gasnete_coll_online_cell_t_ {
+  struct gasnete_coll_online_cell_t_ *next; /* same op and size bucket */
+  uint32_t flags;
+  size_t nbytes;
+  int num_arms;
+  gasnete_coll_implementation_t arms[GASNETE_COLL_ONLINE_MAX_ARMS];
+  uint64_t ncalls;
+  int best;                                  /* agreed at the last epoch boundary */
+  gasnett_tick_t sum[GASNETE_COLL_ONLINE_MAX_ARMS];   /* since the last agreement */
+  uint32_t count[GASNETE_COLL_ONLINE_MAX_ARMS];
+  uint32_t seen[GASNETE_COLL_ONLINE_MAX_ARMS];        /* calls timed, warm-up included */
+  double est[GASNETE_COLL_ONLINE_MAX_ARMS];           /* smoothed mean ticks, 0 if unknown */
+} gasnete_coll_online_cell_t;
+
+typedef struct {
+  gasnete_coll_online_cell_t *cells[GASNET_COLL_NUM_COLL_OPTYPES][GASNETE_COLL_DECISION_BUCKETS];
+} gasnete_coll_online_table_t;
+
 struct gasnete_coll_autotune_info_t_ {
   gasnete_coll_tree_type_t bcast_tree_type;
   gasnete_coll_tree_type_t scatter_tree_type;
@@ -460,6 +608,7 @@ struct gasnete_coll_autotune_info_t_ {
   size_t gather_all_dissem_limit;
   size_t exchange_dissem_limit;
   int exchange_dissem_radix;
+  size_t allreduce_rdbl_limit;
   size_t pipe_seg_size;
   
   int warm_iters;
@@ -473,9 +622,18 @@ struct gasnete_coll_autotune_info_t_ {
   gasnete_coll_algorithm_t *collective_algorithms[GASNET_COLL_NUM_COLL_OPTYPES];
   gasnete_coll_autotune_index_entry_t *autotuner_defaults;
   gasnete_coll_autotune_index_entry_t *collective_profile;
+  /* loaded from a binary tuning database, consulted when autotuner_defaults has no entry */
+  gasnete_coll_tunedb_t *tunedb;
+  /* lazily compiled from autotuner_defaults, dropped whenever it changes */
+  gasnete_coll_decision_t *decisions[GASNET_COLL_NUM_COLL_OPTYPES][GASNETE_COLL_NUM_SYNCMODES][GASNETE_COLL_NUM_ADDRMODES];
+  gasneti_mutex_t decision_lock;
+  /* one table per local image, only with online_enabled */
+  gasnete_coll_online_table_t **online;
   gasnete_coll_team_t team;
   int search_enabled;
   int profile_enabled;
+  int model_enabled;
+  int online_enabled;
 };
 
 
@@ -484,6 +642,20 @@ struct gasnete_coll_autotune_info_t_ {
 gasnete_coll_autotune_info_t* gasnete_coll_autotune_init(gasnet_team_handle_t team, gasnet_node_t mynode, gasnet_node_t total_nodes, 
                                                          gasnet_image_t my_images, gasnet_image_t total_images, 
                                                          size_t min_scratch_size GASNETI_THREAD_FARG);
+
+/*one-time LogGP calibration for GASNET_COLL_ENABLE_MODEL and GASNET_COLL_ENABLE_ONLINE,
+  collective over all nodes*/
+void gasnete_coll_autotune_calibrate(gasnet_seginfo_t *scratch_segs);
+
+/*blocking collectives time themselves for the online tuner: BEGIN drops any
+  sample left by a non-blocking call, END hands over the one autotune_op()
+  took for this call, if any*/
+void gasnete_coll_online_record(gasnete_coll_threaddata_t *td);
+#define GASNETE_COLL_ONLINE_BEGIN() (GASNETE_COLL_MYTHREAD->online_cell = NULL)
+#define GASNETE_COLL_ONLINE_END() do {                                  \
+    gasnete_coll_threaddata_t *_td = GASNETE_COLL_MYTHREAD;             \
+    if_pf(_td->online_cell) gasnete_coll_online_record(_td);            \
+  } while(0)
 /*testing functions*/
 
 gasnete_coll_tree_type_t gasnete_coll_autotune_get_tree_type(gasnete_coll_autotune_info_t* autotune_info, 
@@ -566,6 +738,18 @@ gasnete_coll_autotune_get_reduceM_algorithm(gasnet_team_handle_t team, gasnet_im
                                             gasnet_coll_fn_handle_t func, int func_arg,
                                             uint32_t flags GASNETI_THREAD_FARG);
 
+gasnete_coll_implementation_t 
+gasnete_coll_autotune_get_allreduce_algorithm(gasnet_team_handle_t team, void *dst, void *src,
+                                              size_t elem_size, size_t elem_count,
+                                              gasnet_coll_fn_handle_t func, int func_arg,
+                                              uint32_t flags GASNETI_THREAD_FARG);
+
+gasnete_coll_implementation_t
+gasnete_coll_autotune_get_allreduceM_algorithm(gasnet_team_handle_t team, void * const dstlist[], void * const srclist[],
+                                               size_t elem_size, size_t elem_count,
+                                               gasnet_coll_fn_handle_t func, int func_arg,
+                                               uint32_t flags GASNETI_THREAD_FARG);
+
 
 
 gasnete_coll_implementation_t gasnete_coll_lookup_implementation(gasnete_coll_autotune_info_t* autotune_info, 
@@ -170,6 +170,47 @@ typedef struct {
     unsigned int		flags;
 } gasnet_coll_fn_entry_t;
 
+/* Built-in reduction operators
+ *
+ * In place of an index into the 'fn_tbl' passed to gasnet_coll_init(), the
+ * computational collectives accept GASNET_COLL_FN_BUILTIN(type,op) as the
+ * function handle.  This selects an element-wise operator provided by the
+ * library, vectorized for the best instruction set available at runtime.
+ * The 'func_arg' argument is ignored for built-in operators.
+ * The bitwise operators are not defined for the floating-point types.
+ */
+typedef enum {
+  GASNET_COLL_TYPE_INT32=0,
+  GASNET_COLL_TYPE_UINT32,
+  GASNET_COLL_TYPE_INT64,
+  GASNET_COLL_TYPE_UINT64,
+  GASNET_COLL_TYPE_FLOAT,
+  GASNET_COLL_TYPE_DOUBLE,
+  GASNET_COLL_NUM_TYPES
+} gasnet_coll_type_t;
+
+typedef enum {
+  GASNET_COLL_OP_SUM=0,
+  GASNET_COLL_OP_PROD,
+  GASNET_COLL_OP_MIN,
+  GASNET_COLL_OP_MAX,
+  GASNET_COLL_OP_BAND,
+  GASNET_COLL_OP_BOR,
+  GASNET_COLL_OP_BXOR,
+  GASNET_COLL_NUM_OPS
+} gasnet_coll_builtin_op_t;
+
+#define GASNET_COLL_FN_BUILTIN_BIT	(1<<30)
+#define GASNET_COLL_FN_BUILTIN(type,op) \
+  ((gasnet_coll_fn_handle_t)(GASNET_COLL_FN_BUILTIN_BIT | ((int)(type) * (int)GASNET_COLL_NUM_OPS + (int)(op))))
+#define GASNET_COLL_FN_IS_BUILTIN(fn) (((fn) & GASNET_COLL_FN_BUILTIN_BIT) != 0)
+
+/* Maps the GASNET_COLL_REDUCE_OP_{SUM,MAX,MIN} flags onto a built-in operator */
+#define GASNET_COLL_FN_BUILTIN_FROM_FLAGS(type,flags)                        \
+  GASNET_COLL_FN_BUILTIN(type, (((flags) & GASNET_COLL_REDUCE_OP_MAX) ? GASNET_COLL_OP_MAX : \
+                                ((flags) & GASNET_COLL_REDUCE_OP_MIN) ? GASNET_COLL_OP_MIN : \
+                                                                        GASNET_COLL_OP_SUM))
+
 /* Handle type for collective teams: */
 #ifndef GASNETE_COLL_TEAMS_OVERRIDE
 struct gasnete_coll_team_t_;
@@ -257,6 +298,8 @@ typedef enum {GASNET_COLL_BROADCAST_OP=0,
   GASNET_COLL_EXCHANGEM_OP, 
   GASNET_COLL_REDUCE_OP,
   GASNET_COLL_REDUCEM_OP,
+  GASNET_COLL_ALLREDUCE_OP,
+  GASNET_COLL_ALLREDUCEM_OP,
   GASNET_COLL_NUM_COLL_OPTYPES
 } gasnet_coll_optype_t;
 
@@ -430,6 +473,28 @@ extern void gasnet_coll_set_dissem_limit(gasnet_team_handle_t _team, size_t _dis
     GASNETI_TRACE_EVENT_VAL(W,name,elem_count);                                                            \
     /* XXX: No detail implemented */                                                                       \
   } while (0)
+  #define GASNETI_TRACE_COLL_ALLREDUCE(name,team,dst,src,elem_size,elem_count,func,func_arg,flags) do { \
+    GASNETI_TRACE_EVENT_VAL(W,name,elem_count);                                                            \
+    if (GASNETI_TRACE_ENABLED(D)) {                                                                        \
+      GASNETI_TRACE_PRINTF(D,(#name ": " GASNETI_LADDRFMT " <- " GASNETI_LADDRFMT                          \
+			      " (elem_size=%" PRIuSZ " elem_count=%" PRIuSZ " func=%d team=%p flags=0x%x)\n", \
+			      GASNETI_LADDRSTR(dst), GASNETI_LADDRSTR(src),                                \
+			      (size_t)elem_size, (size_t)elem_count, (int)func, (void *)team, flags));     \
+    }                                                                                                      \
+  } while (0)
+  #define GASNETI_TRACE_COLL_ALLREDUCE_M(name,team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags) do { \
+    GASNETI_TRACE_EVENT_VAL(W,name,elem_count);                                                            \
+    if (GASNETI_TRACE_ENABLED(D)) {                                                                        \
+      char *_srclist = gasnete_coll_format_addrlist(srclist,flags);                                        \
+      char *_dstlist = gasnete_coll_format_addrlist(dstlist,flags);                                        \
+      GASNETI_TRACE_PRINTF(D,(#name ": %s <- %s"                                                           \
+			      " (elem_size=%" PRIuSZ " elem_count=%" PRIuSZ " func=%d team=%p flags=0x%x)\n", \
+			      _dstlist, _srclist,                                                          \
+			      (size_t)elem_size, (size_t)elem_count, (int)func, (void *)team, flags));     \
+      gasneti_extern_free(_dstlist);                                                                       \
+      gasneti_extern_free(_srclist);                                                                       \
+    }                                                                                                      \
+  } while (0)
   #define GASNETI_TRACE_COLL_SCAN(name,team,dst,dst_blksz,dst_offset,src,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags) do { \
     GASNETI_TRACE_EVENT_VAL(W,name,elem_count);                                                            \
     /* XXX: No detail implemented */                                                                       \
@@ -453,6 +518,8 @@ extern void gasnet_coll_set_dissem_limit(gasnet_team_handle_t _team, size_t _dis
   #define GASNETI_TRACE_COLL_EXCHANGE_M(name,team,dstlist,srclist,nbytes,flags)
   #define GASNETI_TRACE_COLL_REDUCE(name,team,dstimage,dst,src,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags)
   #define GASNETI_TRACE_COLL_REDUCE_M(name,team,dstimage,dst,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags)
+  #define GASNETI_TRACE_COLL_ALLREDUCE(name,team,dst,src,elem_size,elem_count,func,func_arg,flags)
+  #define GASNETI_TRACE_COLL_ALLREDUCE_M(name,team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags)
   #define GASNETI_TRACE_COLL_SCAN(name,team,dst,dst_blksz,dst_offset,src,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags)
   #define GASNETI_TRACE_COLL_SCAN_M(name,team,dstlist,dst_blksz,dst_offset,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags)
   #define GASNETI_TRACE_COLL_WAITSYNC_BEGIN() \
@@ -794,6 +861,47 @@ void _gasnet_coll_reduceM(gasnet_team_handle_t _team,
 #define gasnet_coll_reduceM(team,dstimage,dst,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags) \
        _gasnet_coll_reduceM(team,dstimage,dst,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_GET);
 
+/*---------------------------------------------------------------------------------*/
+/* Allreduce: every image receives the reduction of all 'elem_count'-element source vectors */
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduce_nb) 
+gasnet_coll_handle_t _gasnet_coll_allreduce_nb(gasnet_team_handle_t _team,
+                          void *_dst, void *_src,
+                          size_t _elem_size, size_t _elem_count,
+                          gasnet_coll_fn_handle_t _func, int _func_arg,
+                          int _flags GASNETI_THREAD_FARG) ;
+#define gasnet_coll_allreduce_nb(team,dst,src,elem_size,elem_count,func,func_arg,flags) \
+       _gasnet_coll_allreduce_nb(team,dst,src,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduce) 
+void _gasnet_coll_allreduce(gasnet_team_handle_t _team,
+                                   void *_dst, void *_src,
+                                   size_t _elem_size, size_t _elem_count,
+                                   gasnet_coll_fn_handle_t _func, int _func_arg,
+                                   int _flags GASNETI_THREAD_FARG) ;
+#define gasnet_coll_allreduce(team,dst,src,elem_size,elem_count,func,func_arg,flags) \
+       _gasnet_coll_allreduce(team,dst,src,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_GET);
+
+/*---------------------------------------------------------------------------------*/
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduceM_nb) 
+gasnet_coll_handle_t _gasnet_coll_allreduceM_nb(gasnet_team_handle_t _team,
+                           void * const _dstlist[], void * const _srclist[],
+                           size_t _elem_size, size_t _elem_count,
+                           gasnet_coll_fn_handle_t _func, int _func_arg,
+                           int _flags GASNETI_THREAD_FARG) ;
+#define gasnet_coll_allreduceM_nb(team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags) \
+       _gasnet_coll_allreduceM_nb(team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduceM) 
+void _gasnet_coll_allreduceM(gasnet_team_handle_t _team,
+                                    void * const _dstlist[], void * const _srclist[],
+                                    size_t _elem_size, size_t _elem_count,
+                                    gasnet_coll_fn_handle_t _func, int _func_arg,
+                                    int _flags GASNETI_THREAD_FARG) ;
+#define gasnet_coll_allreduceM(team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags) \
+       _gasnet_coll_allreduceM(team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_GET);
+
 /*---------------------------------------------------------------------------------*/
 GASNETI_COLL_FN_HEADER(_gasnet_coll_scan_nb) 
 gasnet_coll_handle_t _gasnet_coll_scan_nb(gasnet_team_handle_t _team,
@@ -837,6 +945,214 @@ void _gasnet_coll_scanM(gasnet_team_handle_t _team,
 #define gasnet_coll_scanM(team,dstlist,dst_blksz,dst_offset,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags) \
        _gasnet_coll_scanM(team,dstlist,dst_blksz,dst_offset,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_GET);
 
+/*---------------------------------------------------------------------------------*/
+/* Persistent collectives
+ *
+ * gasnet_coll_*_init() takes the same arguments as the corresponding *_nb()
+ * call and returns a plan in which the algorithm, the tree geometry and the
+ * in-segment flags have already been chosen.  gasnet_coll_start() then issues
+ * the collective without consulting the autotuner, and returns a handle to be
+ * synced with gasnet_coll_wait_sync() and friends.  The buffers named at
+ * init time are reused by every start, so the client updates their contents
+ * in place.  A plan must not be started again until the previous instance
+ * has been synced.
+ *
+ * Creating and starting plans are collective: every image must do so in the
+ * same order as its other collectives over the team.  Each image owns the
+ * plan it created, and gasnet_coll_plan_free() is a purely local call.
+ */
+struct gasnete_coll_plan_t_;
+typedef struct gasnete_coll_plan_t_ *gasnet_coll_plan_t;
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_broadcast_init)
+gasnet_coll_plan_t _gasnet_coll_broadcast_init(gasnet_team_handle_t _team,
+                          void *_dst,
+                          gasnet_image_t _srcimage, void *_src,
+                          size_t _nbytes, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_broadcast_init(team,dst,srcimage,src,nbytes,flags) \
+       _gasnet_coll_broadcast_init(team,dst,srcimage,src,nbytes,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_reduce_init)
+gasnet_coll_plan_t _gasnet_coll_reduce_init(gasnet_team_handle_t _team,
+                       gasnet_image_t _dstimage, void *_dst,
+                       void *_src, size_t _src_blksz, size_t _src_offset,
+                       size_t _elem_size, size_t _elem_count,
+                       gasnet_coll_fn_handle_t _func, int _func_arg,
+                       int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_reduce_init(team,dstimage,dst,src,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags) \
+       _gasnet_coll_reduce_init(team,dstimage,dst,src,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduce_init)
+gasnet_coll_plan_t _gasnet_coll_allreduce_init(gasnet_team_handle_t _team,
+                          void *_dst, void *_src,
+                          size_t _elem_size, size_t _elem_count,
+                          gasnet_coll_fn_handle_t _func, int _func_arg,
+                          int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_allreduce_init(team,dst,src,elem_size,elem_count,func,func_arg,flags) \
+       _gasnet_coll_allreduce_init(team,dst,src,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_start)
+gasnet_coll_handle_t _gasnet_coll_start(gasnet_coll_plan_t _plan GASNETI_THREAD_FARG);
+#define gasnet_coll_start(plan) \
+       _gasnet_coll_start(plan GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(gasnete_coll_plan_free)
+void gasnete_coll_plan_free(gasnet_coll_plan_t _plan);
+#define gasnet_coll_plan_free(plan) gasnete_coll_plan_free(plan)
+
+/*---------------------------------------------------------------------------------*/
+/* Neighborhood collectives
+ *
+ * A graph attaches a sparse communication pattern to a team.  Each node lists
+ * the team ranks it receives from (sources) and sends to (destinations), and
+ * the lists must agree: r lists s as a source exactly when s lists r as a
+ * destination.  A rank may appear at most once in each list, and may name
+ * itself.  gasnet_coll_graph_create() is collective over the team and does
+ * the per-graph setup, after which each neighborhood collective sends
+ * messages only along the edges of the graph.
+ *
+ * Block k of dst receives the data sent along the edge from sources[k].  The
+ * allgather sends all of src along every out-edge, while the alltoall sends
+ * block j of src to destinations[j].  The alltoallv takes per-edge byte counts
+ * and byte offsets into dst (indegree entries) and src (outdegree entries);
+ * these arrays are copied and need not outlive the call.
+ *
+ * Unlike the other collectives these are called once per node, by a single
+ * thread, even when the node hosts several images.  The graph is a local
+ * object and gasnet_coll_graph_free() is a purely local call.
+ */
+struct gasnete_coll_graph_t_;
+typedef struct gasnete_coll_graph_t_ *gasnet_coll_graph_t;
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_graph_create)
+gasnet_coll_graph_t _gasnet_coll_graph_create(gasnet_team_handle_t _team,
+                          size_t _indegree, const gasnet_node_t _sources[],
+                          size_t _outdegree, const gasnet_node_t _destinations[]
+                          GASNETI_THREAD_FARG);
+#define gasnet_coll_graph_create(team,indegree,sources,outdegree,destinations) \
+       _gasnet_coll_graph_create(team,indegree,sources,outdegree,destinations GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(gasnete_coll_graph_free)
+void gasnete_coll_graph_free(gasnet_coll_graph_t _graph);
+#define gasnet_coll_graph_free(graph) gasnete_coll_graph_free(graph)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_allgather_nb)
+gasnet_coll_handle_t _gasnet_coll_neighbor_allgather_nb(gasnet_coll_graph_t _graph,
+                          void *_dst, void *_src,
+                          size_t _nbytes, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_neighbor_allgather_nb(graph,dst,src,nbytes,flags) \
+       _gasnet_coll_neighbor_allgather_nb(graph,dst,src,nbytes,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_allgather)
+void _gasnet_coll_neighbor_allgather(gasnet_coll_graph_t _graph,
+                          void *_dst, void *_src,
+                          size_t _nbytes, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_neighbor_allgather(graph,dst,src,nbytes,flags) \
+       _gasnet_coll_neighbor_allgather(graph,dst,src,nbytes,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_alltoall_nb)
+gasnet_coll_handle_t _gasnet_coll_neighbor_alltoall_nb(gasnet_coll_graph_t _graph,
+                          void *_dst, void *_src,
+                          size_t _nbytes, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_neighbor_alltoall_nb(graph,dst,src,nbytes,flags) \
+       _gasnet_coll_neighbor_alltoall_nb(graph,dst,src,nbytes,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_alltoall)
+void _gasnet_coll_neighbor_alltoall(gasnet_coll_graph_t _graph,
+                          void *_dst, void *_src,
+                          size_t _nbytes, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_neighbor_alltoall(graph,dst,src,nbytes,flags) \
+       _gasnet_coll_neighbor_alltoall(graph,dst,src,nbytes,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_alltoallv_nb)
+gasnet_coll_handle_t _gasnet_coll_neighbor_alltoallv_nb(gasnet_coll_graph_t _graph,
+                          void *_dst, const size_t _dst_counts[], const size_t _dst_offsets[],
+                          void *_src, const size_t _src_counts[], const size_t _src_offsets[],
+                          int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_neighbor_alltoallv_nb(graph,dst,dst_counts,dst_offsets,src,src_counts,src_offsets,flags) \
+       _gasnet_coll_neighbor_alltoallv_nb(graph,dst,dst_counts,dst_offsets,src,src_counts,src_offsets,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_alltoallv)
+void _gasnet_coll_neighbor_alltoallv(gasnet_coll_graph_t _graph,
+                          void *_dst, const size_t _dst_counts[], const size_t _dst_offsets[],
+                          void *_src, const size_t _src_counts[], const size_t _src_offsets[],
+                          int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_neighbor_alltoallv(graph,dst,dst_counts,dst_offsets,src,src_counts,src_offsets,flags) \
+       _gasnet_coll_neighbor_alltoallv(graph,dst,dst_counts,dst_offsets,src,src_counts,src_offsets,flags GASNETI_THREAD_GET)
+
+/*---------------------------------------------------------------------------------*/
+/* Variable-count collectives
+ *
+ * These generalize gather, scatter, gather_all and exchange to blocks of
+ * different lengths.  Block r of the gathered (or scattered) buffer holds
+ * counts[r] bytes at byte offset offsets[r], and only those bytes are moved.
+ * For gatherv, scatterv and gather_allv the counts[] and offsets[] arrays are
+ * indexed by team rank and must have the same contents on every node.  The
+ * exchangev takes local arrays instead: node i sends src_counts[j] bytes from
+ * src+src_offsets[j] to node j, which must expect the same number of bytes in
+ * dst_counts[i].  The arrays are copied and need not outlive the call.
+ *
+ * Like the neighborhood collectives these are called once per node, by a
+ * single thread, and roots are given as team ranks.
+ */
+GASNETI_COLL_FN_HEADER(_gasnet_coll_gatherv_nb)
+gasnet_coll_handle_t _gasnet_coll_gatherv_nb(gasnet_team_handle_t _team, gasnet_node_t _dstrank,
+                          void *_dst, const size_t _counts[], const size_t _offsets[],
+                          void *_src, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_gatherv_nb(team,dstrank,dst,counts,offsets,src,flags) \
+       _gasnet_coll_gatherv_nb(team,dstrank,dst,counts,offsets,src,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_gatherv)
+void _gasnet_coll_gatherv(gasnet_team_handle_t _team, gasnet_node_t _dstrank,
+                          void *_dst, const size_t _counts[], const size_t _offsets[],
+                          void *_src, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_gatherv(team,dstrank,dst,counts,offsets,src,flags) \
+       _gasnet_coll_gatherv(team,dstrank,dst,counts,offsets,src,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_scatterv_nb)
+gasnet_coll_handle_t _gasnet_coll_scatterv_nb(gasnet_team_handle_t _team, void *_dst, gasnet_node_t _srcrank,
+                          void *_src, const size_t _counts[], const size_t _offsets[],
+                          int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_scatterv_nb(team,dst,srcrank,src,counts,offsets,flags) \
+       _gasnet_coll_scatterv_nb(team,dst,srcrank,src,counts,offsets,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_scatterv)
+void _gasnet_coll_scatterv(gasnet_team_handle_t _team, void *_dst, gasnet_node_t _srcrank,
+                          void *_src, const size_t _counts[], const size_t _offsets[],
+                          int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_scatterv(team,dst,srcrank,src,counts,offsets,flags) \
+       _gasnet_coll_scatterv(team,dst,srcrank,src,counts,offsets,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_gather_allv_nb)
+gasnet_coll_handle_t _gasnet_coll_gather_allv_nb(gasnet_team_handle_t _team,
+                          void *_dst, const size_t _counts[], const size_t _offsets[],
+                          void *_src, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_gather_allv_nb(team,dst,counts,offsets,src,flags) \
+       _gasnet_coll_gather_allv_nb(team,dst,counts,offsets,src,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_gather_allv)
+void _gasnet_coll_gather_allv(gasnet_team_handle_t _team,
+                          void *_dst, const size_t _counts[], const size_t _offsets[],
+                          void *_src, int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_gather_allv(team,dst,counts,offsets,src,flags) \
+       _gasnet_coll_gather_allv(team,dst,counts,offsets,src,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_exchangev_nb)
+gasnet_coll_handle_t _gasnet_coll_exchangev_nb(gasnet_team_handle_t _team,
+                          void *_dst, const size_t _dst_counts[], const size_t _dst_offsets[],
+                          void *_src, const size_t _src_counts[], const size_t _src_offsets[],
+                          int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_exchangev_nb(team,dst,dst_counts,dst_offsets,src,src_counts,src_offsets,flags) \
+       _gasnet_coll_exchangev_nb(team,dst,dst_counts,dst_offsets,src,src_counts,src_offsets,flags GASNETI_THREAD_GET)
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_exchangev)
+void _gasnet_coll_exchangev(gasnet_team_handle_t _team,
+                          void *_dst, const size_t _dst_counts[], const size_t _dst_offsets[],
+                          void *_src, const size_t _src_counts[], const size_t _src_offsets[],
+                          int _flags GASNETI_THREAD_FARG);
+#define gasnet_coll_exchangev(team,dst,dst_counts,dst_offsets,src,src_counts,src_offsets,flags) \
+       _gasnet_coll_exchangev(team,dst,dst_counts,dst_offsets,src,src_counts,src_offsets,flags GASNETI_THREAD_GET)
+
 #undef GASNETI_COLL_FN_HEADER
 
 GASNETI_END_NOWARN
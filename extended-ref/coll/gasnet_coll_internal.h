@@ -121,6 +121,7 @@ typedef struct gasnete_coll_implementation_t_ *gasnete_coll_implementation_t;
 
 extern size_t gasnete_coll_p2p_eager_min;
 extern size_t gasnete_coll_p2p_eager_scale;
+extern size_t gasnete_coll_p2p_eager_buffersz;
 
 
 #ifndef GASNETE_COLL_IMAGE_OVERRIDE
@@ -258,6 +259,18 @@ typedef struct {
 #endif
 } gasnete_coll_peer_list_t;
 
+/* Levels of the machine hierarchy, from the cheapest to the most expensive to cross */
+typedef enum {
+  GASNETE_COLL_TOPO_SOCKET = 0,
+  GASNETE_COLL_TOPO_HOST,
+  GASNETE_COLL_TOPO_GROUP,      /* rack or switch */
+  GASNETE_COLL_TOPO_LEVELS
+} gasnete_coll_topo_level_t;
+
+/* Equal ids iff the two nodes share a domain at the given level */
+extern uint32_t gasnete_coll_topo_domain(gasnete_coll_topo_level_t level, gasnet_node_t node);
+extern int gasnete_coll_topo_have_groups(void);
+
 /* Type for collective teams: */
 struct gasnete_coll_team_t_ {
   /* read-only fields: */
@@ -302,6 +315,10 @@ struct gasnete_coll_team_t_ {
   gasnete_coll_peer_list_t supernode_peers;
 #endif
 
+  /* number of maximal runs of consecutive ranks sharing a socket, host or group,
+     indexed by gasnete_coll_topo_level_t (1 if the whole team shares one) */
+  gasnet_node_t topo_runs[GASNETE_COLL_TOPO_LEVELS];
+
   /* scratch segments allocated on team creation*/
   gasnet_seginfo_t *scratch_segs;
   size_t smallest_scratch_seg;
@@ -332,6 +349,10 @@ struct gasnete_coll_team_t_ {
 #if GASNET_PAR
   int multi_images;	/* count of local images > 1 */
   int multi_images_any;	/* count of any node's images > 1 */
+
+  /* Guards the scratch allocator and consensus barriers, which ops polled by
+     different threads share, unless image 0 is the only poller */
+  gasneti_mutex_t state_lock;
 #endif
   
   /*Stuff for consensus*/
@@ -354,8 +375,12 @@ struct gasnete_coll_team_t_ {
     #define GASNETE_COLL_P2P_TABLE_SIZE 16
   #endif
 
-  gasnet_hsl_t p2p_lock; /* Protects freelist and table */
+  gasnet_hsl_t p2p_lock; /* Protects freelist, table and ring slot claims */
   gasnete_coll_p2p_t *p2p_freelist;
+  /* Descriptors direct-mapped by sequence number, reused across generations and
+     searched without the lock.  p2p_table holds sorted overflow lists for the
+     sequences that found their ring slot still in use by an earlier one. */
+  gasnete_coll_p2p_t *p2p_ring[GASNETE_COLL_P2P_TABLE_SIZE];
   gasnete_coll_p2p_t *p2p_table[GASNETE_COLL_P2P_TABLE_SIZE];
 #endif
   
@@ -384,6 +409,14 @@ gasnete_coll_team_t gasnete_coll_make_team(int allocating_team_all,
 #endif
 #define GASNETE_COLL_REL2ACT(TEAM, IDX) ((TEAM) == GASNET_TEAM_ALL ? IDX : (TEAM)->rel2act_map[IDX])
 
+/* Nonzero if all members of the team share the caller's supernode, in which case
+   every member's segment is cross-mapped and reachable with loads and stores */
+#if GASNET_PSHM
+#define GASNETE_COLL_TEAM_IS_PSHM(TEAM) ((TEAM)->supernode.grp_count == 1)
+#else
+#define GASNETE_COLL_TEAM_IS_PSHM(TEAM) 0
+#endif
+
 /*---------------------------------------------------------------------------------*/
 
 /* Function pointer type for polling collective ops: */
@@ -411,6 +444,11 @@ struct gasnete_coll_op_t_ {
   struct {
     uint32_t			sequence;
   } threads;
+
+  /* Thread data of the creator, which polls the op in partitioned mode */
+  void				*poller;
+  /* Set (under gasnete_coll_active_lock) while a thread runs poll_fn */
+  uint8_t			polling;
 #endif
   
   /* Read-only fields: */
@@ -429,6 +467,8 @@ struct gasnete_coll_op_t_ {
   uint8_t active_scratch_op; /* is this op on the active scratch list?*/
   uint8_t waiting_scratch_op; /* is this op on the waiting scratch list?*/
   uint8_t waiting_for_reconfig_clear;
+  uint8_t scratch_requested; /* has this op called gasnete_coll_scratch_alloc_nb()?*/
+  uint32_t reserved_seqs; /* sequence numbers reserved for subordinates this op may create*/
 #if GASNET_DEBUG
   uint8_t scratch_op_freed;
 #endif
@@ -477,11 +517,20 @@ struct gasnete_coll_p2p_t_ {
   uint32_t		team_id; /* Only needed when debugging */
 #endif
   uint32_t		sequence;
+
+  /* Ring descriptors stay allocated and are only marked idle when freed */
+  uint8_t		in_ring;
+  uint8_t		ring_busy;
   
   /* Volatile arrays of data and state for the point-to-point synchronization */
   uint8_t		*data;
   volatile uint32_t	*state;
   gasneti_weakatomic_t	*counter;
+
+  /* Length of the prefix of state[] and counter[] that may be nonzero,
+     so that recycling the descriptor need not clear all 2*total_images */
+  gasneti_weakatomic_t	state_dirty;
+  gasneti_weakatomic_t	counter_dirty;
     
   /* Handler-safe lock (if needed) */
   gasnet_hsl_t		lock;
@@ -498,6 +547,27 @@ struct gasnete_coll_p2p_t_ {
 };
 #endif
 
+#ifndef GASNETE_COLL_P2P_OVERRIDE
+/* Record that entries [0,end) of state[] or counter[] may be written.  Must
+   precede the write it covers.  Entry 0 of each is always cleared on reuse. */
+#ifdef GASNETI_HAVE_WEAKATOMIC_CAS
+  #define GASNETE_COLL_P2P_TRACK_DIRTY 1
+  GASNETI_INLINE(gasnete_coll_p2p_mark_dirty)
+  void gasnete_coll_p2p_mark_dirty(gasneti_weakatomic_t *dirty, uint32_t end) {
+    gasneti_weakatomic_val_t old;
+    while ((old = gasneti_weakatomic_read(dirty, 0)) < end) {
+      if (gasneti_weakatomic_compare_and_swap(dirty, old, end, 0)) break;
+    }
+  }
+#else
+  /* Without CAS the full arrays are cleared on reuse */
+  #define GASNETE_COLL_P2P_TRACK_DIRTY 0
+  #define gasnete_coll_p2p_mark_dirty(dirty, end) ((void)0)
+#endif
+#define gasnete_coll_p2p_mark_state(p2p, end)   gasnete_coll_p2p_mark_dirty(&(p2p)->state_dirty, (end))
+#define gasnete_coll_p2p_mark_counter(p2p, end) gasnete_coll_p2p_mark_dirty(&(p2p)->counter_dirty, (end))
+#endif
+
 extern gasnete_coll_p2p_t *gasnete_coll_p2p_get(uint32_t team_id, uint32_t sequence);
 extern void gasnete_coll_p2p_destroy(gasnete_coll_p2p_t *p2p);
 extern void gasnete_coll_p2p_signalling_put(gasnete_coll_op_t *op, gasnet_node_t dstnode, void *dst,
@@ -639,6 +709,34 @@ gasnete_coll_p2p_change_states(op, dstnode, 1, offset, state)
 extern gasnet_coll_fn_entry_t *gasnete_coll_fn_tbl;
 extern size_t gasnete_coll_fn_count;
 
+/* Built-in reduction operators, filled in by gasnete_coll_builtin_fn_init()
+ * with the kernels for the best instruction set supported at runtime.
+ */
+#define GASNETE_COLL_NUM_BUILTIN_FNS ((int)GASNET_COLL_NUM_TYPES * (int)GASNET_COLL_NUM_OPS)
+extern gasnet_coll_fn_entry_t gasnete_coll_builtin_fn_tbl[GASNETE_COLL_NUM_BUILTIN_FNS];
+extern void gasnete_coll_builtin_fn_init(void);
+
+/* Function table entry for a function handle, either built-in or client-registered */
+GASNETI_INLINE(gasnete_coll_fn_lookup)
+const gasnet_coll_fn_entry_t *gasnete_coll_fn_lookup(gasnet_coll_fn_handle_t func) {
+  if (GASNET_COLL_FN_IS_BUILTIN(func)) {
+    return &gasnete_coll_builtin_fn_tbl[func & ~GASNET_COLL_FN_BUILTIN_BIT];
+  } else {
+    return &gasnete_coll_fn_tbl[func];
+  }
+}
+
+/* Error check to make sure the function handle is valid */
+#define GASNETE_COLL_CHECK_FN(func) do {                                                      \
+    if (GASNET_COLL_FN_IS_BUILTIN(func)) {                                                   \
+      gasneti_assert(((func) & ~GASNET_COLL_FN_BUILTIN_BIT) < GASNETE_COLL_NUM_BUILTIN_FNS); \
+    } else {                                                                                 \
+      gasneti_assert(gasnete_coll_fn_tbl);                                                   \
+      gasneti_assert((func) < gasnete_coll_fn_count);                                        \
+    }                                                                                        \
+    gasneti_assert(gasnete_coll_fn_lookup(func)->fnptr);                                     \
+  } while (0)
+
 #define GASNETE_COLL_1ST_IMAGE(TEAM,LIST,NODE)              \
 (((void * const *)(LIST))[(TEAM)->all_offset[(NODE)]])
 #define GASNETE_COLL_MY_1ST_IMAGE(TEAM,LIST,FLAGS)                      \
@@ -724,8 +822,8 @@ void gasnete_coll_local_gather(size_t count, void * dst, void * const srclist[],
 
 GASNETI_INLINE(gasnete_coll_local_reduce)
 void gasnete_coll_local_reduce(size_t count, void * dst, void * const srclist[], size_t elem_size, size_t elem_count, gasnet_coll_fn_handle_t func, int func_arg) {
-  gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_tbl[func].fnptr;
-  uint32_t red_fn_flags = gasnete_coll_fn_tbl[func].flags;
+  gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(func)->fnptr;
+  uint32_t red_fn_flags = gasnete_coll_fn_lookup(func)->flags;
   uint32_t reduce_args = func_arg;
   size_t nbytes = elem_size*elem_count;
   int i;
@@ -774,6 +872,14 @@ typedef struct {
   /* XXX: more fields to come */
   gasneti_atomic_val_t num_multi_addr_collectives_started;
   smp_coll_t smp_coll_handle;
+
+  /* Persistent collective being issued by gasnet_coll_start(), if any */
+  const struct gasnete_coll_plan_t_	*active_plan;
+
+  /* Sample the online tuner took for the blocking collective in progress */
+  struct gasnete_coll_online_cell_t_	*online_cell;
+  int					online_arm;
+  gasnett_tick_t			online_start;
   
 
   /* Macro for conduit-specific extension */
@@ -784,6 +890,50 @@ typedef struct {
 
 extern gasnete_coll_threaddata_t *gasnete_coll_new_threaddata(void);
 
+/*---------------------------------------------------------------------------------*/
+/* Persistent collectives: */
+/* A plan is everything gasnete_coll_*_nb_default() would compute before calling
+ * the selected algorithm.  When the thread-local addresses of a GASNET_COLL_LOCAL
+ * call are forwarded to the multi-address variant (as the _nb_default functions
+ * do in PAR builds), 'optype' is the M variant and the lists point at dst/src.
+ */
+struct gasnete_coll_plan_t_ {
+  gasnet_team_handle_t		team;
+  gasnet_coll_optype_t		optype;
+  int				flags;		/* with in-segment flags discovered */
+  gasnete_coll_implementation_t	impl;		/* private copy of the autotuner's choice */
+  gasnete_coll_local_tree_geom_t	*tree_geom;	/* impl->tree_type rooted at tree_root, or NULL */
+  gasnet_node_t			tree_root;
+
+  void				*dst;
+  void				*src;
+  gasnet_image_t		image;		/* srcimage or dstimage */
+  size_t			nbytes;
+  size_t			elem_size;
+  size_t			elem_count;
+  gasnet_coll_fn_handle_t	func;
+  int				func_arg;
+};
+
+/*---------------------------------------------------------------------------------*/
+/* Neighborhood collectives: */
+/* Everything about the graph that the data movement needs is resolved once by
+ * gasnet_coll_graph_create(), so that each collective only exchanges messages
+ * along the edges.  Edges are identified by their index in the local lists.
+ */
+struct gasnete_coll_graph_t_ {
+  gasnet_team_handle_t		team;
+  size_t			indegree;
+  size_t			outdegree;
+  gasnet_node_t			*sources;	/* team ranks, in the order of the dst blocks */
+  gasnet_node_t			*destinations;	/* team ranks, in the order of the src blocks */
+  uint32_t			*out_remote;	/* index of out-edge j among destinations[j]'s sources */
+  uint32_t			*out_slot;	/* p2p slot at which out-edge j learns its destination address */
+  uint32_t			*in_slot;	/* p2p slot of in-edge k at sources[k] (its out_slot) */
+  uint8_t			*out_pshm;	/* non-zero if destinations[j] shares our supernode */
+  uint8_t			*in_pshm;	/* non-zero if sources[k] shares our supernode */
+};
+
 GASNETI_INLINE(_gasnete_coll_get_threaddata)
 gasnete_coll_threaddata_t *
 _gasnete_coll_get_threaddata(gasneti_threaddata_t *mythread) {
@@ -827,10 +977,18 @@ extern void gasnete_coll_validate(gasnet_team_handle_t team,
                                   gasnet_image_t dstimage, const void *dstaddr, size_t dstlen, int dstisv,
                                   gasnet_image_t srcimage, const void *srcaddr, size_t srclen, int srcisv,
                                   int flags GASNETI_THREAD_FARG);
+/* As above, but either length may be zero */
+extern void gasnete_coll_validate_empty_ok(gasnet_team_handle_t team,
+                                  gasnet_image_t dstimage, const void *dstaddr, size_t dstlen, int dstisv,
+                                  gasnet_image_t srcimage, const void *srcaddr, size_t srclen, int srcisv,
+                                  int flags GASNETI_THREAD_FARG);
 #define GASNETE_COLL_VALIDATE(T,DI,DA,DL,DV,SI,SA,SL,SV,F) \
 gasnete_coll_validate(T,DI,DA,DL,DV,SI,SA,SL,SV,F GASNETI_THREAD_PASS)
+#define GASNETE_COLL_VALIDATE_EMPTY_OK(T,DI,DA,DL,DV,SI,SA,SL,SV,F) \
+gasnete_coll_validate_empty_ok(T,DI,DA,DL,DV,SI,SA,SL,SV,F GASNETI_THREAD_PASS)
 #else
 #define GASNETE_COLL_VALIDATE(T,DI,DA,DL,DV,SI,SA,SL,SV,F)
+#define GASNETE_COLL_VALIDATE_EMPTY_OK(T,DI,DA,DL,DV,SI,SA,SL,SV,F)
 #endif
 
 #define GASNETE_COLL_VALIDATE_BROADCAST(T,D,R,S,N,F)   \
@@ -858,6 +1016,19 @@ GASNETE_COLL_VALIDATE(T,(gasnet_image_t)(-1),D,(N)*gasneti_nodes,0,(gasnet_image
 #define GASNETE_COLL_VALIDATE_EXCHANGE_M(T,D,S,N,F)                  \
 GASNETE_COLL_VALIDATE(T,(gasnet_image_t)(-1),D,(N)*gasneti_nodes,1,(gasnet_image_t)(-1),S,(N)*gasneti_nodes,1,F)
 
+#define GASNETE_COLL_VALIDATE_ALLREDUCE(T,D,S,ES,EC,F)                  \
+GASNETE_COLL_VALIDATE(T,(gasnet_image_t)(-1),D,(ES)*(EC),0,(gasnet_image_t)(-1),S,(ES)*(EC),0,F)
+#define GASNETE_COLL_VALIDATE_ALLREDUCE_M(T,D,S,ES,EC,F)                  \
+GASNETE_COLL_VALIDATE(T,(gasnet_image_t)(-1),D,(ES)*(EC),1,(gasnet_image_t)(-1),S,(ES)*(EC),1,F)
+
+/* A rank with no in- or out-neighbors has nothing to receive or send */
+#define GASNETE_COLL_VALIDATE_NEIGHBOR(T,D,DL,S,SL,F)                  \
+GASNETE_COLL_VALIDATE_EMPTY_OK(T,(gasnet_image_t)(-1),D,DL,0,(gasnet_image_t)(-1),S,SL,0,F)
+
+/* Variable-count collectives may give a rank (or every rank) a zero count */
+#define GASNETE_COLL_VALIDATE_VCOLL(T,D,DL,S,SL,F)                     \
+GASNETE_COLL_VALIDATE_EMPTY_OK(T,(gasnet_image_t)(-1),D,DL,0,(gasnet_image_t)(-1),S,SL,0,F)
+
 /* XXX: following arg validations unimplemented */
 #define GASNETE_COLL_VALIDATE_REDUCE(T,DI,D,S,SB,SO,ES,EC,FN,FA,F)
 #define GASNETE_COLL_VALIDATE_REDUCE_M(T,DI,D,SL,SB,SO,ES,EC,FN,FA,F)
@@ -905,12 +1076,16 @@ can *prove* the current thread has a handle for the current op:
   The MY case won't work when we begin to signal threads individially as
   their data is delivered/consumed, but gasnete_poll() should be done
   before that.
++ The dedicated progress thread (GASNET_COLL_PROGRESS_THREAD), when running,
+  is certain to poll again and so may initiate for any op.
   None of this is needed once gasnete_poll() will ensure that gasneti_AMPoll()
   will poll collectives as long as any remain unfinished.
   */
 #if GASNETI_USE_TRUE_MUTEXES 
+extern void *gasnete_coll_progress_threaddata; /* has type gasneti_threaddata_t* */
 #define GASNETE_COLL_MAY_INIT_FOR(op)	((GASNETE_COLL_GENERIC_DATA(op)->owner == GASNETI_MYTHREAD) || \
-				 ((op)->flags & (GASNET_COLL_OUT_MYSYNC | GASNET_COLL_OUT_ALLSYNC)))
+				 ((op)->flags & (GASNET_COLL_OUT_MYSYNC | GASNET_COLL_OUT_ALLSYNC)) || \
+				 (gasnete_coll_progress_threaddata == GASNETI_MYTHREAD))
 #define GASNETE_COLL_SET_OWNER(data)	((data)->owner = GASNETI_MYTHREAD)
 #else
 #define GASNETE_COLL_MAY_INIT_FOR(op)	1
@@ -1214,6 +1389,40 @@ typedef struct {
   gasnet_coll_fn_handle_t func; int func_arg;
 } gasnete_coll_reduceM_args_t;
 
+typedef struct {
+  void *dst;
+  void *src;
+  size_t elem_size; 
+  size_t elem_count;
+  size_t nbytes;
+  gasnet_coll_fn_handle_t func; int func_arg;
+} gasnete_coll_allreduce_args_t;
+
+typedef struct {
+  void * *dstlist;
+  void * *srclist;
+  size_t elem_size; 
+  size_t elem_count;
+  size_t nbytes;
+  gasnet_coll_fn_handle_t func; int func_arg;
+} gasnete_coll_allreduceM_args_t;
+
+typedef struct {
+  gasnet_coll_graph_t graph;
+  void *dst;
+  void *src;
+  size_t nbytes;      /* block length, unless vlens != NULL */
+  size_t src_stride;  /* distance between source blocks: 0 (allgather) or nbytes (alltoall) */
+  size_t *vlens;      /* alltoallv: dst counts and offsets (indegree each), then src counts and offsets (outdegree each) */
+  size_t *rofs;       /* offset of each out-edge's block in the receiver's dst, if known to the sender */
+} gasnete_coll_neighbor_args_t;
+
+typedef struct {
+  void *dst;
+  void *src;
+  size_t *counts;     /* counts, then offsets (total_ranks each) */
+} gasnete_coll_gather_allv_args_t;
+
 /* Options for gasnete_coll_generic_* */
 #define GASNETE_COLL_GENERIC_OPT_INSYNC		0x0001
 #define GASNETE_COLL_GENERIC_OPT_OUTSYNC	0x0002
@@ -1240,13 +1449,17 @@ struct gasnete_coll_generic_data_t_ {
     GASNETE_COLL_GENERIC_TAG(gather_all),
     GASNETE_COLL_GENERIC_TAG(exchange),
     GASNETE_COLL_GENERIC_TAG(reduce),
+    GASNETE_COLL_GENERIC_TAG(allreduce),
+    GASNETE_COLL_GENERIC_TAG(neighbor),
+    GASNETE_COLL_GENERIC_TAG(gather_allv),
     /* Multiple-address interfaces: */
     GASNETE_COLL_GENERIC_TAG(broadcastM),
     GASNETE_COLL_GENERIC_TAG(scatterM),
     GASNETE_COLL_GENERIC_TAG(gatherM),
     GASNETE_COLL_GENERIC_TAG(gather_allM),
     GASNETE_COLL_GENERIC_TAG(exchangeM),
-    GASNETE_COLL_GENERIC_TAG(reduceM)
+    GASNETE_COLL_GENERIC_TAG(reduceM),
+    GASNETE_COLL_GENERIC_TAG(allreduceM)
 #if GASNET_PAR
     /* Single-address/multi-thread interfaces: */
     , GASNETE_COLL_GENERIC_TAG(broadcastT),
@@ -1301,6 +1514,9 @@ struct gasnete_coll_generic_data_t_ {
       gasnete_coll_gather_all_args_t		gather_all;
       gasnete_coll_exchange_args_t		exchange;
       gasnete_coll_reduce_args_t reduce;
+      gasnete_coll_allreduce_args_t		allreduce;
+      gasnete_coll_neighbor_args_t		neighbor;
+      gasnete_coll_gather_allv_args_t		gather_allv;
 
       /* Multiple-address interfaces: */
       gasnete_coll_broadcastM_args_t		broadcastM;
@@ -1309,6 +1525,7 @@ struct gasnete_coll_generic_data_t_ {
       gasnete_coll_gather_allM_args_t		gather_allM;
       gasnete_coll_exchangeM_args_t		exchangeM;
       gasnete_coll_reduceM_args_t		reduceM;
+      gasnete_coll_allreduceM_args_t		allreduceM;
       /* XXX: still need a few more */
       
       /* Hook for conduit-specific extension */
@@ -1556,6 +1773,26 @@ gasnete_coll_generic_reduceM_nb(gasnet_team_handle_t team,
                                int num_params, uint32_t *param_list, gasnete_coll_scratch_req_t *scratch_req
                                GASNETI_THREAD_FARG);
 
+extern gasnet_coll_handle_t
+gasnete_coll_generic_allreduce_nb(gasnet_team_handle_t team,
+                                  void *dst, void *src,
+                                  size_t elem_size, size_t elem_count, 
+                                  gasnet_coll_fn_handle_t func, int func_arg, int flags,
+                                  gasnete_coll_poll_fn poll_fn, int options,
+                                  void *private_data, uint32_t sequence,
+                                  int num_params, uint32_t *param_list, gasnete_coll_scratch_req_t *scratch_req
+                                  GASNETI_THREAD_FARG);
+
+extern gasnet_coll_handle_t
+gasnete_coll_generic_allreduceM_nb(gasnet_team_handle_t team,
+                                   void * const dstlist[], void * const srclist[],
+                                   size_t elem_size, size_t elem_count, 
+                                   gasnet_coll_fn_handle_t func, int func_arg, int flags,
+                                   gasnete_coll_poll_fn poll_fn, int options,
+                                   void *private_data, uint32_t sequence,
+                                   int num_params, uint32_t *param_list, gasnete_coll_scratch_req_t *scratch_req
+                                   GASNETI_THREAD_FARG);
+
 
 
 extern gasnet_coll_handle_t
@@ -1646,6 +1883,9 @@ GASNETE_COLL_DECLARE_BCAST_ALG(TreePutScratch);
 GASNETE_COLL_DECLARE_BCAST_ALG(TreePutSeg);
 GASNETE_COLL_DECLARE_BCAST_ALG(ScatterAllgather);
 GASNETE_COLL_DECLARE_BCAST_ALG(TreeEager);
+#if GASNET_PSHM
+GASNETE_COLL_DECLARE_BCAST_ALG(PSHM);
+#endif
 
 /*---------------------------------------------------------------------------------*/
 
@@ -1693,6 +1933,9 @@ GASNETE_COLL_DECLARE_SCATTER_ALG(TreeEager);
 GASNETE_COLL_DECLARE_SCATTER_ALG(Eager);
 GASNETE_COLL_DECLARE_SCATTER_ALG(RVGet);
 GASNETE_COLL_DECLARE_SCATTER_ALG(RVous);
+#if GASNET_PSHM
+GASNETE_COLL_DECLARE_SCATTER_ALG(PSHM);
+#endif
 
 /*---------------------------------------------------------------------------------*/
 
@@ -1737,6 +1980,9 @@ GASNETE_COLL_DECLARE_GATHER_ALG(TreeEager);
 GASNETE_COLL_DECLARE_GATHER_ALG(Eager);
 GASNETE_COLL_DECLARE_GATHER_ALG(RVPut);
 GASNETE_COLL_DECLARE_GATHER_ALG(RVous);
+#if GASNET_PSHM
+GASNETE_COLL_DECLARE_GATHER_ALG(PSHM);
+#endif
 
 /*---------------------------------------------------------------------------------*/
 
@@ -1812,6 +2058,9 @@ GASNETE_COLL_DECLARE_EXCHANGE_ALG(FlatScratch);
 GASNETE_COLL_DECLARE_EXCHANGE_ALG(Gath);
 GASNETE_COLL_DECLARE_EXCHANGE_ALG(Put);
 GASNETE_COLL_DECLARE_EXCHANGE_ALG(RVPut);
+#if GASNET_PSHM
+GASNETE_COLL_DECLARE_EXCHANGE_ALG(PSHM);
+#endif
 
 /*---------------------------------------------------------------------------------*/
 
@@ -1855,6 +2104,11 @@ GASNETE_COLL_DECLARE_REDUCE_ALG(TreeEager);
 GASNETE_COLL_DECLARE_REDUCE_ALG(TreePut);
 GASNETE_COLL_DECLARE_REDUCE_ALG(TreePutSeg);
 GASNETE_COLL_DECLARE_REDUCE_ALG(TreeGet);
+GASNETE_COLL_DECLARE_REDUCE_ALG(TreeGetSeg);
+GASNETE_COLL_DECLARE_REDUCE_ALG(TreeEagerSeg);
+#if GASNET_PSHM
+GASNETE_COLL_DECLARE_REDUCE_ALG(PSHM);
+#endif
 
 /*#undef GASNETI_COLL_FN_HEADER*/
 
@@ -1875,6 +2129,40 @@ GASNETE_COLL_DECLARE_REDUCEM_ALG(TreeEager);
 GASNETE_COLL_DECLARE_REDUCEM_ALG(TreePut);
 GASNETE_COLL_DECLARE_REDUCEM_ALG(TreePutSeg);
 GASNETE_COLL_DECLARE_REDUCEM_ALG(TreeGet);
+GASNETE_COLL_DECLARE_REDUCEM_ALG(TreeGetSeg);
+GASNETE_COLL_DECLARE_REDUCEM_ALG(TreeEagerSeg);
+
+/*---------------------------------------------------------------------------------*/
+
+#define GASNETE_COLL_DECLARE_ALLREDUCE_ALG(FUNC_EXT) \
+extern gasnet_coll_handle_t \
+gasnete_coll_allreduce_##FUNC_EXT(gasnet_team_handle_t team,\
+                                  void *dst, void *src,\
+                                  size_t elem_size, size_t elem_count,\
+                                  gasnet_coll_fn_handle_t func, int func_arg,\
+                                  int flags, \
+                                  gasnete_coll_implementation_t coll_params,\
+                                  uint32_t sequence\
+                                  GASNETI_THREAD_FARG)
+
+GASNETE_COLL_DECLARE_ALLREDUCE_ALG(RecDbl);
+GASNETE_COLL_DECLARE_ALLREDUCE_ALG(Rabenseifner);
+GASNETE_COLL_DECLARE_ALLREDUCE_ALG(Red);
+
+#define GASNETE_COLL_DECLARE_ALLREDUCEM_ALG(FUNC_EXT) \
+extern gasnet_coll_handle_t \
+gasnete_coll_allreduceM_##FUNC_EXT(gasnet_team_handle_t team,\
+                                   void * const dstlist[], void * const srclist[],\
+                                   size_t elem_size, size_t elem_count,\
+                                   gasnet_coll_fn_handle_t func, int func_arg,\
+                                   int flags, \
+                                   gasnete_coll_implementation_t coll_params,\
+                                   uint32_t sequence\
+                                   GASNETI_THREAD_FARG)
+
+GASNETE_COLL_DECLARE_ALLREDUCEM_ALG(RecDbl);
+GASNETE_COLL_DECLARE_ALLREDUCEM_ALG(Rabenseifner);
+GASNETE_COLL_DECLARE_ALLREDUCEM_ALG(Red);
 
 /*---------------------------------------------------------------------------------*/
 /* Conduit specific extension hooks: */
@@ -704,6 +704,7 @@ static int gasnete_coll_pf_gath_Eager(gasnete_coll_op_t *op GASNETI_THREAD_FARG)
       } else {
         GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(gasnete_coll_scale_ptr(args->dst, op->team->myrank, args->nbytes),
                                             args->src, args->nbytes);
+        gasnete_coll_p2p_mark_state(data->p2p, op->team->myrank + 1);
         data->p2p->state[op->team->myrank] = 2;
       }
       data->state = 1; GASNETI_FALLTHROUGH
@@ -889,6 +890,7 @@ static int gasnete_coll_pf_gathM_Eager(gasnete_coll_op_t *op GASNETI_THREAD_FARG
         gasnete_coll_local_gather(op->team->my_images,
                                   gasnete_coll_scale_ptr(args->dst, op->team->my_offset, args->nbytes),
                                   &GASNETE_COLL_MY_1ST_IMAGE(op->team,args->srclist, op->flags), args->nbytes);
+        gasnete_coll_p2p_mark_state(data->p2p, op->team->my_offset + op->team->my_images);
         s = &(data->p2p->state[op->team->my_offset]);
         for (i = 0; i < op->team->my_images; ++i) {
           *(s++) = 2;
@@ -1441,8 +1443,8 @@ static int gasnete_coll_pf_reduce_Eager(gasnete_coll_op_t *op GASNETI_THREAD_FAR
         uintptr_t dst_addr, src_addr;
         size_t nbytes = args->nbytes;
         int i, done;
-        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_tbl[args->func].fnptr;
-        uint32_t red_fn_flags = gasnete_coll_fn_tbl[args->func].flags;
+        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(args->func)->fnptr;
+        uint32_t red_fn_flags = gasnete_coll_fn_lookup(args->func)->flags;
         uint32_t reduce_args = args->func_arg;
         static int first=1;
         
@@ -1534,8 +1536,8 @@ static int gasnete_coll_pf_reduce_TreeEager(gasnete_coll_op_t *op GASNETI_THREAD
         volatile uint32_t *state;
         size_t nbytes = args->nbytes;
         int i, done;
-        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_tbl[args->func].fnptr;
-        uint32_t red_fn_flags = gasnete_coll_fn_tbl[args->func].flags;
+        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(args->func)->fnptr;
+        uint32_t red_fn_flags = gasnete_coll_fn_lookup(args->func)->flags;
         uint32_t reduce_args = args->func_arg;
         
         gasneti_assert(p2p != NULL);
@@ -1656,8 +1658,8 @@ static int gasnete_coll_pf_reduceM_TreeEager(gasnete_coll_op_t *op GASNETI_THREA
         volatile uint32_t *state;
         size_t nbytes = args->nbytes;
         int i, done;
-        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_tbl[args->func].fnptr;
-        uint32_t red_fn_flags = gasnete_coll_fn_tbl[args->func].flags;
+        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(args->func)->fnptr;
+        uint32_t red_fn_flags = gasnete_coll_fn_lookup(args->func)->flags;
         uint32_t reduce_args = args->func_arg;
         
         gasneti_assert(p2p != NULL);
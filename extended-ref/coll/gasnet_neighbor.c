@@ -0,0 +1,950 @@
+/*   $Source: bitbucket.org:berkeleylab/gasnet.git/extended-ref/coll/gasnet_neighbor.c $
+ * Description: Neighborhood and variable-count collectives for GASNet Collectives
+ * Terms of use are as specified in license.txt
+ */
+
+#include <gasnet_internal.h>
+#include <coll/gasnet_coll.h>
+
+#include <coll/gasnet_coll_internal.h>
+#include <coll/gasnet_trees.h>
+#include <coll/gasnet_scratch.h>
+#include <coll/gasnet_autotune_internal.h>
+
+/* Data moves along each edge in one of three ways:
+ *  - If the destination is in-segment, the sender writes it directly: with
+ *    loads and stores when the receiver shares our supernode, and otherwise
+ *    with AMLongs of at most gasnet_AMMaxLongRequest() bytes.  Each write
+ *    increments counter[0] at the receiver.
+ *  - Otherwise the receiver sends a ready-to-receive (RTR) with its address
+ *    and the sender streams AMMediums into it (see gasnete_coll_p2p_send_rtr).
+ *  - An edge from a node to itself is a local copy.
+ * With a SINGLE in-segment destination, uniform block sizes and IN_NOSYNC,
+ * the sender can compute every destination address itself, so no RTRs are
+ * sent and each edge costs a single one-way message.
+ *
+ * Slot 0 of the p2p state holds the count of expected AMMediums, so the RTR of
+ * out-edge j uses slot out_slot[j] >= 1.  Slots are only assigned to out-edges
+ * to other nodes, so at most total_ranks RTRs fit in the eager buffer.
+ */
+
+/*---------------------------------------------------------------------------------*/
+/* Graph creation */
+
+typedef struct {
+  gasnet_node_t rank;
+  uint32_t src_idx;   /* index in sources[], or GASNETE_COLL_GRAPH_NONE */
+  uint32_t dst_idx;   /* index in destinations[], or GASNETE_COLL_GRAPH_NONE */
+} gasnete_coll_graph_peer_t;
+
+/* What a node tells each of its neighbors during gasnet_coll_graph_create() */
+typedef struct {
+  uint32_t remote;    /* index of the recipient in the sender's sources[] */
+  uint32_t slot;      /* sender's out_slot for the edge to the recipient */
+} gasnete_coll_graph_hello_t;
+
+#define GASNETE_COLL_GRAPH_NONE ((uint32_t)(-1))
+
+typedef struct {
+  gasnet_coll_graph_t graph;
+  size_t npeers;
+  gasnete_coll_graph_peer_t *peers;   /* distinct neighbors other than ourself, sorted by rank */
+} gasnete_coll_graph_setup_t;
+
+static int gasnete_coll_graph_peer_cmp(const void *a, const void *b) {
+  const gasnete_coll_graph_peer_t *pa = a;
+  const gasnete_coll_graph_peer_t *pb = b;
+  return (pa->rank < pb->rank) ? -1 : (pa->rank > pb->rank);
+}
+
+/* Merge sources and destinations into one entry per distinct neighbor */
+static size_t gasnete_coll_graph_peers(gasnet_coll_graph_t graph, gasnete_coll_graph_peer_t *peers) {
+  const gasnet_node_t myrank = graph->team->myrank;
+  size_t i, n = 0, npeers = 0;
+
+  for (i = 0; i < graph->indegree; ++i) {
+    peers[n].rank = graph->sources[i];
+    peers[n].src_idx = i;
+    peers[n].dst_idx = GASNETE_COLL_GRAPH_NONE;
+    n++;
+  }
+  for (i = 0; i < graph->outdegree; ++i) {
+    peers[n].rank = graph->destinations[i];
+    peers[n].src_idx = GASNETE_COLL_GRAPH_NONE;
+    peers[n].dst_idx = i;
+    n++;
+  }
+  qsort(peers, n, sizeof(gasnete_coll_graph_peer_t), &gasnete_coll_graph_peer_cmp);
+
+  for (i = 0; i < n; ++i) {
+    if (npeers && peers[npeers-1].rank == peers[i].rank) {
+      gasnete_coll_graph_peer_t *p = &peers[npeers-1];
+      if (peers[i].src_idx != GASNETE_COLL_GRAPH_NONE) {
+        if (p->src_idx != GASNETE_COLL_GRAPH_NONE)
+          gasneti_fatalerror("gasnet_coll_graph_create: rank %d appears more than once in sources", (int)p->rank);
+        p->src_idx = peers[i].src_idx;
+      } else {
+        if (p->dst_idx != GASNETE_COLL_GRAPH_NONE)
+          gasneti_fatalerror("gasnet_coll_graph_create: rank %d appears more than once in destinations", (int)p->rank);
+        p->dst_idx = peers[i].dst_idx;
+      }
+    } else {
+      peers[npeers++] = peers[i];
+    }
+  }
+
+  /* Resolve the edges from this node to itself locally */
+  for (i = 0; i < npeers; ++i) {
+    if (peers[i].rank == myrank) {
+      if ((peers[i].src_idx == GASNETE_COLL_GRAPH_NONE) != (peers[i].dst_idx == GASNETE_COLL_GRAPH_NONE))
+        gasneti_fatalerror("gasnet_coll_graph_create: a self edge must appear in both sources and destinations");
+      if (peers[i].dst_idx != GASNETE_COLL_GRAPH_NONE) {
+        graph->out_remote[peers[i].dst_idx] = peers[i].src_idx;
+      }
+      memmove(&peers[i], &peers[i+1], (npeers - i - 1) * sizeof(gasnete_coll_graph_peer_t));
+      npeers--;
+      break;
+    }
+  }
+
+  return npeers;
+}
+
+/* Each node sends one hello to each distinct neighbor, stored at the slot of
+ * the sender's rank, and waits for one from each of its own.
+ */
+static int gasnete_coll_pf_graph_setup(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  gasnete_coll_graph_setup_t *setup = data->private_data;
+  gasnet_coll_graph_t graph = setup->graph;
+  const gasnete_coll_graph_hello_t *hello = (const gasnete_coll_graph_hello_t *)data->p2p->data;
+  size_t i;
+  int result = 0;
+
+  switch (data->state) {
+    case 0:	/* Send our half of every edge */
+      for (i = 0; i < setup->npeers; ++i) {
+        const gasnete_coll_graph_peer_t *p = &setup->peers[i];
+        gasnete_coll_graph_hello_t msg;
+        msg.remote = p->src_idx;
+        msg.slot = (p->dst_idx == GASNETE_COLL_GRAPH_NONE) ? GASNETE_COLL_GRAPH_NONE : graph->out_slot[p->dst_idx];
+        gasnete_coll_p2p_eager_put(op, GASNETE_COLL_REL2ACT(op->team, p->rank), &msg,
+                                   sizeof(msg), op->team->myrank, 1);
+      }
+      data->state = 1; GASNETI_FALLTHROUGH
+
+    case 1:	/* Collect the other half */
+      for (i = 0; i < setup->npeers; ++i) {
+        if (!data->p2p->state[setup->peers[i].rank]) return 0;
+      }
+      gasneti_sync_reads();
+      for (i = 0; i < setup->npeers; ++i) {
+        const gasnete_coll_graph_peer_t *p = &setup->peers[i];
+        const gasnete_coll_graph_hello_t *msg = &hello[p->rank];
+        if ((p->dst_idx == GASNETE_COLL_GRAPH_NONE) != (msg->remote == GASNETE_COLL_GRAPH_NONE) ||
+            (p->src_idx == GASNETE_COLL_GRAPH_NONE) != (msg->slot == GASNETE_COLL_GRAPH_NONE)) {
+          gasneti_fatalerror("gasnet_coll_graph_create: the edges between ranks %d and %d are not listed consistently",
+                             (int)op->team->myrank, (int)p->rank);
+        }
+        if (p->dst_idx != GASNETE_COLL_GRAPH_NONE) graph->out_remote[p->dst_idx] = msg->remote;
+        if (p->src_idx != GASNETE_COLL_GRAPH_NONE) graph->in_slot[p->src_idx] = msg->slot;
+      }
+
+      gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+      result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+/* Allocate a graph and resolve everything that is known locally.  A NULL list
+ * of ranks stands for the whole team in rank order.  The caller fills in
+ * out_remote[] and in_slot[].
+ */
+static gasnet_coll_graph_t
+gasnete_coll_graph_alloc(gasnet_team_handle_t team, const char *fname,
+                         size_t indegree, const gasnet_node_t sources[],
+                         size_t outdegree, const gasnet_node_t destinations[]) {
+  gasnet_coll_graph_t graph;
+  uint32_t nslots = 0;
+  size_t i;
+
+  gasneti_assert(team);
+  graph = gasneti_calloc(1, sizeof(struct gasnete_coll_graph_t_));
+  graph->team = team;
+  graph->indegree = indegree;
+  graph->outdegree = outdegree;
+  graph->sources = gasneti_malloc(MAX(1, indegree) * sizeof(gasnet_node_t));
+  graph->destinations = gasneti_malloc(MAX(1, outdegree) * sizeof(gasnet_node_t));
+  graph->out_remote = gasneti_malloc(MAX(1, outdegree) * sizeof(uint32_t));
+  graph->out_slot = gasneti_malloc(MAX(1, outdegree) * sizeof(uint32_t));
+  graph->in_slot = gasneti_malloc(MAX(1, indegree) * sizeof(uint32_t));
+  graph->out_pshm = gasneti_calloc(MAX(1, outdegree), sizeof(uint8_t));
+  graph->in_pshm = gasneti_calloc(MAX(1, indegree), sizeof(uint8_t));
+
+  for (i = 0; i < indegree; ++i) {
+    graph->sources[i] = sources ? sources[i] : (gasnet_node_t)i;
+    if (graph->sources[i] >= team->total_ranks)
+      gasneti_fatalerror("%s: source rank %d is not in the team", fname, (int)graph->sources[i]);
+  #if GASNET_PSHM
+    graph->in_pshm[i] = (graph->sources[i] != team->myrank) &&
+                        gasneti_pshm_in_supernode(GASNETE_COLL_REL2ACT(team, graph->sources[i]));
+  #endif
+    graph->in_slot[i] = GASNETE_COLL_GRAPH_NONE;
+  }
+  for (i = 0; i < outdegree; ++i) {
+    graph->destinations[i] = destinations ? destinations[i] : (gasnet_node_t)i;
+    if (graph->destinations[i] >= team->total_ranks)
+      gasneti_fatalerror("%s: destination rank %d is not in the team", fname, (int)graph->destinations[i]);
+  #if GASNET_PSHM
+    graph->out_pshm[i] = (graph->destinations[i] != team->myrank) &&
+                         gasneti_pshm_in_supernode(GASNETE_COLL_REL2ACT(team, graph->destinations[i]));
+  #endif
+    graph->out_slot[i] = (graph->destinations[i] == team->myrank) ? GASNETE_COLL_GRAPH_NONE : ++nslots;
+    graph->out_remote[i] = GASNETE_COLL_GRAPH_NONE;
+  }
+
+  /* The RTRs live in the p2p eager buffer and state[] */
+  if (((nslots + 1) * sizeof(struct gasnete_coll_p2p_send_struct) > gasnete_coll_p2p_eager_buffersz) ||
+      (nslots + 1 > 2 * team->total_images)) {
+    gasneti_fatalerror("%s: the collective eager buffer (%"PRIuPTR" bytes) is too small for %d destinations\n"
+                       "Increase it through the GASNET_COLL_P2P_EAGER_SCALE environment variable",
+                       fname, (uintptr_t)gasnete_coll_p2p_eager_buffersz, (int)nslots);
+  }
+
+  return graph;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_graph_create)
+gasnet_coll_graph_t
+_gasnet_coll_graph_create(gasnet_team_handle_t team,
+                          size_t indegree, const gasnet_node_t sources[],
+                          size_t outdegree, const gasnet_node_t destinations[]
+                          GASNETI_THREAD_FARG) {
+  gasnet_coll_graph_t graph;
+  gasnete_coll_graph_setup_t setup;
+  gasnete_coll_generic_data_t *data;
+  gasnet_coll_handle_t handle;
+
+  gasneti_assert(sources || !indegree);
+  gasneti_assert(destinations || !outdegree);
+  graph = gasnete_coll_graph_alloc(team, "gasnet_coll_graph_create", indegree, sources, outdegree, destinations);
+
+  /* The hellos are indexed by the rank of their sender */
+  if (team->total_ranks * sizeof(gasnete_coll_graph_hello_t) > gasnete_coll_p2p_eager_buffersz) {
+    gasneti_fatalerror("gasnet_coll_graph_create: the collective eager buffer (%"PRIuPTR" bytes) is too small "
+                       "for this team\nIncrease it through the GASNET_COLL_P2P_EAGER_SCALE environment variable",
+                       (uintptr_t)gasnete_coll_p2p_eager_buffersz);
+  }
+
+  setup.graph = graph;
+  setup.peers = gasneti_malloc(MAX(1, indegree + outdegree) * sizeof(gasnete_coll_graph_peer_t));
+  setup.npeers = gasnete_coll_graph_peers(graph, setup.peers);
+
+  /* One call per node, so there is no need for the threads_first protocol */
+  data = gasnete_coll_generic_alloc(GASNETI_THREAD_PASS_ALONE);
+  GASNETE_COLL_GENERIC_SET_TAG(data, neighbor);
+  data->args.neighbor.graph = graph;
+  data->options = GASNETE_COLL_GENERIC_OPT_P2P;
+  data->private_data = &setup;
+  data->tree_info = NULL;
+  handle = gasnete_coll_op_generic_init_with_scratch(team, GASNET_COLL_IN_NOSYNC | GASNET_COLL_OUT_NOSYNC | GASNET_COLL_NO_IMAGES,
+                                                     data, &gasnete_coll_pf_graph_setup, 0, NULL, 0, NULL, NULL GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+
+  gasneti_free(setup.peers);
+  return graph;
+}
+
+GASNETI_COLL_FN_HEADER(gasnete_coll_graph_free)
+void gasnete_coll_graph_free(gasnet_coll_graph_t graph) {
+  if (graph) {
+    gasneti_free(graph->sources);
+    gasneti_free(graph->destinations);
+    gasneti_free(graph->out_remote);
+    gasneti_free(graph->out_slot);
+    gasneti_free(graph->in_slot);
+    gasneti_free(graph->out_pshm);
+    gasneti_free(graph->in_pshm);
+    gasneti_free(graph);
+  }
+}
+
+/*---------------------------------------------------------------------------------*/
+/* Data movement */
+
+typedef struct {
+  int rtr;              /* receivers advertise their addresses */
+  int own_graph;        /* graph was built for this op alone */
+  size_t expected;      /* direct writes we will see on counter[0] */
+  size_t remaining;     /* out-edges not yet sent */
+  uint8_t *sent;        /* per out-edge */
+} gasnete_coll_neighbor_state_t;
+
+/* Layout of the per-edge block geometry that follows the state: dst counts and
+ * offsets (indegree each), src counts and offsets (outdegree each), and
+ * optionally the offset of each out-edge's block in the receiver's dst.
+ */
+#define GASNETE_COLL_NBR_VLENS(nstate)          ((size_t *)((nstate) + 1))
+#define GASNETE_COLL_NBR_NVLENS(g,rofs)         (2*(g)->indegree + ((rofs) ? 3 : 2)*(g)->outdegree)
+#define GASNETE_COLL_NBR_VLENS_DST_COUNTS(v,g)  (v)
+#define GASNETE_COLL_NBR_VLENS_DST_OFFSETS(v,g) ((v) + (g)->indegree)
+#define GASNETE_COLL_NBR_VLENS_SRC_COUNTS(v,g)  ((v) + 2*(g)->indegree)
+#define GASNETE_COLL_NBR_VLENS_SRC_OFFSETS(v,g) ((v) + 2*(g)->indegree + (g)->outdegree)
+#define GASNETE_COLL_NBR_VLENS_ROFS(v,g)        ((v) + 2*(g)->indegree + 2*(g)->outdegree)
+
+/* Block geometry of in-edge k and out-edge j */
+#define GASNETE_COLL_NBR_DST_LEN(args,g,k) \
+  ((args)->vlens ? (args)->vlens[(k)] : (args)->nbytes)
+#define GASNETE_COLL_NBR_DST_OFF(args,g,k) \
+  ((args)->vlens ? (args)->vlens[(g)->indegree + (k)] : (k)*(args)->nbytes)
+#define GASNETE_COLL_NBR_SRC_LEN(args,g,j) \
+  ((args)->vlens ? (args)->vlens[2*(g)->indegree + (j)] : (args)->nbytes)
+#define GASNETE_COLL_NBR_SRC_OFF(args,g,j) \
+  ((args)->vlens ? (args)->vlens[2*(g)->indegree + (g)->outdegree + (j)] : (j)*(args)->src_stride)
+
+/* Number of direct writes used to deliver nbytes */
+GASNETI_INLINE(gasnete_coll_neighbor_nwrites)
+size_t gasnete_coll_neighbor_nwrites(size_t nbytes, int pshm) {
+  const size_t maxlong = gasnet_AMMaxLongRequest();
+  return (pshm || !nbytes) ? 1 : (nbytes + maxlong - 1) / maxlong;
+}
+
+/* Write nbytes directly into an in-segment destination, signalling counter[idx] */
+static void gasnete_coll_neighbor_write(gasnete_coll_op_t *op, gasnet_node_t node,
+                                        int8_t *dst, int8_t *src, size_t nbytes, int pshm, uint32_t idx) {
+#if GASNET_PSHM
+  if (pshm) {
+    GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(gasneti_pshm_addr2local(node, dst), src, nbytes);
+    gasneti_sync_writes();
+    gasnete_coll_p2p_advance(op, node, idx);
+    return;
+  }
+#endif
+  if (!nbytes) {
+    gasnete_coll_p2p_advance(op, node, idx);
+  } else {
+    const size_t maxlong = gasnet_AMMaxLongRequest();
+    while (nbytes) {
+      size_t len = MIN(nbytes, maxlong);
+      gasnete_coll_p2p_counting_put(op, node, dst, src, len, idx);
+      dst += len; src += len; nbytes -= len;
+    }
+  }
+}
+
+static int gasnete_coll_pf_neighbor(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_neighbor_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, neighbor);
+  gasnete_coll_neighbor_state_t *nstate = data->private_data;
+  gasnet_coll_graph_t graph = args->graph;
+  const gasnet_node_t myrank = op->team->myrank;
+  const int in_segment = (op->flags & GASNET_COLL_DST_IN_SEGMENT);
+  int result = 0;
+  size_t i;
+
+  switch (data->state) {
+    case 0:	/* Optional IN barrier */
+      if (!gasnete_coll_generic_insync(op->team, data)) {
+        break;
+      }
+      data->state = 1; GASNETI_FALLTHROUGH
+
+    case 1:	/* Tell each source where its block goes */
+      for (i = 0; i < graph->indegree; ++i) {
+        const gasnet_node_t node = GASNETE_COLL_REL2ACT(op->team, graph->sources[i]);
+        int8_t *addr = (int8_t *)args->dst + GASNETE_COLL_NBR_DST_OFF(args, graph, i);
+        const size_t len = GASNETE_COLL_NBR_DST_LEN(args, graph, i);
+
+        if (graph->sources[i] == myrank) continue;
+        if (in_segment) {
+          nstate->expected += gasnete_coll_neighbor_nwrites(len, graph->in_pshm[i]);
+          if (nstate->rtr) {
+            struct gasnete_coll_p2p_send_struct rtr;
+            rtr.addr = addr;
+            rtr.sent = 0;
+            gasnete_coll_p2p_eager_put(op, node, &rtr, sizeof(rtr), graph->in_slot[i], 1);
+          }
+        } else {
+          gasnete_coll_p2p_send_rtr(op, data->p2p, graph->in_slot[i], addr, node, len);
+        }
+      }
+      data->state = 2; GASNETI_FALLTHROUGH
+
+    case 2:	/* Send along each out-edge once its destination is known */
+      for (i = 0; nstate->remaining && i < graph->outdegree; ++i) {
+        const gasnet_node_t node = GASNETE_COLL_REL2ACT(op->team, graph->destinations[i]);
+        const uint32_t slot = graph->out_slot[i];
+        int8_t *src = (int8_t *)args->src + GASNETE_COLL_NBR_SRC_OFF(args, graph, i);
+        const size_t len = GASNETE_COLL_NBR_SRC_LEN(args, graph, i);
+
+        if (nstate->sent[i]) continue;
+        if (graph->destinations[i] == myrank) {
+          GASNETE_FAST_UNALIGNED_MEMCPY_CHECK((int8_t *)args->dst +
+                                              GASNETE_COLL_NBR_DST_OFF(args, graph, graph->out_remote[i]),
+                                              src, len);
+        } else if (in_segment) {
+          int8_t *addr;
+          if (nstate->rtr) {
+            if (data->p2p->state[slot] != 1) continue;
+            gasneti_sync_reads();
+            addr = ((struct gasnete_coll_p2p_send_struct *)data->p2p->data)[slot].addr;
+          } else if (args->rofs) {
+            addr = (int8_t *)args->dst + args->rofs[i];
+          } else {
+            addr = (int8_t *)args->dst + graph->out_remote[i] * args->nbytes;
+          }
+          gasnete_coll_neighbor_write(op, node, addr, src, len, graph->out_pshm[i], 0);
+        } else {
+          while (!gasnete_coll_p2p_send_data(op, data->p2p, node, slot, src, len)) {
+            if (data->p2p->state[slot] != 1) break;
+          }
+          if (data->p2p->state[slot] != 2) continue;
+        }
+        nstate->sent[i] = 1;
+        nstate->remaining--;
+      }
+      if (nstate->remaining) {
+        break;
+      }
+      data->state = 3; GASNETI_FALLTHROUGH
+
+    case 3:	/* Wait for every incoming block */
+      if (in_segment) {
+        if (gasneti_weakatomic_read(&data->p2p->counter[0], 0) != nstate->expected) {
+          break;
+        }
+      } else if (!gasnete_coll_p2p_send_done(data->p2p)) {
+        break;
+      }
+      gasneti_sync_reads();
+      data->state = 4; GASNETI_FALLTHROUGH
+
+    case 4:	/* Optional OUT barrier */
+      if (!gasnete_coll_generic_outsync(op->team, data)) {
+        break;
+      }
+      if (nstate->own_graph) gasnete_coll_graph_free(graph);
+      gasneti_free(nstate);
+      gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+      result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+/* Private state for an op over graph, with room for nvlens block lengths */
+static gasnete_coll_neighbor_state_t *
+gasnete_coll_neighbor_state_alloc(gasnet_coll_graph_t graph, size_t nvlens) {
+  gasnete_coll_neighbor_state_t *nstate;
+
+  /* private state, copied block geometry and per-edge flags in one allocation */
+  nstate = gasneti_calloc(1, sizeof(gasnete_coll_neighbor_state_t) + nvlens * sizeof(size_t) + graph->outdegree);
+  nstate->sent = (uint8_t *)(GASNETE_COLL_NBR_VLENS(nstate) + nvlens);
+  nstate->remaining = graph->outdegree;
+  return nstate;
+}
+
+/* Since every block only travels along an edge, MYSYNC is provided by the RTRs
+ * (or by the client, when IN_NOSYNC lets senders skip them), and only the
+ * ALLSYNC modes need a team barrier.  Senders can skip the RTRs only when they
+ * know every destination address: a SINGLE dst with uniform blocks, or with
+ * the remote offsets (rofs) supplied by the caller.
+ */
+static gasnet_coll_handle_t
+gasnete_coll_neighbor_submit(gasnet_coll_graph_t graph, void *dst, void *src,
+                             size_t nbytes, size_t src_stride,
+                             gasnete_coll_neighbor_state_t *nstate, size_t *vlens, size_t *rofs,
+                             int flags GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data;
+  int options = GASNETE_COLL_GENERIC_OPT_P2P |
+                GASNETE_COLL_GENERIC_OPT_INSYNC_IF (flags & GASNET_COLL_IN_ALLSYNC) |
+                GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(flags & GASNET_COLL_OUT_ALLSYNC);
+
+  nstate->rtr = !((vlens == NULL || rofs != NULL) &&
+                  (flags & GASNET_COLL_SINGLE) &&
+                  (flags & GASNET_COLL_DST_IN_SEGMENT) &&
+                  (flags & GASNET_COLL_IN_NOSYNC));
+
+  /* One call per node, so there is no need for the threads_first protocol */
+  data = gasnete_coll_generic_alloc(GASNETI_THREAD_PASS_ALONE);
+  GASNETE_COLL_GENERIC_SET_TAG(data, neighbor);
+  data->args.neighbor.graph      = graph;
+  data->args.neighbor.dst        = dst;
+  data->args.neighbor.src        = src;
+  data->args.neighbor.nbytes     = nbytes;
+  data->args.neighbor.src_stride = src_stride;
+  data->args.neighbor.vlens      = vlens;
+  data->args.neighbor.rofs       = rofs;
+  data->options = options;
+  data->private_data = nstate;
+  data->tree_info = NULL;
+  return gasnete_coll_op_generic_init_with_scratch(graph->team, flags | GASNET_COLL_NO_IMAGES, data, &gasnete_coll_pf_neighbor,
+                                                   0, NULL, 0, NULL, NULL GASNETI_THREAD_PASS);
+}
+
+static gasnet_coll_handle_t
+gasnete_coll_generic_neighbor_nb(gasnet_coll_graph_t graph, void *dst, void *src,
+                                 size_t nbytes, size_t src_stride,
+                                 const size_t dst_counts[], const size_t dst_offsets[],
+                                 const size_t src_counts[], const size_t src_offsets[],
+                                 int own_graph, int flags GASNETI_THREAD_FARG) {
+  gasnete_coll_neighbor_state_t *nstate;
+  size_t *vlens = NULL;
+
+  if (dst_counts) {
+    nstate = gasnete_coll_neighbor_state_alloc(graph, GASNETE_COLL_NBR_NVLENS(graph, 0));
+    vlens = GASNETE_COLL_NBR_VLENS(nstate);
+    GASNETI_MEMCPY_SAFE_EMPTY(GASNETE_COLL_NBR_VLENS_DST_COUNTS(vlens, graph), dst_counts, graph->indegree * sizeof(size_t));
+    GASNETI_MEMCPY_SAFE_EMPTY(GASNETE_COLL_NBR_VLENS_DST_OFFSETS(vlens, graph), dst_offsets, graph->indegree * sizeof(size_t));
+    GASNETI_MEMCPY_SAFE_EMPTY(GASNETE_COLL_NBR_VLENS_SRC_COUNTS(vlens, graph), src_counts, graph->outdegree * sizeof(size_t));
+    GASNETI_MEMCPY_SAFE_EMPTY(GASNETE_COLL_NBR_VLENS_SRC_OFFSETS(vlens, graph), src_offsets, graph->outdegree * sizeof(size_t));
+  } else {
+    nstate = gasnete_coll_neighbor_state_alloc(graph, 0);
+  }
+  nstate->own_graph = own_graph;
+  return gasnete_coll_neighbor_submit(graph, dst, src, nbytes, src_stride, nstate, vlens, NULL, flags GASNETI_THREAD_PASS);
+}
+
+/* Extent of the blocks described by (counts, offsets) */
+static size_t gasnete_coll_neighbor_extent(size_t n, const size_t counts[], const size_t offsets[]) {
+  size_t i, extent = 0;
+  for (i = 0; i < n; ++i) {
+    extent = MAX(extent, offsets[i] + counts[i]);
+  }
+  return extent;
+}
+
+/*---------------------------------------------------------------------------------*/
+/* Public entry points */
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_allgather_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_neighbor_allgather_nb(gasnet_coll_graph_t graph,
+                                   void *dst, void *src,
+                                   size_t nbytes, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  GASNETI_TRACE_EVENT_VAL(W,COLL_NEIGHBOR_ALLGATHER_NB,nbytes);
+  GASNETE_COLL_VALIDATE_NEIGHBOR(graph->team,dst,nbytes*graph->indegree,src,nbytes,flags);
+  flags = gasnete_coll_segment_check(graph->team, flags, 0, 0, dst, nbytes*graph->indegree, 0, 0, src, nbytes);
+  handle = gasnete_coll_generic_neighbor_nb(graph, dst, src, nbytes, 0, NULL, NULL, NULL, NULL, 0, flags GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_allgather)
+void _gasnet_coll_neighbor_allgather(gasnet_coll_graph_t graph,
+                                     void *dst, void *src,
+                                     size_t nbytes, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  GASNETI_TRACE_EVENT_VAL(W,COLL_NEIGHBOR_ALLGATHER,nbytes);
+  GASNETE_COLL_VALIDATE_NEIGHBOR(graph->team,dst,nbytes*graph->indegree,src,nbytes,flags);
+  flags = gasnete_coll_segment_check(graph->team, flags, 0, 0, dst, nbytes*graph->indegree, 0, 0, src, nbytes);
+  handle = gasnete_coll_generic_neighbor_nb(graph, dst, src, nbytes, 0, NULL, NULL, NULL, NULL, 0, flags GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_alltoall_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_neighbor_alltoall_nb(gasnet_coll_graph_t graph,
+                                  void *dst, void *src,
+                                  size_t nbytes, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  GASNETI_TRACE_EVENT_VAL(W,COLL_NEIGHBOR_ALLTOALL_NB,nbytes);
+  GASNETE_COLL_VALIDATE_NEIGHBOR(graph->team,dst,nbytes*graph->indegree,src,nbytes*graph->outdegree,flags);
+  flags = gasnete_coll_segment_check(graph->team, flags, 0, 0, dst, nbytes*graph->indegree,
+                                     0, 0, src, nbytes*graph->outdegree);
+  handle = gasnete_coll_generic_neighbor_nb(graph, dst, src, nbytes, nbytes, NULL, NULL, NULL, NULL, 0, flags GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_alltoall)
+void _gasnet_coll_neighbor_alltoall(gasnet_coll_graph_t graph,
+                                    void *dst, void *src,
+                                    size_t nbytes, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  GASNETI_TRACE_EVENT_VAL(W,COLL_NEIGHBOR_ALLTOALL,nbytes);
+  GASNETE_COLL_VALIDATE_NEIGHBOR(graph->team,dst,nbytes*graph->indegree,src,nbytes*graph->outdegree,flags);
+  flags = gasnete_coll_segment_check(graph->team, flags, 0, 0, dst, nbytes*graph->indegree,
+                                     0, 0, src, nbytes*graph->outdegree);
+  handle = gasnete_coll_generic_neighbor_nb(graph, dst, src, nbytes, nbytes, NULL, NULL, NULL, NULL, 0, flags GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_alltoallv_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_neighbor_alltoallv_nb(gasnet_coll_graph_t graph,
+                                   void *dst, const size_t dst_counts[], const size_t dst_offsets[],
+                                   void *src, const size_t src_counts[], const size_t src_offsets[],
+                                   int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = gasnete_coll_neighbor_extent(graph->indegree, dst_counts, dst_offsets);
+  const size_t srclen = gasnete_coll_neighbor_extent(graph->outdegree, src_counts, src_offsets);
+  GASNETI_TRACE_EVENT_VAL(W,COLL_NEIGHBOR_ALLTOALLV_NB,srclen);
+  GASNETE_COLL_VALIDATE_NEIGHBOR(graph->team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(graph->team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_generic_neighbor_nb(graph, dst, src, 0, 0, dst_counts, dst_offsets,
+                                            src_counts, src_offsets, 0, flags GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_neighbor_alltoallv)
+void _gasnet_coll_neighbor_alltoallv(gasnet_coll_graph_t graph,
+                                     void *dst, const size_t dst_counts[], const size_t dst_offsets[],
+                                     void *src, const size_t src_counts[], const size_t src_offsets[],
+                                     int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = gasnete_coll_neighbor_extent(graph->indegree, dst_counts, dst_offsets);
+  const size_t srclen = gasnete_coll_neighbor_extent(graph->outdegree, src_counts, src_offsets);
+  GASNETI_TRACE_EVENT_VAL(W,COLL_NEIGHBOR_ALLTOALLV,srclen);
+  GASNETE_COLL_VALIDATE_NEIGHBOR(graph->team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(graph->team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_generic_neighbor_nb(graph, dst, src, 0, 0, dst_counts, dst_offsets,
+                                            src_counts, src_offsets, 0, flags GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+}
+
+/*---------------------------------------------------------------------------------*/
+/* Variable-count collectives */
+
+/* The rooted and flat v-collectives run over an implicit graph built locally
+ * for each call: the full team for exchangev and gather_allv, and a star
+ * around the root for gatherv and scatterv.  The edge bookkeeping that
+ * gasnet_coll_graph_create() exchanges is known in closed form here: the
+ * senders number their RTR slots in rank order, skipping themselves.
+ */
+#define GASNETE_COLL_VCOLL_SLOT(sender,rank) \
+  ((rank) == (sender) ? GASNETE_COLL_GRAPH_NONE : (uint32_t)((rank) < (sender) ? (rank)+1 : (rank)))
+
+static gasnet_coll_graph_t gasnete_coll_vcoll_complete_graph(gasnet_team_handle_t team, const char *fname) {
+  const gasnet_node_t myrank = team->myrank;
+  gasnet_coll_graph_t graph = gasnete_coll_graph_alloc(team, fname, team->total_ranks, NULL, team->total_ranks, NULL);
+  gasnet_node_t i;
+
+  for (i = 0; i < team->total_ranks; ++i) {
+    graph->out_remote[i] = myrank;
+    graph->in_slot[i] = GASNETE_COLL_VCOLL_SLOT(i, myrank);
+  }
+  return graph;
+}
+
+/* Total length of the blocks described by (counts, offsets) */
+static size_t gasnete_coll_vcoll_extent(gasnet_team_handle_t team, const size_t counts[], const size_t offsets[]) {
+  return gasnete_coll_neighbor_extent(team->total_ranks, counts, offsets);
+}
+
+/* Bruck dissemination for a SINGLE in-segment gather_allv: in phase r every
+ * node writes the (up to) 2^r blocks it holds directly into their final
+ * places in the dst of the node 2^r behind it, counting on counter[r].  Each
+ * block therefore reaches each node once, and no scratch space or final
+ * rotation is needed since the blocks land at their offsets.
+ */
+static int gasnete_coll_pf_gallv_Dissem(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_gather_allv_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, gather_allv);
+  const gasnet_node_t total_ranks = op->team->total_ranks;
+  const gasnet_node_t myrank = op->team->myrank;
+  const size_t *counts = args->counts;
+  const size_t *offsets = args->counts + total_ranks;
+  int result = 0;
+
+  /* States: 0 = IN barrier, 2r+1 = send phase r, 2r+2 = wait for phase r, last = OUT barrier */
+  if (data->state == 0) {
+    if (!gasnete_coll_generic_insync(op->team, data)) {
+      return 0;
+    }
+    GASNETE_FAST_UNALIGNED_MEMCPY_CHECK((int8_t *)args->dst + offsets[myrank], args->src, counts[myrank]);
+    data->state = 1;
+  }
+
+  while ((gasnet_node_t)1 << ((data->state - 1) / 2) < total_ranks) {
+    const uint32_t phase = (data->state - 1) / 2;
+    const gasnet_node_t dist = (gasnet_node_t)1 << phase;
+    const gasnet_node_t nblk = MIN(dist, total_ranks - dist);
+    gasnet_node_t i;
+
+    if (data->state % 2) {	/* send the blocks we hold to the node dist behind us */
+      const gasnet_node_t peer = (myrank + total_ranks - dist) % total_ranks;
+      const gasnet_node_t node = GASNETE_COLL_REL2ACT(op->team, peer);
+      int pshm = 0;
+    #if GASNET_PSHM
+      pshm = gasneti_pshm_in_supernode(node);
+    #endif
+      for (i = 0; i < nblk; ++i) {
+        const gasnet_node_t blk = (myrank + i) % total_ranks;
+        int8_t *addr = (int8_t *)args->dst + offsets[blk];
+        gasnete_coll_neighbor_write(op, node, addr, addr, counts[blk], pshm, phase);
+      }
+      data->state++;
+    }
+
+    {	/* wait for the blocks of the node dist ahead of us */
+      const gasnet_node_t peer = (myrank + dist) % total_ranks;
+      size_t expected = 0;
+      int pshm = 0;
+    #if GASNET_PSHM
+      pshm = gasneti_pshm_in_supernode(GASNETE_COLL_REL2ACT(op->team, peer));
+    #endif
+      for (i = 0; i < nblk; ++i) {
+        expected += gasnete_coll_neighbor_nwrites(counts[(peer + i) % total_ranks], pshm);
+      }
+      if (gasneti_weakatomic_read(&data->p2p->counter[phase], 0) != expected) {
+        return 0;
+      }
+      gasneti_sync_reads();
+      data->state++;
+    }
+  }
+
+  if (!gasnete_coll_generic_outsync(op->team, data)) {
+    return 0;
+  }
+  gasneti_free(args->counts);
+  gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+  result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+
+  return result;
+}
+
+static gasnet_coll_handle_t
+gasnete_coll_gather_allv_nb(gasnet_team_handle_t team, void *dst,
+                            const size_t counts[], const size_t offsets[],
+                            void *src, int flags GASNETI_THREAD_FARG) {
+  const gasnet_node_t total_ranks = team->total_ranks;
+  const gasnet_node_t myrank = team->myrank;
+
+  if ((flags & GASNET_COLL_SINGLE) && (flags & GASNET_COLL_DST_IN_SEGMENT)) {
+    /* Since the algorithm is naturally in_no / out_no use the in-barrier for anything but IN_NOSYNC,
+       and the out-barrier only for OUT_ALLSYNC */
+    int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (!(flags & GASNET_COLL_IN_NOSYNC)) |
+                  GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(flags & GASNET_COLL_OUT_ALLSYNC) |
+                  GASNETE_COLL_GENERIC_OPT_P2P;
+    gasnete_coll_generic_data_t *data = gasnete_coll_generic_alloc(GASNETI_THREAD_PASS_ALONE);
+    size_t *vlens = gasneti_malloc(2 * total_ranks * sizeof(size_t));
+
+    GASNETI_MEMCPY(vlens, counts, total_ranks * sizeof(size_t));
+    GASNETI_MEMCPY(vlens + total_ranks, offsets, total_ranks * sizeof(size_t));
+    GASNETE_COLL_GENERIC_SET_TAG(data, gather_allv);
+    data->args.gather_allv.dst    = dst;
+    data->args.gather_allv.src    = src;
+    data->args.gather_allv.counts = vlens;
+    data->options = options;
+    data->private_data = NULL;
+    data->tree_info = NULL;
+    return gasnete_coll_op_generic_init_with_scratch(team, flags | GASNET_COLL_NO_IMAGES, data, &gasnete_coll_pf_gallv_Dissem,
+                                                     0, NULL, 0, NULL, NULL GASNETI_THREAD_PASS);
+  } else {
+    /* Every node sends its block straight to the others */
+    gasnet_coll_graph_t graph = gasnete_coll_vcoll_complete_graph(team, "gasnet_coll_gather_allv");
+    gasnete_coll_neighbor_state_t *nstate = gasnete_coll_neighbor_state_alloc(graph, GASNETE_COLL_NBR_NVLENS(graph, 1));
+    size_t *vlens = GASNETE_COLL_NBR_VLENS(nstate);
+    gasnet_node_t i;
+
+    GASNETI_MEMCPY(GASNETE_COLL_NBR_VLENS_DST_COUNTS(vlens, graph), counts, total_ranks * sizeof(size_t));
+    GASNETI_MEMCPY(GASNETE_COLL_NBR_VLENS_DST_OFFSETS(vlens, graph), offsets, total_ranks * sizeof(size_t));
+    for (i = 0; i < total_ranks; ++i) {
+      GASNETE_COLL_NBR_VLENS_SRC_COUNTS(vlens, graph)[i] = counts[myrank];
+      GASNETE_COLL_NBR_VLENS_SRC_OFFSETS(vlens, graph)[i] = 0;
+      GASNETE_COLL_NBR_VLENS_ROFS(vlens, graph)[i] = offsets[myrank];
+    }
+    nstate->own_graph = 1;
+    return gasnete_coll_neighbor_submit(graph, dst, src, 0, 0, nstate, vlens,
+                                        GASNETE_COLL_NBR_VLENS_ROFS(vlens, graph), flags GASNETI_THREAD_PASS);
+  }
+}
+
+/* All nodes send one block to the root, which has an in-edge from each of them */
+static gasnet_coll_handle_t
+gasnete_coll_gatherv_nb(gasnet_team_handle_t team, gasnet_node_t dstrank, void *dst,
+                        const size_t counts[], const size_t offsets[],
+                        void *src, int flags GASNETI_THREAD_FARG) {
+  const gasnet_node_t myrank = team->myrank;
+  const int root = (myrank == dstrank);
+  gasnet_coll_graph_t graph = gasnete_coll_graph_alloc(team, "gasnet_coll_gatherv",
+                                                       root ? team->total_ranks : 0, NULL, 1, &dstrank);
+  gasnete_coll_neighbor_state_t *nstate = gasnete_coll_neighbor_state_alloc(graph, GASNETE_COLL_NBR_NVLENS(graph, 1));
+  size_t *vlens = GASNETE_COLL_NBR_VLENS(nstate);
+  gasnet_node_t i;
+
+  graph->out_remote[0] = myrank;
+  for (i = 0; i < graph->indegree; ++i) {
+    graph->in_slot[i] = (i == myrank) ? GASNETE_COLL_GRAPH_NONE : 1;
+  }
+  GASNETI_MEMCPY_SAFE_EMPTY(GASNETE_COLL_NBR_VLENS_DST_COUNTS(vlens, graph), counts, graph->indegree * sizeof(size_t));
+  GASNETI_MEMCPY_SAFE_EMPTY(GASNETE_COLL_NBR_VLENS_DST_OFFSETS(vlens, graph), offsets, graph->indegree * sizeof(size_t));
+  GASNETE_COLL_NBR_VLENS_SRC_COUNTS(vlens, graph)[0] = counts[myrank];
+  GASNETE_COLL_NBR_VLENS_SRC_OFFSETS(vlens, graph)[0] = 0;
+  GASNETE_COLL_NBR_VLENS_ROFS(vlens, graph)[0] = offsets[myrank];
+  nstate->own_graph = 1;
+  return gasnete_coll_neighbor_submit(graph, dst, src, 0, 0, nstate, vlens,
+                                      GASNETE_COLL_NBR_VLENS_ROFS(vlens, graph), flags GASNETI_THREAD_PASS);
+}
+
+/* The root sends one block to each node, which has a single in-edge from it */
+static gasnet_coll_handle_t
+gasnete_coll_scatterv_nb(gasnet_team_handle_t team, void *dst, gasnet_node_t srcrank,
+                         void *src, const size_t counts[], const size_t offsets[],
+                         int flags GASNETI_THREAD_FARG) {
+  const gasnet_node_t myrank = team->myrank;
+  const int root = (myrank == srcrank);
+  gasnet_coll_graph_t graph = gasnete_coll_graph_alloc(team, "gasnet_coll_scatterv",
+                                                       1, &srcrank, root ? team->total_ranks : 0, NULL);
+  gasnete_coll_neighbor_state_t *nstate = gasnete_coll_neighbor_state_alloc(graph, GASNETE_COLL_NBR_NVLENS(graph, 1));
+  size_t *vlens = GASNETE_COLL_NBR_VLENS(nstate);
+  gasnet_node_t i;
+
+  graph->in_slot[0] = GASNETE_COLL_VCOLL_SLOT(srcrank, myrank);
+  GASNETE_COLL_NBR_VLENS_DST_COUNTS(vlens, graph)[0] = counts[myrank];
+  GASNETE_COLL_NBR_VLENS_DST_OFFSETS(vlens, graph)[0] = 0;
+  for (i = 0; i < graph->outdegree; ++i) {
+    graph->out_remote[i] = 0;
+    GASNETE_COLL_NBR_VLENS_ROFS(vlens, graph)[i] = 0;
+  }
+  GASNETI_MEMCPY_SAFE_EMPTY(GASNETE_COLL_NBR_VLENS_SRC_COUNTS(vlens, graph), counts, graph->outdegree * sizeof(size_t));
+  GASNETI_MEMCPY_SAFE_EMPTY(GASNETE_COLL_NBR_VLENS_SRC_OFFSETS(vlens, graph), offsets, graph->outdegree * sizeof(size_t));
+  nstate->own_graph = 1;
+  return gasnete_coll_neighbor_submit(graph, dst, src, 0, 0, nstate, vlens,
+                                      GASNETE_COLL_NBR_VLENS_ROFS(vlens, graph), flags GASNETI_THREAD_PASS);
+}
+
+/* Each pair of nodes exchanges one block in each direction */
+static gasnet_coll_handle_t
+gasnete_coll_exchangev_nb(gasnet_team_handle_t team,
+                          void *dst, const size_t dst_counts[], const size_t dst_offsets[],
+                          void *src, const size_t src_counts[], const size_t src_offsets[],
+                          int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_graph_t graph = gasnete_coll_vcoll_complete_graph(team, "gasnet_coll_exchangev");
+  return gasnete_coll_generic_neighbor_nb(graph, dst, src, 0, 0, dst_counts, dst_offsets,
+                                          src_counts, src_offsets, 1, flags GASNETI_THREAD_PASS);
+}
+
+/*---------------------------------------------------------------------------------*/
+/* Variable-count entry points */
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_gatherv_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_gatherv_nb(gasnet_team_handle_t team, gasnet_node_t dstrank,
+                        void *dst, const size_t counts[], const size_t offsets[],
+                        void *src, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = gasnete_coll_vcoll_extent(team, counts, offsets);
+  const size_t srclen = counts[team->myrank];
+  GASNETI_TRACE_EVENT_VAL(W,COLL_GATHERV_NB,dstlen);
+  gasneti_assert(dstrank < team->total_ranks);
+  GASNETE_COLL_VALIDATE_VCOLL(team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_gatherv_nb(team, dstrank, dst, counts, offsets, src, flags GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_gatherv)
+void _gasnet_coll_gatherv(gasnet_team_handle_t team, gasnet_node_t dstrank,
+                          void *dst, const size_t counts[], const size_t offsets[],
+                          void *src, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = gasnete_coll_vcoll_extent(team, counts, offsets);
+  const size_t srclen = counts[team->myrank];
+  GASNETI_TRACE_EVENT_VAL(W,COLL_GATHERV,dstlen);
+  gasneti_assert(dstrank < team->total_ranks);
+  GASNETE_COLL_VALIDATE_VCOLL(team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_gatherv_nb(team, dstrank, dst, counts, offsets, src, flags GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_scatterv_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_scatterv_nb(gasnet_team_handle_t team, void *dst, gasnet_node_t srcrank,
+                         void *src, const size_t counts[], const size_t offsets[],
+                         int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = counts[team->myrank];
+  const size_t srclen = gasnete_coll_vcoll_extent(team, counts, offsets);
+  GASNETI_TRACE_EVENT_VAL(W,COLL_SCATTERV_NB,srclen);
+  gasneti_assert(srcrank < team->total_ranks);
+  GASNETE_COLL_VALIDATE_VCOLL(team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_scatterv_nb(team, dst, srcrank, src, counts, offsets, flags GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_scatterv)
+void _gasnet_coll_scatterv(gasnet_team_handle_t team, void *dst, gasnet_node_t srcrank,
+                           void *src, const size_t counts[], const size_t offsets[],
+                           int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = counts[team->myrank];
+  const size_t srclen = gasnete_coll_vcoll_extent(team, counts, offsets);
+  GASNETI_TRACE_EVENT_VAL(W,COLL_SCATTERV,srclen);
+  gasneti_assert(srcrank < team->total_ranks);
+  GASNETE_COLL_VALIDATE_VCOLL(team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_scatterv_nb(team, dst, srcrank, src, counts, offsets, flags GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_gather_allv_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_gather_allv_nb(gasnet_team_handle_t team,
+                            void *dst, const size_t counts[], const size_t offsets[],
+                            void *src, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = gasnete_coll_vcoll_extent(team, counts, offsets);
+  const size_t srclen = counts[team->myrank];
+  GASNETI_TRACE_EVENT_VAL(W,COLL_GATHER_ALLV_NB,dstlen);
+  GASNETE_COLL_VALIDATE_VCOLL(team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_gather_allv_nb(team, dst, counts, offsets, src, flags GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_gather_allv)
+void _gasnet_coll_gather_allv(gasnet_team_handle_t team,
+                              void *dst, const size_t counts[], const size_t offsets[],
+                              void *src, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = gasnete_coll_vcoll_extent(team, counts, offsets);
+  const size_t srclen = counts[team->myrank];
+  GASNETI_TRACE_EVENT_VAL(W,COLL_GATHER_ALLV,dstlen);
+  GASNETE_COLL_VALIDATE_VCOLL(team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_gather_allv_nb(team, dst, counts, offsets, src, flags GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_exchangev_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_exchangev_nb(gasnet_team_handle_t team,
+                          void *dst, const size_t dst_counts[], const size_t dst_offsets[],
+                          void *src, const size_t src_counts[], const size_t src_offsets[],
+                          int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = gasnete_coll_vcoll_extent(team, dst_counts, dst_offsets);
+  const size_t srclen = gasnete_coll_vcoll_extent(team, src_counts, src_offsets);
+  GASNETI_TRACE_EVENT_VAL(W,COLL_EXCHANGEV_NB,srclen);
+  GASNETE_COLL_VALIDATE_VCOLL(team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_exchangev_nb(team, dst, dst_counts, dst_offsets, src, src_counts, src_offsets, flags GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_exchangev)
+void _gasnet_coll_exchangev(gasnet_team_handle_t team,
+                            void *dst, const size_t dst_counts[], const size_t dst_offsets[],
+                            void *src, const size_t src_counts[], const size_t src_offsets[],
+                            int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  const size_t dstlen = gasnete_coll_vcoll_extent(team, dst_counts, dst_offsets);
+  const size_t srclen = gasnete_coll_vcoll_extent(team, src_counts, src_offsets);
+  GASNETI_TRACE_EVENT_VAL(W,COLL_EXCHANGEV,srclen);
+  GASNETE_COLL_VALIDATE_VCOLL(team,dst,dstlen,src,srclen,flags);
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, dstlen, 0, 0, src, srclen);
+  handle = gasnete_coll_exchangev_nb(team, dst, dst_counts, dst_offsets, src, src_counts, src_offsets, flags GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+}
@@ -5764,8 +5764,8 @@ static int gasnete_coll_pf_reduce_TreePut(gasnete_coll_op_t *op GASNETI_THREAD_F
        volatile uint32_t *state;
        size_t nbytes = args->nbytes;
        int i, done;
-       gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_tbl[args->func].fnptr;
-       uint32_t red_fn_flags = gasnete_coll_fn_tbl[args->func].flags;
+       gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(args->func)->fnptr;
+       uint32_t red_fn_flags = gasnete_coll_fn_lookup(args->func)->flags;
        uint32_t reduce_args = args->func_arg;
        
        gasneti_assert(data->p2p != NULL);
@@ -5946,8 +5946,8 @@ static int gasnete_coll_pf_reduce_TreeGet(gasnete_coll_op_t *op GASNETI_THREAD_F
         volatile uint32_t *state;
         size_t nbytes = args->nbytes;
         int i, done;
-        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_tbl[args->func].fnptr;
-        uint32_t red_fn_flags = gasnete_coll_fn_tbl[args->func].flags;
+        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(args->func)->fnptr;
+        uint32_t red_fn_flags = gasnete_coll_fn_lookup(args->func)->flags;
         uint32_t reduce_args = args->func_arg;
         gasneti_assert(data->p2p != NULL);
         gasneti_assert(data->p2p->state != NULL);
@@ -6114,7 +6114,13 @@ gasnete_coll_reduce_TreeGet(gasnet_team_handle_t team,
                                         GASNETI_THREAD_PASS);
   
 }
-static int gasnete_coll_pf_reduce_TreePutSeg(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+/* Segmented reduce: split the vector into pipeline segments of param_list[0] bytes
+   and launch one subordinate reduce per segment using (seg_fn).  The subordinates
+   progress independently, so combining segment k at one tree level overlaps with
+   forwarding segment k-1 to the level above, and the scratch space needed by each
+   level is bounded by the segment size rather than the full vector. */
+GASNETI_INLINE(gasnete_coll_pf_reduce_Seg)
+int gasnete_coll_pf_reduce_Seg(gasnete_coll_op_t *op, gasnete_coll_reduce_fn_ptr_t seg_fn GASNETI_THREAD_FARG) {
   gasnete_coll_generic_data_t *data = op->data;
   const gasnete_coll_reduce_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, reduce);
   int result =0;
@@ -6162,27 +6168,22 @@ static int gasnete_coll_pf_reduce_TreePutSeg(gasnete_coll_op_t *op GASNETI_THREA
       handle_vec->num_handles = num_elem_segs;
       handle_vec->handles = gasneti_malloc(sizeof(gasnet_coll_handle_t)*num_elem_segs);
       
-      /*
-       the TreePut routines only work w/ the single address mode and therefore we need ensure choose 
-       between TreePut and TreePutScratch which collective routine gets invoked when the we are segmenting broadcast
-       */
-      
       for(i=0; i<num_elem_segs-1; i++) {
-        handle_vec->handles[i] = gasnete_coll_reduce_TreePut(op->team, dstproc, 
-                                                             gasnete_coll_scale_ptr(args->dst, sent_elem, args->elem_size), 
-                                                             gasnete_coll_scale_ptr(args->src, sent_elem, args->elem_size), 
-                                                             args->src_blksz, args->src_offset, args->elem_size, seg_size_elem,
-                                                             args->func, args->func_arg, flags, 
-                                                            impl, op->sequence+i+1 GASNETI_THREAD_PASS);
+        handle_vec->handles[i] = (*seg_fn)(op->team, dstproc, 
+                                       gasnete_coll_scale_ptr(args->dst, sent_elem, args->elem_size), 
+                                       gasnete_coll_scale_ptr(args->src, sent_elem, args->elem_size), 
+                                       args->src_blksz, args->src_offset, args->elem_size, seg_size_elem,
+                                       args->func, args->func_arg, flags, 
+                                       impl, op->sequence+i+1 GASNETI_THREAD_PASS);
         gasnete_coll_save_coll_handle(&handle_vec->handles[i] GASNETI_THREAD_PASS);
         sent_elem+=seg_size_elem;
       }
-      handle_vec->handles[i] = gasnete_coll_reduce_TreePut(op->team, dstproc, 
-                                                           gasnete_coll_scale_ptr(args->dst, sent_elem, args->elem_size), 
-                                                           gasnete_coll_scale_ptr(args->src, sent_elem, args->elem_size), 
-                                                           args->src_blksz, args->src_offset, args->elem_size, args->elem_count - sent_elem,
-                                                           args->func, args->func_arg, flags, 
-                                                           impl, op->sequence+i+1 GASNETI_THREAD_PASS);
+      handle_vec->handles[i] = (*seg_fn)(op->team, dstproc, 
+                                       gasnete_coll_scale_ptr(args->dst, sent_elem, args->elem_size), 
+                                       gasnete_coll_scale_ptr(args->src, sent_elem, args->elem_size), 
+                                       args->src_blksz, args->src_offset, args->elem_size, args->elem_count - sent_elem,
+                                       args->func, args->func_arg, flags, 
+                                       impl, op->sequence+i+1 GASNETI_THREAD_PASS);
       gasnete_coll_save_coll_handle(&handle_vec->handles[i] GASNETI_THREAD_PASS);
       gasnete_coll_free_implementation(impl);
     }
@@ -6211,15 +6212,26 @@ static int gasnete_coll_pf_reduce_TreePutSeg(gasnete_coll_op_t *op GASNETI_THREA
   return result;
 }
 
-extern gasnet_coll_handle_t
-gasnete_coll_reduce_TreePutSeg(gasnet_team_handle_t team,
+static int gasnete_coll_pf_reduce_TreePutSeg(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_reduce_Seg(op, &gasnete_coll_reduce_TreePut GASNETI_THREAD_PASS);
+}
+static int gasnete_coll_pf_reduce_TreeGetSeg(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_reduce_Seg(op, &gasnete_coll_reduce_TreeGet GASNETI_THREAD_PASS);
+}
+static int gasnete_coll_pf_reduce_TreeEagerSeg(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_reduce_Seg(op, &gasnete_coll_reduce_TreeEager GASNETI_THREAD_PASS);
+}
+
+GASNETI_INLINE(gasnete_coll_reduce_Seg)
+gasnet_coll_handle_t
+gasnete_coll_reduce_Seg(gasnet_team_handle_t team,
                             gasnet_image_t dstimage, void *dst,
                             void *src, size_t src_blksz, size_t src_offset,
                             size_t elem_size, size_t elem_count,
                             gasnet_coll_fn_handle_t func, int func_arg,
                             int flags, 
                             gasnete_coll_implementation_t coll_params,
-                            uint32_t sequence
+                            uint32_t sequence, gasnete_coll_poll_fn poll_fn
                             GASNETI_THREAD_FARG){
   int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (flags & GASNET_COLL_IN_ALLSYNC) |
   GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(flags & GASNET_COLL_OUT_ALLSYNC)|
@@ -6245,12 +6257,55 @@ gasnete_coll_reduce_TreePutSeg(gasnet_team_handle_t team,
   
   return gasnete_coll_generic_reduce_nb(team, dstimage, dst, src, src_blksz, src_offset,
                                         elem_size, elem_count, func, func_arg, flags, 
-                                        &gasnete_coll_pf_reduce_TreePutSeg, options,
+                                        poll_fn, options,
                                         tree_info, (flags & GASNETE_COLL_SUBORDINATE ? sequence : num_segs), coll_params->num_params, coll_params->param_list, NULL
                                         GASNETI_THREAD_PASS);
   
 }
 
+extern gasnet_coll_handle_t
+gasnete_coll_reduce_TreePutSeg(gasnet_team_handle_t team,
+                            gasnet_image_t dstimage, void *dst,
+                            void *src, size_t src_blksz, size_t src_offset,
+                            size_t elem_size, size_t elem_count,
+                            gasnet_coll_fn_handle_t func, int func_arg,
+                            int flags, 
+                            gasnete_coll_implementation_t coll_params,
+                            uint32_t sequence
+                            GASNETI_THREAD_FARG){
+  return gasnete_coll_reduce_Seg(team, dstimage, dst, src, src_blksz, src_offset,
+                                 elem_size, elem_count, func, func_arg, flags, coll_params,
+                                 sequence, &gasnete_coll_pf_reduce_TreePutSeg GASNETI_THREAD_PASS);
+}
+extern gasnet_coll_handle_t
+gasnete_coll_reduce_TreeGetSeg(gasnet_team_handle_t team,
+                            gasnet_image_t dstimage, void *dst,
+                            void *src, size_t src_blksz, size_t src_offset,
+                            size_t elem_size, size_t elem_count,
+                            gasnet_coll_fn_handle_t func, int func_arg,
+                            int flags, 
+                            gasnete_coll_implementation_t coll_params,
+                            uint32_t sequence
+                            GASNETI_THREAD_FARG){
+  return gasnete_coll_reduce_Seg(team, dstimage, dst, src, src_blksz, src_offset,
+                                 elem_size, elem_count, func, func_arg, flags, coll_params,
+                                 sequence, &gasnete_coll_pf_reduce_TreeGetSeg GASNETI_THREAD_PASS);
+}
+extern gasnet_coll_handle_t
+gasnete_coll_reduce_TreeEagerSeg(gasnet_team_handle_t team,
+                            gasnet_image_t dstimage, void *dst,
+                            void *src, size_t src_blksz, size_t src_offset,
+                            size_t elem_size, size_t elem_count,
+                            gasnet_coll_fn_handle_t func, int func_arg,
+                            int flags, 
+                            gasnete_coll_implementation_t coll_params,
+                            uint32_t sequence
+                            GASNETI_THREAD_FARG){
+  return gasnete_coll_reduce_Seg(team, dstimage, dst, src, src_blksz, src_offset,
+                                 elem_size, elem_count, func, func_arg, flags, coll_params,
+                                 sequence, &gasnete_coll_pf_reduce_TreeEagerSeg GASNETI_THREAD_PASS);
+}
+
 
 
 static int gasnete_coll_pf_reduceM_TreePut(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
@@ -6296,8 +6351,8 @@ static int gasnete_coll_pf_reduceM_TreePut(gasnete_coll_op_t *op GASNETI_THREAD_
         volatile uint32_t *state;
         size_t nbytes = args->nbytes;
         int i, done;
-        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_tbl[args->func].fnptr;
-        uint32_t red_fn_flags = gasnete_coll_fn_tbl[args->func].flags;
+        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(args->func)->fnptr;
+        uint32_t red_fn_flags = gasnete_coll_fn_lookup(args->func)->flags;
         uint32_t reduce_args = args->func_arg;
         
         gasneti_assert(data->p2p != NULL);
@@ -6490,8 +6545,8 @@ static int gasnete_coll_pf_reduceM_TreeGet(gasnete_coll_op_t *op GASNETI_THREAD_
         volatile uint32_t *state;
         size_t nbytes = args->nbytes;
         int i, done;
-        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_tbl[args->func].fnptr;
-        uint32_t red_fn_flags = gasnete_coll_fn_tbl[args->func].flags;
+        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(args->func)->fnptr;
+        uint32_t red_fn_flags = gasnete_coll_fn_lookup(args->func)->flags;
         uint32_t reduce_args = args->func_arg;
         gasneti_assert(data->p2p != NULL);
         gasneti_assert(data->p2p->state != NULL);
@@ -6651,7 +6706,9 @@ gasnete_coll_reduceM_TreeGet(gasnet_team_handle_t team,
   
 }
 
-static int gasnete_coll_pf_reduceM_TreePutSeg(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+/* Multi-address variant of gasnete_coll_pf_reduce_Seg */
+GASNETI_INLINE(gasnete_coll_pf_reduceM_Seg)
+int gasnete_coll_pf_reduceM_Seg(gasnete_coll_op_t *op, gasnete_coll_reduceM_fn_ptr_t seg_fn GASNETI_THREAD_FARG) {
   gasnete_coll_generic_data_t *data = op->data;
   const gasnete_coll_reduceM_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, reduceM);
   int result =0;
@@ -6703,29 +6760,24 @@ static int gasnete_coll_pf_reduceM_TreePutSeg(gasnete_coll_op_t *op GASNETI_THRE
       handle_vec->handles = gasneti_malloc(sizeof(gasnet_coll_handle_t)*num_elem_segs);
       addrs = (void**) ((int8_t*) data->private_data + sizeof(gasnete_coll_handle_vec_t));
             
-      /*
-       the TreePut routines only work w/ the single address mode and therefore we need ensure choose 
-       between TreePut and TreePutScratch which collective routine gets invoked when the we are segmenting broadcast
-       */
-      
       for(i=0; i<num_elem_segs-1; i++) {
         gasnete_coll_scale_ptrM(addrs, args->srclist, sent_elem, args->elem_size, numaddrs); 
-        handle_vec->handles[i] = gasnete_coll_reduceM_TreePut(op->team, dstproc, 
-                                                             gasnete_coll_scale_ptr(args->dst, sent_elem, args->elem_size), 
-                                                             addrs,
-                                                             args->src_blksz, args->src_offset, args->elem_size, seg_size_elem,
-                                                             args->func, args->func_arg, flags, 
-                                                             impl, op->sequence+i+1 GASNETI_THREAD_PASS);
+        handle_vec->handles[i] = (*seg_fn)(op->team, dstproc, 
+                                       gasnete_coll_scale_ptr(args->dst, sent_elem, args->elem_size), 
+                                       addrs,
+                                       args->src_blksz, args->src_offset, args->elem_size, seg_size_elem,
+                                       args->func, args->func_arg, flags, 
+                                       impl, op->sequence+i+1 GASNETI_THREAD_PASS);
         gasnete_coll_save_coll_handle(&handle_vec->handles[i] GASNETI_THREAD_PASS);
         sent_elem+=seg_size_elem;
       }
       gasnete_coll_scale_ptrM(addrs, args->srclist, sent_elem, args->elem_size, numaddrs); 
-      handle_vec->handles[i] = gasnete_coll_reduceM_TreePut(op->team, dstproc, 
-                                                           gasnete_coll_scale_ptr(args->dst, sent_elem, args->elem_size), 
-                                                           addrs, 
-                                                           args->src_blksz, args->src_offset, args->elem_size, args->elem_count - sent_elem,
-                                                           args->func, args->func_arg, flags, 
-                                                           impl, op->sequence+i+1 GASNETI_THREAD_PASS);
+      handle_vec->handles[i] = (*seg_fn)(op->team, dstproc, 
+                                       gasnete_coll_scale_ptr(args->dst, sent_elem, args->elem_size), 
+                                       addrs, 
+                                       args->src_blksz, args->src_offset, args->elem_size, args->elem_count - sent_elem,
+                                       args->func, args->func_arg, flags, 
+                                       impl, op->sequence+i+1 GASNETI_THREAD_PASS);
       gasnete_coll_save_coll_handle(&handle_vec->handles[i] GASNETI_THREAD_PASS);
       gasnete_coll_free_implementation(impl);
     }
@@ -6754,15 +6806,26 @@ static int gasnete_coll_pf_reduceM_TreePutSeg(gasnete_coll_op_t *op GASNETI_THRE
   return result;
 }
 
-extern gasnet_coll_handle_t
-gasnete_coll_reduceM_TreePutSeg(gasnet_team_handle_t team,
+static int gasnete_coll_pf_reduceM_TreePutSeg(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_reduceM_Seg(op, &gasnete_coll_reduceM_TreePut GASNETI_THREAD_PASS);
+}
+static int gasnete_coll_pf_reduceM_TreeGetSeg(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_reduceM_Seg(op, &gasnete_coll_reduceM_TreeGet GASNETI_THREAD_PASS);
+}
+static int gasnete_coll_pf_reduceM_TreeEagerSeg(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_reduceM_Seg(op, &gasnete_coll_reduceM_TreeEager GASNETI_THREAD_PASS);
+}
+
+GASNETI_INLINE(gasnete_coll_reduceM_Seg)
+gasnet_coll_handle_t
+gasnete_coll_reduceM_Seg(gasnet_team_handle_t team,
                                gasnet_image_t dstimage, void *dst,
                                void * const srclist[], size_t src_blksz, size_t src_offset,
                                size_t elem_size, size_t elem_count,
                                gasnet_coll_fn_handle_t func, int func_arg,
                                int flags, 
                                gasnete_coll_implementation_t coll_params,
-                               uint32_t sequence
+                               uint32_t sequence, gasnete_coll_poll_fn poll_fn
                                GASNETI_THREAD_FARG){
   int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (flags & GASNET_COLL_IN_ALLSYNC) |
   GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(flags & GASNET_COLL_OUT_ALLSYNC)|
@@ -6788,9 +6851,890 @@ gasnete_coll_reduceM_TreePutSeg(gasnet_team_handle_t team,
   
   return gasnete_coll_generic_reduceM_nb(team, dstimage, dst, srclist, src_blksz, src_offset,
                                         elem_size, elem_count, func, func_arg, flags, 
-                                        &gasnete_coll_pf_reduceM_TreePutSeg, options,
+                                        poll_fn, options,
                                         tree_info, (flags & GASNETE_COLL_SUBORDINATE ? sequence : num_segs), coll_params->num_params, coll_params->param_list, NULL
                                         GASNETI_THREAD_PASS);
   
 }
 
+extern gasnet_coll_handle_t
+gasnete_coll_reduceM_TreePutSeg(gasnet_team_handle_t team,
+                               gasnet_image_t dstimage, void *dst,
+                               void * const srclist[], size_t src_blksz, size_t src_offset,
+                               size_t elem_size, size_t elem_count,
+                               gasnet_coll_fn_handle_t func, int func_arg,
+                               int flags, 
+                               gasnete_coll_implementation_t coll_params,
+                               uint32_t sequence
+                               GASNETI_THREAD_FARG){
+  return gasnete_coll_reduceM_Seg(team, dstimage, dst, srclist, src_blksz, src_offset,
+                                  elem_size, elem_count, func, func_arg, flags, coll_params,
+                                  sequence, &gasnete_coll_pf_reduceM_TreePutSeg GASNETI_THREAD_PASS);
+}
+extern gasnet_coll_handle_t
+gasnete_coll_reduceM_TreeGetSeg(gasnet_team_handle_t team,
+                               gasnet_image_t dstimage, void *dst,
+                               void * const srclist[], size_t src_blksz, size_t src_offset,
+                               size_t elem_size, size_t elem_count,
+                               gasnet_coll_fn_handle_t func, int func_arg,
+                               int flags, 
+                               gasnete_coll_implementation_t coll_params,
+                               uint32_t sequence
+                               GASNETI_THREAD_FARG){
+  return gasnete_coll_reduceM_Seg(team, dstimage, dst, srclist, src_blksz, src_offset,
+                                  elem_size, elem_count, func, func_arg, flags, coll_params,
+                                  sequence, &gasnete_coll_pf_reduceM_TreeGetSeg GASNETI_THREAD_PASS);
+}
+extern gasnet_coll_handle_t
+gasnete_coll_reduceM_TreeEagerSeg(gasnet_team_handle_t team,
+                               gasnet_image_t dstimage, void *dst,
+                               void * const srclist[], size_t src_blksz, size_t src_offset,
+                               size_t elem_size, size_t elem_count,
+                               gasnet_coll_fn_handle_t func, int func_arg,
+                               int flags, 
+                               gasnete_coll_implementation_t coll_params,
+                               uint32_t sequence
+                               GASNETI_THREAD_FARG){
+  return gasnete_coll_reduceM_Seg(team, dstimage, dst, srclist, src_blksz, src_offset,
+                                  elem_size, elem_count, func, func_arg, flags, coll_params,
+                                  sequence, &gasnete_coll_pf_reduceM_TreeEagerSeg GASNETI_THREAD_PASS);
+}
+
+
+/*---------------------------------------------------------------------------------*/
+/* gasnete_coll_allreduce_nb() and gasnete_coll_allreduceM_nb() */
+
+/* The recursive-doubling and Rabenseifner allreduce algorithms pair the ranks of
+ * a power-of-two subset of the team.  When the team size P is not a power of two,
+ * the first 2*(P-pof2) ranks are folded pairwise: each even rank hands its
+ * contribution to the odd rank above it and waits for the final result.  The
+ * surviving ranks keep their relative order and phases use ascending masks, so
+ * every partial result covers a contiguous range of ranks and is combined with the
+ * lower range as the left operand.  This keeps non-commutative operators correct.
+ */
+typedef struct {
+  gasnet_node_t *peers;       /* scratch peers: fold partner (if any) then one per phase (stored inline) */
+  int nphases;                /* log2(pof2) */
+  int newrank;                /* rank among the pof2 participants, or -1 if folded out */
+  int fold;                   /* non-zero if peers[0] is a fold partner */
+  int step;                   /* current step of the algorithm */
+  int phase;                  /* current phase within a step */
+  int sent;                   /* non-zero once this phase's contribution has been sent */
+  int8_t *acc;                /* location of the running partial result */
+} gasnete_coll_allreduce_sched_t;
+
+/* Builds the schedule and the scratch request for this rank.
+ * Each peer is sent at most (incoming_size) bytes.
+ * The schedule is a single allocation, released with gasneti_free().
+ */
+static gasnete_coll_allreduce_sched_t *
+gasnete_coll_allreduce_sched_init(gasnet_team_handle_t team, size_t incoming_size,
+                                  gasnete_coll_scratch_req_t **scratch_req_p) {
+  gasnete_coll_allreduce_sched_t *sched;
+  const gasnet_node_t myrank = team->myrank;
+  int pof2 = 1, nphases = 0, rem, npeers = 0, i;
+
+  while (2*pof2 <= team->total_ranks) { pof2 *= 2; nphases++; }
+  rem = team->total_ranks - pof2;
+
+  sched = gasneti_calloc(1, sizeof(gasnete_coll_allreduce_sched_t) + sizeof(gasnet_node_t)*(nphases+1));
+  sched->peers = (gasnet_node_t *)(sched + 1);
+  sched->nphases = nphases;
+  if (myrank < 2*rem) {
+    sched->fold = 1;
+    if (myrank % 2 == 0) {
+      sched->newrank = -1;
+      sched->peers[npeers++] = myrank + 1;
+    } else {
+      sched->newrank = myrank / 2;
+      sched->peers[npeers++] = myrank - 1;
+    }
+  } else {
+    sched->newrank = myrank - rem;
+  }
+  if (sched->newrank >= 0) {
+    for (i = 0; i < nphases; ++i) {
+      int pn = sched->newrank ^ (1 << i);
+      sched->peers[npeers++] = (pn < rem) ? (2*pn + 1) : (pn + rem);
+    }
+  }
+
+  if (team->total_ranks > 1) {
+    gasnete_coll_scratch_req_t *scratch_req = gasneti_calloc(1, sizeof(gasnete_coll_scratch_req_t));
+    /* Exchanges are symmetric: every peer we write to also writes to us */
+    scratch_req->op_type = GASNETE_COLL_DISSEM_OP;
+    scratch_req->team = team;
+    scratch_req->tree_dir = GASNETE_COLL_UP_TREE;
+    scratch_req->incoming_size = incoming_size;
+    scratch_req->num_in_peers = scratch_req->num_out_peers = npeers;
+    scratch_req->in_peers = scratch_req->out_peers = sched->peers;
+    scratch_req->out_sizes = (uint64_t*) gasneti_malloc(sizeof(uint64_t)*1);
+    scratch_req->out_sizes[0] = incoming_size;
+    *scratch_req_p = scratch_req;
+  } else {
+    *scratch_req_p = NULL;
+  }
+
+  return sched;
+}
+
+#define GASNETE_COLL_ALLREDUCE_MYSCRATCH(op) \
+  ((int8_t*)(op)->team->scratch_segs[(op)->team->myrank].addr + (op)->myscratchpos)
+#define GASNETE_COLL_ALLREDUCE_PEERSCRATCH(op,sched,idx) \
+  ((int8_t*)(op)->team->scratch_segs[(sched)->peers[(idx)]].addr + (op)->scratchpos[(idx)])
+
+/* Combine an incoming partial result with the local one, keeping rank order.
+ * If the sender is lower ranked the result is left in (in), otherwise in (acc).
+ */
+GASNETI_INLINE(gasnete_coll_allreduce_combine)
+void gasnete_coll_allreduce_combine(int sender_is_lower, void *acc, void *in, size_t elem_count,
+                                    size_t elem_size, gasnet_coll_fn_handle_t func, int func_arg) {
+  gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(func)->fnptr;
+  uint32_t red_fn_flags = gasnete_coll_fn_lookup(func)->flags;
+
+  if (sender_is_lower) {
+    (*reduce_fn)(in, elem_count, in, elem_count, acc, elem_size, red_fn_flags, func_arg);
+  } else {
+    (*reduce_fn)(acc, elem_count, acc, elem_count, in, elem_size, red_fn_flags, func_arg);
+  }
+}
+
+/* Fold step shared by both algorithms, using scratch slot 0 and p2p state 0.
+ * Returns non-zero once this rank may go on to the exchange phases. 
+ */
+static int gasnete_coll_allreduce_fold(gasnete_coll_op_t *op, gasnete_coll_allreduce_sched_t *sched,
+                                       size_t elem_size, size_t elem_count,
+                                       gasnet_coll_fn_handle_t func, int func_arg) {
+  if (sched->fold) {
+    gasnete_coll_generic_data_t *data = op->data;
+    int8_t *slot0 = GASNETE_COLL_ALLREDUCE_MYSCRATCH(op);
+
+    if (sched->newrank < 0) {
+      gasnete_coll_p2p_signalling_put(op, GASNETE_COLL_REL2ACT(op->team, sched->peers[0]),
+                                      GASNETE_COLL_ALLREDUCE_PEERSCRATCH(op, sched, 0),
+                                      sched->acc, elem_size*elem_count, 0, 1);
+    } else {
+      if (data->p2p->state[0] != 1) return 0;
+      gasneti_sync_reads();
+      gasnete_coll_allreduce_combine(1, sched->acc, slot0, elem_count, elem_size, func, func_arg);
+      sched->acc = slot0;
+    }
+  }
+  return 1;
+}
+
+/* Unfold step shared by both algorithms: return the result (at res) to the folded-out rank.
+ * Returns non-zero once the result is in dst.
+ */
+static int gasnete_coll_allreduce_unfold(gasnete_coll_op_t *op, gasnete_coll_allreduce_sched_t *sched,
+                                         void *dst, void *res, size_t nbytes) {
+  gasnete_coll_generic_data_t *data = op->data;
+
+  if (sched->fold && sched->newrank < 0) {
+    if (data->p2p->state[0] != 1) return 0;
+    gasneti_sync_reads();
+    GASNETE_FAST_UNALIGNED_MEMCPY(dst, GASNETE_COLL_ALLREDUCE_MYSCRATCH(op), nbytes);
+  } else {
+    if (sched->fold) {
+      gasnete_coll_p2p_signalling_put(op, GASNETE_COLL_REL2ACT(op->team, sched->peers[0]),
+                                      GASNETE_COLL_ALLREDUCE_PEERSCRATCH(op, sched, 0),
+                                      res, nbytes, 0, 1);
+    }
+    GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(dst, res, nbytes);
+  }
+  return 1;
+}
+
+/* Recursive doubling: every phase exchanges the full vector with the partner.
+ * Scratch: slot 0 for the fold, then one slot of nbytes per phase.
+ * Returns non-zero once the result is in dst.
+ */
+static int gasnete_coll_allreduce_RecDbl_step(gasnete_coll_op_t *op, gasnete_coll_allreduce_sched_t *sched,
+                                              void *dst, size_t elem_size, size_t elem_count,
+                                              gasnet_coll_fn_handle_t func, int func_arg) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const size_t nbytes = elem_size*elem_count;
+
+  if (sched->step == 0) {
+    if (!gasnete_coll_allreduce_fold(op, sched, elem_size, elem_count, func, func_arg)) return 0;
+    sched->step = (sched->newrank < 0) ? 2 : 1;
+  }
+  if (sched->step == 1) {
+    while (sched->phase < sched->nphases) {
+      const int idx = sched->fold + sched->phase;
+      const int slot = 1 + sched->phase;
+      int8_t *in = GASNETE_COLL_ALLREDUCE_MYSCRATCH(op) + slot*nbytes;
+
+      if (!sched->sent) {
+        gasnete_coll_p2p_signalling_put(op, GASNETE_COLL_REL2ACT(op->team, sched->peers[idx]),
+                                        GASNETE_COLL_ALLREDUCE_PEERSCRATCH(op, sched, idx) + slot*nbytes,
+                                        sched->acc, nbytes, slot, 1);
+        sched->sent = 1;
+      }
+      if (data->p2p->state[slot] != 1) return 0;
+      gasneti_sync_reads();
+      if (sched->peers[idx] < op->team->myrank) {
+        gasnete_coll_allreduce_combine(1, sched->acc, in, elem_count, elem_size, func, func_arg);
+        sched->acc = in;
+      } else {
+        gasnete_coll_allreduce_combine(0, sched->acc, in, elem_count, elem_size, func, func_arg);
+      }
+      sched->phase++;
+      sched->sent = 0;
+    }
+    sched->step = 2;
+  }
+  if (sched->step == 2) {
+    if (!gasnete_coll_allreduce_unfold(op, sched, dst, sched->acc, nbytes)) return 0;
+    sched->step = 3;
+  }
+  return 1;
+}
+
+/* Element range [lo,hi) owned by (newrank) after (levels) halvings of (count) elements */
+GASNETI_INLINE(gasnete_coll_allreduce_range)
+void gasnete_coll_allreduce_range(int newrank, int levels, size_t count, size_t *lo, size_t *hi) {
+  size_t l = 0, h = count;
+  int j;
+  for (j = 0; j < levels; ++j) {
+    size_t mid = l + (h - l)/2;
+    if ((newrank >> j) & 1) l = mid; else h = mid;
+  }
+  *lo = l; *hi = h;
+}
+
+/* Offset (in elements) within the reduce-scatter region at which (newrank) receives in phase k */
+GASNETI_INLINE(gasnete_coll_allreduce_rs_offset)
+size_t gasnete_coll_allreduce_rs_offset(int newrank, int k, size_t count) {
+  size_t off = 0, lo, hi;
+  int j;
+  for (j = 0; j < k; ++j) {
+    gasnete_coll_allreduce_range(newrank, j+1, count, &lo, &hi);
+    off += hi - lo;
+  }
+  return off;
+}
+
+/* Rabenseifner: a recursive-halving reduce-scatter followed by a recursive-doubling
+ * allgather, so each rank sends about 2*nbytes in total regardless of the team size.
+ * Scratch: slot 0 (nbytes) for the fold, the reduce-scatter region
+ * (nbytes + nphases elements) and the allgather region (nbytes).
+ * Returns non-zero once the result is in dst.
+ */
+#define GASNETE_COLL_ALLREDUCE_RAB_SCRATCH_SIZE(nbytes,nphases,elem_size) \
+  (3*(nbytes) + (nphases)*(elem_size))
+static int gasnete_coll_allreduce_Rabenseifner_step(gasnete_coll_op_t *op, gasnete_coll_allreduce_sched_t *sched,
+                                                    void *dst, size_t elem_size, size_t elem_count,
+                                                    gasnet_coll_fn_handle_t func, int func_arg) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const size_t nbytes = elem_size*elem_count;
+  const size_t rs_base = nbytes;
+  const size_t ag_base = 2*nbytes + sched->nphases*elem_size;
+  int8_t *myscratch = GASNETE_COLL_ALLREDUCE_MYSCRATCH(op);
+  size_t lo, hi;
+
+  if (sched->step == 0) {
+    if (!gasnete_coll_allreduce_fold(op, sched, elem_size, elem_count, func, func_arg)) return 0;
+    sched->step = (sched->newrank < 0) ? 3 : 1;
+  }
+  if (sched->step == 1) { /* reduce-scatter */
+    while (sched->phase < sched->nphases) {
+      const int k = sched->phase;
+      const int idx = sched->fold + k;
+      const int pn = sched->newrank ^ (1 << k);
+
+      if (!sched->sent) {
+        gasnete_coll_allreduce_range(pn, k+1, elem_count, &lo, &hi);
+        gasnete_coll_p2p_signalling_put(op, GASNETE_COLL_REL2ACT(op->team, sched->peers[idx]),
+                                        GASNETE_COLL_ALLREDUCE_PEERSCRATCH(op, sched, idx) + rs_base +
+                                        gasnete_coll_allreduce_rs_offset(pn, k, elem_count)*elem_size,
+                                        sched->acc + lo*elem_size, (hi-lo)*elem_size, 1+k, 1);
+        sched->sent = 1;
+      }
+      if (data->p2p->state[1+k] != 1) return 0;
+      gasneti_sync_reads();
+      gasnete_coll_allreduce_range(sched->newrank, k+1, elem_count, &lo, &hi);
+      {
+        int8_t *in = myscratch + rs_base + gasnete_coll_allreduce_rs_offset(sched->newrank, k, elem_count)*elem_size;
+        int8_t *mine = sched->acc + lo*elem_size;
+        if (pn < sched->newrank) {
+          gasnete_coll_allreduce_combine(1, mine, in, hi-lo, elem_size, func, func_arg);
+          GASNETE_FAST_UNALIGNED_MEMCPY(mine, in, (hi-lo)*elem_size);
+        } else {
+          gasnete_coll_allreduce_combine(0, mine, in, hi-lo, elem_size, func, func_arg);
+        }
+      }
+      sched->phase++;
+      sched->sent = 0;
+    }
+    /* seed the allgather with the fully reduced block */
+    gasnete_coll_allreduce_range(sched->newrank, sched->nphases, elem_count, &lo, &hi);
+    GASNETE_FAST_UNALIGNED_MEMCPY(myscratch + ag_base + lo*elem_size, sched->acc + lo*elem_size, (hi-lo)*elem_size);
+    sched->phase = 0;
+    sched->step = 2;
+  }
+  if (sched->step == 2) { /* allgather, in the reverse phase order */
+    while (sched->phase < sched->nphases) {
+      const int k = sched->nphases - 1 - sched->phase;
+      const int idx = sched->fold + k;
+
+      if (!sched->sent) {
+        gasnete_coll_allreduce_range(sched->newrank, k+1, elem_count, &lo, &hi);
+        gasnete_coll_p2p_signalling_put(op, GASNETE_COLL_REL2ACT(op->team, sched->peers[idx]),
+                                        GASNETE_COLL_ALLREDUCE_PEERSCRATCH(op, sched, idx) + ag_base + lo*elem_size,
+                                        myscratch + ag_base + lo*elem_size, (hi-lo)*elem_size,
+                                        1 + sched->nphases + k, 1);
+        sched->sent = 1;
+      }
+      if (data->p2p->state[1 + sched->nphases + k] != 1) return 0;
+      gasneti_sync_reads();
+      sched->phase++;
+      sched->sent = 0;
+    }
+    sched->step = 3;
+  }
+  if (sched->step == 3) {
+    if (!gasnete_coll_allreduce_unfold(op, sched, dst, myscratch + ag_base, nbytes)) return 0;
+    sched->step = 4;
+  }
+  return 1;
+}
+
+typedef int (*gasnete_coll_allreduce_step_fn_t)(gasnete_coll_op_t *op, gasnete_coll_allreduce_sched_t *sched,
+                                                void *dst, size_t elem_size, size_t elem_count,
+                                                gasnet_coll_fn_handle_t func, int func_arg);
+
+GASNETI_INLINE(gasnete_coll_pf_allreduce_common)
+int gasnete_coll_pf_allreduce_common(gasnete_coll_op_t *op, gasnete_coll_allreduce_step_fn_t step_fn GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  gasnete_coll_allreduce_sched_t *sched = data->private_data;
+  const gasnete_coll_allreduce_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, allreduce);
+  int result = 0;
+
+  switch (data->state) {
+  case 0:	/* Allocate scratch space */
+    if (op->team->total_ranks > 1 && !gasnete_coll_scratch_alloc_nb(op GASNETI_THREAD_PASS)) {
+      break;
+    }
+    data->state = 1; GASNETI_FALLTHROUGH
+
+  case 1:	/* Optional IN barrier, then load our contribution */
+    if (!gasnete_coll_generic_all_threads(data) ||
+        !gasnete_coll_generic_insync(op->team, data)) {
+      break;
+    }
+    GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(args->dst, args->src, args->nbytes);
+    sched->acc = args->dst;
+    data->state = 2; GASNETI_FALLTHROUGH
+
+  case 2:	/* Data movement */
+    if (op->team->total_ranks > 1 &&
+        !(*step_fn)(op, sched, args->dst, args->elem_size, args->elem_count, args->func, args->func_arg)) {
+      break;
+    }
+    gasneti_sync_writes();
+    data->state = 3; GASNETI_FALLTHROUGH
+
+  case 3:	/* Optional OUT barrier */
+    if (!gasnete_coll_generic_outsync(op->team, data)) {
+      break;
+    }
+    if (op->team->total_ranks > 1) gasnete_coll_free_scratch(op);
+    gasneti_free(sched);
+    gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+    result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+GASNETI_INLINE(gasnete_coll_pf_allreduceM_common)
+int gasnete_coll_pf_allreduceM_common(gasnete_coll_op_t *op, gasnete_coll_allreduce_step_fn_t step_fn GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  gasnete_coll_allreduce_sched_t *sched = data->private_data;
+  const gasnete_coll_allreduceM_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, allreduceM);
+  void * const *dstlist = &GASNETE_COLL_MY_1ST_IMAGE(op->team, args->dstlist, op->flags);
+  int result = 0;
+
+  switch (data->state) {
+  case 0:	/* Allocate scratch space */
+    if (op->team->total_ranks > 1 && !gasnete_coll_scratch_alloc_nb(op GASNETI_THREAD_PASS)) {
+      break;
+    }
+    data->state = 1; GASNETI_FALLTHROUGH
+
+  case 1:	/* Optional IN barrier, then reduce our images' contributions */
+    if (!gasnete_coll_threads_ready2(op, args->dstlist, args->srclist GASNETI_THREAD_PASS) ||
+        !gasnete_coll_generic_insync(op->team, data)) {
+      break;
+    }
+    gasnete_coll_local_reduce(op->team->my_images, dstlist[0],
+                              &GASNETE_COLL_MY_1ST_IMAGE(op->team, args->srclist, op->flags),
+                              args->elem_size, args->elem_count, args->func, args->func_arg);
+    sched->acc = dstlist[0];
+    data->state = 2; GASNETI_FALLTHROUGH
+
+  case 2:	/* Data movement */
+    if (op->team->total_ranks > 1 &&
+        !(*step_fn)(op, sched, dstlist[0], args->elem_size, args->elem_count, args->func, args->func_arg)) {
+      break;
+    }
+    {
+      gasnet_image_t i;
+      for (i = 1; i < op->team->my_images; ++i) {
+        GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(dstlist[i], dstlist[0], args->nbytes);
+      }
+    }
+    gasneti_sync_writes();
+    data->state = 3; GASNETI_FALLTHROUGH
+
+  case 3:	/* Optional OUT barrier */
+    if (!gasnete_coll_generic_outsync(op->team, data)) {
+      break;
+    }
+    if (op->team->total_ranks > 1) gasnete_coll_free_scratch(op);
+    gasneti_free(sched);
+    gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+    result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+static int gasnete_coll_pf_allreduce_RecDbl(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_allreduce_common(op, &gasnete_coll_allreduce_RecDbl_step GASNETI_THREAD_PASS);
+}
+static int gasnete_coll_pf_allreduce_Rabenseifner(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_allreduce_common(op, &gasnete_coll_allreduce_Rabenseifner_step GASNETI_THREAD_PASS);
+}
+static int gasnete_coll_pf_allreduceM_RecDbl(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_allreduceM_common(op, &gasnete_coll_allreduce_RecDbl_step GASNETI_THREAD_PASS);
+}
+static int gasnete_coll_pf_allreduceM_Rabenseifner(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  return gasnete_coll_pf_allreduceM_common(op, &gasnete_coll_allreduce_Rabenseifner_step GASNETI_THREAD_PASS);
+}
+
+/* Since no data is written into user buffers of other ranks, IN_MYSYNC and OUT_MYSYNC
+   are naturally satisfied and only the ALLSYNC modes need a barrier */
+#define GASNETE_COLL_ALLREDUCE_OPTIONS(flags) \
+  (GASNETE_COLL_GENERIC_OPT_INSYNC_IF ((flags) & GASNET_COLL_IN_ALLSYNC) | \
+   GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF((flags) & GASNET_COLL_OUT_ALLSYNC) | \
+   GASNETE_COLL_GENERIC_OPT_P2P | GASNETE_COLL_USE_SCRATCH)
+
+GASNETI_INLINE(gasnete_coll_allreduce_nphases)
+int gasnete_coll_allreduce_nphases(gasnet_team_handle_t team) {
+  int nphases = 0;
+  while ((2 << nphases) <= team->total_ranks) nphases++;
+  return nphases;
+}
+
+extern gasnet_coll_handle_t
+gasnete_coll_allreduce_RecDbl(gasnet_team_handle_t team,
+                              void *dst, void *src,
+                              size_t elem_size, size_t elem_count,
+                              gasnet_coll_fn_handle_t func, int func_arg,
+                              int flags, 
+                              gasnete_coll_implementation_t coll_params,
+                              uint32_t sequence
+                              GASNETI_THREAD_FARG) {
+  gasnete_coll_scratch_req_t *scratch_req;
+  gasnete_coll_allreduce_sched_t *sched =
+    gasnete_coll_allreduce_sched_init(team, elem_size*elem_count*(gasnete_coll_allreduce_nphases(team)+1),
+                                      &scratch_req);
+
+  return gasnete_coll_generic_allreduce_nb(team, dst, src, elem_size, elem_count, func, func_arg, flags,
+                                           &gasnete_coll_pf_allreduce_RecDbl, GASNETE_COLL_ALLREDUCE_OPTIONS(flags),
+                                           sched, sequence, coll_params->num_params, coll_params->param_list, scratch_req
+                                           GASNETI_THREAD_PASS);
+}
+
+extern gasnet_coll_handle_t
+gasnete_coll_allreduce_Rabenseifner(gasnet_team_handle_t team,
+                                    void *dst, void *src,
+                                    size_t elem_size, size_t elem_count,
+                                    gasnet_coll_fn_handle_t func, int func_arg,
+                                    int flags, 
+                                    gasnete_coll_implementation_t coll_params,
+                                    uint32_t sequence
+                                    GASNETI_THREAD_FARG) {
+  gasnete_coll_scratch_req_t *scratch_req;
+  gasnete_coll_allreduce_sched_t *sched =
+    gasnete_coll_allreduce_sched_init(team,
+                                      GASNETE_COLL_ALLREDUCE_RAB_SCRATCH_SIZE(elem_size*elem_count,
+                                                                              gasnete_coll_allreduce_nphases(team), elem_size),
+                                      &scratch_req);
+
+  return gasnete_coll_generic_allreduce_nb(team, dst, src, elem_size, elem_count, func, func_arg, flags,
+                                           &gasnete_coll_pf_allreduce_Rabenseifner, GASNETE_COLL_ALLREDUCE_OPTIONS(flags),
+                                           sched, sequence, coll_params->num_params, coll_params->param_list, scratch_req
+                                           GASNETI_THREAD_PASS);
+}
+
+extern gasnet_coll_handle_t
+gasnete_coll_allreduceM_RecDbl(gasnet_team_handle_t team,
+                               void * const dstlist[], void * const srclist[],
+                               size_t elem_size, size_t elem_count,
+                               gasnet_coll_fn_handle_t func, int func_arg,
+                               int flags, 
+                               gasnete_coll_implementation_t coll_params,
+                               uint32_t sequence
+                               GASNETI_THREAD_FARG) {
+  gasnete_coll_scratch_req_t *scratch_req;
+  gasnete_coll_allreduce_sched_t *sched =
+    gasnete_coll_allreduce_sched_init(team, elem_size*elem_count*(gasnete_coll_allreduce_nphases(team)+1),
+                                      &scratch_req);
+
+  return gasnete_coll_generic_allreduceM_nb(team, dstlist, srclist, elem_size, elem_count, func, func_arg, flags,
+                                            &gasnete_coll_pf_allreduceM_RecDbl, GASNETE_COLL_ALLREDUCE_OPTIONS(flags),
+                                            sched, sequence, coll_params->num_params, coll_params->param_list, scratch_req
+                                            GASNETI_THREAD_PASS);
+}
+
+extern gasnet_coll_handle_t
+gasnete_coll_allreduceM_Rabenseifner(gasnet_team_handle_t team,
+                                     void * const dstlist[], void * const srclist[],
+                                     size_t elem_size, size_t elem_count,
+                                     gasnet_coll_fn_handle_t func, int func_arg,
+                                     int flags, 
+                                     gasnete_coll_implementation_t coll_params,
+                                     uint32_t sequence
+                                     GASNETI_THREAD_FARG) {
+  gasnete_coll_scratch_req_t *scratch_req;
+  gasnete_coll_allreduce_sched_t *sched =
+    gasnete_coll_allreduce_sched_init(team,
+                                      GASNETE_COLL_ALLREDUCE_RAB_SCRATCH_SIZE(elem_size*elem_count,
+                                                                              gasnete_coll_allreduce_nphases(team), elem_size),
+                                      &scratch_req);
+
+  return gasnete_coll_generic_allreduceM_nb(team, dstlist, srclist, elem_size, elem_count, func, func_arg, flags,
+                                            &gasnete_coll_pf_allreduceM_Rabenseifner, GASNETE_COLL_ALLREDUCE_OPTIONS(flags),
+                                            sched, sequence, coll_params->num_params, coll_params->param_list, scratch_req
+                                            GASNETI_THREAD_PASS);
+}
+
+#if GASNET_PSHM
+/*---------------------------------------------------------------------------------*/
+/* PSHM algorithms */
+
+/* These are valid only when every member of the team shares our supernode
+ * (see GASNETE_COLL_TEAM_IS_PSHM()).  Since all segments are cross-mapped,
+ * data moves by direct loads and stores on the peers' segments and no
+ * AMs are sent for the data movement.  The optional IN/OUT barriers go
+ * through the team barrier, which is itself PSHM-based on such teams.
+ * Valid for SINGLE only, any size.
+ */
+#define GASNETE_COLL_PSHM_ADDR(team, rank, addr) \
+        gasneti_pshm_addr2local(GASNETE_COLL_REL2ACT(team, rank), (addr))
+
+/* bcast PSHM: all nodes copy directly out of the root's source */
+static int gasnete_coll_pf_bcast_PSHM(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_broadcast_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, broadcast);
+  int result = 0;
+
+  switch (data->state) {
+    case 0:	/* Optional IN barrier */
+      if (!gasnete_coll_generic_all_threads(data) ||
+          !gasnete_coll_generic_insync(op->team, data)) {
+        break;
+      }
+      data->state = 1; GASNETI_FALLTHROUGH
+
+    case 1:	/* Data movement */
+      if (op->team->myrank == args->srcnode) {
+        GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(args->dst, args->src, args->nbytes);
+      } else {
+        gasneti_sync_reads();
+        GASNETE_FAST_UNALIGNED_MEMCPY(args->dst,
+                                      GASNETE_COLL_PSHM_ADDR(op->team, args->srcnode, args->src),
+                                      args->nbytes);
+      }
+      data->state = 2; GASNETI_FALLTHROUGH
+
+    case 2:	/* Optional OUT barrier */
+      if (!gasnete_coll_generic_outsync(op->team, data)) {
+        break;
+      }
+
+      gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+      result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+GASNETE_COLL_DECLARE_BCAST_ALG(PSHM)
+{
+  int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (!(flags & GASNET_COLL_IN_NOSYNC)) |
+  GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(!(flags & GASNET_COLL_OUT_NOSYNC));
+
+  gasneti_assert(GASNETE_COLL_TEAM_IS_PSHM(team));
+  gasneti_assert(flags & GASNET_COLL_SINGLE);
+  gasneti_assert(flags & GASNET_COLL_SRC_IN_SEGMENT);
+  return gasnete_coll_generic_broadcast_nb(team, dst, srcimage, src, nbytes, flags,
+                                           &gasnete_coll_pf_bcast_PSHM, options,
+                                           NULL, sequence, coll_params->num_params, coll_params->param_list GASNETI_THREAD_PASS);
+}
+
+/* scat PSHM: all nodes copy their block directly out of the root's source */
+static int gasnete_coll_pf_scat_PSHM(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_scatter_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, scatter);
+  int result = 0;
+
+  gasneti_assert(op->flags & GASNET_COLL_SINGLE);
+
+  switch (data->state) {
+    case 0:	/* Optional IN barrier */
+      if (!gasnete_coll_generic_all_threads(data) ||
+          !gasnete_coll_generic_insync(op->team, data)) {
+        break;
+      }
+      data->state = 1; GASNETI_FALLTHROUGH
+
+    case 1:	/* Data movement */
+      if (op->team->myrank == args->srcnode) {
+        GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(args->dst,
+                                            gasnete_coll_scale_ptr(args->src, op->team->myrank, args->nbytes),
+                                            args->nbytes);
+      } else {
+        void *src = GASNETE_COLL_PSHM_ADDR(op->team, args->srcnode, args->src);
+        gasneti_sync_reads();
+        GASNETE_FAST_UNALIGNED_MEMCPY(args->dst,
+                                      gasnete_coll_scale_ptr(src, op->team->myrank, args->nbytes),
+                                      args->nbytes);
+      }
+      data->state = 2; GASNETI_FALLTHROUGH
+
+    case 2:	/* Optional OUT barrier */
+      if (!gasnete_coll_generic_outsync(op->team, data)) {
+        break;
+      }
+
+      gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+      result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+GASNETE_COLL_DECLARE_SCATTER_ALG(PSHM)
+{
+  int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (!(flags & GASNET_COLL_IN_NOSYNC)) |
+  GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(!(flags & GASNET_COLL_OUT_NOSYNC));
+
+  gasneti_assert(GASNETE_COLL_TEAM_IS_PSHM(team));
+  gasneti_assert(flags & GASNET_COLL_SRC_IN_SEGMENT);
+  return gasnete_coll_generic_scatter_nb(team, dst, srcimage, src, nbytes, dist, flags,
+                                         &gasnete_coll_pf_scat_PSHM, options,
+                                         NULL, sequence, coll_params->num_params, coll_params->param_list GASNETI_THREAD_PASS);
+}
+
+/* gath PSHM: all nodes store their block directly into the root's destination */
+static int gasnete_coll_pf_gath_PSHM(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_gather_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, gather);
+  int result = 0;
+
+  gasneti_assert(op->flags & GASNET_COLL_SINGLE);
+
+  switch (data->state) {
+    case 0:	/* Optional IN barrier */
+      if (!gasnete_coll_generic_all_threads(data) ||
+          !gasnete_coll_generic_insync(op->team, data)) {
+        break;
+      }
+      data->state = 1; GASNETI_FALLTHROUGH
+
+    case 1:	/* Data movement */
+      if (op->team->myrank == args->dstnode) {
+        GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(gasnete_coll_scale_ptr(args->dst, op->team->myrank, args->nbytes),
+                                            args->src, args->nbytes);
+      } else {
+        void *dst = GASNETE_COLL_PSHM_ADDR(op->team, args->dstnode, args->dst);
+        GASNETE_FAST_UNALIGNED_MEMCPY(gasnete_coll_scale_ptr(dst, op->team->myrank, args->nbytes),
+                                      args->src, args->nbytes);
+        gasneti_sync_writes();
+      }
+      data->state = 2; GASNETI_FALLTHROUGH
+
+    case 2:	/* Optional OUT barrier */
+      if (!gasnete_coll_generic_outsync(op->team, data)) {
+        break;
+      }
+
+      gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+      result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+GASNETE_COLL_DECLARE_GATHER_ALG(PSHM)
+{
+  int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (!(flags & GASNET_COLL_IN_NOSYNC)) |
+  GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(!(flags & GASNET_COLL_OUT_NOSYNC));
+
+  gasneti_assert(GASNETE_COLL_TEAM_IS_PSHM(team));
+  gasneti_assert(flags & GASNET_COLL_DST_IN_SEGMENT);
+  return gasnete_coll_generic_gather_nb(team, dstimage, dst, src, nbytes, nbytes, flags,
+                                        &gasnete_coll_pf_gath_PSHM, options,
+                                        NULL, sequence, coll_params->num_params, coll_params->param_list GASNETI_THREAD_PASS);
+}
+
+/* exchg PSHM: each node copies its block directly out of every peer's source */
+static int gasnete_coll_pf_exchg_PSHM(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_exchange_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, exchange);
+  const gasnet_node_t myrank = op->team->myrank;
+  const gasnet_node_t total_ranks = op->team->total_ranks;
+  const size_t nbytes = args->nbytes;
+  int result = 0;
+  gasnet_node_t i;
+
+  gasneti_assert(op->flags & GASNET_COLL_SINGLE);
+
+  switch (data->state) {
+    case 0:	/* Optional IN barrier */
+      if (!gasnete_coll_generic_all_threads(data) ||
+          !gasnete_coll_generic_insync(op->team, data)) {
+        break;
+      }
+      data->state = 1; GASNETI_FALLTHROUGH
+
+    case 1:	/* Data movement, staggered to spread the load over the peers */
+      gasneti_sync_reads();
+      for (i = myrank + 1; i < total_ranks; ++i) {
+        int8_t *src = GASNETE_COLL_PSHM_ADDR(op->team, i, args->src);
+        GASNETE_FAST_UNALIGNED_MEMCPY((int8_t*)args->dst + i*nbytes, src + myrank*nbytes, nbytes);
+      }
+      for (i = 0; i < myrank; ++i) {
+        int8_t *src = GASNETE_COLL_PSHM_ADDR(op->team, i, args->src);
+        GASNETE_FAST_UNALIGNED_MEMCPY((int8_t*)args->dst + i*nbytes, src + myrank*nbytes, nbytes);
+      }
+      GASNETE_FAST_UNALIGNED_MEMCPY_CHECK((int8_t*)args->dst + myrank*nbytes,
+                                          (int8_t*)args->src + myrank*nbytes, nbytes);
+      data->state = 2; GASNETI_FALLTHROUGH
+
+    case 2:	/* Optional OUT barrier */
+      if (!gasnete_coll_generic_outsync(op->team, data)) {
+        break;
+      }
+
+      gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+      result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+GASNETE_COLL_DECLARE_EXCHANGE_ALG(PSHM)
+{
+  int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (!(flags & GASNET_COLL_IN_NOSYNC)) |
+  GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(!(flags & GASNET_COLL_OUT_NOSYNC));
+
+  gasneti_assert(GASNETE_COLL_TEAM_IS_PSHM(team));
+  gasneti_assert(flags & GASNET_COLL_SINGLE);
+  gasneti_assert(flags & GASNET_COLL_SRC_IN_SEGMENT);
+  return gasnete_coll_generic_exchange_nb(team, dst, src, nbytes, flags,
+                                          &gasnete_coll_pf_exchg_PSHM, options,
+                                          NULL, NULL, sequence, coll_params->num_params, coll_params->param_list GASNETI_THREAD_PASS);
+}
+
+/* reduce PSHM: when the root's destination is in-segment, each node combines
+ * its own slice of the vector across every node's source and stores it into
+ * the root's destination, which the OUT barrier then publishes to the root.
+ * Otherwise only the root can reach the destination, and it combines every
+ * node's source directly.  In both cases sources are combined in rank order.
+ */
+static int gasnete_coll_pf_reduce_PSHM(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_reduce_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, reduce);
+  const gasnet_node_t myrank = op->team->myrank;
+  const gasnet_node_t total_ranks = op->team->total_ranks;
+  int result = 0;
+
+  gasneti_assert(op->flags & GASNET_COLL_SINGLE);
+
+  switch (data->state) {
+    case 0:	/* Optional IN barrier */
+      if (!gasnete_coll_generic_all_threads(data) ||
+          !gasnete_coll_generic_insync(op->team, data)) {
+        break;
+      }
+      data->state = 1; GASNETI_FALLTHROUGH
+
+    case 1:	/* Reduction of my slice (all of it at the root, if not sliced) */
+    {
+      const size_t elem_size = args->elem_size;
+      size_t first = 0, count = 0;
+      int8_t *dst = NULL;
+
+      if (op->flags & GASNET_COLL_DST_IN_SEGMENT) {
+        /* Slices of whole cache lines where elements pack evenly into them */
+        size_t slice = (args->elem_count + total_ranks - 1) / total_ranks;
+        if (!(GASNETI_CACHE_LINE_BYTES % elem_size)) {
+          const size_t per_line = GASNETI_CACHE_LINE_BYTES / elem_size;
+          slice = GASNETI_ALIGNUP(slice, per_line);
+        }
+        first = MIN(args->elem_count, myrank * slice);
+        count = MIN(args->elem_count - first, slice);
+        dst = GASNETE_COLL_PSHM_ADDR(op->team, args->dstnode, args->dst);
+      } else if (myrank == args->dstnode) {
+        count = args->elem_count;
+        dst = args->dst;
+      }
+
+      if (count) {
+        gasnet_coll_reduce_fn_t reduce_fn = gasnete_coll_fn_lookup(args->func)->fnptr;
+        uint32_t red_fn_flags = gasnete_coll_fn_lookup(args->func)->flags;
+        const size_t offset = first * elem_size;
+        gasnet_node_t i;
+
+        dst += offset;
+        gasneti_sync_reads();
+        GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(dst, (int8_t*)GASNETE_COLL_PSHM_ADDR(op->team, 0, args->src) + offset,
+                                            count * elem_size);
+        for (i = 1; i < total_ranks; ++i) {
+          (*reduce_fn)(dst, count, dst, count,
+                       (int8_t*)GASNETE_COLL_PSHM_ADDR(op->team, i, args->src) + offset, elem_size,
+                       red_fn_flags, args->func_arg);
+        }
+        if (myrank != args->dstnode) gasneti_sync_writes();
+      }
+      data->state = 2; GASNETI_FALLTHROUGH
+    }
+
+    case 2:	/* OUT barrier: optional, unless the root must wait for the slices */
+      if (!gasnete_coll_generic_outsync(op->team, data)) {
+        break;
+      }
+      if ((op->flags & GASNET_COLL_DST_IN_SEGMENT) && (myrank == args->dstnode)) {
+        gasneti_sync_reads();
+      }
+
+      gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+      result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+
+GASNETE_COLL_DECLARE_REDUCE_ALG(PSHM)
+{
+  /* When sliced, the root cannot complete until every node has stored its slice */
+  int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (!(flags & GASNET_COLL_IN_NOSYNC)) |
+  GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(!(flags & GASNET_COLL_OUT_NOSYNC) || (flags & GASNET_COLL_DST_IN_SEGMENT));
+
+  gasneti_assert(GASNETE_COLL_TEAM_IS_PSHM(team));
+  gasneti_assert(flags & GASNET_COLL_SINGLE);
+  gasneti_assert(flags & GASNET_COLL_SRC_IN_SEGMENT);
+  return gasnete_coll_generic_reduce_nb(team, dstimage, dst, src, src_blksz, src_offset,
+                                        elem_size, elem_count, func, func_arg, flags,
+                                        &gasnete_coll_pf_reduce_PSHM, options,
+                                        NULL, sequence, coll_params->num_params, coll_params->param_list, NULL
+                                        GASNETI_THREAD_PASS);
+}
+
+#undef GASNETE_COLL_PSHM_ADDR
+#endif /* GASNET_PSHM */
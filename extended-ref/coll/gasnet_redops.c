@@ -0,0 +1,160 @@
+/*   $Source: bitbucket.org:berkeleylab/gasnet.git/extended-ref/coll/gasnet_redops.c $
+ * Description: Built-in reduction operators for GASNet Collectives
+ * Terms of use are as specified in license.txt
+ */
+
+/* Each built-in operator has the gasnet_coll_reduce_fn_t signature and follows
+ * the element-wise convention used by the reduction algorithms:
+ *   results[i] = left_operands[i] OP right_operands[i], i=0..result_count-1
+ * The loops are written so that the compiler vectorizes them.  On x86-64 with
+ * a compiler that supports function-level target attributes, the same loops
+ * are also compiled for AVX2 and AVX-512 and the widest variant supported by
+ * the CPU is selected at startup (overridable by GASNET_COLL_REDUCE_SIMD).
+ */
+
+#if PLATFORM_ARCH_X86_64 && !PLATFORM_COMPILER_INTEL && \
+    ((PLATFORM_COMPILER_GNU && PLATFORM_COMPILER_VERSION_GE(5,0,0)) || \
+     (PLATFORM_COMPILER_CLANG && PLATFORM_COMPILER_VERSION_GE(3,9,0)))
+  #define GASNETE_COLL_REDOP_X86_DISPATCH 1
+#else
+  #define GASNETE_COLL_REDOP_X86_DISPATCH 0
+#endif
+
+gasnet_coll_fn_entry_t gasnete_coll_builtin_fn_tbl[GASNETE_COLL_NUM_BUILTIN_FNS];
+
+#define GASNETE_COLL_REDOP_SUM(a,b)  ((a) + (b))
+#define GASNETE_COLL_REDOP_PROD(a,b) ((a) * (b))
+#define GASNETE_COLL_REDOP_MIN(a,b)  (((b) < (a)) ? (b) : (a))
+#define GASNETE_COLL_REDOP_MAX(a,b)  (((b) > (a)) ? (b) : (a))
+#define GASNETE_COLL_REDOP_BAND(a,b) ((a) & (b))
+#define GASNETE_COLL_REDOP_BOR(a,b)  ((a) | (b))
+#define GASNETE_COLL_REDOP_BXOR(a,b) ((a) ^ (b))
+
+#define GASNETE_COLL_REDOP_KERNEL(ISA,ATTR,TNAME,T,OP)                                    \
+static ATTR void gasnete_coll_redop_##ISA##_##TNAME##_##OP(                              \
+        void *_results, size_t _result_count,                                            \
+        const void *_left_operands, size_t _left_count,                                  \
+        const void *_right_operands,                                                     \
+        size_t _elem_size, int _flags, int _arg) {                                       \
+  T *res = (T *)_results;                                                                \
+  const T *left = (const T *)_left_operands;                                             \
+  const T *right = (const T *)_right_operands;                                           \
+  size_t i;                                                                              \
+  gasneti_assert(_elem_size == sizeof(T));                                               \
+  gasneti_assert(_left_count == _result_count);                                          \
+  for (i = 0; i < _result_count; ++i) {                                                  \
+    res[i] = GASNETE_COLL_REDOP_##OP(left[i], right[i]);                                 \
+  }                                                                                      \
+}
+
+#define GASNETE_COLL_REDOP_ARITH_KERNELS(ISA,ATTR,TNAME,T) \
+  GASNETE_COLL_REDOP_KERNEL(ISA,ATTR,TNAME,T,SUM)          \
+  GASNETE_COLL_REDOP_KERNEL(ISA,ATTR,TNAME,T,PROD)         \
+  GASNETE_COLL_REDOP_KERNEL(ISA,ATTR,TNAME,T,MIN)          \
+  GASNETE_COLL_REDOP_KERNEL(ISA,ATTR,TNAME,T,MAX)
+#define GASNETE_COLL_REDOP_INT_KERNELS(ISA,ATTR,TNAME,T) \
+  GASNETE_COLL_REDOP_ARITH_KERNELS(ISA,ATTR,TNAME,T)     \
+  GASNETE_COLL_REDOP_KERNEL(ISA,ATTR,TNAME,T,BAND)       \
+  GASNETE_COLL_REDOP_KERNEL(ISA,ATTR,TNAME,T,BOR)        \
+  GASNETE_COLL_REDOP_KERNEL(ISA,ATTR,TNAME,T,BXOR)
+
+#define GASNETE_COLL_REDOP_ALL_KERNELS(ISA,ATTR)                \
+  GASNETE_COLL_REDOP_INT_KERNELS(ISA,ATTR,int32,int32_t)        \
+  GASNETE_COLL_REDOP_INT_KERNELS(ISA,ATTR,uint32,uint32_t)      \
+  GASNETE_COLL_REDOP_INT_KERNELS(ISA,ATTR,int64,int64_t)        \
+  GASNETE_COLL_REDOP_INT_KERNELS(ISA,ATTR,uint64,uint64_t)      \
+  GASNETE_COLL_REDOP_ARITH_KERNELS(ISA,ATTR,float,float)        \
+  GASNETE_COLL_REDOP_ARITH_KERNELS(ISA,ATTR,double,double)
+
+/* Rows are indexed by gasnet_coll_type_t and columns by gasnet_coll_builtin_op_t */
+#define GASNETE_COLL_REDOP_ARITH_ROW(ISA,TNAME)       \
+  gasnete_coll_redop_##ISA##_##TNAME##_SUM,           \
+  gasnete_coll_redop_##ISA##_##TNAME##_PROD,          \
+  gasnete_coll_redop_##ISA##_##TNAME##_MIN,           \
+  gasnete_coll_redop_##ISA##_##TNAME##_MAX
+#define GASNETE_COLL_REDOP_INT_ROW(ISA,TNAME)         \
+  GASNETE_COLL_REDOP_ARITH_ROW(ISA,TNAME),            \
+  gasnete_coll_redop_##ISA##_##TNAME##_BAND,          \
+  gasnete_coll_redop_##ISA##_##TNAME##_BOR,           \
+  gasnete_coll_redop_##ISA##_##TNAME##_BXOR
+#define GASNETE_COLL_REDOP_FLOAT_ROW(ISA,TNAME)       \
+  GASNETE_COLL_REDOP_ARITH_ROW(ISA,TNAME), NULL, NULL, NULL
+
+#define GASNETE_COLL_REDOP_TABLE(ISA,ATTR)                                                     \
+  GASNETE_COLL_REDOP_ALL_KERNELS(ISA,ATTR)                                                     \
+  static const gasnet_coll_reduce_fn_t gasnete_coll_redop_tbl_##ISA[GASNETE_COLL_NUM_BUILTIN_FNS] = { \
+    GASNETE_COLL_REDOP_INT_ROW(ISA,int32),                                                     \
+    GASNETE_COLL_REDOP_INT_ROW(ISA,uint32),                                                    \
+    GASNETE_COLL_REDOP_INT_ROW(ISA,int64),                                                     \
+    GASNETE_COLL_REDOP_INT_ROW(ISA,uint64),                                                    \
+    GASNETE_COLL_REDOP_FLOAT_ROW(ISA,float),                                                   \
+    GASNETE_COLL_REDOP_FLOAT_ROW(ISA,double)                                                   \
+  };
+
+/* Baseline: SSE2 on x86-64, otherwise whatever the compiler targets by default */
+#define GASNETE_COLL_REDOP_NOATTR
+GASNETE_COLL_REDOP_TABLE(generic, GASNETE_COLL_REDOP_NOATTR)
+
+#if GASNETE_COLL_REDOP_X86_DISPATCH
+GASNETE_COLL_REDOP_TABLE(avx2, __attribute__((__target__("avx2"))))
+GASNETE_COLL_REDOP_TABLE(avx512, __attribute__((__target__("avx512f,avx512dq"))))
+#endif
+
+extern void gasnete_coll_builtin_fn_init(void) {
+  const gasnet_coll_reduce_fn_t *tbl = gasnete_coll_redop_tbl_generic;
+  const char *isa = "generic";
+  int i;
+
+#if GASNETE_COLL_REDOP_X86_DISPATCH
+  {
+    const char *limit = gasneti_getenv_withdefault("GASNET_COLL_REDUCE_SIMD", "auto");
+    int allow_avx512 = !strcmp(limit, "auto") || !strcmp(limit, "avx512");
+    int allow_avx2   = allow_avx512 || !strcmp(limit, "avx2");
+
+    if (!allow_avx2 && strcmp(limit, "sse2") && strcmp(limit, "none")) {
+      gasneti_fatalerror("GASNET_COLL_REDUCE_SIMD='%s' is not one of auto, avx512, avx2, sse2 or none", limit);
+    }
+    __builtin_cpu_init();
+    if (allow_avx512 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+      tbl = gasnete_coll_redop_tbl_avx512; isa = "avx512";
+    } else if (allow_avx2 && __builtin_cpu_supports("avx2")) {
+      tbl = gasnete_coll_redop_tbl_avx2; isa = "avx2";
+    }
+  }
+#endif
+  GASNETI_TRACE_PRINTF(W,("Built-in reduction operators use the %s kernels", isa));
+
+  for (i = 0; i < GASNETE_COLL_NUM_BUILTIN_FNS; ++i) {
+    gasnete_coll_builtin_fn_tbl[i].fnptr = tbl[i];
+    gasnete_coll_builtin_fn_tbl[i].flags = GASNET_COLL_AMSAFE;
+  }
+}
+
+/* For the internal diagnostics: the kernel table of compiled variant i and
+ * its ISA name.  *tbl_p is NULL if this CPU cannot run that variant.
+ * Returns zero once i is past the last compiled variant.
+ */
+extern int gasnete_coll_builtin_fn_variant(int i, const char **isa_p,
+                                           const gasnet_coll_reduce_fn_t **tbl_p) {
+  switch (i) {
+    case 0:
+      *isa_p = "generic";
+      *tbl_p = gasnete_coll_redop_tbl_generic;
+      return 1;
+#if GASNETE_COLL_REDOP_X86_DISPATCH
+    case 1:
+      __builtin_cpu_init();
+      *isa_p = "avx2";
+      *tbl_p = __builtin_cpu_supports("avx2") ? gasnete_coll_redop_tbl_avx2 : NULL;
+      return 1;
+    case 2:
+      __builtin_cpu_init();
+      *isa_p = "avx512";
+      *tbl_p = (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+               ? gasnete_coll_redop_tbl_avx512 : NULL;
+      return 1;
+#endif
+    default:
+      return 0;
+  }
+}
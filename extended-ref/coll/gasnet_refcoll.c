@@ -22,6 +22,40 @@
 #include <coll/gasnet_refcoll.h>
 #include <gasnet_vis.h>
 
+/* Who walks the active list (PAR builds only, chosen in gasnete_coll_init):
+ *  IMAGE0      - local image 0 (or, with ALL_THREADS_POLL, the winner of a
+ *                trylock) polls every op on behalf of all threads.
+ *  PARTITIONED - every thread polls the ops it created, so collectives issued
+ *                by different threads progress concurrently.
+ *  THREAD      - a dedicated progress thread polls every op and client threads
+ *                only poll the network and reap their own saved handles.
+ * In the last two modes each op's 'polling' flag keeps it from being polled by
+ * two threads at once (or re-entered by its own poller), so independent
+ * collectives advance concurrently even on a single team.  The little state
+ * those ops share, the team's scratch allocator and consensus barriers, is
+ * guarded by team->state_lock, and the scratch allocator also takes requests
+ * in sequence order (see gasnete_coll_scratch_turn()).
+ */
+#if GASNET_PAR
+enum {
+  GASNETE_COLL_PROGRESS_IMAGE0 = 0,
+  GASNETE_COLL_PROGRESS_PARTITIONED,
+  GASNETE_COLL_PROGRESS_THREAD
+};
+static int gasnete_coll_progress_mode = GASNETE_COLL_PROGRESS_IMAGE0;
+/* THREAD mode: the thread sleeps on this (with gasnete_coll_active_lock)
+   while there is nothing to poll, until an op is added or it is stopped */
+static gasneti_cond_t gasnete_coll_progress_cond = GASNETI_COND_INITIALIZER;
+static pthread_t gasnete_coll_progress_tid;
+static volatile int gasnete_coll_progress_stop = 0;
+static volatile int gasnete_coll_progress_done = 0;
+#define GASNETE_COLL_THREAD_POLLS(td) \
+  ((td)->my_local_image == 0 || ALL_THREADS_POLL || \
+   (gasnete_coll_progress_mode != GASNETE_COLL_PROGRESS_IMAGE0))
+#else
+#define GASNETE_COLL_THREAD_POLLS(td) ((td)->my_local_image == 0 || ALL_THREADS_POLL)
+#endif
+
 /*TEMPORARY (Need to eventually change it such that 
   the files are compiled under their own .o files)*/
 #include <coll/gasnet_trees.c>
@@ -30,12 +64,17 @@
 */
 #include <coll/gasnet_autotune.c>
 #include <coll/gasnet_scratch.c>
+#include <coll/gasnet_redops.c>
 #include <smp-collectives/smp_coll.c>
 #include <smp-collectives/smp_coll_barrier.c>
 
+#if GASNETI_USE_TRUE_MUTEXES
+void *gasnete_coll_progress_threaddata = NULL;
+#endif
+
 size_t gasnete_coll_p2p_eager_min = 0;
 size_t gasnete_coll_p2p_eager_scale = 0;
-static size_t gasnete_coll_p2p_eager_buffersz = 0;
+size_t gasnete_coll_p2p_eager_buffersz = 0;
 /*set a std segment size of 1024 bytes*/
 
 /*---------------------------------------------------------------------------------*/
@@ -52,10 +91,13 @@ gasnet_team_handle_t gasnete_coll_teamB;
 
 int gasnete_coll_init_done = 0;
 
-void gasnete_coll_validate(gasnet_team_handle_t team,
-                           gasnet_image_t dstimage, const void *dst, size_t dstlen, int dstisv,
-                           gasnet_image_t srcimage, const void *src, size_t srclen, int srcisv,
-                           int flags GASNETI_THREAD_FARG) {
+/* allow_empty permits a zero dstlen or srclen (nothing is bounds checked then),
+   as when a rank has no neighbors on one side of a graph */
+GASNETI_INLINE(gasnete_coll_validate_inner)
+void gasnete_coll_validate_inner(gasnet_team_handle_t team,
+                                 gasnet_image_t dstimage, const void *dst, size_t dstlen, int dstisv,
+                                 gasnet_image_t srcimage, const void *src, size_t srclen, int srcisv,
+                                 int flags, int allow_empty GASNETI_THREAD_FARG) {
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD_NOALLOC;
   int i;
 
@@ -125,8 +167,8 @@ void gasnete_coll_validate(gasnet_team_handle_t team,
   gasneti_assert(((flags & GASNET_COLL_SINGLE)?1:0) ^ ((flags & GASNET_COLL_LOCAL)?1:0));
 
   /* Bounds check any local portion of dst/dstlist which user claims is in-segment */
-  gasneti_assert(dstlen > 0);
-  if ((dstimage == td->my_image) && (flags & GASNET_COLL_DST_IN_SEGMENT)) {
+  gasneti_assert(allow_empty || (dstlen > 0));
+  if (dstlen && (dstimage == td->my_image) && (flags & GASNET_COLL_DST_IN_SEGMENT)) {
     if (!dstisv) {
       gasneti_boundscheck(gasneti_mynode, dst, dstlen);
     } else {
@@ -139,8 +181,8 @@ void gasnete_coll_validate(gasnet_team_handle_t team,
   }
 
   /* Bounds check any local portion of src/srclist which user claims is in-segment */
-  gasneti_assert(srclen > 0);
-  if ((srcimage == td->my_image) && (flags & GASNET_COLL_SRC_IN_SEGMENT)) {
+  gasneti_assert(allow_empty || (srclen > 0));
+  if (srclen && (srcimage == td->my_image) && (flags & GASNET_COLL_SRC_IN_SEGMENT)) {
     if (!srcisv) {
       gasneti_boundscheck(gasneti_mynode, src, srclen);
     } else {
@@ -158,6 +200,22 @@ void gasnete_coll_validate(gasnet_team_handle_t team,
    */
 }
 
+void gasnete_coll_validate(gasnet_team_handle_t team,
+                           gasnet_image_t dstimage, const void *dst, size_t dstlen, int dstisv,
+                           gasnet_image_t srcimage, const void *src, size_t srclen, int srcisv,
+                           int flags GASNETI_THREAD_FARG) {
+  gasnete_coll_validate_inner(team, dstimage, dst, dstlen, dstisv, srcimage, src, srclen, srcisv,
+                              flags, 0 GASNETI_THREAD_PASS);
+}
+
+void gasnete_coll_validate_empty_ok(gasnet_team_handle_t team,
+                                    gasnet_image_t dstimage, const void *dst, size_t dstlen, int dstisv,
+                                    gasnet_image_t srcimage, const void *src, size_t srclen, int srcisv,
+                                    int flags GASNETI_THREAD_FARG) {
+  gasnete_coll_validate_inner(team, dstimage, dst, dstlen, dstisv, srcimage, src, srclen, srcisv,
+                              flags, 1 GASNETI_THREAD_PASS);
+}
+
 /*---------------------------------------------------------------------------------*/
 /* Handles */
 #ifndef GASNETE_COLL_HANDLE_OVERRIDE
@@ -226,7 +284,7 @@ gasnete_coll_try_sync(gasnet_coll_handle_t handle GASNETI_THREAD_FARG) {
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD_NOALLOC;
   gasneti_assert(handle != GASNET_COLL_INVALID_HANDLE); /* caller must check */
 
-  if(td->my_local_image == 0 || ALL_THREADS_POLL)
+  if (GASNETE_COLL_THREAD_POLLS(td))
     gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
 
 
@@ -245,7 +303,7 @@ gasnete_coll_try_sync_some(gasnet_coll_handle_t *phandle, size_t numhandles GASN
 
   gasneti_assert(phandle != NULL);
   
-  if(td->my_local_image == 0 || ALL_THREADS_POLL)
+  if (GASNETE_COLL_THREAD_POLLS(td))
     gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
 
   
@@ -272,7 +330,7 @@ gasnete_coll_try_sync_all(gasnet_coll_handle_t *phandle, size_t numhandles GASNE
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD_NOALLOC;
   gasneti_assert(phandle != NULL);
 
-  if(td->my_local_image == 0 || ALL_THREADS_POLL)
+  if (GASNETE_COLL_THREAD_POLLS(td))
     gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
 
   for (i = 0; i < numhandles; ++i, ++phandle) {
@@ -874,6 +932,11 @@ gasnete_coll_op_submit(gasnete_coll_op_t *op, gasnet_coll_handle_t handle GASNET
     /* All ops go onto the active list */
     gasneti_mutex_lock(&gasnete_coll_active_lock);
     gasnete_coll_active_ins(op);
+#if GASNET_PAR
+    if (gasnete_coll_progress_mode == GASNETE_COLL_PROGRESS_THREAD) {
+      gasneti_cond_signal(&gasnete_coll_progress_cond);
+    }
+#endif
     gasneti_mutex_unlock(&gasnete_coll_active_lock);
 
     return handle;
@@ -934,6 +997,10 @@ gasnete_coll_op_create(gasnete_coll_team_t team, uint32_t sequence, int flags GA
     op->handle   = GASNET_COLL_INVALID_HANDLE;
     op->poll_fn  = (gasnete_coll_poll_fn)NULL;
     op->scratchpos = NULL;
+#if GASNET_PAR
+    op->poller   = td;
+    op->polling  = 0;
+#endif
 
     /* The aggregation and 'data' fields are setup elsewhere */
 
@@ -948,11 +1015,145 @@ gasnete_coll_op_destroy(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
   td->op_freelist = op;
 }
 
+#if GASNET_PAR
+/* Polls the active ops created by 'poller', or every active op if NULL.
+ *
+ * Ops stay with the thread that created them (which includes subordinates
+ * created by their parent's poll function) because any handles saved while
+ * polling them can only be reaped by that same thread.
+ * Poll functions run without gasnete_coll_active_lock, but with the op's
+ * 'polling' flag set.  Since only the thread which set that flag may complete
+ * (and thus unlink) the op, 'op' remains on the list until we retake the
+ * active lock to step past it.
+ * Returns non-zero if any op was polled.
+ */
+static int gasnete_coll_poll_ops(gasnete_coll_threaddata_t *poller GASNETI_THREAD_FARG) {
+  gasnete_coll_op_t *op;
+  int polled = 0;
+
+  gasneti_mutex_lock(&gasnete_coll_active_lock);
+  op = gasnete_coll_active_first();
+  while (op != NULL) {
+    gasnete_coll_op_t *next;
+
+    if ((!poller || (op->poller == poller)) && !op->polling) {
+      int poll_result;
+
+      op->polling = 1;
+      gasneti_mutex_unlock(&gasnete_coll_active_lock);
+      gasneti_assert(op->poll_fn != (gasnete_coll_poll_fn)NULL);
+      poll_result = (*op->poll_fn)(op GASNETI_THREAD_PASS);
+      gasneti_mutex_lock(&gasnete_coll_active_lock);
+
+      next = gasnete_coll_active_next(op);
+      op->polling = 0;
+      if (poll_result != 0) {
+        gasnete_coll_op_complete(op, poll_result GASNETI_THREAD_PASS);
+      }
+      polled = 1;
+    } else {
+      next = gasnete_coll_active_next(op);
+    }
+
+    op = next;
+  }
+  gasneti_mutex_unlock(&gasnete_coll_active_lock);
+
+  return polled;
+}
+
+static void *gasnete_coll_progress_thread(void *arg) {
+  GASNETI_THREAD_LOOKUP
+  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+
+  gasnete_coll_progress_threaddata = GASNETI_MYTHREAD;
+  gasneti_sync_writes();
+
+  while (!gasnete_coll_progress_stop) {
+    int polled;
+
+    gasneti_AMPoll();
+    gasnete_coll_sync_saved_handles(GASNETI_THREAD_PASS_ALONE);
+    polled = gasnete_coll_poll_ops(NULL GASNETI_THREAD_PASS);
+    if (!polled && !td->handles.used) {
+      /* Client threads poll the network themselves, so sleep while idle */
+      gasneti_mutex_lock(&gasnete_coll_active_lock);
+      while (!gasnete_coll_progress_stop && !gasnete_coll_active_first()) {
+        gasneti_cond_wait(&gasnete_coll_progress_cond, &gasnete_coll_active_lock);
+      }
+      gasneti_mutex_unlock(&gasnete_coll_active_lock);
+      gasneti_sched_yield();
+    }
+  }
+
+  gasneti_sync_writes();
+  gasnete_coll_progress_done = 1;
+  return NULL;
+}
+
+static void gasnete_coll_progress_init(void) {
+  if (gasneti_getenv_yesno_withdefault("GASNET_COLL_PROGRESS_THREAD", 0)) {
+    int ret;
+
+    gasnete_coll_progress_mode = GASNETE_COLL_PROGRESS_THREAD;
+    gasneti_sync_writes();
+
+    /* Joinable, so that gasnete_coll_fini() can wait for it to stop */
+    ret = pthread_create(&gasnete_coll_progress_tid, NULL, gasnete_coll_progress_thread, NULL);
+    if (ret) {
+      gasneti_fatalerror("Error creating collectives progress thread: %s", strerror(ret));
+    }
+  } else if (gasneti_getenv_yesno_withdefault("GASNET_COLL_PARTITIONED_POLL", 0)) {
+    gasnete_coll_progress_mode = GASNETE_COLL_PROGRESS_PARTITIONED;
+  }
+}
+#endif
+
+extern void gasnete_coll_fini(void) {
+#if GASNET_PAR
+  gasneti_tick_t start;
+
+  if (gasnete_coll_progress_mode != GASNETE_COLL_PROGRESS_THREAD || gasnete_coll_progress_stop) return;
+  gasnete_coll_progress_stop = 1;
+  gasneti_sync_writes();
+  if (pthread_equal(pthread_self(), gasnete_coll_progress_tid)) return; /* exit from a handler it ran */
+
+  /* The exiting thread may itself hold the active lock, and the progress
+     thread may be stuck (e.g. in a handler which called gasnet_exit()),
+     so never block: retry the wakeup for a bounded time, and join only if
+     the thread has actually left its loop. */
+  start = gasneti_ticks_now();
+  while (!gasnete_coll_progress_done &&
+         (gasneti_ticks_to_ns(gasneti_ticks_now() - start) < 1000000000)) {
+    if (!gasneti_mutex_trylock(&gasnete_coll_active_lock)) {
+      gasneti_cond_broadcast(&gasnete_coll_progress_cond);
+      gasneti_mutex_unlock(&gasnete_coll_active_lock);
+    }
+    gasneti_sched_yield();
+  }
+  if (gasnete_coll_progress_done) {
+    (void) pthread_join(gasnete_coll_progress_tid, NULL);
+  }
+#endif
+}
+
 void gasnete_coll_poll(GASNETI_THREAD_FARG_ALONE) {
 #if ALL_THREADS_POLL
   static gasneti_mutex_t poll_lock = GASNETI_MUTEX_INITIALIZER;
 #endif
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+
+#if GASNET_PAR
+  if (gasnete_coll_progress_mode != GASNETE_COLL_PROGRESS_IMAGE0) {
+    gasneti_AMPoll();
+    gasnete_coll_sync_saved_handles(GASNETI_THREAD_PASS_ALONE);
+    if (gasnete_coll_progress_mode == GASNETE_COLL_PROGRESS_PARTITIONED) {
+      (void) gasnete_coll_poll_ops(td GASNETI_THREAD_PASS);
+    }
+    return;
+  }
+#endif
+
   if(td->my_local_image==0 || ALL_THREADS_POLL) {
     gasneti_AMPoll();
   }
@@ -961,9 +1162,6 @@ void gasnete_coll_poll(GASNETI_THREAD_FARG_ALONE) {
   if(td->my_local_image==0 || ALL_THREADS_POLL) {
     gasnete_coll_sync_saved_handles(GASNETI_THREAD_PASS_ALONE);
   }
-  /* XXX: We'd also like to have multiple pollers walk the list polling
-   * distinct entries.
-   */
 #if ALL_THREADS_POLL
   if (gasneti_mutex_trylock(&poll_lock) == 0)
 #else
@@ -1103,6 +1301,7 @@ extern void gasnete_coll_init(const gasnet_image_t images[], gasnet_image_t my_i
                                           gasnete_coll_total_images * gasnete_coll_p2p_eager_scale);
     
     
+    gasnete_coll_builtin_fn_init();
     gasnete_coll_fn_count = fn_count;
     if (fn_count != 0) {
       size_t tbl_size = sizeof(gasnet_coll_fn_entry_t) * fn_count;
@@ -1128,6 +1327,12 @@ extern void gasnete_coll_init(const gasnet_image_t images[], gasnet_image_t my_i
     /* This barrier, together with the thread barrier that follows, ensures all global
        collectives initialization is complete before any collectives can be called. */
     gasnet_barrier((int)GASNET_TEAM_ALL->sequence,0);
+
+    gasnete_coll_autotune_calibrate(gasnete_coll_auxseg_save);
+
+#if GASNET_PAR
+    gasnete_coll_progress_init();
+#endif
   }
 
   if (images) {
@@ -1252,6 +1457,14 @@ void gasnete_coll_consensus_do_notify(gasnete_coll_team_t team) {
 
 extern int gasnete_coll_consensus_try(gasnete_coll_team_t team, gasnete_coll_consensus_t id) {
   uint32_t tmp = id << 1;	/* low bit is used for barrier phase (notify vs wait) */
+#if GASNET_PAR
+  /* Ops of this team may be polled by several threads: whoever holds the
+     lock advances the barriers for everyone, so the others need not wait */
+  const int locked = (gasnete_coll_progress_mode != GASNETE_COLL_PROGRESS_IMAGE0);
+  if (locked && gasneti_mutex_trylock(&team->state_lock)) {
+    return ((int32_t)(team->consensus_id - tmp) > 1) ? GASNET_OK : GASNET_ERR_NOT_READY;
+  }
+#endif
   /* We can only notify when our own turn comes up.
    * Thus, the most progress we could make in one call
    * would be to sucessfully 'try' for our predecessor,
@@ -1283,6 +1496,10 @@ extern int gasnete_coll_consensus_try(gasnete_coll_team_t team, gasnete_coll_con
 	  }
   }
 
+#if GASNET_PAR
+  if (locked) gasneti_mutex_unlock(&team->state_lock);
+#endif
+
   /* Note that we need to be careful of wrapping, thus the (int32_t)(a-b) construct
    * must be used in place of simply (a-b).
    */
@@ -1309,15 +1526,103 @@ extern int gasnete_coll_consensus_wait(gasnete_coll_team_t team GASNETI_THREAD_F
 	 (gasneti_assert(GASNETI_POWEROFTWO(GASNETE_COLL_P2P_TABLE_SIZE)), \
           ((uint32_t)(S) & (GASNETE_COLL_P2P_TABLE_SIZE-1)))
 
+/* Allocate a descriptor with all state and counters zeroed */
+static gasnete_coll_p2p_t *gasnete_coll_p2p_alloc(gasnete_coll_team_t team) {
+  size_t statesz = GASNETI_ALIGNUP(2*team->total_images * sizeof(uint32_t), 8);
+  size_t countersz = GASNETI_ALIGNUP(2*team->total_images * sizeof(gasneti_weakatomic_t), 8);
+  /* Round to 8-byte alignment of entry array */
+  size_t alloc_size = GASNETI_ALIGNUP(sizeof(gasnete_coll_p2p_t) + statesz + countersz,8)
+    + gasnete_coll_p2p_eager_buffersz;
+  uintptr_t p = (uintptr_t)gasneti_malloc(alloc_size);
+  gasnete_coll_p2p_t *p2p = (gasnete_coll_p2p_t *)p;
+  int i;
+
+  p += sizeof(gasnete_coll_p2p_t);
+
+  p2p->state = (uint32_t *)p;
+  p += statesz;
+
+  p2p->counter = (gasneti_weakatomic_t *)p;
+  p += countersz;
+
+  p = GASNETI_ALIGNUP(p,8);
+  p2p->data = (uint8_t *)p;
+
+  memset((void *)p2p->state, 0, statesz);
+  for(i=0; i<2*team->total_images; i++) {
+    gasneti_weakatomic_set(&p2p->counter[i], 0, 0);
+  }
+  gasneti_weakatomic_set(&p2p->state_dirty, 0, 0);
+  gasneti_weakatomic_set(&p2p->counter_dirty, 0, 0);
+  gasnet_hsl_init(&p2p->lock);
+
+  p2p->p2p_next = NULL;
+  p2p->in_ring = 0;
+  p2p->ring_busy = 0;
+
+  return p2p;
+}
+
+/* Prepare a new or recycled descriptor for (team_id, sequence).
+   Only the prefix of state[] and counter[] written during its previous use is
+   cleared, and the eager buffer is not cleared at all since it is only read
+   at offsets whose state or counter has signalled the arrival of data. */
+static void gasnete_coll_p2p_reset(gasnete_coll_team_t team, gasnete_coll_p2p_t *p2p,
+                                   uint32_t team_id, uint32_t sequence) {
+#if GASNETE_COLL_P2P_TRACK_DIRTY
+  uint32_t nstate = MAX(1, gasneti_weakatomic_read(&p2p->state_dirty, 0));
+  uint32_t ncounter = MAX(1, gasneti_weakatomic_read(&p2p->counter_dirty, 0));
+#else
+  uint32_t nstate = 2*team->total_images;
+  uint32_t ncounter = 2*team->total_images;
+#endif
+  uint32_t i;
+
+  gasneti_assert(nstate <= 2*team->total_images);
+  gasneti_assert(ncounter <= 2*team->total_images);
+  memset((void *)p2p->state, 0, nstate * sizeof(uint32_t));
+  for (i = 0; i < ncounter; i++) {
+    gasneti_weakatomic_set(&p2p->counter[i], 0, 0);
+  }
+  gasneti_weakatomic_set(&p2p->state_dirty, 0, 0);
+  gasneti_weakatomic_set(&p2p->counter_dirty, 0, 0);
+
+  /*allocate an empty interval for the free list */
+  p2p->seg_intervals = NULL;
+#if GASNET_DEBUG
+  p2p->team_id = team_id;
+#endif
+
+  /* The new sequence number publishes the cleared descriptor to lock-free lookups */
+  gasneti_sync_writes();
+  p2p->sequence = sequence;
+}
+
 gasnete_coll_p2p_t *gasnete_coll_p2p_get(uint32_t team_id, uint32_t sequence) {
   gasnete_coll_team_t team = gasnete_coll_team_lookup(team_id);
   unsigned int slot_nr = GASNETE_COLL_P2P_TABLE_SLOT(sequence);
   gasnete_coll_p2p_t *p2p, **prev_p;
-  int i;
+
+  /* Fast path: the ring slot already holds this sequence.  A slot is only
+     recycled after its previous sequence is freed, at which point no more
+     lookups of that sequence can occur, so a match here is never stale. */
+  p2p = team->p2p_ring[slot_nr];
+  if_pt (p2p && (p2p->sequence == sequence)) {
+    gasneti_sync_reads();
+    gasneti_assert(p2p->ring_busy);
+    gasneti_assert(p2p->team_id == team->team_id);
+    return p2p;
+  }
   
   gasnet_hsl_lock(&team->p2p_lock);
 
-  /* Search table, which is sorted by sequence */
+  p2p = team->p2p_ring[slot_nr];
+  if (p2p && p2p->ring_busy && (p2p->sequence == sequence)) {
+    gasnet_hsl_unlock(&team->p2p_lock);
+    return p2p;
+  }
+
+  /* Search overflow list, which is sorted by sequence */
   prev_p = &(team->p2p_table[slot_nr]);
   p2p = team->p2p_table[slot_nr];
   while (p2p && (p2p->sequence < sequence)) {
@@ -1325,60 +1630,42 @@ gasnete_coll_p2p_t *gasnete_coll_p2p_get(uint32_t team_id, uint32_t sequence) {
     p2p = p2p->p2p_next;
   }
 
-  /* If not found, create it with all zeros */
+  /* If not found, claim the ring slot if it is idle, or else add to the overflow list */
   if_pf ((p2p == NULL) || (p2p->sequence != sequence)) {
-    size_t statesz = GASNETI_ALIGNUP(2*team->total_images * sizeof(uint32_t), 8);
-    size_t countersz = GASNETI_ALIGNUP(2*team->total_images * sizeof(gasneti_weakatomic_t), 8);
-    gasnete_coll_p2p_t *next = p2p;
-        
-    p2p = team->p2p_freelist;
-        
-    if_pf (p2p == NULL) {
-      /* Round to 8-byte alignment of entry array */
-      size_t alloc_size = GASNETI_ALIGNUP(sizeof(gasnete_coll_p2p_t) + statesz + countersz,8)
-        + gasnete_coll_p2p_eager_buffersz;
-      uintptr_t p = (uintptr_t)gasneti_malloc(alloc_size);
-          
-      p2p = (gasnete_coll_p2p_t *)p;
-      p += sizeof(gasnete_coll_p2p_t);
-          
-      p2p->state = (uint32_t *)p;
-      p += statesz;
-          
-      p2p->counter = (gasneti_weakatomic_t *)p;
-      p += countersz;
-          
-      p = GASNETI_ALIGNUP(p,8);
-      p2p->data = (uint8_t *)p;
-          
-      p2p->p2p_next = NULL;
-    }
-        
-    memset((void *)p2p->state, 0, statesz);
-    memset(p2p->data, 0, gasnete_coll_p2p_eager_buffersz);
-    for(i=0; i<2*team->total_images; i++) {
-      gasneti_weakatomic_set(&p2p->counter[i], 0, 0);
+    gasnete_coll_p2p_t *ring = team->p2p_ring[slot_nr];
+
+    if (ring == NULL) {
+      ring = gasnete_coll_p2p_alloc(team);
+      ring->in_ring = 1;
+      ring->sequence = ~sequence; /* cannot match until reset */
+      gasneti_sync_writes();
+      team->p2p_ring[slot_nr] = ring;
     }
-    gasneti_sync_writes();
-    /*allocate an empty interval for the free list */
-    p2p->seg_intervals = NULL;
-        
-#if GASNET_DEBUG
-    p2p->team_id = team_id;
-#endif
-    p2p->sequence = sequence;
-    gasnet_hsl_init(&p2p->lock);
-        
-    team->p2p_freelist = p2p->p2p_next;
-        
-    /* Insert in order before the last location searched */
-    gasneti_assert(prev_p != NULL);
-    gasneti_assert(!next || (next->p2p_prev_p == prev_p));
-    *prev_p = p2p;
-    p2p->p2p_prev_p = prev_p;
-    p2p->p2p_next = next;
-    if (next) {
-      next->p2p_prev_p = &p2p->p2p_next;
+
+    if (!ring->ring_busy) {
+      p2p = ring;
+      p2p->ring_busy = 1;
+      gasnete_coll_p2p_reset(team, p2p, team_id, sequence);
+    } else {
+      gasnete_coll_p2p_t *next = p2p;
+
+      p2p = team->p2p_freelist;
+      if_pf (p2p == NULL) {
+        p2p = gasnete_coll_p2p_alloc(team);
+      } else {
+        team->p2p_freelist = p2p->p2p_next;
+      }
+      gasnete_coll_p2p_reset(team, p2p, team_id, sequence);
+
+      /* Insert in order before the last location searched */
+      gasneti_assert(prev_p != NULL);
+      gasneti_assert(!next || (next->p2p_prev_p == prev_p));
+      *prev_p = p2p;
+      p2p->p2p_prev_p = prev_p;
+      p2p->p2p_next = next;
+      if (next) {
+        next->p2p_prev_p = &p2p->p2p_next;
+      }
     }
 #ifdef GASNETE_P2P_EXTRA_INIT
     GASNETE_P2P_EXTRA_INIT(p2p)
@@ -1401,22 +1688,29 @@ void gasnete_coll_p2p_free(gasnete_coll_team_t team, gasnete_coll_p2p_t *p2p) {
 
   gasnet_hsl_lock(&team->p2p_lock);
 
-  *(p2p->p2p_prev_p) = p2p->p2p_next;
-  if (p2p->p2p_next) {
-    p2p->p2p_next->p2p_prev_p = p2p->p2p_prev_p;
-  }
 #ifdef GASNETE_P2P_EXTRA_FREE
   GASNETE_P2P_EXTRA_FREE(p2p)
 #endif
 
-  p2p->p2p_next = team->p2p_freelist;
-  team->p2p_freelist = p2p;
+  if (p2p->in_ring) {
+    /* Stays in the ring; the next sequence to claim the slot resets it */
+    gasneti_assert(p2p->ring_busy);
+    p2p->ring_busy = 0;
+  } else {
+    *(p2p->p2p_prev_p) = p2p->p2p_next;
+    if (p2p->p2p_next) {
+      p2p->p2p_next->p2p_prev_p = p2p->p2p_prev_p;
+    }
+
+    p2p->p2p_next = team->p2p_freelist;
+    team->p2p_freelist = p2p;
 
 #if GASNET_DEBUG
-  /* Detect double free using otherwise unused prev pointer */
-  gasneti_assert(p2p->p2p_prev_p != &p2p->p2p_next);
-  p2p->p2p_prev_p = &p2p->p2p_next;
+    /* Detect double free using otherwise unused prev pointer */
+    gasneti_assert(p2p->p2p_prev_p != &p2p->p2p_next);
+    p2p->p2p_prev_p = &p2p->p2p_next;
 #endif
+  }
 
   gasnet_hsl_unlock(&team->p2p_lock);
 }
@@ -1552,6 +1846,7 @@ extern void gasnete_coll_p2p_long_reqh(gasnet_token_t token, void *buf, size_t n
     gasneti_sync_writes();
   }
 
+  gasnete_coll_p2p_mark_state(p2p, offset + count);
   for (i = 0; i < count; ++i, ++offset) {
     p2p->state[offset] = state;
   }
@@ -1578,6 +1873,7 @@ extern void gasnete_coll_p2p_med_reqh(gasnet_token_t token, void *buf, size_t nb
     gasneti_sync_writes();
   }
 
+  gasnete_coll_p2p_mark_state(p2p, offset + count);
   for (i = 0; i < count; ++i, ++offset) {
     p2p->state[offset] = state;
   }
@@ -1596,6 +1892,7 @@ extern void gasnete_coll_p2p_med_counting_reqh(gasnet_token_t token, void *buf,
     gasneti_sync_writes();
   }
   
+  gasnete_coll_p2p_mark_counter(p2p, idx + 1);
   gasneti_weakatomic_increment(&p2p->counter[idx], 0);
 }
 
@@ -1628,6 +1925,7 @@ extern void gasnete_coll_p2p_short_reqh(gasnet_token_t token,
   gasnete_coll_p2p_t *p2p = gasnete_coll_p2p_get(team_id, sequence);
   int i;
 
+  gasnete_coll_p2p_mark_state(p2p, offset + count);
   for (i = 0; i < count; ++i, ++offset) {
     p2p->state[offset] = state;
   }
@@ -1640,6 +1938,7 @@ extern void gasnete_coll_p2p_advance_reqh(gasnet_token_t token,
                                           gasnet_handlerarg_t idx) {
 
   gasnete_coll_p2p_t *p2p = gasnete_coll_p2p_get(team_id, sequence);
+  gasnete_coll_p2p_mark_counter(p2p, idx + 1);
   gasneti_weakatomic_increment(&p2p->counter[idx], 0);
 }
 
@@ -1656,6 +1955,7 @@ extern void gasnete_coll_p2p_put_and_advance_reqh(gasnet_token_t token, void *bu
   }
       
   p2p = gasnete_coll_p2p_get(team_id, sequence);
+  gasnete_coll_p2p_mark_counter(p2p, idx + 1);
   gasneti_weakatomic_increment(&p2p->counter[idx], 0);
 }
 
@@ -2003,6 +2303,7 @@ gasnete_coll_op_generic_init_with_scratch(gasnete_coll_team_t team, int flags,
                                           uint32_t sequence, gasnete_coll_scratch_req_t *scratch_req, int num_params, uint32_t *param_list, gasnete_coll_tree_data_t *tree_info GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle = GASNET_COLL_INVALID_HANDLE;
   gasnete_coll_op_t *op;
+  uint32_t reserved_seqs = 0;
 #if !ALL_THREADS_POLL && GASNET_PAR
   gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD_NOALLOC;
   int first_thread;
@@ -2032,6 +2333,7 @@ gasnete_coll_op_generic_init_with_scratch(gasnete_coll_team_t team, int flags,
     /* XXX: need team scope for sequence numbers */
     uint32_t tmp = team->sequence;
     team->sequence += (1 + sequence);
+    reserved_seqs = sequence;
     sequence = tmp;
 	
   }
@@ -2088,6 +2390,8 @@ gasnete_coll_op_generic_init_with_scratch(gasnete_coll_team_t team, int flags,
     op->waiting_scratch_op = 0;
     op->active_scratch_op = 0;
     op->waiting_for_reconfig_clear=0;
+    op->scratch_requested = 0;
+    op->reserved_seqs = reserved_seqs;
 #if GASNET_DEBUG
     op->scratch_op_freed = 0;
 #endif
@@ -2137,7 +2441,14 @@ extern gasnete_coll_tree_data_t *gasnete_coll_tree_init(gasnete_coll_tree_type_t
   
     /* unlock aquisition and free in tree init*/
     data->sent_bytes = 0;
-    data->geom = gasnete_coll_local_tree_geom_fetch(tree_type, root, team);
+    if (td->active_plan && td->active_plan->tree_geom &&
+        td->active_plan->impl->tree_type == tree_type &&
+        td->active_plan->tree_root == root && td->active_plan->team == team) {
+      /* gasnet_coll_start(): geometry was fetched when the plan was made */
+      data->geom = td->active_plan->tree_geom;
+    } else {
+      data->geom = gasnete_coll_local_tree_geom_fetch(tree_type, root, team);
+    }
 
     return data;
 }
@@ -2211,8 +2522,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_broadcast)
                                  gasnet_image_t srcimage, void *src,
                                  size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_broadcast_nb(team,dst,srcimage,src,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_broadcast)
@@ -2287,8 +2600,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_broadcastM)
                                   gasnet_image_t srcimage, void *src,
                                   size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_broadcastM_nb(team,dstlist,srcimage,src,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_broadcastM)
@@ -2355,8 +2670,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_scatter)
                                gasnet_image_t srcimage, void *src,
                                size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_scatter_nb(team,dst,srcimage,src,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_scatter)
@@ -2413,8 +2730,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_scatterM)
                                 gasnet_image_t srcimage, void *src,
                                 size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_scatterM_nb(team,dstlist,srcimage,src,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_scatterM)
@@ -2473,8 +2792,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_gather)
                               void *src,
                               size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_gather_nb(team,dstimage,dst,src,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_gather)
@@ -2531,8 +2852,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_gatherM)
                                void * const srclist[],
                                size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_gatherM_nb(team,dstimage,dst,srclist,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_gatherM)
@@ -2593,8 +2916,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_gather_all)
                                   void *dst, void *src,
                                   size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_gather_all_nb(team,dst,src,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_gather_all)
@@ -2662,8 +2987,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_gather_allM)
                                    void * const dstlist[], void * const srclist[],
                                    size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_gather_allM_nb(team,dstlist,srclist,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_gather_allM)
@@ -2725,8 +3052,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_exchange)
                                 void *dst, void *src,
                                 size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_exchange_nb(team,dst,src,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_exchange)
@@ -2777,8 +3106,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_exchangeM)
                                  void * const dstlist[], void * const srclist[],
                                  size_t nbytes, int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_exchangeM_nb(team,dstlist,srclist,nbytes,flags,0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_exchangeM)
@@ -2843,8 +3174,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_reduce)
                               gasnet_coll_fn_handle_t func, int func_arg,
                               int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_reduce_nb(team,dstimage,dst,src,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags, 0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_reduce)
@@ -2911,8 +3244,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_reduceM)
                                gasnet_coll_fn_handle_t func, int func_arg,
                                int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_reduceM_nb(team,dstimage,dst,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags, 0 GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_reduceM)
@@ -2927,6 +3262,350 @@ GASNETI_COLL_FN_HEADER(_gasnet_coll_reduceM)
   gasnete_coll_reduceM(team,dstimage,dst,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_PASS);
 }
 
+/**** Allreduce ***/
+#ifndef gasnete_coll_allreduce_nb
+#define gasnete_coll_allreduce_nb gasnete_coll_allreduce_nb_default
+#else
+extern gasnet_coll_handle_t
+gasnete_coll_allreduce_nb_default(gasnet_team_handle_t team,
+                                  void *dst, void *src,
+                                  size_t elem_size, size_t elem_count,
+                                  gasnet_coll_fn_handle_t func, int func_arg,
+                                  int flags, uint32_t sequence GASNETI_THREAD_FARG);
+#endif
+
+extern gasnet_coll_handle_t
+gasnete_coll_allreduce_nb(gasnet_team_handle_t team,
+                          void *dst, void *src,
+                          size_t elem_size, size_t elem_count,
+                          gasnet_coll_fn_handle_t func, int func_arg,
+                          int flags, uint32_t sequence GASNETI_THREAD_FARG);
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduce_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_allreduce_nb(gasnet_team_handle_t team,
+                          void *dst, void *src,
+                          size_t elem_size, size_t elem_count,
+                          gasnet_coll_fn_handle_t func, int func_arg,
+                          int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  GASNETI_TRACE_COLL_ALLREDUCE(COLL_ALLREDUCE_NB,team,dst,src,elem_size,elem_count,func,func_arg,flags);
+  GASNETE_COLL_VALIDATE_ALLREDUCE(team,dst,src,elem_size,elem_count,flags);
+  handle = gasnete_coll_allreduce_nb(team,dst,src,elem_size,elem_count,func,func_arg,flags, 0 GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+#ifdef gasnete_coll_allreduce
+extern void
+gasnete_coll_allreduce(gasnet_team_handle_t team,
+                       void *dst, void *src,
+                       size_t elem_size, size_t elem_count,
+                       gasnet_coll_fn_handle_t func, int func_arg,
+                       int flags GASNETI_THREAD_FARG);
+#else
+GASNETI_COLL_FN_HEADER(gasnete_coll_allreduce)
+     void gasnete_coll_allreduce(gasnet_team_handle_t team,
+                                 void *dst, void *src,
+                                 size_t elem_size, size_t elem_count,
+                                 gasnet_coll_fn_handle_t func, int func_arg,
+                                 int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
+  handle = gasnete_coll_allreduce_nb(team,dst,src,elem_size,elem_count,func,func_arg,flags, 0 GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
+}
+#endif
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduce)
+     void _gasnet_coll_allreduce(gasnet_team_handle_t team,
+                                 void *dst, void *src,
+                                 size_t elem_size, size_t elem_count,
+                                 gasnet_coll_fn_handle_t func, int func_arg,
+                                 int flags GASNETI_THREAD_FARG) {
+  GASNETI_TRACE_COLL_ALLREDUCE(COLL_ALLREDUCE,team,dst,src,elem_size,elem_count,func,func_arg,flags);
+  GASNETE_COLL_VALIDATE_ALLREDUCE(team,dst,src,elem_size,elem_count,flags);
+  gasnete_coll_allreduce(team,dst,src,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_PASS);
+}
+
+
+/*** Allreduce Multiaddr ****/
+#ifndef gasnete_coll_allreduceM_nb
+#define gasnete_coll_allreduceM_nb gasnete_coll_allreduceM_nb_default
+#else
+extern gasnet_coll_handle_t
+gasnete_coll_allreduceM_nb_default(gasnet_team_handle_t team,
+                                   void * const dstlist[], void * const srclist[],
+                                   size_t elem_size, size_t elem_count,
+                                   gasnet_coll_fn_handle_t func, int func_arg,
+                                   int flags, uint32_t sequence GASNETI_THREAD_FARG);
+#endif
+extern gasnet_coll_handle_t
+gasnete_coll_allreduceM_nb(gasnet_team_handle_t team,
+                           void * const dstlist[], void * const srclist[],
+                           size_t elem_size, size_t elem_count,
+                           gasnet_coll_fn_handle_t func, int func_arg,
+                           int flags, uint32_t sequence GASNETI_THREAD_FARG);
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduceM_nb) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_allreduceM_nb(gasnet_team_handle_t team,
+                           void * const dstlist[], void * const srclist[],
+                           size_t elem_size, size_t elem_count,
+                           gasnet_coll_fn_handle_t func, int func_arg,
+                           int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  GASNETI_TRACE_COLL_ALLREDUCE_M(COLL_ALLREDUCE_M_NB,team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags);
+  GASNETE_COLL_VALIDATE_ALLREDUCE_M(team,dstlist,srclist,elem_size,elem_count,flags);
+  handle = gasnete_coll_allreduceM_nb(team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags, 0 GASNETI_THREAD_PASS);
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+#ifdef gasnete_coll_allreduceM
+extern void
+gasnete_coll_allreduceM(gasnet_team_handle_t team,
+                        void * const dstlist[], void * const srclist[],
+                        size_t elem_size, size_t elem_count,
+                        gasnet_coll_fn_handle_t func, int func_arg,
+                        int flags GASNETI_THREAD_FARG);
+#else
+GASNETI_COLL_FN_HEADER(gasnete_coll_allreduceM)
+     void gasnete_coll_allreduceM(gasnet_team_handle_t team,
+                                  void * const dstlist[], void * const srclist[],
+                                  size_t elem_size, size_t elem_count,
+                                  gasnet_coll_fn_handle_t func, int func_arg,
+                                  int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
+  handle = gasnete_coll_allreduceM_nb(team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags, 0 GASNETI_THREAD_PASS);
+  gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
+}
+#endif
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduceM)
+     void _gasnet_coll_allreduceM(gasnet_team_handle_t team,
+                                  void * const dstlist[], void * const srclist[],
+                                  size_t elem_size, size_t elem_count,
+                                  gasnet_coll_fn_handle_t func, int func_arg,
+                                  int flags GASNETI_THREAD_FARG) {
+  GASNETI_TRACE_COLL_ALLREDUCE_M(COLL_ALLREDUCE_M,team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags);
+  GASNETE_COLL_VALIDATE_ALLREDUCE_M(team,dstlist,srclist,elem_size,elem_count,flags);
+  gasnete_coll_allreduceM(team,dstlist,srclist,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_PASS);
+}
+
+/*---------------------------------------------------------------------------------*/
+/* Persistent collectives */
+
+/* The *_init functions repeat the selection steps of the corresponding
+ * gasnete_coll_*_nb_default(), but keep the result in a plan instead of
+ * calling the algorithm.  gasnet_coll_start() later calls it directly.
+ */
+static gasnet_coll_plan_t
+gasnete_coll_plan_alloc(gasnet_team_handle_t team, gasnet_coll_optype_t optype, void *dst, void *src) {
+  gasnet_coll_plan_t plan = gasneti_calloc(1, sizeof(struct gasnete_coll_plan_t_));
+  plan->team = team;
+  plan->optype = optype;
+  plan->dst = dst;
+  plan->src = src;
+  return plan;
+}
+
+/* Take a private copy of the autotuner's choice, since implementations owned
+ * by the tuning state are not guaranteed to outlive the plan, and pin the
+ * geometry of its tree (if any) so starts skip the geometry cache lookup.
+ */
+static void gasnete_coll_plan_set_impl(gasnet_coll_plan_t plan, gasnete_coll_implementation_t impl,
+                                       gasnet_node_t tree_root) {
+  plan->impl = gasnete_coll_get_implementation();
+  memcpy(plan->impl, impl, sizeof(struct gasnete_coll_implementation_t_));
+  plan->impl->next = NULL;
+  plan->impl->need_to_free = 0;
+  if(impl->need_to_free) gasnete_coll_free_implementation(impl);
+
+  plan->tree_root = tree_root;
+  if (plan->impl->tree_type) {
+    plan->tree_geom = gasnete_coll_local_tree_geom_fetch(plan->impl->tree_type, tree_root, plan->team);
+  }
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_broadcast_init) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_plan_t
+_gasnet_coll_broadcast_init(gasnet_team_handle_t team,
+                            void *dst,
+                            gasnet_image_t srcimage, void *src,
+                            size_t nbytes, int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_plan_t plan;
+  gasnete_coll_implementation_t impl;
+
+  GASNETE_COLL_VALIDATE_BROADCAST(team,dst,srcimage,src,nbytes,flags);
+
+#if GASNET_PAR
+  /* Thread-local addr(s) - plan a bcastM_nb() */
+  if (flags & GASNET_COLL_LOCAL && !(flags & GASNET_COLL_NO_IMAGES)) {
+    plan = gasnete_coll_plan_alloc(team, GASNET_COLL_BROADCASTM_OP, dst, src);
+    flags |= GASNETE_COLL_THREAD_LOCAL;
+    flags = gasnete_coll_segment_checkM(team, flags, 0, 0, &plan->dst, nbytes, 1, srcimage, src, nbytes);
+    impl = gasnete_coll_autotune_get_bcastM_algorithm(team, &plan->dst, srcimage, src, nbytes, flags GASNETI_THREAD_PASS);
+  } else
+#endif
+  {
+    plan = gasnete_coll_plan_alloc(team, GASNET_COLL_BROADCAST_OP, dst, src);
+    flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, nbytes, 1, srcimage, src, nbytes);
+    impl = gasnete_coll_autotune_get_bcast_algorithm(team, dst, srcimage, src, nbytes, flags GASNETI_THREAD_PASS);
+  }
+  plan->flags = flags;
+  plan->image = srcimage;
+  plan->nbytes = nbytes;
+  gasnete_coll_plan_set_impl(plan, impl, gasnete_coll_image_node(team, srcimage));
+  return plan;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_reduce_init) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_plan_t
+_gasnet_coll_reduce_init(gasnet_team_handle_t team,
+                         gasnet_image_t dstimage, void *dst,
+                         void *src, size_t src_blksz, size_t src_offset,
+                         size_t elem_size, size_t elem_count,
+                         gasnet_coll_fn_handle_t func, int func_arg,
+                         int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_plan_t plan;
+  gasnete_coll_implementation_t impl;
+  size_t nbytes = elem_size*elem_count;
+
+  GASNETE_COLL_VALIDATE_REDUCE(team,dstimage,dst,src,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags);
+  /*initial limitations*/
+  gasneti_assert(src_blksz == 0);
+  gasneti_assert(src_offset == 0);
+
+  /*error check to make sure the function table is properly configured*/
+  GASNETE_COLL_CHECK_FN(func);
+
+#if GASNET_PAR
+  if (flags & GASNET_COLL_LOCAL) {
+    plan = gasnete_coll_plan_alloc(team, GASNET_COLL_REDUCEM_OP, dst, src);
+    flags |= GASNETE_COLL_THREAD_LOCAL;
+    flags = gasnete_coll_segment_checkM(team, flags, 1, dstimage, dst, nbytes,
+                                        0, 0, &plan->src, nbytes);
+    impl = gasnete_coll_autotune_get_reduceM_algorithm(team, dstimage, dst, &plan->src, src_blksz, src_offset,
+                                                       elem_size, elem_count, func, func_arg, flags GASNETI_THREAD_PASS);
+  } else
+#endif
+  {
+    plan = gasnete_coll_plan_alloc(team, GASNET_COLL_REDUCE_OP, dst, src);
+    flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, nbytes*team->total_ranks,
+                                       0, 0, src, nbytes);
+    impl = gasnete_coll_autotune_get_reduce_algorithm(team, dstimage, dst, src, src_blksz, src_offset,
+                                                      elem_size, elem_count, func, func_arg, flags GASNETI_THREAD_PASS);
+  }
+  plan->flags = flags;
+  plan->image = dstimage;
+  plan->nbytes = nbytes;
+  plan->elem_size = elem_size;
+  plan->elem_count = elem_count;
+  plan->func = func;
+  plan->func_arg = func_arg;
+  gasnete_coll_plan_set_impl(plan, impl, gasnete_coll_image_node(team, dstimage));
+  return plan;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_allreduce_init) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_plan_t
+_gasnet_coll_allreduce_init(gasnet_team_handle_t team,
+                            void *dst, void *src,
+                            size_t elem_size, size_t elem_count,
+                            gasnet_coll_fn_handle_t func, int func_arg,
+                            int flags GASNETI_THREAD_FARG) {
+  gasnet_coll_plan_t plan;
+  gasnete_coll_implementation_t impl;
+  size_t nbytes = elem_size*elem_count;
+
+  GASNETE_COLL_VALIDATE_ALLREDUCE(team,dst,src,elem_size,elem_count,flags);
+
+  /*error check to make sure the function table is properly configured*/
+  GASNETE_COLL_CHECK_FN(func);
+
+#if GASNET_PAR
+  if (flags & GASNET_COLL_LOCAL) {
+    plan = gasnete_coll_plan_alloc(team, GASNET_COLL_ALLREDUCEM_OP, dst, src);
+    flags |= GASNETE_COLL_THREAD_LOCAL;
+    flags = gasnete_coll_segment_checkM(team, flags, 0, 0, &plan->dst, nbytes,
+                                        0, 0, &plan->src, nbytes);
+    impl = gasnete_coll_autotune_get_allreduceM_algorithm(team, &plan->dst, &plan->src, elem_size, elem_count,
+                                                          func, func_arg, flags GASNETI_THREAD_PASS);
+  } else
+#endif
+  {
+    plan = gasnete_coll_plan_alloc(team, GASNET_COLL_ALLREDUCE_OP, dst, src);
+    flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, nbytes,
+                                       0, 0, src, nbytes);
+    impl = gasnete_coll_autotune_get_allreduce_algorithm(team, dst, src, elem_size, elem_count,
+                                                         func, func_arg, flags GASNETI_THREAD_PASS);
+  }
+  plan->flags = flags;
+  plan->nbytes = nbytes;
+  plan->elem_size = elem_size;
+  plan->elem_count = elem_count;
+  plan->func = func;
+  plan->func_arg = func_arg;
+  /* Allreduce algorithms have no tree of their own */
+  gasnete_coll_plan_set_impl(plan, impl, 0);
+  return plan;
+}
+
+GASNETI_COLL_FN_HEADER(_gasnet_coll_start) GASNETI_WARN_UNUSED_RESULT
+gasnet_coll_handle_t
+_gasnet_coll_start(gasnet_coll_plan_t plan GASNETI_THREAD_FARG) {
+  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+  gasnete_coll_implementation_t impl = plan->impl;
+  gasnet_team_handle_t team = plan->team;
+  gasnet_coll_handle_t handle = GASNET_COLL_INVALID_HANDLE;
+
+  GASNETI_TRACE_EVENT_VAL(W,COLL_START,plan->nbytes);
+  gasneti_assert(td->active_plan == NULL);
+  td->active_plan = plan;
+  switch (plan->optype) {
+    case GASNET_COLL_BROADCAST_OP:
+      handle = (*((gasnete_coll_bcast_fn_ptr_t) (impl->fn_ptr)))(team, plan->dst, plan->image, plan->src, plan->nbytes,
+                                                                 plan->flags, impl, 0 GASNETI_THREAD_PASS);
+      break;
+    case GASNET_COLL_BROADCASTM_OP:
+      handle = (*((gasnete_coll_bcastM_fn_ptr_t) (impl->fn_ptr)))(team, &plan->dst, plan->image, plan->src, plan->nbytes,
+                                                                  plan->flags, impl, 0 GASNETI_THREAD_PASS);
+      break;
+    case GASNET_COLL_REDUCE_OP:
+      handle = (*((gasnete_coll_reduce_fn_ptr_t) (impl->fn_ptr)))(team, plan->image, plan->dst, plan->src, 0, 0,
+                                                                  plan->elem_size, plan->elem_count, plan->func, plan->func_arg,
+                                                                  plan->flags, impl, 0 GASNETI_THREAD_PASS);
+      break;
+    case GASNET_COLL_REDUCEM_OP:
+      handle = (*((gasnete_coll_reduceM_fn_ptr_t) (impl->fn_ptr)))(team, plan->image, plan->dst, &plan->src, 0, 0,
+                                                                   plan->elem_size, plan->elem_count, plan->func, plan->func_arg,
+                                                                   plan->flags, impl, 0 GASNETI_THREAD_PASS);
+      break;
+    case GASNET_COLL_ALLREDUCE_OP:
+      handle = (*((gasnete_coll_allreduce_fn_ptr_t) (impl->fn_ptr)))(team, plan->dst, plan->src,
+                                                                     plan->elem_size, plan->elem_count, plan->func, plan->func_arg,
+                                                                     plan->flags, impl, 0 GASNETI_THREAD_PASS);
+      break;
+    case GASNET_COLL_ALLREDUCEM_OP:
+      handle = (*((gasnete_coll_allreduceM_fn_ptr_t) (impl->fn_ptr)))(team, &plan->dst, &plan->src,
+                                                                      plan->elem_size, plan->elem_count, plan->func, plan->func_arg,
+                                                                      plan->flags, impl, 0 GASNETI_THREAD_PASS);
+      break;
+    default:
+      gasneti_fatalerror("gasnet_coll_start: unknown plan type %d", (int)plan->optype);
+  }
+  td->active_plan = NULL;
+  gasnete_coll_poll(GASNETI_THREAD_PASS_ALONE);
+  return handle;
+}
+
+GASNETI_COLL_FN_HEADER(gasnete_coll_plan_free)
+void gasnete_coll_plan_free(gasnet_coll_plan_t plan) {
+  if (plan) {
+    gasnete_coll_free_implementation(plan->impl);
+    gasneti_free(plan);
+  }
+}
+
 /*** Scan **/
 
 #ifndef gasnete_coll_scan_nb
@@ -2980,8 +3659,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_scan)
                             gasnet_coll_fn_handle_t func, int func_arg,
                             int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_scan_nb(team,dst,dst_blksz,dst_offset,src,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_scan)
@@ -3050,8 +3731,10 @@ GASNETI_COLL_FN_HEADER(gasnete_coll_scanM)
                              gasnet_coll_fn_handle_t func, int func_arg,
                              int flags GASNETI_THREAD_FARG) {
   gasnet_coll_handle_t handle;
+  GASNETE_COLL_ONLINE_BEGIN();
   handle = gasnete_coll_scanM_nb(team,dstlist,dst_blksz,dst_offset,srclist,src_blksz,src_offset,elem_size,elem_count,func,func_arg,flags GASNETI_THREAD_PASS);
   gasnete_coll_wait_sync(handle GASNETI_THREAD_PASS);
+  GASNETE_COLL_ONLINE_END();
 }
 #endif
 GASNETI_COLL_FN_HEADER(_gasnet_coll_scanM)
@@ -5162,9 +5845,7 @@ gasnete_coll_reduce_nb_default(gasnet_team_handle_t team,
   gasneti_assert(src_offset == 0);
   
   /*error check to make sure the function table is properly configured*/
-  gasneti_assert(gasnete_coll_fn_tbl);
-  gasneti_assert(func < gasnete_coll_fn_count);
-  gasneti_assert(gasnete_coll_fn_tbl[func].fnptr);
+  GASNETE_COLL_CHECK_FN(func);
   
   
   impl = gasnete_coll_autotune_get_reduce_algorithm(team, dstimage, dst, src, src_blksz, 
@@ -5297,9 +5978,7 @@ gasnete_coll_reduceM_nb_default(gasnet_team_handle_t team,
   gasneti_assert(src_offset == 0);
   
   /*error check to make sure the function table is properly configured*/
-  gasneti_assert(gasnete_coll_fn_tbl);
-  gasneti_assert(func < gasnete_coll_fn_count);
-  gasneti_assert(gasnete_coll_fn_tbl[func].fnptr);
+  GASNETE_COLL_CHECK_FN(func);
   
   
   impl = gasnete_coll_autotune_get_reduceM_algorithm(team, dstimage, dst, srclist, src_blksz, 
@@ -5311,6 +5990,422 @@ gasnete_coll_reduceM_nb_default(gasnet_team_handle_t team,
 
 }
 
+/*---------------------------------------------------------------------------------*/
+/* gasnete_coll_allreduce_nb() */
+
+/* Red: Implement allreduce as one reduce to each rank */
+/* Used for payloads too large for the scratch-based algorithms */
+/* Valid wherever the underlying reduce is valid */
+/* When the payload exceeds the pipeline segment size each reduce is the segmented
+ * TreeGetSeg, and the op reserves a block of (1+num_segs) sequence numbers per rank
+ * for it (param_list[0] holds the segment size, or num_params is zero if unsegmented).
+ */
+/* Note that reduce followed by broadcast is NOT used, since the broadcast
+ * source would not be ready on entry and subordinates cannot synchronize.
+ */
+static int gasnete_coll_pf_allreduce_Red(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_allreduce_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, allreduce);
+  int result = 0;
+
+  switch (data->state) {
+  case 0:	/* Optional IN barrier */
+    if (!gasnete_coll_generic_all_threads(data) ||
+        !gasnete_coll_generic_insync(op->team, data)) {
+      break;
+    }
+    data->state = 1; GASNETI_FALLTHROUGH
+
+  case 1:	/* Initiate data movement */
+    if (!GASNETE_COLL_MAY_INIT_FOR(op)) break;
+    {
+      gasnet_coll_handle_t *h;
+      int flags = GASNETE_COLL_FORWARD_FLAGS(op->flags);
+      gasnet_team_handle_t team = op->team;
+      gasnete_coll_implementation_t impl = NULL;
+      uint32_t stride = 1;
+      gasnet_node_t i;
+
+      if (op->num_coll_params) {
+        impl = gasnete_coll_get_implementation();
+        impl->fn_ptr = NULL;
+        impl->num_params = 1;
+        impl->param_list[0] = op->param_list[0];
+        impl->tree_type = gasnete_coll_autotune_get_tree_type(team->autotune_info, GASNET_COLL_REDUCE_OP,
+                                                              -1, args->nbytes, flags);
+        stride += (args->nbytes + op->param_list[0] - 1) / op->param_list[0];
+      }
+
+      /* XXX: freelist ? */
+      h = gasneti_malloc(op->team->total_ranks * sizeof(gasnet_coll_handle_t));
+      data->private_data = h;
+
+      /* Root each reduce at the first image of a rank, so each dst is written once */
+      for (i = 0; i < op->team->total_ranks; ++i, ++h) {
+        if (impl) {
+          *h = gasnete_coll_reduce_TreeGetSeg(team, team->all_offset[i], args->dst, args->src, 0, 0,
+                                              args->elem_size, args->elem_count, args->func, args->func_arg,
+                                              flags|GASNETE_COLL_NONROOT_SUBORDINATE, impl, op->sequence+i*stride+1 GASNETI_THREAD_PASS);
+        } else {
+          *h = gasnete_coll_reduce_nb(team, team->all_offset[i], args->dst, args->src, 0, 0,
+                                      args->elem_size, args->elem_count, args->func, args->func_arg,
+                                      flags|GASNETE_COLL_NONROOT_SUBORDINATE|GASNET_COLL_DISABLE_AUTOTUNE, op->sequence+i+1 GASNETI_THREAD_PASS);
+        }
+        gasnete_coll_save_coll_handle(h GASNETI_THREAD_PASS);
+      }
+      if (impl) gasnete_coll_free_implementation(impl);
+    }
+    data->state = 2; GASNETI_FALLTHROUGH
+
+  case 2:	/* Sync data movement */
+    if (!gasnete_coll_generic_coll_sync(data->private_data, op->team->total_ranks GASNETI_THREAD_PASS)) {
+      break;
+    }
+    data->state = 3; GASNETI_FALLTHROUGH
+
+  case 3:	/* Optional OUT barrier */
+    if (!gasnete_coll_generic_outsync(op->team, data)) {
+      break;
+    }
+
+    gasneti_free(data->private_data);
+    gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+    result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+extern gasnet_coll_handle_t
+gasnete_coll_allreduce_Red(gasnet_team_handle_t team,
+                           void *dst, void *src,
+                           size_t elem_size, size_t elem_count,
+                           gasnet_coll_fn_handle_t func, int func_arg,
+                           int flags, 
+                           gasnete_coll_implementation_t coll_params,
+                           uint32_t sequence
+                           GASNETI_THREAD_FARG)
+{
+  int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (!(flags & GASNET_COLL_IN_NOSYNC)) |
+		GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(!(flags & GASNET_COLL_OUT_NOSYNC));
+  /* A subordinate Red only has one sequence number per rank reserved by its parent */
+  uint32_t seg_param = (flags & GASNETE_COLL_SUBORDINATE) ? 0 :
+                       gasnete_coll_reduce_default_seg_size(team, elem_size, elem_count, flags);
+  uint32_t stride = seg_param ? 1 + (elem_size*elem_count + seg_param - 1) / seg_param : 1;
+
+  return gasnete_coll_generic_allreduce_nb(team, dst, src, elem_size, elem_count, func, func_arg, flags,
+                                           &gasnete_coll_pf_allreduce_Red, options, NULL,
+                                           (flags & GASNETE_COLL_SUBORDINATE) ? sequence : team->total_ranks*stride,
+                                           (seg_param ? 1 : 0), &seg_param, NULL
+                                           GASNETI_THREAD_PASS);
+}
+
+extern gasnet_coll_handle_t
+gasnete_coll_generic_allreduce_nb(gasnet_team_handle_t team,
+                                  void *dst, void *src,
+                                  size_t elem_size, size_t elem_count, 
+                                  gasnet_coll_fn_handle_t func, int func_arg, int flags,
+                                  gasnete_coll_poll_fn poll_fn, int options,
+                                  void *private_data, uint32_t sequence,
+                                  int num_params, uint32_t *param_list, gasnete_coll_scratch_req_t *scratch_req
+                                  GASNETI_THREAD_FARG) {
+  gasnet_coll_handle_t result;
+  int first_thread;
+  
+  gasnete_coll_threads_lock(team, flags GASNETI_THREAD_PASS);
+  if(!(flags & GASNETE_COLL_SUBORDINATE) || ALL_THREADS_POLL) {
+    first_thread = gasnete_coll_threads_first(GASNETI_THREAD_PASS_ALONE);
+  } else {
+    first_thread = 1;
+  }
+  
+  if_pt (first_thread) {
+    gasnete_coll_generic_data_t *data = gasnete_coll_generic_alloc(GASNETI_THREAD_PASS_ALONE);
+    GASNETE_COLL_GENERIC_SET_TAG(data, allreduce);
+    data->args.allreduce.dst        = dst;
+    data->args.allreduce.src        = src;
+    data->args.allreduce.elem_size  = elem_size;
+    data->args.allreduce.elem_count = elem_count;
+    data->args.allreduce.nbytes     = elem_size*elem_count;
+    data->args.allreduce.func       = func;
+    data->args.allreduce.func_arg   = func_arg;
+    
+    data->options = options;
+    data->private_data = private_data; data->tree_info=NULL;
+    result = gasnete_coll_op_generic_init_with_scratch(team, flags, data, poll_fn, sequence, scratch_req, num_params, param_list, NULL GASNETI_THREAD_PASS);
+  } else {
+    /* only the first thread's request is used */
+    if (scratch_req) {
+      gasneti_free(scratch_req->out_sizes);
+      gasneti_free(scratch_req);
+    }
+    gasneti_free(private_data);
+    result = gasnete_coll_threads_get_handle(GASNETI_THREAD_PASS_ALONE);
+  }
+  gasnete_coll_threads_unlock(GASNETI_THREAD_PASS_ALONE);
+  return result;
+}
+
+extern gasnet_coll_handle_t
+gasnete_coll_allreduce_nb_default(gasnet_team_handle_t team,
+                                  void *dst, void *src,
+                                  size_t elem_size, size_t elem_count,
+                                  gasnet_coll_fn_handle_t func, int func_arg,
+                                  int flags, uint32_t sequence GASNETI_THREAD_FARG)
+{
+  gasnete_coll_implementation_t impl;
+  size_t nbytes = elem_size*elem_count;
+  gasnet_coll_handle_t ret;
+  
+#if GASNET_PAR
+  if(flags & GASNET_COLL_LOCAL && !(flags & GASNETE_COLL_SUBORDINATE)) {
+    return gasnete_coll_allreduceM_nb(team, &dst, &src, elem_size, elem_count, func, func_arg,
+                                      flags | GASNETE_COLL_THREAD_LOCAL, sequence GASNETI_THREAD_PASS);
+  }
+#endif
+  flags = gasnete_coll_segment_check(team, flags, 0, 0, dst, nbytes,
+                                     0, 0, src, nbytes);
+  
+  /*error check to make sure the function table is properly configured*/
+  GASNETE_COLL_CHECK_FN(func);
+  
+  impl = gasnete_coll_autotune_get_allreduce_algorithm(team, dst, src, elem_size, elem_count,
+                                                        func, func_arg, flags GASNETI_THREAD_PASS);
+  ret = (*((gasnete_coll_allreduce_fn_ptr_t) (impl->fn_ptr)))(team, dst, src, elem_size, elem_count, func, func_arg,
+                                                               flags, impl, sequence GASNETI_THREAD_PASS);
+  if(impl->need_to_free) gasnete_coll_free_implementation(impl);
+  return ret;
+}
+
+/*---------------------------------------------------------------------------------*/
+/* gasnete_coll_allreduceM_nb() */
+
+/* RedM: Implement allreduceM as one reduceM to each rank, plus a local copy */
+static int gasnete_coll_pf_allreduceM_Red(gasnete_coll_op_t *op GASNETI_THREAD_FARG) {
+  gasnete_coll_generic_data_t *data = op->data;
+  const gasnete_coll_allreduceM_args_t *args = GASNETE_COLL_GENERIC_ARGS(data, allreduceM);
+  int result = 0;
+
+  switch (data->state) {
+  case 0:	/* Optional IN barrier */
+    if (!gasnete_coll_threads_ready2(op, args->dstlist, args->srclist GASNETI_THREAD_PASS) ||
+        !gasnete_coll_generic_insync(op->team, data)) {
+      break;
+    }
+    data->state = 1; GASNETI_FALLTHROUGH
+
+  case 1:	/* Initiate data movement */
+    if (!GASNETE_COLL_MAY_INIT_FOR(op)) break;
+    {
+      gasnet_coll_handle_t *h;
+      int flags = GASNETE_COLL_FORWARD_FLAGS(op->flags);
+      gasnet_team_handle_t team = op->team;
+      gasnete_coll_implementation_t impl = NULL;
+      uint32_t stride = 1;
+      gasnet_node_t i;
+
+      if (op->num_coll_params) {
+        impl = gasnete_coll_get_implementation();
+        impl->fn_ptr = NULL;
+        impl->num_params = 1;
+        impl->param_list[0] = op->param_list[0];
+        impl->tree_type = gasnete_coll_autotune_get_tree_type(team->autotune_info, GASNET_COLL_REDUCEM_OP,
+                                                              -1, args->nbytes, flags);
+        stride += (args->nbytes + op->param_list[0] - 1) / op->param_list[0];
+      }
+
+      /* XXX: freelist ? */
+      h = gasneti_malloc(op->team->total_ranks * sizeof(gasnet_coll_handle_t));
+      data->private_data = h;
+
+      /* Root each reduceM at the first image of a rank */
+      for (i = 0; i < op->team->total_ranks; ++i, ++h) {
+        void *dst;
+        if (op->flags & GASNET_COLL_SINGLE) {
+          dst = args->dstlist[team->all_offset[i]];
+        } else {
+          dst = (i == team->myrank) ? args->dstlist[0] : NULL;
+        }
+        if (impl) {
+          *h = gasnete_coll_reduceM_TreeGetSeg(team, team->all_offset[i], dst, args->srclist, 0, 0,
+                                               args->elem_size, args->elem_count, args->func, args->func_arg,
+                                               flags|GASNETE_COLL_NONROOT_SUBORDINATE, impl, op->sequence+i*stride+1 GASNETI_THREAD_PASS);
+        } else {
+          *h = gasnete_coll_reduceM_nb(team, team->all_offset[i], dst, args->srclist, 0, 0,
+                                       args->elem_size, args->elem_count, args->func, args->func_arg,
+                                       flags|GASNETE_COLL_NONROOT_SUBORDINATE|GASNET_COLL_DISABLE_AUTOTUNE, op->sequence+i+1 GASNETI_THREAD_PASS);
+        }
+        gasnete_coll_save_coll_handle(h GASNETI_THREAD_PASS);
+      }
+      if (impl) gasnete_coll_free_implementation(impl);
+    }
+    data->state = 2; GASNETI_FALLTHROUGH
+
+  case 2:	/* Sync data movement, then copy to the remaining local images */
+    if (!gasnete_coll_generic_coll_sync(data->private_data, op->team->total_ranks GASNETI_THREAD_PASS)) {
+      break;
+    }
+    {
+      void * const *p = &GASNETE_COLL_MY_1ST_IMAGE(op->team, args->dstlist, op->flags);
+      gasnet_image_t i;
+
+      for (i = 1; i < op->team->my_images; ++i) {
+        GASNETE_FAST_UNALIGNED_MEMCPY_CHECK(p[i], p[0], args->nbytes);
+      }
+      gasneti_sync_writes();
+    }
+    data->state = 3; GASNETI_FALLTHROUGH
+
+  case 3:	/* Optional OUT barrier */
+    if (!gasnete_coll_generic_outsync(op->team, data)) {
+      break;
+    }
+
+    gasneti_free(data->private_data);
+    gasnete_coll_generic_free(op->team, data GASNETI_THREAD_PASS);
+    result = (GASNETE_COLL_OP_COMPLETE | GASNETE_COLL_OP_INACTIVE);
+  }
+
+  return result;
+}
+extern gasnet_coll_handle_t
+gasnete_coll_allreduceM_Red(gasnet_team_handle_t team,
+                            void * const dstlist[], void * const srclist[],
+                            size_t elem_size, size_t elem_count,
+                            gasnet_coll_fn_handle_t func, int func_arg,
+                            int flags, 
+                            gasnete_coll_implementation_t coll_params,
+                            uint32_t sequence
+                            GASNETI_THREAD_FARG)
+{
+  int options = GASNETE_COLL_GENERIC_OPT_INSYNC_IF (!(flags & GASNET_COLL_IN_NOSYNC)) |
+		GASNETE_COLL_GENERIC_OPT_OUTSYNC_IF(!(flags & GASNET_COLL_OUT_NOSYNC));
+  /* A subordinate Red only has one sequence number per rank reserved by its parent */
+  uint32_t seg_param = (flags & GASNETE_COLL_SUBORDINATE) ? 0 :
+                       gasnete_coll_reduce_default_seg_size(team, elem_size, elem_count, flags);
+  uint32_t stride = seg_param ? 1 + (elem_size*elem_count + seg_param - 1) / seg_param : 1;
+
+  return gasnete_coll_generic_allreduceM_nb(team, dstlist, srclist, elem_size, elem_count, func, func_arg, flags,
+                                            &gasnete_coll_pf_allreduceM_Red, options, NULL,
+                                            (flags & GASNETE_COLL_SUBORDINATE) ? sequence : team->total_ranks*stride,
+                                            (seg_param ? 1 : 0), &seg_param, NULL
+                                            GASNETI_THREAD_PASS);
+}
+
+extern gasnet_coll_handle_t
+gasnete_coll_generic_allreduceM_nb(gasnet_team_handle_t team,
+                                   void * const dstlist[], void * const srclist[],
+                                   size_t elem_size, size_t elem_count, 
+                                   gasnet_coll_fn_handle_t func, int func_arg, int flags,
+                                   gasnete_coll_poll_fn poll_fn, int options,
+                                   void *private_data, uint32_t sequence,
+                                   int num_params, uint32_t *param_list, gasnete_coll_scratch_req_t *scratch_req
+                                   GASNETI_THREAD_FARG) {
+  gasnete_coll_threaddata_t *td = GASNETE_COLL_MYTHREAD;
+  gasnet_coll_handle_t result;
+
+  if (td->my_local_image != 0) {
+    /* only the first image's request is used */
+    if (scratch_req) {
+      gasneti_free(scratch_req->out_sizes);
+      gasneti_free(scratch_req);
+    }
+    gasneti_free(private_data);
+  }
+
+#if GASNET_PAR
+  if (flags & GASNETE_COLL_THREAD_LOCAL) {
+    gasnete_coll_generic_data_t *data;
+    if (td->my_local_image == 0) {
+      data = gasnete_coll_generic_alloc(GASNETI_THREAD_PASS_ALONE);
+      GASNETE_COLL_GENERIC_SET_TAG(data, allreduceM);
+      data->threads.data = gasneti_calloc(2 * team->my_images, sizeof(void *));
+      data->args.allreduceM.srclist    = (void**)data->threads.data;
+      data->args.allreduceM.dstlist    = (void**)data->threads.data + team->my_images;
+      data->args.allreduceM.elem_size  = elem_size;
+      data->args.allreduceM.elem_count = elem_count;
+      data->args.allreduceM.nbytes     = elem_size*elem_count;
+      data->args.allreduceM.func       = func;
+      data->args.allreduceM.func_arg   = func_arg;
+      data->options = options;
+      data->private_data = private_data; data->tree_info=NULL;
+      result = gasnete_coll_op_generic_init_with_scratch(team, flags, data, poll_fn, sequence, scratch_req, num_params, param_list, NULL GASNETI_THREAD_PASS);
+      gasnete_coll_post_multi_addr_collective(team, flags GASNETI_THREAD_PASS);
+    } else {
+      gasnete_coll_wait_multi_addr_collective(team, flags GASNETI_THREAD_PASS);
+      result = gasnete_coll_threads_get_handle_and_data(&data GASNETI_THREAD_PASS);
+    }
+    gasneti_assert(*srclist != NULL);
+    data->args.allreduceM.srclist[td->my_local_image] = *srclist;
+    gasneti_assert(*dstlist != NULL);
+    data->args.allreduceM.dstlist[td->my_local_image] = *dstlist; /* signalling write */
+  } else
+#endif
+  {
+    if (td->my_local_image == 0) {
+      gasnete_coll_generic_data_t *data = gasnete_coll_generic_alloc(GASNETI_THREAD_PASS_ALONE);
+      int num_addrs = (flags & GASNET_COLL_LOCAL ? team->my_images : team->total_images);
+      void **addrs;
+      GASNETE_COLL_GENERIC_SET_TAG(data, allreduceM);
+
+#if GASNET_PAR
+      data->threads.data = addrs = gasneti_calloc(2 * num_addrs, sizeof(void *));
+#else
+      data->addrs = addrs = gasneti_calloc(2 * num_addrs, sizeof(void *));
+#endif
+      data->args.allreduceM.srclist = addrs;
+      data->args.allreduceM.dstlist = addrs + num_addrs;
+      GASNETE_FAST_UNALIGNED_MEMCPY(data->args.allreduceM.srclist, srclist, sizeof(void*)*num_addrs);
+      GASNETE_FAST_UNALIGNED_MEMCPY(data->args.allreduceM.dstlist, dstlist, sizeof(void*)*num_addrs);
+      data->args.allreduceM.elem_size  = elem_size;
+      data->args.allreduceM.elem_count = elem_count;
+      data->args.allreduceM.nbytes     = elem_size*elem_count;
+      data->args.allreduceM.func       = func;
+      data->args.allreduceM.func_arg   = func_arg;
+      data->options = options;
+      data->private_data = private_data; data->tree_info=NULL;
+      result = gasnete_coll_op_generic_init_with_scratch(team, flags, data, poll_fn, sequence, scratch_req, num_params, param_list, NULL GASNETI_THREAD_PASS);
+      gasnete_coll_post_multi_addr_collective(team, flags GASNETI_THREAD_PASS);
+    } else {
+      gasnete_coll_wait_multi_addr_collective(team, flags GASNETI_THREAD_PASS);
+      result = gasnete_coll_threads_get_handle(GASNETI_THREAD_PASS_ALONE);
+    }
+  }
+
+  return result;
+}
+
+extern gasnet_coll_handle_t
+gasnete_coll_allreduceM_nb_default(gasnet_team_handle_t team,
+                                   void * const dstlist[], void * const srclist[],
+                                   size_t elem_size, size_t elem_count,
+                                   gasnet_coll_fn_handle_t func, int func_arg,
+                                   int flags, uint32_t sequence GASNETI_THREAD_FARG)
+{
+  gasnete_coll_implementation_t impl;
+  size_t nbytes = elem_size*elem_count;
+  gasnet_coll_handle_t ret;
+#if GASNET_SEQ
+  /* Exactly one thread-local addr per list - forward to allreduce_nb() */
+  if(flags & GASNET_COLL_LOCAL) {
+    return gasnete_coll_allreduce_nb(team, dstlist[0], srclist[0], elem_size, elem_count,
+                                     func, func_arg, flags, sequence GASNETI_THREAD_PASS);
+  }
+#endif
+  /* "Discover" in-segment flags if needed/possible */
+  flags = gasnete_coll_segment_checkM(team, flags, 0, 0, dstlist, nbytes,
+                                      0, 0, srclist, nbytes);
+  
+  /*error check to make sure the function table is properly configured*/
+  GASNETE_COLL_CHECK_FN(func);
+  
+  impl = gasnete_coll_autotune_get_allreduceM_algorithm(team, dstlist, srclist, elem_size, elem_count,
+                                                         func, func_arg, flags GASNETI_THREAD_PASS);
+  ret = (*((gasnete_coll_allreduceM_fn_ptr_t) (impl->fn_ptr)))(team, dstlist, srclist, elem_size, elem_count, func, func_arg,
+                                                                flags, impl, sequence GASNETI_THREAD_PASS);
+  if(impl->need_to_free) gasnete_coll_free_implementation(impl);
+  return ret;
+}
+
 /*---------------------------------------------------------------------------------*/
 
 extern gasnet_coll_handle_t
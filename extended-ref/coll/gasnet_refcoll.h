@@ -32,7 +32,7 @@
 #define _hidx_gasnete_coll_p2p_seg_put_reqh (GASNETE_COLL_HANDLER_BASE+8)
 
 /*---------------------------------------------------------------------------------*/
-/*four args: team id, node id, seq number, head, tail*/
+/*three args: team id, node id, scratch slot*/
 #define GASNETE_COLL_NUM_SCRATCH_HANDLERS 1
 #ifndef GASNETE_COLL_SCRATCH_HANDLER_BASE
 #define GASNETE_COLL_SCRATCH_HANDLER_BASE (GASNETE_COLL_HANDLER_BASE-GASNETE_COLL_NUM_SCRATCH_HANDLERS)
@@ -40,11 +40,14 @@
 
 #define _hidx_gasnete_coll_scratch_update_reqh (GASNETE_COLL_SCRATCH_HANDLER_BASE+0)
 
-#define GASNETE_COLL_NUM_TEAM_HANDLERS 1
+#define GASNETE_COLL_NUM_TEAM_HANDLERS 4
 #ifndef GASNETE_COLL_TEAM_HANDLER_BASE
-#define GASNETE_COLL_TEAM_HANDLER_BASE (GASNETE_COLL_SCRATCH_HANDLER_BASE-GASNETE_COLL_NUM_SCRATCH_HANDLERS)
+#define GASNETE_COLL_TEAM_HANDLER_BASE (GASNETE_COLL_SCRATCH_HANDLER_BASE-GASNETE_COLL_NUM_TEAM_HANDLERS)
 #endif
 #define _hidx_gasnete_coll_teamid_reqh (GASNETE_COLL_TEAM_HANDLER_BASE+0)
+#define _hidx_gasnete_coll_split_join_reqh (GASNETE_COLL_TEAM_HANDLER_BASE+1)
+#define _hidx_gasnete_coll_split_join_reph (GASNETE_COLL_TEAM_HANDLER_BASE+2)
+#define _hidx_gasnete_coll_split_members_reqh (GASNETE_COLL_TEAM_HANDLER_BASE+3)
 
 #ifndef GASNETE_COLL_P2P_OVERRIDE
 
@@ -75,13 +78,20 @@ MEDIUM_HANDLER_NOBITS_DECL(gasnete_coll_p2p_med_counting_reqh,5);
 #endif
 
 #ifndef GASNETE_COLL_SCRATCH_OVERRIDE
-SHORT_HANDLER_NOBITS_DECL(gasnete_coll_scratch_update_reqh, 2);
+SHORT_HANDLER_NOBITS_DECL(gasnete_coll_scratch_update_reqh, 3);
 #define GASNETE_COLL_SCRATCH_HANDLERS() gasneti_handler_tableentry_no_bits(gasnete_coll_scratch_update_reqh),
 #endif
 
 #ifndef GASNETE_COLL_TEAM_OVERRIDE
 SHORT_HANDLER_NOBITS_DECL(gasnete_coll_teamid_reqh, 1);
-#define GASNETE_COLL_TEAM_HANDLERS() gasneti_handler_tableentry_no_bits(gasnete_coll_teamid_reqh),
+MEDIUM_HANDLER_NOBITS_DECL(gasnete_coll_split_join_reqh, 1);
+SHORT_HANDLER_NOBITS_DECL(gasnete_coll_split_join_reph, 1);
+MEDIUM_HANDLER_NOBITS_DECL(gasnete_coll_split_members_reqh, 4);
+#define GASNETE_COLL_TEAM_HANDLERS() \
+      gasneti_handler_tableentry_no_bits(gasnete_coll_teamid_reqh),       \
+      gasneti_handler_tableentry_no_bits(gasnete_coll_split_join_reqh),   \
+      gasneti_handler_tableentry_no_bits(gasnete_coll_split_join_reph),   \
+      gasneti_handler_tableentry_no_bits(gasnete_coll_split_members_reqh),
 #endif
 
 #define GASNETE_REFCOLL_HANDLERS()                           \
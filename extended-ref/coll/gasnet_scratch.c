@@ -13,6 +13,9 @@ typedef struct gasnete_coll_op_info_t_ gasnete_coll_op_info_t;
 struct gasnete_coll_scratch_config_t_;
 typedef struct gasnete_coll_scratch_config_t_ gasnete_coll_scratch_config_t;
 
+struct gasnete_coll_scratch_slot_t_;
+typedef struct gasnete_coll_scratch_slot_t_ gasnete_coll_scratch_slot_t;
+
 
 typedef enum {GASNETE_COLL_SCRATCH_NO_WAIT=0, GASNETE_COLL_SCRATCH_BAD_CONFIG, 
   GASNETE_COLL_SCRATCH_FULL, GASNETE_COLL_SCRATCH_DRAIN_IN_PROGRESS} gasnete_coll_scratch_reason_t;
@@ -78,8 +81,8 @@ struct gasnete_coll_scratch_config_t_ {
 };
 
 
-/*this structure describes an operation info*/
-struct gasnete_coll_scratch_status_t_ {
+/*one slot of the scratch space: a ring of its own, owned by one collective shape at a time*/
+struct gasnete_coll_scratch_slot_t_ {
   /*creates an array of node statuses*/
   /* list of currently active peers*/
   
@@ -94,32 +97,93 @@ struct gasnete_coll_scratch_status_t_ {
   /*an indicator telling you whether the upcoming collective op is the first after a barrier*/
   uint8_t scratch_empty;
   uint8_t clear_signal_sent;
+  int index;
   gasnete_coll_team_t team;
 
 };
 
+/*the scratch space of a team, cut into slots*/
+struct gasnete_coll_scratch_status_t_ {
+  gasnete_coll_scratch_slot_t *slots;
+  int num_slots;
+  gasnete_coll_team_t team;
+};
+
+/* the scratch space of every node is cut into the same number of equal slots */
+GASNETI_INLINE(gasnete_coll_scratch_slot_size)
+uint64_t gasnete_coll_scratch_slot_size(gasnete_coll_team_t team, gasnet_node_t node) {
+  if(team->scratch_status->num_slots == 1) return team->scratch_segs[node].size;
+  return GASNETI_ALIGNDOWN(team->scratch_segs[node].size / team->scratch_status->num_slots,
+                           GASNETE_COLL_SCRATCH_SLOT_ALIGN);
+}
+
+GASNETI_INLINE(gasnete_coll_scratch_slot_base)
+uint64_t gasnete_coll_scratch_slot_base(gasnete_coll_scratch_slot_t *slot, gasnet_node_t node) {
+  return slot->index * gasnete_coll_scratch_slot_size(slot->team, node);
+}
+
+/* Every node derives the slot of an op from the same fields of its request,
+   so senders and receivers pick the same ring without talking.  Dissemination
+   ops keep slot 0 to themselves and trees share the others, so neither has to
+   drain the scratch space for the other. */
+GASNETI_INLINE(gasnete_coll_scratch_slot_of)
+int gasnete_coll_scratch_slot_of(gasnete_coll_scratch_status_t *stat, gasnete_coll_scratch_req_t *req) {
+  gasnete_coll_tree_type_t t;
+  uint32_t h;
+  int i;
+
+  if(stat->num_slots == 1 || req->op_type == GASNETE_COLL_DISSEM_OP) return 0;
+  h = ((uint32_t)req->root << 1) ^ (uint32_t)req->tree_dir;
+  for(t = req->tree_type; t; t = t->subtree) {
+    h = h*31 + (uint32_t)t->tree_class;
+    for(i=0; i<t->num_params; i++) h = h*31 + (uint32_t)t->params[i];
+  }
+  return 1 + h % (stat->num_slots-1);
+}
+
 
 void gasnete_coll_alloc_new_scratch_status(gasnete_coll_team_t team) {
   gasnete_coll_scratch_status_t *stat;
-  int i;
+  static int num_slots = 0;
+  int i, k;
   
+  if(!num_slots) {
+    num_slots = gasneti_getenv_int_withdefault("GASNET_COLL_SCRATCH_SLOTS", GASNETE_COLL_SCRATCH_SLOTS_DEFAULT, 0);
+    num_slots = MAX(1, MIN(num_slots, GASNETE_COLL_SCRATCH_MAX_SLOTS));
+  }
+
   stat = (gasnete_coll_scratch_status_t*) gasneti_calloc(1,sizeof(gasnete_coll_scratch_status_t));
-  stat->node_status = (gasnete_coll_node_scratch_status_t*)gasneti_malloc(sizeof(gasnete_coll_node_scratch_status_t)*team->total_ranks);
-  
-  stat->active_config_and_ops = NULL;
-  stat->waiting_config_and_ops_head = stat->waiting_config_and_ops_tail = NULL;
-  stat->num_waiting_ops = 0;
   stat->team = team;
-  stat->scratch_empty = 1;
-  stat->clear_signal_sent = 0;
-  for(i=0; i<team->total_ranks; i++) {
-    stat->node_status[i].head = 0;
-    gasneti_weakatomic_set(&(stat->node_status[i].reset_signal_sent),0,0);
-    gasneti_weakatomic_set(&(stat->node_status[i].reset_signal_recv),0,0);
+  /* every node sees the same smallest segment, so every node drops the same slots */
+  stat->num_slots = num_slots;
+  while(stat->num_slots > 1 && team->smallest_scratch_seg / stat->num_slots < GASNETE_COLL_SCRATCH_MIN_SLOT_SIZE) {
+    stat->num_slots--;
   }
-  
+  stat->slots = (gasnete_coll_scratch_slot_t*) gasneti_calloc(stat->num_slots,sizeof(gasnete_coll_scratch_slot_t));
   team->scratch_status = stat;
+  
+  for(k=0; k<stat->num_slots; k++) {
+    gasnete_coll_scratch_slot_t *slot = &stat->slots[k];
+    slot->node_status = (gasnete_coll_node_scratch_status_t*)gasneti_malloc(sizeof(gasnete_coll_node_scratch_status_t)*team->total_ranks);
+  
+    slot->active_config_and_ops = NULL;
+    slot->waiting_config_and_ops_head = slot->waiting_config_and_ops_tail = NULL;
+    slot->num_waiting_ops = 0;
+    slot->index = k;
+    slot->team = team;
+    slot->scratch_empty = 1;
+    slot->clear_signal_sent = 0;
+    for(i=0; i<team->total_ranks; i++) {
+      slot->node_status[i].head = 0;
+      gasneti_weakatomic_set(&(slot->node_status[i].reset_signal_sent),0,0);
+      gasneti_weakatomic_set(&(slot->node_status[i].reset_signal_recv),0,0);
+    }
+  }
 
+  /* collectives only ever see one slot */
+  if(stat->num_slots > 1)
+    team->smallest_scratch_seg = GASNETI_ALIGNDOWN(team->smallest_scratch_seg / stat->num_slots,
+                                                   GASNETE_COLL_SCRATCH_SLOT_ALIGN);
 }
 
 
@@ -128,19 +192,19 @@ void gasnete_coll_free_scratch_status(gasnete_coll_scratch_status_t *in GASNETI_
 }
 
 
-void gasnete_coll_scratch_send_updates(gasnete_coll_team_t team, int seq) {
+void gasnete_coll_scratch_send_updates(gasnete_coll_scratch_slot_t *stat, int seq) {
   int i;
-  gasnete_coll_scratch_status_t *stat = team->scratch_status;
+  gasnete_coll_team_t team = stat->team;
   
   /*Becareful with the teams here and how the peer list is specified*/
   /*for gasnet team all it doesn't matter but in other cases it does
   stat->active_config_and_ops->peers[i] needs to be translated to an absolute rank*/
   for(i=0; i<stat->active_config_and_ops->numpeers; i++) {
-    GASNETI_SAFE(SHORT_REQ(2,2,(GASNETE_COLL_REL2ACT(team, stat->active_config_and_ops->peers[i]),
+    GASNETI_SAFE(SHORT_REQ(3,3,(GASNETE_COLL_REL2ACT(team, stat->active_config_and_ops->peers[i]),
                                 gasneti_handleridx(gasnete_coll_scratch_update_reqh),
-                                team->team_id, team->myrank)));
+                                team->team_id, team->myrank, stat->index)));
 #if GASNETE_COLL_SCRATCH_DEBUG_PRINTS
-    fprintf(stderr, "%d,%d> CLEAR!->%d\n", seq, gasneti_mynode, stat->active_config_and_ops->peers[i]); 
+    fprintf(stderr, "%d,%d> CLEAR!->%d (slot %d)\n", seq, gasneti_mynode, stat->active_config_and_ops->peers[i], stat->index); 
 #endif
     
   }
@@ -149,16 +213,18 @@ void gasnete_coll_scratch_send_updates(gasnete_coll_team_t team, int seq) {
 
 void gasnete_coll_scratch_update_reqh(gasnet_token_t token,
 				      gasnet_handlerarg_t teamid,
-				      gasnet_handlerarg_t node) {
+				      gasnet_handlerarg_t node,
+				      gasnet_handlerarg_t slot) {
   gasnete_coll_team_t team;
   gasnete_coll_scratch_status_t *stat;
   
   team = gasnete_coll_team_lookup(teamid);
   stat = team->scratch_status;
   gasneti_assert(stat);
-  gasneti_assert(stat->node_status);
+  gasneti_assert(slot < stat->num_slots);
+  gasneti_assert(stat->slots[slot].node_status);
   /* for now signal the new val as 1*/
-  gasneti_weakatomic_increment(&(stat->node_status[node].reset_signal_sent),0);
+  gasneti_weakatomic_increment(&(stat->slots[slot].node_status[node].reset_signal_sent),0);
 }
 /***************************/
 
@@ -230,7 +296,7 @@ gasnete_coll_op_info_t* gasnete_coll_scratch_remove_first_op_from_config(gasnete
 
 GASNETI_INLINE(gasnete_coll_scratch_add_to_wait)
 void gasnete_coll_scratch_add_to_wait(gasnete_coll_scratch_req_t *scratch_req, gasnete_coll_op_t* op) {
-  gasnete_coll_scratch_status_t *stat = scratch_req->team->scratch_status;
+  gasnete_coll_scratch_slot_t *stat = &scratch_req->team->scratch_status->slots[scratch_req->slot];
   gasnete_coll_op_info_t *new_op;
   gasnete_coll_scratch_config_t *temp;
     
@@ -269,7 +335,7 @@ void gasnete_coll_scratch_add_to_wait(gasnete_coll_scratch_req_t *scratch_req, g
 }
 
 GASNETI_INLINE(gasnete_coll_scratch_remove_first_waiting_op)
-gasnete_coll_op_info_t* gasnete_coll_scratch_remove_first_waiting_op(gasnete_coll_scratch_status_t *stat) {
+gasnete_coll_op_info_t* gasnete_coll_scratch_remove_first_waiting_op(gasnete_coll_scratch_slot_t *stat) {
   gasnete_coll_op_info_t* ret;
   ret = gasnete_coll_scratch_remove_first_op_from_config(stat->waiting_config_and_ops_head);
   stat->num_waiting_ops--;
@@ -292,7 +358,7 @@ gasnete_coll_op_info_t* gasnete_coll_scratch_remove_first_waiting_op(gasnete_col
 }
 
 GASNETI_INLINE(gasnete_coll_scratch_reconfigure)
-void gasnete_coll_scratch_reconfigure(gasnete_coll_scratch_status_t *stat, 
+void gasnete_coll_scratch_reconfigure(gasnete_coll_scratch_slot_t *stat, 
                                       gasnete_coll_scratch_req_t *req,
                                       gasnete_coll_scratch_config_t *new_config) {
   /* free the old configuration*/
@@ -326,23 +392,23 @@ void gasnete_coll_scratch_reconfigure(gasnete_coll_scratch_status_t *stat,
 
 GASNETI_INLINE(gasnete_coll_scratch_check_local_alloc)
 uint8_t gasnete_coll_scratch_check_local_alloc(gasnete_coll_scratch_req_t *req,
-                                               gasnete_coll_scratch_status_t *stat) {
+                                               gasnete_coll_scratch_slot_t *stat) {
   return (req->incoming_size + stat->node_status[req->team->myrank].head <= 
-          req->team->scratch_segs[req->team->myrank].size);
+          gasnete_coll_scratch_slot_size(req->team, req->team->myrank));
 }
 
 GASNETI_INLINE(gasnete_coll_scratch_make_local_alloc)
 uint64_t gasnete_coll_scratch_make_local_alloc(gasnete_coll_scratch_req_t *req,
-                                               gasnete_coll_scratch_status_t *stat) {
+                                               gasnete_coll_scratch_slot_t *stat) {
   uint64_t ret;
-  ret = stat->node_status[req->team->myrank].head;
+  ret = gasnete_coll_scratch_slot_base(stat, req->team->myrank) + stat->node_status[req->team->myrank].head;
   stat->node_status[req->team->myrank].head += req->incoming_size;
   return ret;
 }
 
 GASNETI_INLINE(gasnete_coll_scratch_check_remote_clear)
 uint8_t gasnete_coll_scratch_check_remote_clear(gasnete_coll_scratch_req_t *req,
-                                                gasnete_coll_scratch_status_t *stat) {
+                                                gasnete_coll_scratch_slot_t *stat) {
   gasnet_node_t i;
   
   for(i=0; i<req->num_out_peers; i++) {
@@ -364,12 +430,12 @@ uint8_t gasnete_coll_scratch_check_remote_clear(gasnete_coll_scratch_req_t *req,
 
 GASNETI_INLINE(gasnete_coll_scratch_check_remote_alloc)
 uint8_t gasnete_coll_scratch_check_remote_alloc(gasnete_coll_scratch_req_t *req,
-                                                gasnete_coll_scratch_status_t *stat) {
+                                                gasnete_coll_scratch_slot_t *stat) {
   gasnet_node_t i;
   
   for(i=0; i<req->num_out_peers; i++) {
     if(stat->node_status[req->out_peers[i]].head + req->out_sizes[(req->op_type == GASNETE_COLL_DISSEM_OP ? 0 : i)] >  
-       req->team->scratch_segs[req->out_peers[i]].size) {
+       gasnete_coll_scratch_slot_size(req->team, req->out_peers[i])) {
       /*fprintf(stderr, "%d> waiting for clear from %d\n", gasneti_mynode, req->out_peers[i]);*/
       /* remote space is full */
       if(gasneti_weakatomic_read(&(stat->node_status[req->out_peers[i]].reset_signal_sent),0)==
@@ -388,26 +454,32 @@ uint8_t gasnete_coll_scratch_check_remote_alloc(gasnete_coll_scratch_req_t *req,
 
 GASNETI_INLINE(gasnete_coll_scratch_make_remote_alloc)
 void gasnete_coll_scratch_make_remote_alloc(gasnete_coll_scratch_req_t *req,
-                                            gasnete_coll_scratch_status_t *stat,
+                                            gasnete_coll_scratch_slot_t *stat,
                                             uint64_t *rem_pos) {
   gasnet_node_t i;
   for(i=0; i<req->num_out_peers; i++) {
-    rem_pos[i] = stat->node_status[req->out_peers[i]].head;
+    rem_pos[i] = gasnete_coll_scratch_slot_base(stat, req->out_peers[i]) + stat->node_status[req->out_peers[i]].head;
     stat->node_status[req->out_peers[i]].head += req->out_sizes[(req->op_type == GASNETE_COLL_DISSEM_OP ? 0 : i)]; 
   }  
 }
 
-int8_t gasnete_coll_scratch_alloc_nb(gasnete_coll_op_t* op GASNETI_THREAD_FARG) {
+GASNETI_INLINE(gasnete_coll_scratch_do_alloc_nb)
+int8_t gasnete_coll_scratch_do_alloc_nb(gasnete_coll_op_t* op GASNETI_THREAD_FARG) {
   gasnete_coll_scratch_req_t *scratch_req = op->scratch_req;
-  gasnete_coll_scratch_status_t *stat = scratch_req->team->scratch_status;
+  gasnete_coll_scratch_slot_t *stat;
 
   gasneti_assert(scratch_req);
-  gasneti_assert(stat);
+  gasneti_assert(scratch_req->team->scratch_status);
+  scratch_req->slot = gasnete_coll_scratch_slot_of(scratch_req->team->scratch_status, scratch_req);
+  stat = &scratch_req->team->scratch_status->slots[scratch_req->slot];
   /*if the incoming size is greater than the total allocated scratch space signal an error*/
-  if(scratch_req->incoming_size > scratch_req->team->scratch_segs[scratch_req->team->myrank].size) {
-    gasneti_fatalerror("%d> collective requires temporary storage (%"PRIuPTR" bytes) which is greater than total scratch space (%"PRIuPTR" bytes)\nIncrease size of collective scratch space through GASNET_COLL_SCRATCH_SIZE environment variable to at least %"PRIuPTR" bytes\n", 
+  if(scratch_req->incoming_size > gasnete_coll_scratch_slot_size(scratch_req->team, scratch_req->team->myrank)) {
+    const int num_slots = scratch_req->team->scratch_status->num_slots;
+    gasneti_fatalerror("%d> collective requires temporary storage (%"PRIuPTR" bytes) which is greater than one of the %d slots of scratch space (%"PRIuPTR" bytes)\nIncrease size of collective scratch space through GASNET_COLL_SCRATCH_SIZE environment variable to at least %"PRIuPTR" bytes, or lower GASNET_COLL_SCRATCH_SLOTS\n", 
                        (int)scratch_req->team->myrank, 
-                       (uintptr_t)scratch_req->incoming_size, (uintptr_t)scratch_req->team->scratch_segs[0].size, (uintptr_t)scratch_req->incoming_size); 
+                       (uintptr_t)scratch_req->incoming_size, num_slots,
+                       (uintptr_t)gasnete_coll_scratch_slot_size(scratch_req->team, scratch_req->team->myrank),
+                       (uintptr_t)(scratch_req->incoming_size*num_slots)); 
   }
   gasneti_assert(op->waiting_scratch_op == 0 || op->waiting_scratch_op == 1);
   if(op->waiting_scratch_op) {
@@ -458,7 +530,7 @@ int8_t gasnete_coll_scratch_alloc_nb(gasnete_coll_op_t* op GASNETI_THREAD_FARG)
     if(stat->clear_signal_sent==0) {
       stat->node_status[scratch_req->team->myrank].head = 0; 
       /* send a clear signal to the new peers*/
-      gasnete_coll_scratch_send_updates(scratch_req->team, op->sequence);
+      gasnete_coll_scratch_send_updates(stat, op->sequence);
       stat->clear_signal_sent=1; /* make sure clear signal is sent only once per drain cycle*/
     }
 
@@ -516,7 +588,7 @@ int8_t gasnete_coll_scratch_alloc_nb(gasnete_coll_op_t* op GASNETI_THREAD_FARG)
         if(stat->clear_signal_sent==0) {
           stat->node_status[scratch_req->team->myrank].head = 0; 
           /* send a clear signal to the new peers*/
-          gasnete_coll_scratch_send_updates(scratch_req->team, op->sequence);
+          gasnete_coll_scratch_send_updates(stat, op->sequence);
           stat->clear_signal_sent=1; /* make sure clear signal is sent only once per drain cycle*/
         }
       } else {
@@ -585,9 +657,11 @@ int8_t gasnete_coll_scratch_alloc_nb(gasnete_coll_op_t* op GASNETI_THREAD_FARG)
 }
 
   
-void gasnete_coll_free_scratch(gasnete_coll_op_t *op) {
+GASNETI_INLINE(gasnete_coll_scratch_do_free)
+void gasnete_coll_scratch_do_free(gasnete_coll_op_t *op) {
   /* find the op in the active scratch op list and remove it*/
-  gasnete_coll_op_info_t *temp= op->scratch_req->team->scratch_status->active_config_and_ops->op_list_head;
+  gasnete_coll_scratch_slot_t *stat = &op->scratch_req->team->scratch_status->slots[op->scratch_req->slot];
+  gasnete_coll_op_info_t *temp= stat->active_config_and_ops->op_list_head;
   int op_found = 0;
   int first = 1;
 
@@ -601,11 +675,11 @@ void gasnete_coll_free_scratch(gasnete_coll_op_t *op) {
     if(temp->seq_number == op->sequence) {
       if(temp->next) temp->next->prev = temp->prev;
       if(temp->prev) temp->prev->next = temp->next;
-      if(temp == op->scratch_req->team->scratch_status->active_config_and_ops->op_list_head) {
-        op->scratch_req->team->scratch_status->active_config_and_ops->op_list_head = temp->next;
+      if(temp == stat->active_config_and_ops->op_list_head) {
+        stat->active_config_and_ops->op_list_head = temp->next;
       } 
-      if(temp == op->scratch_req->team->scratch_status->active_config_and_ops->op_list_tail) {
-        op->scratch_req->team->scratch_status->active_config_and_ops->op_list_tail = temp->prev;
+      if(temp == stat->active_config_and_ops->op_list_tail) {
+        stat->active_config_and_ops->op_list_tail = temp->prev;
       }
       op_found = 1;
       gasneti_free(temp);
@@ -623,16 +697,72 @@ void gasnete_coll_free_scratch(gasnete_coll_op_t *op) {
 #if GASNET_DEBUG
   op->scratch_op_freed = 1;
 #endif
-  op->scratch_req->team->scratch_status->active_config_and_ops->num_ops--;
+  stat->active_config_and_ops->num_ops--;
   
-  if(op->scratch_req->team->scratch_status->active_config_and_ops->num_ops==0) {
-    op->scratch_req->team->scratch_status->active_config_and_ops->op_list_head = 
-    op->scratch_req->team->scratch_status->active_config_and_ops->op_list_tail = NULL;
+  if(stat->active_config_and_ops->num_ops==0) {
+    stat->active_config_and_ops->op_list_head = 
+    stat->active_config_and_ops->op_list_tail = NULL;
   } else {
-    gasneti_assert(op->scratch_req->team->scratch_status->active_config_and_ops->op_list_head);
-    gasneti_assert(op->scratch_req->team->scratch_status->active_config_and_ops->op_list_tail);
+    gasneti_assert(stat->active_config_and_ops->op_list_head);
+    gasneti_assert(stat->active_config_and_ops->op_list_tail);
   }
 
   gasneti_free(op->scratch_req);
 
 }
+
+#if GASNET_PAR
+/* When several threads poll (see gasnete_coll_progress_mode), the ops of one
+   team can reach the scratch allocator out of order.  Every node must queue
+   them in the same order, so an op only makes its first request once every
+   lower-numbered active op of its team that holds a scratch request has made
+   its own.  An op which reserved sequence numbers may still create
+   subordinates that need scratch, so it holds back requests from ops beyond
+   its reserved range until it is done. */
+static int gasnete_coll_scratch_turn(gasnete_coll_op_t *op) {
+  gasnete_coll_op_t *other;
+  int ok = 1;
+
+  gasneti_mutex_lock(&gasnete_coll_active_lock);
+  for (other = gasnete_coll_active_first(); other; other = gasnete_coll_active_next(other)) {
+    const int32_t ahead = (int32_t)(op->sequence - other->sequence);
+    if ((other != op) && (other->team == op->team) && (ahead > 0) &&
+        ((other->scratch_req && !other->scratch_requested) ||
+         ((uint32_t)ahead > other->reserved_seqs && other->reserved_seqs))) {
+      ok = 0;
+      break;
+    }
+  }
+  gasneti_mutex_unlock(&gasnete_coll_active_lock);
+  return ok;
+}
+#endif
+
+int8_t gasnete_coll_scratch_alloc_nb(gasnete_coll_op_t* op GASNETI_THREAD_FARG) {
+  int8_t result;
+#if GASNET_PAR
+  const int locked = (gasnete_coll_progress_mode != GASNETE_COLL_PROGRESS_IMAGE0);
+  if (locked) {
+    if (!op->scratch_requested && !gasnete_coll_scratch_turn(op)) return 0;
+    gasneti_mutex_lock(&op->team->state_lock);
+  }
+#endif
+  op->scratch_requested = 1;
+  result = gasnete_coll_scratch_do_alloc_nb(op GASNETI_THREAD_PASS);
+#if GASNET_PAR
+  if (locked) gasneti_mutex_unlock(&op->team->state_lock);
+#endif
+  return result;
+}
+
+void gasnete_coll_free_scratch(gasnete_coll_op_t *op) {
+#if GASNET_PAR
+  const int locked = (gasnete_coll_progress_mode != GASNETE_COLL_PROGRESS_IMAGE0);
+  gasnete_coll_team_t team = op->team;
+  if (locked) gasneti_mutex_lock(&team->state_lock);
+#endif
+  gasnete_coll_scratch_do_free(op);
+#if GASNET_PAR
+  if (locked) gasneti_mutex_unlock(&team->state_lock);
+#endif
+}
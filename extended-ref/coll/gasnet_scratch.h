@@ -12,6 +12,16 @@
 #define GASNETE_COLL_SCRATCH_TREE_OP 0
 #define GASNETE_COLL_SCRATCH_DISSEM_OP 1
 
+/* The scratch space is cut into slots, each one a ring with its own
+   configuration, so that ops of different shapes only drain each other
+   when they land in the same slot (see gasnete_coll_scratch_slot_of()). */
+#ifndef GASNETE_COLL_SCRATCH_SLOTS_DEFAULT
+#define GASNETE_COLL_SCRATCH_SLOTS_DEFAULT 1
+#endif
+#define GASNETE_COLL_SCRATCH_MAX_SLOTS 16
+#define GASNETE_COLL_SCRATCH_MIN_SLOT_SIZE (64*1024) /* fewer slots rather than smaller ones */
+#define GASNETE_COLL_SCRATCH_SLOT_ALIGN 64
+
 
 struct gasnete_coll_node_scratch_status_t_;
 typedef struct gasnete_coll_node_scratch_status_t_ gasnete_coll_node_scratch_status_t;
@@ -49,7 +59,8 @@ struct gasnete_coll_scratch_req_t_ {
   gasnet_node_t *out_peers;
   uint64_t *out_sizes;
   
-  
+  /*the slot of the scratch space this op uses, set by gasnete_coll_scratch_alloc_nb()*/
+  int slot;
 };
 
 /* try to allocate scratch space*/
@@ -129,16 +129,20 @@ static void initialize_team_fields(gasnete_coll_team_t team,
   team->dissem_cache_head = NULL;
   team->dissem_cache_tail = NULL;
   gasneti_mutex_init(&team->dissem_cache_lock);
+#if GASNET_PAR
+  gasneti_mutex_init(&team->state_lock);
+#endif
   team->myrank = myrank;
   team->total_ranks = num_members;
   team->scratch_segs = scratch_segments;
   team->smallest_scratch_seg = smallest_scratch_seg;
+  /*reduces smallest_scratch_seg to the size of one slot, which is what the algorithms get*/
+  gasnete_coll_alloc_new_scratch_status(team);
   team->autotune_info = gasnete_coll_autotune_init(team, myrank, num_members, 
                                                    team->my_images, team->total_images,
-                                                   smallest_scratch_seg GASNETI_THREAD_PASS);
+                                                   team->smallest_scratch_seg GASNETI_THREAD_PASS);
   team->consensus_issued_id = 0;
   team->consensus_id = 0;
-  gasnete_coll_alloc_new_scratch_status(team);
   gasneti_weakatomic_set(&team->num_multi_addr_collectives_started, 0, GASNETT_ATOMIC_WMB_PRE);
   if(!team->fixed_image_count && team->myrank ==0) {
     fprintf(stderr, "WARNING: Current collective implementation requires a constant number\n");
@@ -149,6 +153,7 @@ static void initialize_team_fields(gasnete_coll_team_t team,
   gasnet_hsl_init(&team->p2p_lock);
   team->p2p_freelist = NULL;
   for (i = 0; i < GASNETE_COLL_P2P_TABLE_SIZE; ++i) {
+    team->p2p_ring[i] = NULL;
     team->p2p_table[i] = NULL;
   }
 #endif
@@ -170,6 +175,127 @@ static int gasnete_node_pair_sort_fn(const void *a_p, const void *b_p) {
   }
 }
 
+/*---------------------------------------------------------------------------------*/
+/* Machine topology beyond the supernode:
+ *   SOCKET - GASNET_COLL_TOPO_SOCKETS splits the processes of each host into
+ *            that many equal blocks (in node order), one per socket
+ *   HOST   - gasneti_nodeinfo[].host
+ *   GROUP  - a rack/switch group, read from GASNET_COLL_TOPO_FILE (lines of
+ *            "<first>[-<last>] <group>" naming GASNet nodes) or formed from
+ *            every GASNET_COLL_TOPO_GROUP_HOSTS consecutive hosts
+ * The tables are built once, from data every node computes identically, so
+ * no communication is needed to agree on the domains.
+ */
+static gasneti_mutex_t gasnete_coll_topo_lock = GASNETI_MUTEX_INITIALIZER;
+static int gasnete_coll_topo_ready = 0;
+static uint32_t *gasnete_coll_topo_socket = NULL; /* NULL unless more than one socket per host */
+static uint32_t *gasnete_coll_topo_group = NULL;  /* NULL unless GASNET_COLL_TOPO_FILE is set */
+static uint32_t gasnete_coll_topo_group_hosts = 0;
+
+#define GASNETE_COLL_TOPO_HOST_OF(N) (gasneti_nodeinfo ? gasneti_nodeinfo[(N)].host : 0)
+
+static void gasnete_coll_topo_read_file(const char *filename) {
+  FILE *fp = fopen(filename, "r");
+  char line[256];
+  int lineno = 0;
+  gasnet_node_t i;
+
+  if (!fp) gasneti_fatalerror("GASNET_COLL_TOPO_FILE: unable to open '%s'", filename);
+
+  /* Nodes the file does not mention each get a group of their own host,
+   * numbered from the top so they never collide with user-supplied groups */
+  gasnete_coll_topo_group = gasneti_malloc(gasneti_nodes * sizeof(uint32_t));
+  for (i = 0; i < gasneti_nodes; ++i) {
+    gasnete_coll_topo_group[i] = 0xffffffff - GASNETE_COLL_TOPO_HOST_OF(i);
+  }
+
+  while (fgets(line, sizeof(line), fp)) {
+    unsigned long first, last, group, n;
+    char *p = line;
+    ++lineno;
+    while (isspace((unsigned char)*p)) ++p;
+    if (!*p || *p == '#') continue;
+    if (sscanf(p, "%lu-%lu %lu", &first, &last, &group) != 3) {
+      if (sscanf(p, "%lu %lu", &first, &group) != 2) {
+        gasneti_fatalerror("GASNET_COLL_TOPO_FILE: malformed line %d in '%s'", lineno, filename);
+      }
+      last = first;
+    }
+    if ((first > last) || (group >= 0x80000000UL)) {
+      gasneti_fatalerror("GASNET_COLL_TOPO_FILE: invalid node range or group at line %d in '%s'", lineno, filename);
+    }
+    /* one file may serve jobs of several sizes: ignore nodes beyond this job */
+    for (n = first; n <= last && n < gasneti_nodes; ++n) {
+      gasnete_coll_topo_group[n] = group;
+    }
+  }
+  fclose(fp);
+}
+
+static void gasnete_coll_topo_init(void) {
+  int sockets;
+  const char *filename;
+
+  gasneti_mutex_lock(&gasnete_coll_topo_lock);
+  if (gasnete_coll_topo_ready) {
+    gasneti_mutex_unlock(&gasnete_coll_topo_lock);
+    return;
+  }
+
+  sockets = gasneti_getenv_int_withdefault("GASNET_COLL_TOPO_SOCKETS", 1, 0);
+  if (sockets > 1) {
+    /* Count the processes of each host, then deal them out to its sockets */
+    gasnet_node_t *count = gasneti_calloc(gasneti_nodes, sizeof(gasnet_node_t));
+    gasnet_node_t *seen  = gasneti_calloc(gasneti_nodes, sizeof(gasnet_node_t));
+    gasnet_node_t i;
+    for (i = 0; i < gasneti_nodes; ++i) {
+      count[GASNETE_COLL_TOPO_HOST_OF(i)] += 1;
+    }
+    gasnete_coll_topo_socket = gasneti_malloc(gasneti_nodes * sizeof(uint32_t));
+    for (i = 0; i < gasneti_nodes; ++i) {
+      const gasnet_node_t host = GASNETE_COLL_TOPO_HOST_OF(i);
+      const uint64_t local = seen[host]++;
+      gasnete_coll_topo_socket[i] = host * sockets + (uint32_t)((local * sockets) / count[host]);
+    }
+    gasneti_free(count);
+    gasneti_free(seen);
+  }
+
+  filename = gasneti_getenv("GASNET_COLL_TOPO_FILE");
+  if (filename && *filename) {
+    gasnete_coll_topo_read_file(filename);
+  } else {
+    gasnete_coll_topo_group_hosts = gasneti_getenv_int_withdefault("GASNET_COLL_TOPO_GROUP_HOSTS", 0, 0);
+  }
+
+  gasnete_coll_topo_ready = 1;
+  gasneti_mutex_unlock(&gasnete_coll_topo_lock);
+}
+
+/* Returns an id which is equal for two nodes iff they share a domain at the given level */
+uint32_t gasnete_coll_topo_domain(gasnete_coll_topo_level_t level, gasnet_node_t node) {
+  gasneti_assert(gasnete_coll_topo_ready);
+  gasneti_assert(node < gasneti_nodes);
+  switch (level) {
+    case GASNETE_COLL_TOPO_SOCKET:
+      return gasnete_coll_topo_socket ? gasnete_coll_topo_socket[node] : GASNETE_COLL_TOPO_HOST_OF(node);
+    case GASNETE_COLL_TOPO_HOST:
+      return GASNETE_COLL_TOPO_HOST_OF(node);
+    case GASNETE_COLL_TOPO_GROUP:
+      if (gasnete_coll_topo_group) return gasnete_coll_topo_group[node];
+      return gasnete_coll_topo_group_hosts ? GASNETE_COLL_TOPO_HOST_OF(node) / gasnete_coll_topo_group_hosts : 0;
+    default:
+      gasneti_fatalerror("unknown topology level %d", (int)level);
+      return 0;
+  }
+}
+
+/* Nonzero if the user described rack/switch groups */
+int gasnete_coll_topo_have_groups(void) {
+  gasnete_coll_topo_init();
+  return (gasnete_coll_topo_group != NULL) || (gasnete_coll_topo_group_hosts != 0);
+}
+
 void gasnete_coll_team_init(gasnet_team_handle_t team, 
                             uint32_t team_id, 
                             uint32_t total_ranks,
@@ -217,6 +343,22 @@ void gasnete_coll_team_init(gasnet_team_handle_t team,
     }
   }
 
+  /* Count the runs of consecutive ranks sharing each topology level */
+  gasnete_coll_topo_init();
+  {
+    int level;
+    for (level = 0; level < GASNETE_COLL_TOPO_LEVELS; ++level) {
+      uint32_t prev = gasnete_coll_topo_domain((gasnete_coll_topo_level_t)level, team->rel2act_map[0]);
+      gasnet_node_t runs = 1;
+      for (i = 1; i < total_ranks; ++i) {
+        uint32_t curr = gasnete_coll_topo_domain((gasnete_coll_topo_level_t)level, team->rel2act_map[i]);
+        runs += (curr != prev);
+        prev = curr;
+      }
+      team->topo_runs[level] = runs;
+    }
+  }
+
 #if GASNET_PSHM
   /* Build supernode stats (unless already constructed) */
   if (!team->supernode.node_count) {
@@ -321,10 +463,19 @@ void gasnete_coll_team_fini(gasnet_team_handle_t team)
   gasneti_assert(team_dir != NULL);
   gasnete_hashtable_remove(team_dir, team->team_id, NULL);
 
-#if !defined(GASNETE_COLL_P2P_OVERRIDE) && GASNET_DEBUG
+#ifndef GASNETE_COLL_P2P_OVERRIDE
   for (i = 0; i < GASNETE_COLL_P2P_TABLE_SIZE; ++i) {
     /* Check that table is actually empty */
     gasneti_assert(team->p2p_table[i] == NULL);
+    if (team->p2p_ring[i]) {
+      gasneti_assert(!team->p2p_ring[i]->ring_busy);
+      gasneti_free(team->p2p_ring[i]);
+    }
+  }
+  while (team->p2p_freelist) {
+    gasnete_coll_p2p_t *p2p = team->p2p_freelist;
+    team->p2p_freelist = p2p->p2p_next;
+    gasneti_free(p2p);
   }
 #endif
 
@@ -338,6 +489,21 @@ void gasnete_coll_team_fini(gasnet_team_handle_t team)
 #endif
 }
 
+/* Team ids are minted by a single node, whose id occupies the high bits,
+ * so they never collide without any node acting as a central allocator.
+ */
+static uint32_t gasnete_coll_mint_team_id(void)
+{
+  /* gasneti_atomic_increment(&(my_team_seq), GASNETI_ATOMIC_NONE); */
+  my_team_seq++; /* need to be an atomic operation */
+  /* limitation: each node can only allocate team sequence id
+     4096 times */
+  if_pf (my_team_seq >= 0xfff || gasneti_mynode >= (1 << 20)) {
+    gasneti_fatalerror("node %u has exhausted its team ids", (unsigned int)gasneti_mynode);
+  }
+  return ((gasneti_mynode << 12) | (my_team_seq & 0xfff));
+}
+
 void gasnete_coll_teamid_reqh(gasnet_token_t token,
                               gasnet_handlerarg_t team_id)
 {
@@ -354,10 +520,9 @@ gasnet_team_handle_t gasnete_coll_team_create(uint32_t total_ranks,
                                               gasnet_node_t *rel2act_map, gasnet_seginfo_t* scratch_segs GASNETI_THREAD_FARG)
 {
   gasnet_team_handle_t team;
-  gasnet_node_t team_lead = rel2act_map[0];
   uint32_t i;
 #ifdef DEBUG_TEAM
-  fprintf(stderr, "gasnete_coll_team_create: team_lead %u, total_ranks %u, myrank %u\n", team_lead, total_ranks, myrank);
+  fprintf(stderr, "gasnete_coll_team_create: team_lead %u, total_ranks %u, myrank %u\n", rel2act_map[0], total_ranks, myrank);
   fflush(stderr);
   if (myrank == 0) {
     PRINT_ARRAY(stderr, rel2act_map, total_ranks, "%u");
@@ -369,12 +534,8 @@ gasnet_team_handle_t gasnete_coll_team_create(uint32_t total_ranks,
 
   if (myrank == 0) {
     /* the team leader (rank 0) computes the new team_id */
-    /* gasneti_atomic_increment(&(my_team_seq), GASNETI_ATOMIC_NONE); */
-    my_team_seq++; /* need to be an atomic operation */
-    /* limitation: each root node can only allocate team sequence id
-       4096 times */
-    gasneti_assert(my_team_seq < 0xfff);
-    new_team_id = ((team_lead << 12) | (my_team_seq & 0xfff));
+    gasneti_assert(rel2act_map[0] == gasneti_mynode);
+    new_team_id = gasnete_coll_mint_team_id();
     
     /* send out team_id */
     for(i=1; i<total_ranks; i++) {
@@ -416,6 +577,161 @@ void gasnete_coll_team_free(gasnet_team_handle_t team)
   gasneti_free(team);
 }
 
+/*---------------------------------------------------------------------------------*/
+/* Distributed team split:
+ *  1. Each member registers (color, relrank, node, scratch segment) with a
+ *     rendezvous member of the parent team chosen by hashing its color.
+ *  2. After a barrier of the parent team every rendezvous holds the complete
+ *     membership of its colors.  It mints the new team's id and sends the
+ *     member list to relrank 0 of that color.
+ *  3. Members forward the list down a binomial tree over the new relranks.
+ * No node handles more than its own new team and the colors hashed to it,
+ * so there is neither an O(P) all-gather nor a central id allocator.
+ */
+typedef struct {
+  gasnet_node_t node;
+  gasnet_seginfo_t seg;
+} gasnete_coll_split_member_t;
+
+typedef struct {
+  gasnet_node_t color;
+  gasnet_node_t relrank;
+  gasnete_coll_split_member_t member;
+} gasnete_coll_split_join_t;
+
+typedef struct gasnete_coll_split_color_s {
+  struct gasnete_coll_split_color_s *next;
+  gasnet_node_t color;
+  gasnet_node_t count, space;
+  gasnete_coll_split_join_t *joins;
+} gasnete_coll_split_color_t;
+
+typedef struct gasnete_coll_split_s {
+  struct gasnete_coll_split_s *next;
+  uint32_t parent_id;
+  /* as a rendezvous: the registrations of the colors hashed to this node */
+  gasnete_coll_split_color_t *colors;
+  /* as a member: acknowledgement of registration and the new team */
+  volatile int joined;
+  volatile uint32_t team_id;
+  volatile gasnet_node_t total_ranks;
+  volatile gasnet_node_t received;
+  gasnete_coll_split_member_t *members; /* indexed by new relrank */
+} gasnete_coll_split_t;
+
+static gasnet_hsl_t gasnete_coll_split_lock = GASNET_HSL_INITIALIZER;
+static gasnete_coll_split_t *gasnete_coll_split_list = NULL;
+
+/* Must hold gasnete_coll_split_lock.  Creates the state on first reference,
+ * since messages may arrive before this node enters the split. */
+static gasnete_coll_split_t *gasnete_coll_split_find(uint32_t parent_id) {
+  gasnete_coll_split_t *split;
+  for (split = gasnete_coll_split_list; split; split = split->next) {
+    if (split->parent_id == parent_id) return split;
+  }
+  split = gasneti_calloc(1, sizeof(gasnete_coll_split_t));
+  split->parent_id = parent_id;
+  split->next = gasnete_coll_split_list;
+  gasnete_coll_split_list = split;
+  return split;
+}
+
+static void gasnete_coll_split_remove(gasnete_coll_split_t *split) {
+  gasnete_coll_split_t **p;
+  gasnet_hsl_lock(&gasnete_coll_split_lock);
+  for (p = &gasnete_coll_split_list; *p != split; p = &(*p)->next) {
+    gasneti_assert(*p != NULL);
+  }
+  *p = split->next;
+  gasnet_hsl_unlock(&gasnete_coll_split_lock);
+  while (split->colors) {
+    gasnete_coll_split_color_t *c = split->colors;
+    split->colors = c->next;
+    gasneti_free(c->joins);
+    gasneti_free(c);
+  }
+  gasneti_free(split);
+}
+
+/* parent team rank acting as rendezvous for a color */
+static gasnet_node_t gasnete_coll_split_rendezvous(gasnet_team_handle_t team, gasnet_node_t color) {
+  uint64_t h = (uint64_t)color * 0x9E3779B97F4A7C15ULL;
+  return (gasnet_node_t)((h >> 32) % team->total_ranks);
+}
+
+void gasnete_coll_split_join_reqh(gasnet_token_t token, void *buf, size_t nbytes,
+                                  gasnet_handlerarg_t parent_id)
+{
+  const gasnete_coll_split_join_t *join = (const gasnete_coll_split_join_t *)buf;
+  gasnete_coll_split_t *split;
+  gasnete_coll_split_color_t *c;
+
+  gasneti_assert(nbytes == sizeof(gasnete_coll_split_join_t));
+  gasnet_hsl_lock(&gasnete_coll_split_lock);
+  split = gasnete_coll_split_find((uint32_t)parent_id);
+  for (c = split->colors; c && c->color != join->color; c = c->next) {}
+  if (!c) {
+    c = gasneti_calloc(1, sizeof(gasnete_coll_split_color_t));
+    c->color = join->color;
+    c->next = split->colors;
+    split->colors = c;
+  }
+  if (c->count == c->space) {
+    c->space = c->space ? 2 * c->space : 8;
+    c->joins = gasneti_realloc(c->joins, c->space * sizeof(gasnete_coll_split_join_t));
+  }
+  c->joins[c->count++] = *join;
+  gasnet_hsl_unlock(&gasnete_coll_split_lock);
+
+  GASNETI_SAFE(SHORT_REP(1,1,(token, gasneti_handleridx(gasnete_coll_split_join_reph), parent_id)));
+}
+
+void gasnete_coll_split_join_reph(gasnet_token_t token,
+                                  gasnet_handlerarg_t parent_id)
+{
+  gasnet_hsl_lock(&gasnete_coll_split_lock);
+  gasnete_coll_split_find((uint32_t)parent_id)->joined = 1;
+  gasnet_hsl_unlock(&gasnete_coll_split_lock);
+}
+
+void gasnete_coll_split_members_reqh(gasnet_token_t token, void *buf, size_t nbytes,
+                                     gasnet_handlerarg_t parent_id,
+                                     gasnet_handlerarg_t team_id,
+                                     gasnet_handlerarg_t total_ranks,
+                                     gasnet_handlerarg_t offset)
+{
+  const size_t count = nbytes / sizeof(gasnete_coll_split_member_t);
+  gasnete_coll_split_t *split;
+
+  gasnet_hsl_lock(&gasnete_coll_split_lock);
+  split = gasnete_coll_split_find((uint32_t)parent_id);
+  if (!split->members) {
+    split->members = gasneti_malloc(total_ranks * sizeof(gasnete_coll_split_member_t));
+    split->team_id = (uint32_t)team_id;
+    split->total_ranks = (gasnet_node_t)total_ranks;
+  }
+  gasneti_assert(offset + count <= (size_t)total_ranks);
+  GASNETE_FAST_UNALIGNED_MEMCPY(split->members + offset, buf, nbytes);
+  gasneti_local_wmb();
+  split->received += count;
+  gasnet_hsl_unlock(&gasnete_coll_split_lock);
+}
+
+/* Send a complete member list to one node, in AMMedium-sized pieces */
+static void gasnete_coll_split_send_members(gasnet_node_t node, uint32_t parent_id, uint32_t team_id,
+                                            gasnet_node_t total_ranks,
+                                            const gasnete_coll_split_member_t *members)
+{
+  const gasnet_node_t chunk = gasnet_AMMaxMedium() / sizeof(gasnete_coll_split_member_t);
+  gasnet_node_t offset;
+  for (offset = 0; offset < total_ranks; offset += chunk) {
+    const gasnet_node_t count = MIN(chunk, total_ranks - offset);
+    GASNETI_SAFE(MEDIUM_REQ(4,4,(node, gasneti_handleridx(gasnete_coll_split_members_reqh),
+                                 (void *)(members + offset), count * sizeof(gasnete_coll_split_member_t),
+                                 parent_id, team_id, total_ranks, offset)));
+  }
+}
+
 gasnet_team_handle_t gasnete_coll_team_split(gasnet_team_handle_t team,
                                              gasnet_node_t mycolor,
                                              gasnet_node_t myrelrank,
@@ -423,58 +739,76 @@ gasnet_team_handle_t gasnete_coll_team_split(gasnet_team_handle_t team,
                                              GASNETI_THREAD_FARG)
 {
   gasnet_team_handle_t newteam;
-  uint32_t new_total_ranks;
-  gasnet_node_t *colors; /* gasnet_image_t for PAR mode*/
-  gasnet_node_t *relranks; /* gasnet_image_t for PAR mode */
+  gasnete_coll_split_t *split;
+  gasnete_coll_split_join_t join;
+  gasnete_coll_split_color_t *c;
   gasnet_node_t *rel2act_map;
-  gasnet_seginfo_t *allsegs, *segments;
-  uint32_t i;
+  gasnet_seginfo_t *segments;
+  gasnet_node_t new_total_ranks, mask;
+  uint32_t new_team_id, i;
 #ifdef DEBUG_TEAM
   fprintf(stderr, "gasnete_coll_team_split: team rank %u, parent team handle %p, mycolor %u, myrank %u\n",
           team->myrank, team, mycolor, myrelrank);
   fflush(stderr);
 #endif
 
-  colors = (gasnet_node_t *)gasneti_malloc(sizeof(mycolor)*team->total_ranks);
-  relranks = (gasnet_node_t *)gasneti_malloc(sizeof(myrelrank)*team->total_ranks);
-  allsegs = (gasnet_seginfo_t*) gasneti_malloc(sizeof(gasnet_seginfo_t)*team->total_ranks);
- 
-  
-  gasnet_coll_gather_all(team, allsegs, (gasnet_seginfo_t*) clientdata, 
-                         sizeof(gasnet_seginfo_t), GASNET_COLL_LOCAL|GASNET_COLL_IN_MYSYNC | GASNET_COLL_OUT_MYSYNC);
-  /* collect the color information */
-  gasnet_coll_gather_all(team, colors, &mycolor, sizeof(gasnet_node_t), GASNET_COLL_LOCAL|GASNET_COLL_IN_MYSYNC | GASNET_COLL_OUT_MYSYNC);
-
-  
-  /* collect the relrank information */
-  gasnet_coll_gather_all(team, relranks, &myrelrank, sizeof(gasnet_node_t), GASNET_COLL_LOCAL|GASNET_COLL_IN_MYSYNC | GASNET_COLL_OUT_MYSYNC);
+  gasnet_hsl_lock(&gasnete_coll_split_lock);
+  split = gasnete_coll_split_find(team->team_id);
+  gasnet_hsl_unlock(&gasnete_coll_split_lock);
+
+  /* register with the rendezvous of my color and wait for the acknowledgement */
+  join.color = mycolor;
+  join.relrank = myrelrank;
+  join.member.node = gasneti_mynode;
+  join.member.seg = *(gasnet_seginfo_t *)clientdata;
+  GASNETI_SAFE(MEDIUM_REQ(1,1,(GASNETE_COLL_REL2ACT(team, gasnete_coll_split_rendezvous(team, mycolor)),
+                               gasneti_handleridx(gasnete_coll_split_join_reqh),
+                               &join, sizeof(join), team->team_id)));
+  gasneti_polluntil(split->joined);
+
+  /* after this barrier every registration has reached its rendezvous */
+  gasnete_coll_barrier(team, 0, GASNET_BARRIERFLAG_UNNAMED GASNETI_THREAD_PASS);
 
+  /* as a rendezvous: mint an id for each of my colors and seed its relrank 0 */
+  for (c = split->colors; c; c = c->next) {
+    gasnete_coll_split_member_t *members = gasneti_malloc(c->count * sizeof(gasnete_coll_split_member_t));
+    uint8_t *seen = gasneti_calloc(c->count, sizeof(uint8_t));
+    for (i = 0; i < c->count; ++i) {
+      const gasnet_node_t r = c->joins[i].relrank;
+      if (r >= c->count || seen[r]) break;
+      members[r] = c->joins[i].member;
+      seen[r] = 1;
+    }
+    gasneti_free(seen);
+    if (i != c->count) {
+      gasneti_fatalerror("team split: the relranks given for color %u are not a permutation of 0..%u",
+                         (unsigned int)c->color, (unsigned int)(c->count - 1));
+    }
+    gasnete_coll_split_send_members(members[0].node, team->team_id, gasnete_coll_mint_team_id(),
+                                    c->count, members);
+    gasneti_free(members);
+  }
 
-  /* pass 1: just count */
-  new_total_ranks = 0;
-  for (i=0; i<team->total_ranks; i++) {
-    new_total_ranks += (mycolor == colors[i]);
+  /* as a member: receive the list, then forward it to my binomial children */
+  gasneti_polluntil(split->members && (split->received == split->total_ranks));
+  gasneti_local_rmb();
+  new_team_id = split->team_id;
+  new_total_ranks = split->total_ranks;
+  gasneti_assert(split->members[myrelrank].node == gasneti_mynode);
+  for (mask = 1; mask <= myrelrank; mask <<= 1) {}
+  for (; myrelrank + mask < new_total_ranks; mask <<= 1) {
+    gasnete_coll_split_send_members(split->members[myrelrank + mask].node, team->team_id,
+                                    new_team_id, new_total_ranks, split->members);
   }
 
-  /* pass 2: collect members */
   rel2act_map = (gasnet_node_t *)gasneti_malloc(new_total_ranks*sizeof(gasnet_node_t));
   segments = (gasnet_seginfo_t *)gasneti_malloc(new_total_ranks*sizeof(gasnet_seginfo_t));
-  for (i=0; i<team->total_ranks; i++) {
-    if (mycolor == colors[i]) {
-      rel2act_map[relranks[i]] = team->rel2act_map[i];
-      segments[relranks[i]] = allsegs[i];
-    }
+  for (i=0; i<new_total_ranks; i++) {
+    rel2act_map[i] = split->members[i].node;
+    segments[i] = split->members[i].seg;
   }
-  gasneti_free(allsegs);
-  gasneti_free(relranks);
-  gasneti_free(colors);
-
-  
-  /* It would be better to add some sanity check for team correctness here. */
-  
-  /* create a team */
-  new_team_id = 0;
-  gasnete_coll_barrier(team, 0, GASNET_BARRIERFLAG_UNNAMED GASNETI_THREAD_PASS);
+  gasneti_free(split->members);
+  gasnete_coll_split_remove(split);
 
 #ifdef DEBUG_TEAM
   fprintf(stderr, "gasnete_coll_team_split: new_total_ranks %u, myrelrank %u.\n",
@@ -483,9 +817,15 @@ gasnet_team_handle_t gasnete_coll_team_split(gasnet_team_handle_t team,
   fflush(stderr);
 #endif
 
-  newteam = gasnete_coll_team_create(new_total_ranks, myrelrank, rel2act_map, segments GASNETI_THREAD_PASS);
+  /* create the team locally */
+  newteam = (gasnet_team_handle_t)gasneti_calloc(1,sizeof(struct gasnete_coll_team_t_));
+#if GASNET_PAR
+  gasneti_fatalerror("can't call team_init in PAR Builds yet");
+#endif
+  gasnete_coll_team_init(newteam, new_team_id, new_total_ranks, myrelrank, rel2act_map, segments, NULL GASNETI_THREAD_PASS);
   
   gasneti_free(rel2act_map);
+  /* no member may start another split of this parent before all are done with this one */
   gasnete_coll_barrier(team, 0, GASNET_BARRIERFLAG_UNNAMED GASNETI_THREAD_PASS);
 #ifdef GASNETI_USE_FCA
   gasnet_team_fca_enable(newteam);
@@ -22,8 +22,9 @@ gasnete_coll_tree_type_t gasnete_coll_get_tree_type(void) {
 }
 
 void gasnete_coll_free_tree_type(gasnete_coll_tree_type_t in){
-  gasneti_free(in->params);
   if(in!=NULL) {
+    gasnete_coll_free_tree_type(in->subtree);
+    gasneti_free(in->params);
     gasneti_lifo_push(&gasnete_coll_tree_type_free_list, in);
   }
 }
@@ -110,17 +111,28 @@ gasnete_coll_tree_type_t gasnete_coll_make_tree_type_str(char *tree_name_str) {
     
     num_splits = split_string(&inner_split, outer_split[0],inner_delim);
     num_params = num_splits-1;/*first split is the tree name*/
-    gasneti_assert(strcmp(inner_split[0], "HIERARCHICAL_TREE")==0);
     ret->tree_class = GASNETE_COLL_HIERARCHICAL_TREE;
-    if(num_params != num_levels-1){
-      gasneti_fatalerror("badly formed hierarchical tree expect HIEARCHICAL_TREE,<numlevels>,<in level1>,<in level2>,..,<in level n-1>:TREE1,PARAMS1:TREE2,PARAMS2:(etc)\n");
+    if(strcmp(inner_split[0], "HIERARCHICAL_TREE") || num_params != num_levels-1 ||
+       atoi(inner_split[1]) != num_levels-1){
+      gasneti_fatalerror("badly formed hierarchical tree %s expect HIERARCHICAL_TREE,<numlevels>,<in level1>,<in level2>,..,<in level n-1>:TREE1,PARAMS1:TREE2,PARAMS2:(etc)\n"
+                         "where each <in level> is a group size or one of SOCKET, HOST or GROUP\n", tree_name_str);
     }
-    /*NOT DONE*/
     ret->params = gasneti_malloc(sizeof(int)*(num_params));
     ret->num_params = num_params;
-    for(i=0; i<num_params; i++) {
-      ret->params[i] = atoi(inner_split[i+1]);
+    ret->params[0] = num_levels-1;
+    for(i=1; i<num_params; i++) {
+      const char *level = inner_split[i+1];
+      if(!strcmp(level, "SOCKET")) {
+        ret->params[i] = GASNETE_COLL_TREE_TOPO_PARAM(GASNETE_COLL_TOPO_SOCKET);
+      } else if(!strcmp(level, "HOST") || !strcmp(level, "NODE")) {
+        ret->params[i] = GASNETE_COLL_TREE_TOPO_PARAM(GASNETE_COLL_TOPO_HOST);
+      } else if(!strcmp(level, "GROUP") || !strcmp(level, "RACK")) {
+        ret->params[i] = GASNETE_COLL_TREE_TOPO_PARAM(GASNETE_COLL_TOPO_GROUP);
+      } else if((ret->params[i] = atoi(level)) <= 0) {
+        gasneti_fatalerror("bad level in hierarchical tree %s: %s\n", tree_name_str, level);
+      }
     }
+    gasneti_free(inner_split);
 
     temp = ret;
     for(i=1; i<num_levels; i++) {
@@ -138,6 +150,25 @@ gasnete_coll_tree_type_t gasnete_coll_make_tree_type_str(char *tree_name_str) {
 char* gasnete_coll_tree_type_to_str(char *buffer, gasnete_coll_tree_type_t tree_type) {
   int i;
   if(!tree_type) {memset(buffer, 0, 10); return buffer;}
+  if(tree_type->tree_class == GASNETE_COLL_HIERARCHICAL_TREE) {
+    static const char * const level_names[GASNETE_COLL_TOPO_LEVELS] = {"SOCKET", "HOST", "GROUP"};
+    gasnete_coll_tree_type_t sub;
+    strcpy(buffer, "HIERARCHICAL_TREE");
+    for(i=0; i<tree_type->num_params; i++) {
+      const int param = tree_type->params[i];
+      if(i > 0 && GASNETE_COLL_TREE_PARAM_IS_TOPO(param)) {
+        sprintf(buffer+strlen(buffer), ",%s", level_names[GASNETE_COLL_TREE_PARAM_TOPO_LEVEL(param)]);
+      } else {
+        sprintf(buffer+strlen(buffer), ",%d", param);
+      }
+    }
+    for(sub = tree_type->subtree; sub; sub = sub->subtree) {
+      strcat(buffer, ":");
+      gasnete_coll_tree_type_to_str(buffer+strlen(buffer), sub);
+      gasneti_assert(strlen(buffer) < GASNETE_COLL_MAX_TREE_TYPE_STRLEN);
+    }
+    return buffer;
+  }
   switch (tree_type->tree_class) {
     case GASNETE_COLL_NARY_TREE:
       strcpy(buffer, "NARY_TREE");
@@ -450,77 +481,93 @@ static tree_node_t make_flat_tree(tree_node_t *nodes, int num_nodes) {
   return nodes[0];
 }
 
-static tree_node_t make_hiearchical_tree_helper(gasnete_coll_tree_type_t tree_type, int level, int final_level, tree_node_t *allnodes, int num_nodes, int *node_counts) {
+static tree_node_t make_level_tree(gasnete_coll_tree_type_t tree_type, tree_node_t *nodes, int num_nodes) {
+  switch (tree_type->tree_class) {
+    case GASNETE_COLL_NARY_TREE:
+      return make_nary_tree(nodes, num_nodes, tree_type->params[0]);
+    case GASNETE_COLL_FLAT_TREE:
+      return make_flat_tree(nodes, num_nodes);
+    case GASNETE_COLL_KNOMIAL_TREE:
+      return make_knomial_tree(nodes, num_nodes, tree_type->params[0]);
+    case GASNETE_COLL_RECURSIVE_TREE:
+      return make_recursive_tree(nodes, num_nodes, tree_type->params[0]);
+    case GASNETE_COLL_FORK_TREE:
+      if(multarr(tree_type->params, tree_type->num_params) != num_nodes) {
+        gasneti_fatalerror("FORK_TREE dimensions do not cover the %d nodes of a hierarchical tree level", num_nodes);
+      }
+      return make_fork_tree(nodes, num_nodes, tree_type->params, tree_type->num_params);
+    default:
+      gasneti_fatalerror("unknown tree type");
+      return NULL; /* warning suppression */
+  }
+}
+
+/*length of the group starting at nodes[0] for the given level split*/
+static int hiearchical_group_len(gasnete_coll_team_t team, tree_node_t *nodes, int num_nodes, int split) {
+  gasnete_coll_topo_level_t level;
+  uint32_t domain;
+  int i;
+
+  if(!GASNETE_COLL_TREE_PARAM_IS_TOPO(split)) return MIN(split, num_nodes);
+
+  level = GASNETE_COLL_TREE_PARAM_TOPO_LEVEL(split);
+  if(team->topo_runs[level] == 1) return num_nodes;
+  domain = gasnete_coll_topo_domain(level, GASNETE_COLL_REL2ACT(team, GET_NODE_ID(nodes[0])));
+  for(i=1; i<num_nodes; i++) {
+    if(gasnete_coll_topo_domain(level, GASNETE_COLL_REL2ACT(team, GET_NODE_ID(nodes[i]))) != domain) break;
+  }
+  return i;
+}
+
+static tree_node_t make_hiearchical_tree_helper(gasnete_coll_team_t team, gasnete_coll_tree_type_t tree_type, int level, int final_level, tree_node_t *allnodes, int num_nodes, int *node_counts) {
   tree_node_t rootnode;
-  tree_node_t *temp;
   gasneti_assert(tree_type !=NULL);
   if(level == final_level) {
-    switch (tree_type->tree_class) {
-      case GASNETE_COLL_NARY_TREE:
-        rootnode = make_nary_tree(allnodes, num_nodes, tree_type->params[0]);
-        break;
-      case GASNETE_COLL_FLAT_TREE:
-        rootnode = make_flat_tree(allnodes, num_nodes);
-        break;
-      case GASNETE_COLL_KNOMIAL_TREE:
-        rootnode = make_knomial_tree(allnodes, num_nodes, tree_type->params[0]);
-        break;
-      case GASNETE_COLL_RECURSIVE_TREE:
-        rootnode = make_recursive_tree(allnodes, num_nodes, tree_type->params[0]);
-        break;
-      case GASNETE_COLL_FORK_TREE:
-        rootnode = make_fork_tree(allnodes, num_nodes, tree_type->params, tree_type->num_params);
-        break;
-      default:
-        rootnode = NULL; /* warning suppression */
-        gasneti_fatalerror("unknown tree type");
-    }
-  
+    rootnode = make_level_tree(tree_type, allnodes, num_nodes);
   } else {
-    int i,j=0,num_processed=0;
-    int level_nodes = MYCEIL(num_nodes, node_counts[0]);
-    temp = gasneti_malloc(sizeof(tree_node_t) * level_nodes);
-    for(i=0; i<level_nodes-1; i++) {
-      temp[j]=make_hiearchical_tree_helper(tree_type->subtree, level+1, final_level, allnodes+i*node_counts[0], node_counts[0], node_counts+1);  
-      j++;
-      num_processed += node_counts[0];
-    }
-    temp[j]=make_hiearchical_tree_helper(tree_type->subtree, level+1, final_level, allnodes+i*node_counts[0], num_nodes - num_processed, node_counts+1); 
-    j++;
-    switch (tree_type->tree_class) {
-      case GASNETE_COLL_NARY_TREE:
-        rootnode = make_nary_tree(temp, j, tree_type->params[0]);
-        break;
-      case GASNETE_COLL_FLAT_TREE:
-        rootnode = make_flat_tree(temp,j);
-        break;
-      case GASNETE_COLL_KNOMIAL_TREE:
-        rootnode = make_knomial_tree(temp, j, tree_type->params[0]);
-        break;
-      case GASNETE_COLL_RECURSIVE_TREE:
-        rootnode = make_recursive_tree(temp, j, tree_type->params[0]);
-        break;
-      case GASNETE_COLL_FORK_TREE:
-        rootnode = make_fork_tree(temp, j, tree_type->params, tree_type->num_params);
-        break;
-      default:
-        rootnode = NULL; /* warning suppression */
-        gasneti_fatalerror("unknown tree type");
+    /*build a subtree for each group and connect the group leaders with this level's tree*/
+    tree_node_t *temp = gasneti_malloc(sizeof(tree_node_t) * num_nodes);
+    int i, len, j=0;
+    for(i=0; i<num_nodes; i+=len) {
+      len = hiearchical_group_len(team, allnodes+i, num_nodes-i, node_counts[0]);
+      temp[j++] = make_hiearchical_tree_helper(team, tree_type->subtree, level+1, final_level, allnodes+i, len, node_counts+1);
     }
+    rootnode = make_level_tree(tree_type, temp, j);
     gasneti_free(temp);
   }
   return rootnode;
 }
 
-static tree_node_t make_hiearchical_tree(gasnete_coll_tree_type_t tree_type, tree_node_t *allnodes, int num_nodes) {
+static tree_node_t make_hiearchical_tree(gasnete_coll_tree_type_t tree_type, gasnete_coll_team_t team, tree_node_t *allnodes, int num_nodes) {
   /*first param tells us how many tree levels there are going to be*/
-  /*the second contains the number at teh lowest level grouping*/
+  /*the rest contain the grouping at each level below the top, either as a fixed number of nodes or a topology level*/
   /*each tree level contains a triple (tree shape, <tree args>*/
   /*so a 64 node run with 8 flat trees grouped into a binomial tree w/ 8 ndoes would have
     2, 8*/
   int num_levels = tree_type->params[0];
-  gasneti_assert(tree_type->num_params >= 2);
-  return make_hiearchical_tree_helper(tree_type->subtree, 0, num_levels-1, allnodes, num_nodes, tree_type->params+1);
+  gasneti_assert(tree_type->num_params == num_levels);
+  return make_hiearchical_tree_helper(team, tree_type->subtree, 0, num_levels-1, allnodes, num_nodes, tree_type->params+1);
+}
+
+/*Order every child list by decreasing distance from the root and mark it reversed.
+  The levels of a hierarchical tree each prepend their own children, so this
+  restores the sequential DFS order that the tree collectives rely on.*/
+static void order_children(tree_node_t node, gasnet_node_t rootrank, gasnet_node_t total_ranks) {
+  int i, j;
+  for(i=1; i<GET_NUM_CHILDREN(node); i++) {
+    tree_node_t child = GET_CHILD_IDX(node, i);
+    gasnet_node_t dist = (GET_NODE_ID(child) + total_ranks - rootrank) % total_ranks;
+    for(j=i; j>0; j--) {
+      tree_node_t prev = GET_CHILD_IDX(node, j-1);
+      if((GET_NODE_ID(prev) + total_ranks - rootrank) % total_ranks > dist) break;
+      node->children[j] = prev;
+    }
+    node->children[j] = child;
+  }
+  node->children_reversed = (GET_NUM_CHILDREN(node) > 0);
+  for(i=0; i<GET_NUM_CHILDREN(node); i++) {
+    order_children(GET_CHILD_IDX(node, i), rootrank, total_ranks);
+  }
 }
        
 static tree_node_t setparentshelper(tree_node_t main_node, tree_node_t parent) {
@@ -627,15 +674,13 @@ gasnete_coll_local_tree_geom_t *gasnete_coll_tree_geom_create_local(gasnete_coll
        geom->rotation_points[0] = rootrank;
       break;
     case GASNETE_COLL_HIERARCHICAL_TREE:
-#if 0
-      allnodes = team->tree_construction_scratch = allocate_nodes(allnodes, team, 0);
-      rootnode = make_hiearchical_tree(in_type, allnodes, team->total_ranks);
-       /* XXX ADD CODE TO GET ROTATION POINTS*/
+      allnodes = allocate_nodes((tree_node_t**) &team->tree_construction_scratch, team, rootrank);
+      rootnode = make_hiearchical_tree(in_type, team, allnodes, team->total_ranks);
+      order_children(rootnode, rootrank, team->total_ranks);
+      geom->rotation_points = (int*) gasneti_malloc(sizeof(int)*1);
+      geom->num_rotations = 1;
+      geom->rotation_points[0] = rootrank;
       break;
-#else
-       rootnode = NULL; /* warning suppression */
-       gasneti_fatalerror("HIERARCHICAL_TREE not yet fully supported");
-#endif
 #endif
     default:
        rootnode = NULL; /* warning suppression */
@@ -829,6 +874,10 @@ int gasnete_coll_compare_tree_types(gasnete_coll_tree_type_t a, gasnete_coll_tre
       for(i=0; i<a->num_params; i++) {
         if(a->params[i]!=b->params[i]) return 0;
       }
+      if(a->subtree || b->subtree) {
+        /*hierarchical trees must also agree on every level*/
+        return (a->subtree && b->subtree && gasnete_coll_compare_tree_types(a->subtree, b->subtree));
+      }
       return 1;
     }
   } 
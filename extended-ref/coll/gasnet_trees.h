@@ -43,10 +43,17 @@ struct gasnete_coll_tree_type_t_ {
 };
 
 
+/* In a HIERARCHICAL_TREE the group size of a level may instead name a level
+   of the machine topology (SOCKET, HOST or GROUP), in which case the groups
+   are the runs of consecutive ranks sharing a domain at that level */
+#define GASNETE_COLL_TREE_TOPO_PARAM(LEVEL)   (-1 - (int)(LEVEL))
+#define GASNETE_COLL_TREE_PARAM_IS_TOPO(P)    ((P) < 0)
+#define GASNETE_COLL_TREE_PARAM_TOPO_LEVEL(P) ((gasnete_coll_topo_level_t)(-1 - (P)))
+
 /*returns 1 if they are equal or 0 otherwise*/
 int gasnete_coll_compare_tree_types(gasnete_coll_tree_type_t a, gasnete_coll_tree_type_t b);
 
-#define GASNETE_COLL_MAX_TREE_TYPE_STRLEN 100
+#define GASNETE_COLL_MAX_TREE_TYPE_STRLEN 200
 gasnete_coll_tree_type_t gasnete_coll_make_tree_type_str(char *tree_name_str);
 gasnete_coll_tree_type_t gasnete_coll_make_tree_type(int tree_type, int *params, int num_params);
 char* gasnete_coll_tree_type_to_str(char *buffer, gasnete_coll_tree_type_t tree_type);
@@ -0,0 +1,72 @@
+/*   $Source: bitbucket.org:berkeleylab/gasnet.git/extended-ref/coll/gasnet_tunedb.h $
+ * Description: GASNet Autotuner binary tuning database format
+ * Terms of use are as specified in license.txt
+ */
+
+/* On-disk layout of a compiled tuning database.  The file is meant to be
+   mmap()ed read-only by every process and searched in place, so it holds
+   no pointers: every reference is an index into one of the arrays below.
+
+   The index is the same tree that gasnete_coll_dumpTuningState() writes,
+   one array of entries for all levels below the machine:
+     num_nodes, threads_per_node, sync_mode, address_mode, collective, root, size
+   The children of an entry are contiguous and sorted by increasing start.
+   Entries on the size level have no children and name a leaf instead.
+   Enumerated levels hold the numeric values of gasnete_coll_syncmode_t,
+   gasnete_coll_addr_mode_t and gasnet_coll_optype_t.
+
+   Only C types of fixed width are used, so that this header can also be
+   included by the standalone conversion tool (other/myxml/myxml_tunedb.c).
+   A file written on a host of the other byte order is rejected by the
+   byte_order check rather than swapped. */
+
+#ifndef __GASNET_TUNEDB_H__
+#define __GASNET_TUNEDB_H__ 1
+
+#define GASNETE_COLL_TUNEDB_MAGIC       "GASNTDB"  /* 8 bytes including the NUL */
+#define GASNETE_COLL_TUNEDB_VERSION     1          /* bump on any layout change */
+#define GASNETE_COLL_TUNEDB_BYTE_ORDER  0x01020304
+#define GASNETE_COLL_TUNEDB_LEVELS      7          /* num_nodes through size */
+#define GASNETE_COLL_TUNEDB_MAX_PARAMS  8
+#define GASNETE_COLL_TUNEDB_NONE        0xffffffff /* no string */
+#define GASNETE_COLL_TUNEDB_ALIGN       8          /* alignment of every section */
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t num_machines;
+  uint32_t num_entries;
+  uint32_t num_leaves;
+  uint32_t strings_size;     /* bytes, the last one is always a NUL */
+  uint64_t machines_offset;  /* all offsets are from the start of the file */
+  uint64_t entries_offset;
+  uint64_t leaves_offset;
+  uint64_t strings_offset;
+  uint64_t file_size;
+} gasnete_coll_tunedb_header_t;
+
+/* one per GASNET_CONFIG_STRING the data was collected under */
+typedef struct {
+  uint32_t config_str;  /* offset into the string table */
+  uint32_t first;       /* its num_nodes entries */
+  uint32_t count;
+  uint32_t reserved;
+} gasnete_coll_tunedb_machine_t;
+
+typedef struct {
+  uint32_t start;
+  uint32_t first;       /* first child entry, or the leaf on the size level */
+  uint32_t count;       /* number of children, 0 on the size level */
+} gasnete_coll_tunedb_entry_t;
+
+/* the tuned implementation: the fields of a Best_Alg element */
+typedef struct {
+  uint32_t fn_idx;
+  uint32_t alg_name;    /* offset into the string table or NONE */
+  uint32_t tree_type;   /* offset into the string table or NONE */
+  uint32_t num_params;
+  uint32_t params[GASNETE_COLL_TUNEDB_MAX_PARAMS];
+} gasnete_coll_tunedb_leaf_t;
+
+#endif
@@ -166,6 +166,22 @@ void gasnete_barrier_pf_disable(gasnete_coll_team_t team) {
   #define GASNETE_PSHM_BARR_U64 0
 #endif
 
+/* GASNETE_PSHM_BARR_TREE: support for GASNET_BARRIER=PSHMTREE (pure-SMP only)
+ * Arrival combines first within each L3 cache (or socket) domain and then among
+ * the domain leaders.  Completion is passed back down the same tree through
+ * per-node release words, rather than all nodes polling the single shared
+ * state word (which must otherwise be read by every core after each write).
+ */
+#if !GASNETI_PSHM_BARRIER_HIER
+  #define GASNETE_PSHM_BARR_TREE 1
+#else
+  #define GASNETE_PSHM_BARR_TREE 0
+#endif
+#ifndef GASNETE_PSHM_BARR_TREE_RADIX
+  /* Out-degree of both levels of the PSHMTREE tree, unless GASNET_PSHM_BARRIER_RADIX > 0 */
+  #define GASNETE_PSHM_BARR_TREE_RADIX 4
+#endif
+
 typedef struct gasnete_coll_pshmbarrier_s {
   struct {
     struct gasneti_pshm_barrier_node *mynode;
@@ -178,8 +194,13 @@ typedef struct gasnete_coll_pshmbarrier_s {
       #endif
     } *children;
     int rank, num_children;
+    int parent; /* rank of parent in the tree, or -1 at the root */
     int remain, value, flags; /* Partial state between notify and completion */
     int volatile two_to_phase; /* Local var alternates between 2^0 and 2^1 */
+    gasneti_atomic_t *state_p; /* Where completion is signalled: shared or per-node */
+  #if GASNETE_PSHM_BARR_TREE
+    int tree; /* Non-zero for topology-aware tree with tree-based release */
+  #endif
   } private;
   gasneti_pshm_barrier_t *shared;
 } gasnete_pshmbarrier_data_t;
@@ -200,7 +221,9 @@ typedef struct gasnete_coll_pshmbarrier_s {
     const int _tmp_result = (_result);                                         \
     const gasneti_atomic_sval_t _state = (_tmp_result << PSHM_BSTATE_DONE_BITS) | (_two_to_phase);\
     gasneti_assert(PSHM_BSTATE_TO_RESULT(_state) == _tmp_result);              \
-    gasneti_atomic_set(&(_bdata)->shared->state, _state, GASNETI_ATOMIC_REL);  \
+    gasneti_atomic_set((_bdata)->private.state_p, _state, GASNETI_ATOMIC_REL); \
+    if ((_bdata)->private.state_p == &(_bdata)->shared->state)                 \
+      gasneti_pshm_wakeup_all(); /* waiters may be in a blocking wait */       \
   } while(0)
 
 
@@ -216,6 +239,9 @@ void gasnete_pshmbarrier_arrive(gasnete_pshmbarrier_data_t * const pshm_bdata, i
   gasneti_local_wmb();
   pshm_bdata->private.mynode->u.wmb.phase = two_to_phase;
 #endif
+  if (pshm_bdata->private.parent >= 0) {
+    gasneti_pshm_wakeup_one(pshm_bdata->private.parent); /* may be in a blocking wait */
+  }
 
   /* Root (rank == 0) must publish the results and signal the barrier w/ phase and result */
   if (! pshm_bdata->private.rank) {
@@ -403,17 +429,37 @@ int finish_pshm_barrier(const gasnete_pshmbarrier_data_t * const pshm_bdata, int
   return ret;
 }
 
+/* Pass completion down the tree, if using tree-based release */
+GASNETI_INLINE(gasnete_pshmbarrier_release)
+void gasnete_pshmbarrier_release(gasnete_pshmbarrier_data_t * const pshm_bdata, gasneti_atomic_sval_t state) {
+#if GASNETE_PSHM_BARR_TREE
+  if (pshm_bdata->private.tree) {
+    struct gasnete_pshmbarrier_children * const children = pshm_bdata->private.children;
+    const int num_children = pshm_bdata->private.num_children;
+    int i;
+    for (i = 0; i < num_children; ++i) {
+      gasneti_atomic_set(&children[i].node->release, state, GASNETI_ATOMIC_REL);
+    }
+    for (i = 0; i < num_children; ++i) {
+      gasneti_pshm_wakeup_one(children[i].node - pshm_bdata->shared->node);
+    }
+  }
+#endif
+}
+
 /* Poll waiting for appropriate done bit in "state"
  * Returns GASNET_{OK,ERR_BARRIER_MISMATCH}
  */
 GASNETI_INLINE(gasnete_pshmbarrier_wait_inner)
 int gasnete_pshmbarrier_wait_inner(gasnete_pshmbarrier_data_t * const pshm_bdata, int id, int flags, int shift) {
   const gasneti_atomic_sval_t goal = pshm_bdata->private.two_to_phase << shift;
-  gasneti_atomic_t * const state_p = &pshm_bdata->shared->state;
+  gasneti_atomic_t * const state_p = pshm_bdata->private.state_p;
   gasneti_atomic_sval_t state;
 
-  gasneti_polluntil((gasnete_pshmbarrier_kick(pshm_bdata),
-                     (goal & (state = gasneti_atomic_read(state_p, 0)))));
+  /* Every store which may satisfy this wait is followed by a PSHM wakeup */
+  gasneti_pshm_polluntil((gasnete_pshmbarrier_kick(pshm_bdata),
+                          (goal & (state = gasneti_atomic_read(state_p, 0)))));
+  gasnete_pshmbarrier_release(pshm_bdata, state);
 
   return finish_pshm_barrier(pshm_bdata, id, flags, state);
 }
@@ -424,14 +470,16 @@ int gasnete_pshmbarrier_wait_inner(gasnete_pshmbarrier_data_t * const pshm_bdata
 GASNETI_INLINE(gasnete_pshmbarrier_try_inner)
 gasneti_atomic_sval_t gasnete_pshmbarrier_try_inner(gasnete_pshmbarrier_data_t * const pshm_bdata, int shift) {
   const gasneti_atomic_sval_t goal = pshm_bdata->private.two_to_phase << shift;
-  gasneti_atomic_t * const state_p = &pshm_bdata->shared->state;
+  gasneti_atomic_t * const state_p = pshm_bdata->private.state_p;
   gasneti_atomic_sval_t state;
 
   gasnete_pshmbarrier_kick(pshm_bdata);
   state = gasneti_atomic_read(state_p, GASNETI_ATOMIC_ACQ);
 
 #if !GASNETI_PSHM_BARRIER_HIER
-  return (goal & state) ? state : 0;
+  if (!(goal & state)) return 0;
+  gasnete_pshmbarrier_release(pshm_bdata, state);
+  return state;
 #else
   return (goal & state);
 #endif
@@ -441,11 +489,11 @@ gasneti_atomic_sval_t gasnete_pshmbarrier_try_inner(gasnete_pshmbarrier_data_t *
  * NULL return on failure might eventually come from a failed shared memory allocation.
  */
 static gasnete_pshmbarrier_data_t *
-gasnete_pshmbarrier_init_inner(gasnete_coll_team_t team) {
+gasnete_pshmbarrier_init_inner(gasnete_coll_team_t team, int tree) {
   gasnete_pshmbarrier_data_t *pshm_bdata = NULL;
   gasneti_pshm_barrier_t *shared_data = NULL;
   const int two_to_phase = 1; /* 2^0 */
-  int i, radix;
+  int i, radix, env_radix;
 
   if (team == GASNET_TEAM_ALL) {
     shared_data = gasneti_pshm_barrier;
@@ -463,6 +511,12 @@ gasnete_pshmbarrier_init_inner(gasnete_coll_team_t team) {
     pshm_bdata->private.two_to_phase = two_to_phase;
     pshm_bdata->private.rank = rank;
     pshm_bdata->private.mynode = &shared_data->node[rank];
+    pshm_bdata->private.state_p = &shared_data->state;
+  #if GASNETE_PSHM_BARR_TREE
+    pshm_bdata->private.tree = tree;
+  #else
+    gasneti_assert(!tree);
+  #endif
 
     /* GASNET_PSHM_BARRIER_RADIX
      *  If positive then the given value is the out-degree of the tree.
@@ -472,17 +526,106 @@ gasnete_pshmbarrier_init_inner(gasnete_coll_team_t team) {
      *    process is the parent of the other group-representatives (in addition to
      *    being the parent of the others in its own group).
      */
-    radix = gasneti_getenv_int_withdefault("GASNET_PSHM_BARRIER_RADIX", 0, 0);
-    if (radix == 0) radix = size - 1;
+    env_radix = gasneti_getenv_int_withdefault("GASNET_PSHM_BARRIER_RADIX", 0, 0);
+    radix = env_radix ? env_radix : (size - 1);
 
     pshm_bdata->private.children = NULL;
     pshm_bdata->private.num_children = 0;
     pshm_bdata->private.remain = 0;
+    pshm_bdata->private.parent = -1;
 
     if (size == 1) {
       /* Nothing to do */
+  #if GASNETE_PSHM_BARR_TREE
+    } else if (tree) { /* Two-level tree: within each L3 (or socket) domain, then among domains */
+      /* Both levels are N-ary trees of out-degree GASNET_PSHM_BARRIER_RADIX
+       * (if positive, else GASNETE_PSHM_BARR_TREE_RADIX): one over the domain
+       * leaders, rooted at rank 0, and one over the members of each domain,
+       * rooted at its leader.  Positions in each tree follow rank order. */
+      const int k = (env_radix > 0) ? env_radix : GASNETE_PSHM_BARR_TREE_RADIX;
+      int *domain = gasneti_malloc(3 * size * sizeof(int));
+      int *leader = domain + size;
+      int *pos = leader + size; /* position in my tree: my domain, or the leaders' */
+      int mydomain = gasneti_pshm_cpu_domain();
+      int count, j, n, my_lpos = -1;
+
+      gasneti_assert(team == GASNET_TEAM_ALL); /* exchange below is over the supernode */
+      gasneti_pshmnet_bootstrapExchange(gasneti_request_pshmnet, &mydomain, sizeof(int), domain);
+      for (i = 0; i < size; ++i) {
+        if (domain[i] < 0) break;
+      }
+      if (i < size) {
+        /* Some process is not bound within a single domain:
+         * use groups of sqrt(size) consecutive ranks instead */
+        int group = 1;
+        while (group * group < size) ++group;
+        for (i = 0; i < size; ++i) domain[i] = i / group;
+      }
+
+      /* Leader of each domain is its lowest rank, which makes rank 0 the root */
+      for (i = 0; i < size; ++i) {
+        int m;
+        for (m = 0; domain[m] != domain[i]; ++m) {}
+        leader[i] = m;
+      }
+
+      /* Number the members of my domain (pos[], by rank order) and find my
+       * position among the leaders, from which both parent and children follow */
+      for (i = 0, n = 0, j = 0; i < size; ++i) {
+        if (leader[i] == leader[rank]) pos[n++] = i;
+        if (leader[i] == i) {
+          if (i == rank) my_lpos = j;
+          ++j;
+        }
+      }
+      {
+        const int num_leaders = j;
+        int my_pos, first, last, lfirst = 0, llast = -1;
+
+        for (my_pos = 0; pos[my_pos] != rank; ++my_pos) {}
+        first = k * my_pos + 1;
+        last  = MIN(n, first + k) - 1;
+        if (my_lpos >= 0) {
+          lfirst = k * my_lpos + 1;
+          llast  = MIN(num_leaders, lfirst + k) - 1;
+        }
+        count = MAX(0, 1 + last - first) + MAX(0, 1 + llast - lfirst);
+
+        if (my_pos) {
+          pshm_bdata->private.parent = pos[(my_pos - 1) / k];
+        } else if (my_lpos > 0) {
+          const int lparent = (my_lpos - 1) / k;
+          for (i = 0, j = 0; ; ++i) {
+            if ((leader[i] == i) && (j++ == lparent)) break;
+          }
+          pshm_bdata->private.parent = i;
+        }
+
+        if (count) {
+          pshm_bdata->private.num_children = count;
+          pshm_bdata->private.children = gasneti_malloc(count * sizeof(struct gasnete_pshmbarrier_children));
+          gasneti_leak(pshm_bdata->private.children);
+          j = 0;
+          /* Members of my own domain first, since they are the nearest */
+          for (i = first; i <= last; ++i) {
+            pshm_bdata->private.children[j++].node = &shared_data->node[pos[i]];
+          }
+          for (i = 0, n = 0; i < size; ++i) {
+            if (leader[i] != i) continue;
+            if ((n >= lfirst) && (n <= llast)) pshm_bdata->private.children[j++].node = &shared_data->node[i];
+            ++n;
+          }
+          gasneti_assert(j == count);
+        }
+      }
+      gasneti_free(domain);
+
+      /* Each node polls its own release word for completion */
+      pshm_bdata->private.state_p = &shared_data->node[rank].release;
+  #endif
     } else if (radix < 0) { /* Break into "cells" of size = -radix (e.g. cores/socket) */
       radix = -radix;
+      if (rank) pshm_bdata->private.parent = (rank % radix) ? (rank - (rank % radix)) : 0;
       if (rank == 0) {
         int last  = MIN(size, radix) - 1;
         int count = last + (size - 1) / radix;
@@ -512,6 +655,7 @@ gasnete_pshmbarrier_init_inner(gasnete_coll_team_t team) {
       }
     } else { /* Build an N-ary tree */
       int first = radix * rank + 1;
+      if (rank) pshm_bdata->private.parent = (rank - 1) / radix;
       int last  = MIN(size, first + radix) - 1;
       int count = MAX(0, 1 + last - first);
 
@@ -536,6 +680,7 @@ gasnete_pshmbarrier_init_inner(gasnete_coll_team_t team) {
       #else
         shared_data->node[i].u.wmb.phase = two_to_phase;
       #endif
+        gasneti_atomic_set(&shared_data->node[i].release, 0, 0);
       }
 
       /* Flags word to poll or spin on until barrier is done */
@@ -582,7 +727,7 @@ gasnete_pshmbarrier_init_hier(gasnete_coll_team_t team, int *size_p, int *rank_p
     return NULL;
   }
 
-  pshm_bdata = gasnete_pshmbarrier_init_inner(team);
+  pshm_bdata = gasnete_pshmbarrier_init_inner(team, 0);
   if (pshm_bdata) {
     *size_p = team->supernode.grp_count;
     *rank_p = team->supernode.grp_rank;
@@ -656,8 +801,8 @@ static int gasnete_pshmbarrier_result(gasnete_coll_team_t team, int *id) {
   }
 }
 
-static void gasnete_pshmbarrier_init(gasnete_coll_team_t team) {
-  team->barrier_data = (void *)gasnete_pshmbarrier_init_inner(team);
+static void gasnete_pshmbarrier_init(gasnete_coll_team_t team, int tree) {
+  team->barrier_data = (void *)gasnete_pshmbarrier_init_inner(team, tree);
 
   team->barrier_notify = &gasnete_pshmbarrier_notify;
   team->barrier_wait =   &gasnete_pshmbarrier_wait;
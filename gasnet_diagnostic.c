@@ -18,6 +18,7 @@
 #define TEST_OMIT_CONFIGSTRINGS 1
 #include <../tests/test.h>
 #include <gasnet_handler.h>
+#include <gasnet_coll.h>
 
 /* this file should *only* contain symbols used for internal diagnostics,
    so that we can avoid needlessly linking it into production executables 
@@ -100,6 +101,13 @@ static void atomic128_test(int id);
 static void malloc_test(int id);
 static void progressfns_test(int id);
 static void op_test(int id);
+static void redop_test(int id);
+static void online_test(int id);
+
+extern int gasnete_coll_builtin_fn_variant(int i, const char **isa_p,
+                                           const gasnet_coll_reduce_fn_t **tbl_p);
+extern int gasnete_coll_online_simulate(int num_arms, const uint64_t cost[], int ncalls,
+                                        int samples, int explore, int epoch, int *explored_p);
 
 /* ------------------------------------------------------------------------------------ */
 /* run iters iterations of diagnostics and return zero on success 
@@ -163,6 +171,12 @@ extern int gasneti_run_diagnostics(int iter_cnt, int threadcnt, const char *test
 
   op_test(0);
 
+  BARRIER();
+  redop_test(0);
+
+  BARRIER();
+  online_test(0);
+
   BARRIER();
   TEST_HEADER("conduit tests") {
     BARRIER();
@@ -1133,6 +1147,150 @@ static void op_test(int id) {
 }
 #endif
 /* ------------------------------------------------------------------------------------ */
+/* Every built-in reduction operator, in every kernel variant compiled into the
+   library, against a scalar reference over odd lengths and misaligned starts */
+#define REDOP_MAXLEN  1031 /* odd, and not a multiple of any vector width */
+#define REDOP_MAXSKEW 7    /* elements */
+#define REDOP_GUARD   4    /* elements past the end which must be left alone */
+
+#define REDOP_ARITH_REF(op,a,b)                 \
+  ((op) == GASNET_COLL_OP_SUM  ? (a) + (b) :    \
+   (op) == GASNET_COLL_OP_PROD ? (a) * (b) :    \
+   (op) == GASNET_COLL_OP_MIN  ? ((b) < (a) ? (b) : (a)) : ((b) > (a) ? (b) : (a)))
+#define REDOP_INT_REF(op,a,b)                   \
+  ((op) == GASNET_COLL_OP_BAND ? (a) & (b) :    \
+   (op) == GASNET_COLL_OP_BOR  ? (a) | (b) :    \
+   (op) == GASNET_COLL_OP_BXOR ? (a) ^ (b) : REDOP_ARITH_REF(op,a,b))
+/* small values keep the products exact and free of signed overflow */
+#define REDOP_INT_VAL(T)   ((T)TEST_RAND(-1000,1000))
+#define REDOP_FLOAT_VAL(T) ((T)TEST_RAND(-1000,1000) / 8)
+
+/* returns 1 + the index of the first wrong element, or 0 if all are right */
+#define REDOP_CHECK_FN(TNAME,T,REF,VAL)                                                 \
+static int redop_check_##TNAME(gasnet_coll_reduce_fn_t fn, int op,                     \
+                               size_t len, size_t skew, int inplace) {                 \
+  static T mem[3][REDOP_MAXSKEW + REDOP_MAXLEN + REDOP_GUARD + 64/sizeof(T)];           \
+  static T expect[REDOP_MAXLEN + REDOP_GUARD];                                          \
+  T * const left  = (T *)GASNETI_ALIGNUP(mem[0], 64) + skew;                            \
+  T * const right = (T *)GASNETI_ALIGNUP(mem[1], 64) + (skew + 1) % (REDOP_MAXSKEW + 1); \
+  T * const res   = inplace ? left : (T *)GASNETI_ALIGNUP(mem[2], 64) + REDOP_MAXSKEW - skew; \
+  size_t i;                                                                             \
+  for (i = 0; i < len + REDOP_GUARD; ++i) {                                             \
+    left[i] = VAL(T);                                                                   \
+    right[i] = VAL(T);                                                                  \
+    if (!inplace) res[i] = VAL(T);                                                      \
+  }                                                                                     \
+  for (i = 0; i < len + REDOP_GUARD; ++i) {                                             \
+    expect[i] = (i < len) ? (T)REF(op, left[i], right[i]) : res[i];                     \
+  }                                                                                     \
+  (*fn)(res, len, left, len, right, sizeof(T), 0, 0);                                   \
+  for (i = 0; i < len + REDOP_GUARD; ++i) {                                             \
+    if (res[i] != expect[i]) return (int)i + 1;                                         \
+  }                                                                                     \
+  return 0;                                                                             \
+}
+REDOP_CHECK_FN(int32,  int32_t,  REDOP_INT_REF,   REDOP_INT_VAL)
+REDOP_CHECK_FN(uint32, uint32_t, REDOP_INT_REF,   REDOP_INT_VAL)
+REDOP_CHECK_FN(int64,  int64_t,  REDOP_INT_REF,   REDOP_INT_VAL)
+REDOP_CHECK_FN(uint64, uint64_t, REDOP_INT_REF,   REDOP_INT_VAL)
+REDOP_CHECK_FN(float,  float,    REDOP_ARITH_REF, REDOP_FLOAT_VAL)
+REDOP_CHECK_FN(double, double,   REDOP_ARITH_REF, REDOP_FLOAT_VAL)
+
+static void redop_test(int id) {
+  static const size_t lens[] = { 0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 33,
+                                 63, 65, 127, 129, 255, 257, REDOP_MAXLEN };
+  static const char * const tnames[] = { "int32", "uint32", "int64", "uint64", "float", "double" };
+  const gasnet_coll_reduce_fn_t *tbl;
+  const char *isa;
+  int v;
+
+  TEST_HEADER("built-in reduction operator test"); else return;
+
+  for (v = 0; gasnete_coll_builtin_fn_variant(v, &isa, &tbl); ++v) {
+    int t, op;
+    if (!tbl) {
+      MSG0("  %s kernels - SKIPPED (not supported by this CPU)", isa);
+      continue;
+    }
+    for (t = 0; t < (int)GASNET_COLL_NUM_TYPES; ++t) {
+      for (op = 0; op < (int)GASNET_COLL_NUM_OPS; ++op) {
+        const gasnet_coll_reduce_fn_t fn = tbl[t * (int)GASNET_COLL_NUM_OPS + op];
+        const int is_int = (t < (int)GASNET_COLL_TYPE_FLOAT);
+        size_t l, skew;
+        int inplace;
+
+        if (!fn) {
+          if (is_int || op < (int)GASNET_COLL_OP_BAND)
+            ERR("%s kernels have no operator %i for %s", isa, op, tnames[t]);
+          continue;
+        }
+        for (l = 0; l < sizeof(lens)/sizeof(lens[0]); ++l) {
+          for (skew = 0; skew <= REDOP_MAXSKEW; ++skew) {
+            for (inplace = 0; inplace < 2; ++inplace) {
+              int bad;
+              switch (t) {
+                case GASNET_COLL_TYPE_INT32:  bad = redop_check_int32(fn, op, lens[l], skew, inplace); break;
+                case GASNET_COLL_TYPE_UINT32: bad = redop_check_uint32(fn, op, lens[l], skew, inplace); break;
+                case GASNET_COLL_TYPE_INT64:  bad = redop_check_int64(fn, op, lens[l], skew, inplace); break;
+                case GASNET_COLL_TYPE_UINT64: bad = redop_check_uint64(fn, op, lens[l], skew, inplace); break;
+                case GASNET_COLL_TYPE_FLOAT:  bad = redop_check_float(fn, op, lens[l], skew, inplace); break;
+                default:                      bad = redop_check_double(fn, op, lens[l], skew, inplace); break;
+              }
+              if (bad) {
+                ERR("%s kernel for %s operator %i is wrong at element %i of %i (skew=%i%s)",
+                    isa, tnames[t], op, bad - 1, (int)lens[l], (int)skew, inplace ? ", in place" : "");
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/* The online collective tuner must settle on the fastest arm, wherever it is
+ * ranked, while trying the others on at most one call in every 'explore'. */
+#define ONLINE_MAXARMS  8  /* GASNETE_COLL_ONLINE_MAX_ARMS */
+#define ONLINE_NCALLS   2000
+static void online_test(int id) {
+  static const int scheds[][3] = { /* samples, explore, epoch */
+    { 5, 16, 256 }, { 2, 4, 16 }, { 1, 0, 0 }, { 3, 8, 0 }
+  };
+  int s;
+
+  TEST_HEADER("online collective tuner test"); else return;
+
+  for (s = 0; s < (int)(sizeof(scheds)/sizeof(scheds[0])); ++s) {
+    const int samples = scheds[s][0], explore = scheds[s][1], epoch = scheds[s][2];
+    const int max_explored = (explore > 1) ? (ONLINE_NCALLS / explore + 1) : 0;
+    int num_arms, fastest;
+
+    for (num_arms = 1; num_arms <= ONLINE_MAXARMS; ++num_arms) {
+      for (fastest = 0; fastest < num_arms; ++fastest) {
+        uint64_t cost[ONLINE_MAXARMS];
+        int k, best, explored;
+
+        for (k = 0; k < num_arms; ++k) {
+          cost[k] = (k == fastest) ? 500 : (1000 + 37 * k);
+        }
+        /* samples > 1 is needed to time an arm after its discarded warm-up */
+        best = gasnete_coll_online_simulate(num_arms, cost, ONLINE_NCALLS,
+                                            samples, explore, epoch, &explored);
+        if ((samples > 1 || num_arms == 1) && (best != fastest)) {
+          ERR("online tuner settled on arm %i of %i instead of the fastest, %i"
+              " (samples=%i explore=%i epoch=%i)",
+              best, num_arms, fastest, samples, explore, epoch);
+        }
+        if (explored > max_explored) {
+          ERR("online tuner explored on %i of %i calls, more than %i"
+              " (samples=%i explore=%i epoch=%i)",
+              explored, ONLINE_NCALLS, max_explored, samples, explore, epoch);
+        }
+      }
+    }
+  }
+}
+/* ------------------------------------------------------------------------------------ */
 #if GASNET_PAR
 
 static void * thread_fn(void *arg) {
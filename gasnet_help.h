@@ -744,6 +744,20 @@ extern int gasneti_wait_mode; /* current waitmode hint */
     gasneti_spinloop_hint();                                          \
   } while (0)
 
+/* Variant for waits which can only end by delivery of a PSHM message to this
+ * process, or by an explicit gasneti_pshm_wakeup_{one,all}() (such as the PSHM
+ * barriers).  Conduits may override GASNETI_PSHM_WAITHOOK_BLOCK() with a true
+ * blocking wait, which would be wrong for waits ended by other events.
+ */
+#ifndef GASNETI_PSHM_WAITHOOK_BLOCK
+  #define GASNETI_PSHM_WAITHOOK_BLOCK() gasneti_sched_yield()
+#endif
+#define GASNETI_PSHM_WAITHOOK() do {                                          \
+    if (gasneti_wait_mode != GASNET_WAIT_SPIN) GASNETI_PSHM_WAITHOOK_BLOCK(); \
+    gasneti_compiler_fence();                                                 \
+    gasneti_spinloop_hint();                                                  \
+  } while (0)
+
 /* busy-waits, with no implicit polling (cnd should include an embedded poll)
    differs from GASNET_BLOCKUNTIL because it may be waiting for an event
      caused by the receipt of a non-AM message
@@ -772,6 +786,24 @@ extern int gasneti_wait_mode; /* current waitmode hint */
 #endif
 #define gasneti_polluntil(cnd) gasneti_pollwhile(!(cnd)) 
 
+/* PSHM variants of the above, using GASNETI_PSHM_WAITHOOK() */
+#define gasneti_pshm_waitwhile(cnd) do { \
+    while (cnd) GASNETI_PSHM_WAITHOOK();  \
+    gasneti_local_rmb();                  \
+  } while (0)
+#define gasneti_pshm_waituntil(cnd) gasneti_pshm_waitwhile(!(cnd))
+#define gasneti_pshm_pollwhile(cnd) do { \
+    if (cnd) {                            \
+      gasneti_AMPoll();                   \
+      while (cnd) {                       \
+        GASNETI_PSHM_WAITHOOK();          \
+        gasneti_AMPoll();                 \
+      }                                   \
+    }                                     \
+    gasneti_local_rmb();                  \
+  } while (0)
+#define gasneti_pshm_polluntil(cnd) gasneti_pshm_pollwhile(!(cnd))
+
 /* ------------------------------------------------------------------------------------ */
 
 /* high-performance timer library */
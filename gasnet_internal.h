@@ -57,6 +57,10 @@ extern void gasneti_decode_args(int *argc, char ***argv);
 /* extract exit coordination timeout from environment vars (with defaults) */
 extern double gasneti_get_exittimeout(double dflt_max, double dflt_min, double dflt_factor, double lower_bound);
 
+/* stop any thread started by the collectives, before the conduit is torn
+   down by gasnetc_exit() (not signal-safe) */
+extern void gasnete_coll_fini(void);
+
 /* Safe memory allocation/deallocation 
    Beware - in debug mode, gasneti_malloc/gasneti_calloc/gasneti_free are NOT
    compatible with malloc/calloc/free
@@ -801,6 +805,15 @@ typedef struct _gasneti_threaddata_t {
 
   gasnete_iop_t *iop_free;      /*  free list of iops */
 
+  #if GASNET_PSHM
+  //
+  // AMPSHM data
+  // Owned by gasnet_pshm.c
+  //
+  void *pshm_loopback_buf[2];   /* cached loopback AM buffers, indexed by isReq */
+  int pshm_loopback_cleanup;    /* non-zero once the thread exit cleanup is registered */
+  #endif
+
   //
   // Conduit-specific data
   // Owned by [CONDUIT]-conduie/gasnet_extended_fwd.h
@@ -33,9 +33,22 @@
  #endif
 #endif
 
+/* Runtime-selectable hugepage backing of PSHM objects (GASNET_PSHM_HUGEPAGES).
+ * Supported for PSHM over POSIX or FILE on Linux, using files in a hugetlbfs
+ * mount.  Not used when configured to use libhugetlbfs for all mappings.
+ */
+#if GASNET_PSHM && PLATFORM_OS_LINUX && !defined(GASNETI_USE_HUGETLBFS) && \
+    (defined(GASNETI_PSHM_POSIX) || defined(GASNETI_PSHM_FILE))
+  #define GASNETI_PSHM_HUGEPAGES 1
+  static uintptr_t gasneti_pshm_hugepagesize(void);
+#endif
+
 #if defined(GASNETI_MMAP_OR_PSHM) && defined(GASNETI_USE_HUGETLBFS)
   #define gasneti_mmap_aligndown(sz) gasneti_mmap_aligndown_huge(sz)
   #define gasneti_mmap_pagesize()    gasneti_mmap_pagesize_huge()
+#elif GASNETI_PSHM_HUGEPAGES
+  #define gasneti_mmap_pagesize()    (gasneti_pshm_hugepagesize() ? gasneti_pshm_hugepagesize() : GASNETI_PAGESIZE)
+  #define gasneti_mmap_aligndown(sz) GASNETI_ALIGNDOWN(sz, gasneti_mmap_pagesize())
 #else
   #define gasneti_mmap_aligndown(sz) GASNETI_PAGE_ALIGNDOWN(sz)
   #define gasneti_mmap_pagesize()    GASNETI_PAGESIZE
@@ -434,6 +447,142 @@ static const char *gasneti_pshm_makeunique(const char *unique) {
   return unique;
 }
 #endif
+
+#if GASNETI_PSHM_HUGEPAGES
+#include <sys/vfs.h> /* for statfs() */
+#ifndef HUGETLBFS_MAGIC
+#define HUGETLBFS_MAGIC 0x958458f6
+#endif
+
+/* Hugepage backing is attempted per object, and each object independently
+ * falls back to regular pages if it cannot be created in hugetlbfs (most
+ * commonly due to an insufficient pool of free hugepages).  Therefore the
+ * attaching processes look for the hugetlbfs file first and then for the
+ * regular object of the same name.
+ */
+#define GASNETI_PSHM_HUGEDIR_MAX 960
+static uintptr_t gasneti_pshm_hugepgsz = 0; /* 0 if disabled or unavailable */
+static char gasneti_pshm_hugedir[GASNETI_PSHM_HUGEDIR_MAX];
+static char gasneti_pshm_hugeobj[GASNETI_PSHM_MAX_NODES+1]; /* indexed by pshm rank, as names/keys */
+
+/* Returns the hugetlbfs page size at 'dir' if it is a usable hugetlbfs mount, else 0 */
+static uintptr_t gasneti_pshm_hugedir_pagesize(const char *dir) {
+  struct statfs sfs;
+  if (strlen(dir) >= GASNETI_PSHM_HUGEDIR_MAX) return 0;
+  if (statfs(dir, &sfs) || (sfs.f_type != HUGETLBFS_MAGIC)) return 0;
+  if (access(dir, R_OK|W_OK|X_OK)) return 0;
+  return (uintptr_t)sfs.f_bsize;
+}
+
+/* Returns the hugepage size to use for PSHM objects, or 0 if hugepages are not used.
+ * The first call selects a hugetlbfs mount, preferring one with 2MB pages.
+ */
+static uintptr_t gasneti_pshm_hugepagesize(void) {
+  static int isinit = 0;
+  if (isinit) return gasneti_pshm_hugepgsz;
+  isinit = 1;
+
+  if (!gasneti_getenv_yesno_withdefault("GASNET_PSHM_HUGEPAGES", 0)) return 0;
+
+  const char *dir = gasneti_getenv_withdefault("GASNET_PSHM_HUGEPAGE_DIR", "");
+  uintptr_t pgsz = 0;
+  if (strlen(dir)) {
+    pgsz = gasneti_pshm_hugedir_pagesize(dir);
+    if (pgsz) strcpy(gasneti_pshm_hugedir, dir);
+  } else {
+    FILE *fp = fopen("/proc/mounts", "r");
+    char line[1024];
+    while (fp && fgets(line, sizeof(line), fp)) {
+      char mnt[GASNETI_PSHM_HUGEDIR_MAX];
+      char type[32];
+      if (2 != sscanf(line, "%*s %959s %31s", mnt, type)) continue;
+      if (strcmp(type, "hugetlbfs")) continue;
+      uintptr_t sz = gasneti_pshm_hugedir_pagesize(mnt);
+      if (sz && (!pgsz || (sz == (2<<20)))) {
+        pgsz = sz;
+        strcpy(gasneti_pshm_hugedir, mnt);
+        if (sz == (2<<20)) break;
+      }
+    }
+    if (fp) fclose(fp);
+  }
+
+  if (!pgsz) {
+    GASNETI_TRACE_PRINTF(I,("WARNING: GASNET_PSHM_HUGEPAGES set but no usable hugetlbfs mount was found"));
+    if (gasneti_verboseenv())
+      fprintf(stderr, "WARNING: GASNET_PSHM_HUGEPAGES set but no usable hugetlbfs mount was found\n");
+  }
+  gasneti_pshm_hugepgsz = pgsz;
+  return pgsz;
+}
+
+/* Path of the hugetlbfs file for the object of the given pshm rank */
+static void gasneti_pshm_hugename(int pshm_rank, char *buf, size_t len) {
+  const char *base = strrchr(gasneti_pshmname[pshm_rank], '/');
+  gasneti_assert(base);
+  snprintf(buf, len, "%s%s", gasneti_pshm_hugedir, base);
+}
+
+/* Create or attach the hugetlbfs file for an object, returning MAP_FAILED on failure.
+ * The mapped length is always a multiple of the hugepage size.
+ */
+static void *gasneti_pshm_huge_mmap(int pshm_rank, void *segbase, size_t segsize, int create) {
+  const uintptr_t pgsz = gasneti_pshm_hugepgsz;
+  int mmap_flags = MAP_SHARED;
+  void *ptr = MAP_FAILED;
+  char filename[GASNETI_PSHM_HUGEDIR_MAX + 32];
+
+  if (segbase) {
+    /* The mapping may be longer than requested, and so must not displace other mappings */
+    if ((uintptr_t)segbase % pgsz) return MAP_FAILED;
+  #ifdef MAP_FIXED_NOREPLACE
+    mmap_flags |= MAP_FIXED_NOREPLACE;
+  #endif
+  }
+  segsize = GASNETI_ALIGNUP(segsize, pgsz);
+
+  gasneti_pshm_hugename(pshm_rank, filename, sizeof(filename));
+  int fd = open(filename, O_RDWR | (create ? (O_CREAT | O_EXCL) : 0), S_IRUSR | S_IWUSR);
+  if (fd == -1) return MAP_FAILED;
+
+  /* Hugepages are reserved by the creator's mmap(), which fails if the pool is insufficient */
+  if (!create || !ftruncate(fd, segsize)) {
+    ptr = mmap(segbase, segsize, (PROT_READ|PROT_WRITE), mmap_flags, fd, 0);
+    if (segbase && (ptr != MAP_FAILED) && (ptr != segbase)) { /* kernel lacks MAP_FIXED_NOREPLACE */
+      (void)munmap(ptr, segsize);
+      ptr = MAP_FAILED;
+    }
+  }
+  (void) close(fd);
+  if (create && (ptr == MAP_FAILED)) (void) unlink(filename);
+
+  return ptr;
+}
+
+/* Length to pass to munmap() for an object of the given pshm rank */
+GASNETI_INLINE(gasneti_pshm_maplen)
+uintptr_t gasneti_pshm_maplen(int pshm_rank, uintptr_t segsize) {
+  return gasneti_pshm_hugeobj[pshm_rank] ? GASNETI_ALIGNUP(segsize, gasneti_pshm_hugepgsz) : segsize;
+}
+
+/* Report the backing selected for an object */
+static void gasneti_pshm_report_backing(const char *what, int pshm_rank) {
+  char desc[GASNETI_PSHM_HUGEDIR_MAX + 64];
+  if (gasneti_pshm_hugeobj[pshm_rank]) {
+    snprintf(desc, sizeof(desc), "hugepages (%"PRIuPTR" KB pages in %s)",
+             gasneti_pshm_hugepgsz >> 10, gasneti_pshm_hugedir);
+  } else {
+    strcpy(desc, gasneti_pshm_hugepgsz ? "regular pages (hugepage allocation failed)" : "regular pages");
+  }
+  GASNETI_TRACE_PRINTF(I,("PSHM %s is backed by %s", what, desc));
+  if (gasneti_verboseenv() && !gasneti_pshm_mynode) { /* once per supernode */
+    fprintf(stderr, "PSHM %s is backed by %s\n", what, desc);
+    fflush(stderr);
+  }
+}
+#else
+  #define gasneti_pshm_maplen(pshm_rank, segsize) (segsize)
+#endif /* GASNETI_PSHM_HUGEPAGES */
 #endif /* GASNET_PSHM */
 
 #if defined(GASNETI_USE_HUGETLBFS)
@@ -511,6 +660,17 @@ static void * __attribute__((noinline)) gasneti_pshm_mmap(int pshm_rank, void *s
   const char *filename = gasneti_pshmname[pshm_rank];
   int fd = -1;
 
+  #if GASNETI_PSHM_HUGEPAGES
+    gasneti_pshm_hugeobj[pshm_rank] = 0;
+    if (gasneti_pshm_hugepagesize()) {
+      ptr = gasneti_pshm_huge_mmap(pshm_rank, segbase, segsize, create);
+      if (ptr != MAP_FAILED) {
+        gasneti_pshm_hugeobj[pshm_rank] = 1;
+        return ptr;
+      }
+    }
+  #endif
+
   /* create or open */
   #if defined(GASNETI_PSHM_FILE)
    #if defined(GASNETI_USE_HUGETLBFS)
@@ -604,7 +764,7 @@ static void gasneti_pshm_munmap(void *segbase, uintptr_t segsize) {
 	      GASNETI_LADDRSTR(segbase), strerror(errno));
   }
 #elif defined(GASNETI_PSHM_FILE) || defined(GASNETI_PSHM_POSIX) || defined(GASNETI_PSHM_XPMEM)
-  gasneti_munmap(segbase, segsize);
+  gasneti_munmap(segbase, gasneti_pshm_maplen(gasneti_pshm_mynode, segsize));
 #elif defined(GASNETI_PSHM_GHEAP)
   gasneti_pshm_vfree(segbase);
 #else
@@ -622,7 +782,7 @@ static void gasneti_munmap_remote(gasnet_node_t pshm_rank, void *segbase, uintpt
 	      GASNETI_LADDRSTR(segbase), strerror(errno));
   }
 #elif defined(GASNETI_PSHM_FILE) || defined(GASNETI_PSHM_POSIX)
-  gasneti_munmap(segbase, segsize);
+  gasneti_munmap(segbase, gasneti_pshm_maplen(pshm_rank, segsize));
 #elif defined(GASNETI_PSHM_XPMEM)
  #if HAVE_XPMEM_MAKE_2
   xpmem_detach_2(segbase, segsize);
@@ -676,6 +836,13 @@ static void gasneti_pshm_unlink(int pshm_rank){
 #else
   #error
 #endif
+#if GASNETI_PSHM_HUGEPAGES
+  if (gasneti_pshm_hugepgsz) {
+    char hugename[GASNETI_PSHM_HUGEDIR_MAX + 32];
+    gasneti_pshm_hugename(pshm_rank, hugename, sizeof(hugename));
+    (void)unlink(hugename);
+  }
+#endif
 }
 
 /* gasneti_pshm_unlink() so the shared memory will disappear upon exit.
@@ -932,6 +1099,10 @@ extern void *gasneti_mmap_vnet(uintptr_t size, gasneti_bootstrapBroadcastfn_t sn
   gasneti_vnet_addr = ptr;
   gasneti_vnet_size = size;
 
+  #if GASNETI_PSHM_HUGEPAGES
+  if (ptr != MAP_FAILED) gasneti_pshm_report_backing("network region", gasneti_pshm_nodes);
+  #endif
+
   return (ptr == MAP_FAILED) ? NULL : ptr;
 }
 extern void gasneti_unlink_vnet(void) {
@@ -1596,6 +1767,11 @@ void gasneti_segmentAttach(uintptr_t segsize, uintptr_t minheapoffset,
   #ifdef GASNETI_MMAP_OR_PSHM
   { /* TODO: this assumes heap grows up */
     uintptr_t topofheap;
+  #if GASNETI_PSHM_HUGEPAGES
+    /* Place and map the segment in whole hugepages, but report the size requested */
+    const uintptr_t client_segsize = segsize;
+    segsize = MIN(GASNETI_ALIGNUP(segsize, gasneti_mmap_pagesize()), gasneti_segment.size);
+  #endif
     #if GASNET_ALIGNED_SEGMENTS
       #if GASNETI_USE_HIGHSEGMENT
         { /* the segsizes requested may differ across nodes, so in order to 
@@ -1690,10 +1866,17 @@ void gasneti_segmentAttach(uintptr_t segsize, uintptr_t minheapoffset,
         segbase =
 #endif
         gasneti_do_mmap_fixed(segbase, segsize);
+      #if GASNET_PSHM
+        gasneti_pshm_numa_place("segment", segbase, segsize);
+      #endif
       }
     }
     gasneti_free(gasneti_segexch);
     gasneti_segexch = NULL;
+  #if GASNETI_PSHM_HUGEPAGES
+    segsize = MIN(segsize, client_segsize);
+    if (segsize) gasneti_pshm_report_backing("segment", gasneti_pshm_mynode);
+  #endif
   }
   #else /* !GASNETI_MMAP_OR_PSHM */
     /* for the T3E, and other platforms which don't support mmap */
@@ -1752,6 +1935,8 @@ void gasneti_segmentAttach(uintptr_t segsize, uintptr_t minheapoffset,
         }
     }
 
+    gasneti_pshm_numa_dump_placement();
+
     /* Barrier #1 ensures all attaches complete before unlinking */
     gasneti_pshmnet_bootstrapBarrier();
     gasneti_cleanup_shm();
@@ -1873,10 +2058,10 @@ extern void gasneti_pshm_fini(void) {
         lrank += 1;
       }
     } else {
-      gasneti_munmap(gasneti_segment.addr, gasneti_segment.size);
+      gasneti_munmap(gasneti_segment.addr, gasneti_pshm_maplen(gasneti_pshm_mynode, gasneti_segment.size));
     }
     if (gasneti_vnet_addr) {
-      gasneti_munmap(gasneti_vnet_addr, gasneti_vnet_size);
+      gasneti_munmap(gasneti_vnet_addr, gasneti_pshm_maplen(gasneti_pshm_nodes, gasneti_vnet_size));
     }
   #else
     // Not currently supported (or thought to be necessary) on platforms other than WSL
@@ -12,6 +12,18 @@
 
 #include <sys/types.h>
 #include <signal.h>
+#if PLATFORM_OS_LINUX
+  #include <sys/syscall.h> /* for mbind, move_pages and futex */
+  #if defined(SYS_futex)
+    #include <linux/futex.h>
+    #define GASNETI_PSHM_FUTEX 1
+  #endif
+#endif
+
+#if PLATFORM_ARCH_X86_64 && GASNETI_HAVE_GCC_ASM && \
+    (PLATFORM_COMPILER_GNU || PLATFORM_COMPILER_CLANG || PLATFORM_COMPILER_INTEL)
+  #define GASNETI_PSHM_HAVE_NTCOPY 1 /* SSE2 non-temporal stores */
+#endif
 
 #if defined(GASNETI_USE_GENERIC_ATOMICOPS) || defined(GASNETI_USE_OS_ATOMICOPS)
   #error "GASNet PSHM support requires Native atomics"
@@ -34,11 +46,18 @@ static uintptr_t gasneti_pshmnet_queue_mem = 0;
 
 static void *gasnetc_pshmnet_region = NULL;
 
+/* Thresholds (in bytes) for large AMLong payloads, where 0 means disabled */
+static size_t gasneti_pshm_longasync_threshold = 0;
+static size_t gasneti_pshm_ntcopy_threshold = 0;
+
 static struct gasneti_pshm_info {
     gasneti_atomic_t    bootstrap_barrier_cnt;
     char _pad1[GASNETI_CACHE_PAD(sizeof(gasneti_atomic_t))];
     gasneti_atomic_t    bootstrap_barrier_gen;
     char _pad2[GASNETI_CACHE_PAD(sizeof(gasneti_atomic_t))];
+    /* non-zero once any process has slept in a blocking wait (never reset) */
+    gasneti_atomic_t    sleepers_seen;
+    char _pad3[GASNETI_CACHE_PAD(sizeof(gasneti_atomic_t))];
     /* early_barrier will be overwritten by other vars after its completion */
     /* sig_atomic_t should be wide enough to avoid word-tearing, right? */
     union {
@@ -48,6 +67,52 @@ static struct gasneti_pshm_info {
 } *gasneti_pshm_info = NULL;
 #define GASNETI_PSHM_BSB_LIMIT (GASNETI_ATOMIC_MAX - 2)
 
+/* Per-rank words for blocking waits (GASNET_WAIT_BLOCK and GASNET_WAIT_SPINBLOCK).
+ * An idle process sleeps on its 'seq' word (a futex) for a bounded time.
+ * Senders advance 'seq' and wake the target only if its 'sleeping' count is
+ * non-zero, and only check that once some process has ever slept.  Both reads
+ * follow a full fence after the message is written.
+ */
+typedef union {
+  struct {
+    volatile uint32_t seq;     /* futex word */
+    gasneti_atomic_t sleeping; /* number of threads of this rank asleep */
+  } w;
+  char _pad[GASNETI_CACHE_LINE_BYTES];
+} gasneti_pshm_wakeup_t;
+static gasneti_pshm_wakeup_t *gasneti_pshm_wakeup = NULL; /* lives in shared space */
+static void gasneti_pshm_waithook_init(void);
+
+/* Blocking wait state (see gasneti_pshm_waithook()) */
+#define GASNETI_PSHM_SLEEP_MIN_NS 50000 /* 50us */
+static uint64_t gasneti_pshm_spin_iters = 0;
+static uint64_t gasneti_pshm_sleep_max_ns = 0;
+static uint64_t gasneti_pshm_idle_iters = 0;
+static uint64_t gasneti_pshm_sleep_ns = GASNETI_PSHM_SLEEP_MIN_NS;
+#define gasneti_pshm_waithook_reset() do {                         \
+    if (gasneti_pshm_idle_iters ||                                 \
+        (gasneti_pshm_sleep_ns != GASNETI_PSHM_SLEEP_MIN_NS)) {    \
+      gasneti_pshm_idle_iters = 0;                                 \
+      gasneti_pshm_sleep_ns = GASNETI_PSHM_SLEEP_MIN_NS;           \
+    }                                                              \
+  } while (0)
+
+#if GASNETI_PSHM_FUTEX
+GASNETI_INLINE(gasneti_pshm_wakeup_rank)
+void gasneti_pshm_wakeup_rank(gasneti_pshm_rank_t rank) {
+  gasneti_local_mb(); /* order our message before reading 'sleepers_seen' and 'sleeping' */
+  if_pf (gasneti_atomic_read(&gasneti_pshm_info->sleepers_seen, 0)) {
+    gasneti_pshm_wakeup_t * const w = &gasneti_pshm_wakeup[rank];
+    if (gasneti_atomic_read(&w->w.sleeping, 0)) {
+      w->w.seq++;
+      (void)syscall(SYS_futex, &w->w.seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+  }
+}
+#else
+  #define gasneti_pshm_wakeup_rank(rank) ((void)0)
+#endif
+
 #define round_up_to_pshmpage(size_or_addr)               \
         GASNETI_ALIGNUP(size_or_addr, GASNETI_PSHMNET_PAGESIZE)
 
@@ -56,6 +121,239 @@ static struct gasneti_pshm_info {
 
 static void (*gasnetc_pshm_abort_callback)(void);
 
+/*******************************************************************************
+ * NUMA-aware placement of per-process shared memory:
+ * The NUMA node of each process is taken from its CPU affinity together with the
+ * node-to-CPU map in sysfs (no libnuma needed).  A process bound within a single
+ * NUMA node sets a preferred-node policy via mbind() on its own receive queues,
+ * payload regions and segment before they are first touched.  When enabled, the
+ * queue headers and SPSC rings are padded to whole pages to permit this.
+ ******************************************************************************/
+#if PLATFORM_OS_LINUX && defined(SYS_mbind)
+  #define GASNETI_PSHM_NUMA 1
+  #define GASNETI_PSHM_NUMA_MAXCPU  4096
+  #define GASNETI_PSHM_NUMA_MAXNODE 1024
+  #define GASNETI_PSHM_MPOL_PREFERRED 1 /* from <linux/mempolicy.h> */
+  typedef struct { uint64_t bits[GASNETI_PSHM_NUMA_MAXCPU/64]; } gasneti_pshm_cpuset_t;
+  static int gasneti_pshm_numa_node = -1; /* -1 if unknown or unbound */
+  static int gasneti_pshm_numa_dump = 0;
+
+  /* Parse a Linux "cpulist" (e.g. "0-3,8,10-11") into a bitmask. Returns 0 on success */
+  static int gasneti_pshm_parse_cpulist(const char *list, gasneti_pshm_cpuset_t *set) {
+    memset(set, 0, sizeof(*set));
+    while (*list && (*list != '\n')) {
+      char *end;
+      unsigned long lo = strtoul(list, &end, 10);
+      unsigned long hi = lo;
+      if (end == list) return 1;
+      if (*end == '-') {
+        list = end + 1;
+        hi = strtoul(list, &end, 10);
+        if (end == list) return 1;
+      }
+      if (hi >= GASNETI_PSHM_NUMA_MAXCPU) return 1;
+      for (; lo <= hi; ++lo) set->bits[lo/64] |= ((uint64_t)1 << (lo%64));
+      list = (*end == ',') ? end + 1 : end;
+    }
+    return 0;
+  }
+
+  /* Read a cpulist from the line of 'filename' beginning with 'tag' (or the first line if NULL) */
+  static int gasneti_pshm_read_cpulist(const char *filename, const char *tag, gasneti_pshm_cpuset_t *set) {
+    FILE *fp = fopen(filename, "r");
+    char line[8192];
+    int rc = 1;
+    if (!fp) return 1;
+    while (fgets(line, sizeof(line), fp)) {
+      if (!tag) {
+        rc = gasneti_pshm_parse_cpulist(line, set);
+        break;
+      } else if (!strncmp(line, tag, strlen(tag))) {
+        const char *p = line + strlen(tag);
+        while (*p == ' ' || *p == '\t') ++p;
+        rc = gasneti_pshm_parse_cpulist(p, set);
+        break;
+      }
+    }
+    fclose(fp);
+    return rc;
+  }
+
+  /* Returns the NUMA node containing all CPUs this process may run on, or -1 */
+  static int gasneti_pshm_numa_find_node(void) {
+    gasneti_pshm_cpuset_t allowed, nodecpus;
+    int node, result = -1;
+    if (gasneti_pshm_read_cpulist("/proc/self/status", "Cpus_allowed_list:", &allowed)) return -1;
+    for (node = 0; node < GASNETI_PSHM_NUMA_MAXNODE; ++node) {
+      char filename[64];
+      int i, subset = 1, overlap = 0;
+      snprintf(filename, sizeof(filename), "/sys/devices/system/node/node%d/cpulist", node);
+      if (access(filename, R_OK)) continue; /* node numbering may be sparse */
+      if (gasneti_pshm_read_cpulist(filename, NULL, &nodecpus)) continue;
+      for (i = 0; i < GASNETI_PSHM_NUMA_MAXCPU/64; ++i) {
+        if (allowed.bits[i] & ~nodecpus.bits[i]) subset = 0;
+        if (allowed.bits[i] & nodecpus.bits[i]) overlap = 1;
+      }
+      if (subset && overlap) { result = node; break; }
+      if (overlap) break; /* allowed CPUs span multiple nodes */
+    }
+    return result;
+  }
+
+  /* Returns non-zero if 'a' is a non-empty subset of 'b' */
+  static int gasneti_pshm_cpuset_within(const gasneti_pshm_cpuset_t *a, const gasneti_pshm_cpuset_t *b) {
+    int i, any = 0;
+    for (i = 0; i < GASNETI_PSHM_NUMA_MAXCPU/64; ++i) {
+      if (a->bits[i] & ~b->bits[i]) return 0;
+      any |= (a->bits[i] != 0);
+    }
+    return any;
+  }
+
+  static int gasneti_pshm_cpuset_first(const gasneti_pshm_cpuset_t *a) {
+    int i;
+    for (i = 0; i < GASNETI_PSHM_NUMA_MAXCPU; ++i) {
+      if (a->bits[i/64] & ((uint64_t)1 << (i%64))) return i;
+    }
+    return -1;
+  }
+
+  /* Prefer allocation of [addr, addr+len) on this process's NUMA node, if known.
+   * Returns 0 on success, or an errno value.  The range must be page-aligned. */
+  static int gasneti_pshm_numa_bind(void *addr, uintptr_t len) {
+    unsigned long mask[GASNETI_PSHM_NUMA_MAXNODE / (8*sizeof(unsigned long))];
+    const int bpl = 8*sizeof(unsigned long);
+    const int node = gasneti_pshm_numa_node;
+    if (node < 0 || !len) return 0;
+    memset(mask, 0, sizeof(mask));
+    mask[node / bpl] = 1UL << (node % bpl);
+    if (syscall(SYS_mbind, addr, (unsigned long)len, GASNETI_PSHM_MPOL_PREFERRED,
+                mask, (unsigned long)(GASNETI_PSHM_NUMA_MAXNODE + 1), 0)) {
+      return errno;
+    }
+    return 0;
+  }
+
+  /* Ranges placed since the last diagnostic dump */
+  #define GASNETI_PSHM_NUMA_MAXREC 8
+  static struct {
+    const char *what;
+    void *addr;
+    uintptr_t len;
+    int rc;
+  } gasneti_pshm_numa_rec[GASNETI_PSHM_NUMA_MAXREC];
+  static int gasneti_pshm_numa_nrec = 0;
+#endif
+
+/* Returns an identifier, unique within the O/S node, for the L3 cache (or else the
+ * processor package) to which this process is bound, or -1 if not bound within one.
+ */
+extern int gasneti_pshm_cpu_domain(void) {
+#if GASNETI_PSHM_NUMA
+  gasneti_pshm_cpuset_t allowed, domain;
+  char filename[128];
+  int cpu, idx;
+
+  if (gasneti_pshm_read_cpulist("/proc/self/status", "Cpus_allowed_list:", &allowed)) return -1;
+  cpu = gasneti_pshm_cpuset_first(&allowed);
+  if (cpu < 0) return -1;
+
+  /* Unified L3 cache, if any */
+  for (idx = 0; idx < 10; ++idx) {
+    FILE *fp;
+    int level = 0;
+    snprintf(filename, sizeof(filename), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, idx);
+    if (!(fp = fopen(filename, "r"))) break;
+    if (1 != fscanf(fp, "%d", &level)) level = 0;
+    fclose(fp);
+    if (level != 3) continue;
+    snprintf(filename, sizeof(filename), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, idx);
+    if (!gasneti_pshm_read_cpulist(filename, NULL, &domain) && gasneti_pshm_cpuset_within(&allowed, &domain)) {
+      return gasneti_pshm_cpuset_first(&domain);
+    }
+    break;
+  }
+
+  /* Processor package (socket) */
+  snprintf(filename, sizeof(filename), "/sys/devices/system/cpu/cpu%d/topology/core_siblings_list", cpu);
+  if (!gasneti_pshm_read_cpulist(filename, NULL, &domain) && gasneti_pshm_cpuset_within(&allowed, &domain)) {
+    return GASNETI_PSHM_NUMA_MAXCPU + gasneti_pshm_cpuset_first(&domain);
+  }
+#endif
+  return -1;
+}
+
+/* Whether per-process placement is enabled (GASNET_PSHM_NUMA).
+ * This determines the layout of the pshmnet region, and so must agree across the supernode.
+ */
+static int gasneti_pshm_numa_enabled(void) {
+#if GASNETI_PSHM_NUMA
+  static int enabled = -1;
+  if_pf (enabled < 0) {
+    enabled = gasneti_getenv_yesno_withdefault("GASNET_PSHM_NUMA", 0);
+    gasneti_pshm_numa_dump = gasneti_getenv_yesno_withdefault("GASNET_PSHM_NUMA_DUMP", 0);
+    if (enabled) gasneti_pshm_numa_node = gasneti_pshm_numa_find_node();
+  }
+  return enabled;
+#else
+  return 0;
+#endif
+}
+
+/* Place memory owned by this process on its own NUMA node, if possible */
+extern void gasneti_pshm_numa_place(const char *what, void *addr, uintptr_t len) {
+#if GASNETI_PSHM_NUMA
+  const int rc = gasneti_pshm_numa_bind(addr, len);
+  GASNETI_TRACE_PRINTF(I,("PSHM NUMA: %s at "GASNETI_LADDRFMT" len %"PRIuPTR" preferred node %d%s%s",
+                          what, GASNETI_LADDRSTR(addr), len, gasneti_pshm_numa_node,
+                          rc ? ": mbind failed: " : "", rc ? strerror(rc) : ""));
+  if (gasneti_pshm_numa_dump && (gasneti_pshm_numa_nrec < GASNETI_PSHM_NUMA_MAXREC)) {
+    gasneti_pshm_numa_rec[gasneti_pshm_numa_nrec].what = what;
+    gasneti_pshm_numa_rec[gasneti_pshm_numa_nrec].addr = addr;
+    gasneti_pshm_numa_rec[gasneti_pshm_numa_nrec].len = len;
+    gasneti_pshm_numa_rec[gasneti_pshm_numa_nrec].rc = rc;
+    gasneti_pshm_numa_nrec += 1;
+  }
+#endif
+}
+
+/* Diagnostic dump (GASNET_PSHM_NUMA_DUMP) of the ranges placed since the previous
+ * call, including the node currently holding the first page of each range */
+extern void gasneti_pshm_numa_dump_placement(void) {
+#if GASNETI_PSHM_NUMA
+  int i;
+  for (i = 0; i < gasneti_pshm_numa_nrec; ++i) {
+    void *addr = gasneti_pshm_numa_rec[i].addr;
+    const int rc = gasneti_pshm_numa_rec[i].rc;
+    char policy[80], where[80];
+    int status = -ENOENT;
+  #if defined(SYS_move_pages)
+    void *page = (void *)GASNETI_ALIGNDOWN((uintptr_t)addr, GASNETI_PSHMNET_PAGESIZE);
+    if (syscall(SYS_move_pages, 0, 1UL, &page, NULL, &status, 0)) status = -errno;
+  #endif
+    if (gasneti_pshm_numa_node < 0) {
+      strcpy(policy, "not placed (process not bound within one NUMA node)");
+    } else if (rc) {
+      snprintf(policy, sizeof(policy), "placement on node %d failed (%s)", gasneti_pshm_numa_node, strerror(rc));
+    } else {
+      snprintf(policy, sizeof(policy), "preferred node %d", gasneti_pshm_numa_node);
+    }
+    if (status >= 0) {
+      snprintf(where, sizeof(where), "first page on node %d", status);
+    } else if (status == -ENOENT) {
+      strcpy(where, "first page not yet resident");
+    } else {
+      snprintf(where, sizeof(where), "first page location unknown (%s)", strerror(-status));
+    }
+    fprintf(stderr, "PSHM NUMA: node %d (local rank %d) %s ["GASNETI_LADDRFMT", +%"PRIuPTR"): %s, %s\n",
+            (int)gasneti_mynode, (int)gasneti_pshm_mynode, gasneti_pshm_numa_rec[i].what,
+            GASNETI_LADDRSTR(addr), gasneti_pshm_numa_rec[i].len, policy, where);
+  }
+  if (gasneti_pshm_numa_nrec) fflush(stderr);
+  gasneti_pshm_numa_nrec = 0;
+#endif
+}
+
 void *gasneti_pshm_init(gasneti_bootstrapBroadcastfn_t snodebcastfn, size_t aux_sz) {
   size_t vnetsz, mmapsz;
   int discontig = 0;
@@ -104,6 +402,9 @@ void *gasneti_pshm_init(gasneti_bootstrapBroadcastfn_t snodebcastfn, size_t aux_
     info_sz = GASNETI_ALIGNUP(info_sz, GASNETI_CACHE_LINE_BYTES);
     info_sz += sizeof(gasneti_pshm_barrier_t) +
 	       (gasneti_pshm_nodes - 1) * sizeof(gasneti_pshm_barrier->node);
+    /* space for the blocking wait words */
+    info_sz = GASNETI_ALIGNUP(info_sz, GASNETI_CACHE_LINE_BYTES);
+    info_sz += gasneti_pshm_nodes * sizeof(gasneti_pshm_wakeup_t);
     /* space for early barrier, sharing space with the items above: */
     info_sz = MAX(info_sz, gasneti_pshm_nodes * sizeof(gasneti_pshm_info->early_barrier[0]));
     info_sz += offsetof(struct gasneti_pshm_info, early_barrier);
@@ -130,6 +431,7 @@ void *gasneti_pshm_init(gasneti_bootstrapBroadcastfn_t snodebcastfn, size_t aux_
   if (gasneti_pshm_mynode == 0) {
     gasneti_atomic_set(&gasneti_pshm_info->bootstrap_barrier_cnt, gasneti_pshm_nodes, 0);
     gasneti_atomic_set(&gasneti_pshm_info->bootstrap_barrier_gen, 0, 0);
+    gasneti_atomic_set(&gasneti_pshm_info->sleepers_seen, 0, 0);
   }
 
   /* "early" barrier which protects initialization of the real barrier counter. */
@@ -166,6 +468,12 @@ void *gasneti_pshm_init(gasneti_bootstrapBroadcastfn_t snodebcastfn, size_t aux_
     gasneti_pshm_barrier = (gasneti_pshm_barrier_t *)addr;
     addr += sizeof(gasneti_pshm_barrier_t) +
 	    (gasneti_pshm_nodes-1) * sizeof(gasneti_pshm_barrier->node);
+    /* blocking wait words, each initialized by its owner: */
+    addr = GASNETI_ALIGNUP(addr, GASNETI_CACHE_LINE_BYTES);
+    gasneti_pshm_wakeup = (gasneti_pshm_wakeup_t *)addr;
+    gasneti_pshm_wakeup[gasneti_pshm_mynode].w.seq = 0;
+    gasneti_atomic_set(&gasneti_pshm_wakeup[gasneti_pshm_mynode].w.sleeping, 0, 0);
+    addr += gasneti_pshm_nodes * sizeof(gasneti_pshm_wakeup_t);
   }
 
   /* Populate gasneti_pshm_firsts[] */
@@ -207,8 +515,23 @@ void *gasneti_pshm_init(gasneti_bootstrapBroadcastfn_t snodebcastfn, size_t aux_
           gasneti_pshmnet_init((void*)((uintptr_t)gasnetc_pshmnet_region + vnetsz),
                                vnetsz, gasneti_pshm_nodes);
 
+  /* Large payload behaviors for AMPSHM */
+  gasneti_pshm_longasync_threshold =
+          gasneti_getenv_int_withdefault("GASNET_PSHM_LONGASYNC_THRESHOLD", 65536, 1);
+#if GASNETI_PSHM_HAVE_NTCOPY
+  gasneti_pshm_ntcopy_threshold =
+          gasneti_getenv_int_withdefault("GASNET_PSHM_NTCOPY_THRESHOLD", 4*1024*1024, 1);
+  if (gasneti_pshm_ntcopy_threshold) {
+    /* Smaller copies cannot use even one 64-byte non-temporal block */
+    gasneti_pshm_ntcopy_threshold = MAX(gasneti_pshm_ntcopy_threshold, 64);
+  }
+#endif
+
+  gasneti_pshm_waithook_init();
+
   /* Ensure all peers are initialized before return */
   gasneti_pshmnet_bootstrapBarrier();
+  gasneti_pshm_numa_dump_placement();
 
   /* Return the conduit's portion, if any */
   return aux_sz ? (void*)((uintptr_t)gasnetc_pshmnet_region +
@@ -326,6 +649,7 @@ typedef struct {
   gasneti_AMPSHM_msg_t msg;
   uint32_t numbytes;
   void *   longdata;
+  void *   longsrc; /* non-NULL if receiver must copy from sender's segment */
 } gasneti_AMPSHM_longmsg_t;
 
 typedef union {
@@ -403,9 +727,33 @@ typedef struct gasneti_pshmnet_queue {
                              + sizeof(gasneti_atomic_val_t))];
   /* Consumers' cache line: */
   volatile gasneti_atomic_val_t shead; /* shadow head */
-  char _pad1[GASNETI_CACHE_PAD(sizeof(gasneti_atomic_val_t))];
+  gasneti_atomic_val_t stail; /* shadow tail: end of a detached run, if any */
+  char _pad1[GASNETI_CACHE_PAD(2*sizeof(gasneti_atomic_val_t))];
 } gasneti_pshmnet_queue_t;
 
+/* Alternative to the queue above: one single-producer/single-consumer ring
+ * per (sender, receiver) pair, selected by GASNET_PSHM_NETWORK_SPSC.
+ *
+ * Capacity is reserved by the sender at buffer allocation time (serialized
+ * by the caller), but a slot index is only assigned
+ * at delivery, under a lock held just long enough to fill the slot.  Slots
+ * are thus filled in index order, and a sender stalled between allocation
+ * and delivery cannot hold up messages delivered by other threads.  The
+ * receiver consumes slots strictly in order, clearing each one before
+ * publishing the consumer index to the sender.  No atomic read-modify-write
+ * operations are used by either side.
+ *
+ * Each receiver also has a "summary" array of one flag byte per sender,
+ * which senders set after filling a slot, so the receiver need only scan
+ * the flags (a word at a time) rather than every ring.
+ */
+#define GASNETI_PSHMNET_RING_SLOTS 64 /* must be a power of two */
+typedef struct gasneti_pshmnet_ring {
+  volatile gasneti_atomic_val_t cons; /* written only by the receiver */
+  char _pad0[GASNETI_CACHE_PAD(sizeof(gasneti_atomic_val_t))];
+  volatile gasneti_atomic_val_t slot[GASNETI_PSHMNET_RING_SLOTS];
+} gasneti_pshmnet_ring_t;
+
 struct gasneti_pshmnet_allocator;  /* forward definition */
 
 /* message payload metadata */
@@ -441,7 +789,6 @@ typedef struct {
 
 #define GASNETI_PSHMNET_ALLOC_MAXSZ \
     round_up_to_pshmpage(sizeof(gasneti_pshmnet_allocator_block_t))
-#define GASNETI_PSHMNET_ALLOC_MAXPG (GASNETI_PSHMNET_ALLOC_MAXSZ >> GASNETI_PSHMNET_PAGESHIFT)
 
 #define GASNETI_PSHMNET_MAX_PAYLOAD \
     (GASNETI_PSHMNET_ALLOC_MAXSZ - offsetof(gasneti_pshmnet_allocator_block_t, payload.data))
@@ -450,20 +797,54 @@ size_t gasneti_pshmnet_max_payload(void) {
   return GASNETI_PSHMNET_MAX_PAYLOAD;
 }
 
-/* This implementation uses a circular queue of variable-sized payloads.
- * This data structure lives entirely in private memory.
+/* This implementation uses a set of size classes, each of which is a ring
+ * of fixed-size blocks carved from the region at initialization time.
+ * The ring metadata lives entirely in private memory, while the per-block
+ * 'in_use' flag lives in the (shared) block header so that the receiver can
+ * free a block without touching the sender's allocator.
+ *
+ * Allocation scans the ring of the smallest class which fits the request,
+ * starting from where the last allocation in that class succeeded, and
+ * "spills" into larger classes only once every block of the class is in use.
+ * Thus it returns NULL only when no block large enough is free.  In the common
+ * case the first block probed is free, since blocks are freed roughly in the
+ * order they were allocated.  Free is a single store.
  *
- * The allocator's per-block metadata is external to the blocks, and is
- * stored in the "length" array.  There is a length entry for each "page",
- * but only the entries corresponding to the first page of each block have
- * defined values.  The "length[]", "next" and "count" are all in units
- * of GASNETI_PSHMNET_PAGESIZE (which must be a power-of-2).
+ * Blocks are claimed by compare-and-swap on 'in_use', and the per-class
+ * starting point is only a hint, so concurrent allocations from one allocator
+ * need no lock.  (AMPSHM still serializes its senders, so that small messages
+ * cannot starve large ones.)  Platforms without an atomic compare-and-swap
+ * fall back to a plain store, and there the callers must serialize.
+ *
+ * The largest class always holds gasneti_pshmnet_network_depth blocks of
+ * GASNETI_PSHMNET_ALLOC_MAXSZ, which preserves the "network depth" guarantee
+ * for messages of any size.  The smaller classes equally divide an additional
+ * 1/GASNETI_PSHMNET_ALLOC_SMALL_RATIO of that space.
  */
+#define GASNETI_PSHMNET_ALLOC_MINSHIFT    8 /* smallest class is 256 bytes */
+#define GASNETI_PSHMNET_ALLOC_CLASSSHIFT  2 /* each class is 4 times the previous */
+#define GASNETI_PSHMNET_ALLOC_MAXCLASSES  8
+#define GASNETI_PSHMNET_ALLOC_SMALL_RATIO 4
+
+typedef struct {
+  uintptr_t base;
+  size_t size;          /* block size in bytes (multiple of cache line) */
+  unsigned int count;   /* number of blocks in the ring */
+  gasneti_weakatomic_t next; /* hint: next block to probe */
+} gasneti_pshmnet_sizeclass_t;
+
+#if defined(GASNETI_HAVE_ATOMIC_CAS)
+  #define gasneti_pshmnet_block_claim(_b) \
+          gasneti_atomic_compare_and_swap(&(_b)->in_use, 0, 1, GASNETI_ATOMIC_ACQ)
+#else
+  #define gasneti_pshmnet_block_claim(_b) \
+          (gasneti_atomic_set(&(_b)->in_use, 1, 0), 1)
+#endif
+
 typedef struct gasneti_pshmnet_allocator {
   void *region;
-  unsigned int next;
-  unsigned int count;
-  unsigned int length[1]; /* Variable length */
+  int num_classes;
+  gasneti_pshmnet_sizeclass_t sizeclass[GASNETI_PSHMNET_ALLOC_MAXCLASSES];
 } gasneti_pshmnet_allocator_t;
 
 /* WARNING: the amount requested from this allocator must be less than 
@@ -486,18 +867,40 @@ static void gasneti_pshmnet_free(gasneti_pshmnet_payload_t *p);
 struct gasneti_pshmnet {
   gasneti_pshm_rank_t nodecount;    /* nodes in supernode */
   gasneti_pshmnet_queue_t *queues;  /* array of queue heads */
+  size_t queue_stride;              /* distance between nodes' queue heads */
   gasneti_pshmnet_queue_t *my_queue;
   /* only need to see one's own allocator */
   gasneti_pshmnet_allocator_t *my_allocator;
+  /* state for SPSC mode (NULL spsc_base otherwise) */
+  uintptr_t spsc_base;              /* flags and rings of node 0 */
+  size_t spsc_stride;               /* distance between nodes' flags and rings */
+  gasneti_atomic_val_t *spsc_prod;  /* private: slots reserved, by target */
+  gasneti_atomic_val_t *spsc_fill;  /* private: next slot to fill, by target */
+  gasneti_pshm_rank_t spsc_next;    /* sender to scan first */
 #if GASNET_PAR || GASNETI_CONDUIT_THREADS
   /* serializes dequeue operations */
   gasneti_mutex_t lock;
+  /* serializes assignment and filling of SPSC slots */
+  gasneti_mutex_t spsc_lock;
 #endif
 };
 
 #define gasneti_assert_align(p, align) \
         gasneti_assert((((uintptr_t)p) % align) == 0)
 
+#define gasneti_pshmnet_queue(vnet, node) \
+        ((gasneti_pshmnet_queue_t *)((uintptr_t)(vnet)->queues + (node) * (vnet)->queue_stride))
+
+/* Summary flags and rings in SPSC mode, by receiver and sender */
+#define GASNETI_PSHMNET_SPSC_FLAGSZ(nodes) \
+        GASNETI_ALIGNUP((nodes), GASNETI_CACHE_LINE_BYTES)
+#define gasneti_pshmnet_spsc_flags(vnet, recvr) \
+        ((volatile uint8_t *)((vnet)->spsc_base + (recvr) * (vnet)->spsc_stride))
+#define gasneti_pshmnet_spsc_ring(vnet, recvr, sender) \
+        ((gasneti_pshmnet_ring_t *)((vnet)->spsc_base + (recvr) * (vnet)->spsc_stride \
+                                    + GASNETI_PSHMNET_SPSC_FLAGSZ((vnet)->nodecount)) \
+         + (sender))
+
 /* Macros for determining the offset and the real address, used for
  * the addresses inside the pshmnet region */
 #define gasneti_pshm_offset(addr) \
@@ -536,7 +939,9 @@ static uintptr_t get_queue_mem(int nodes)
     gasneti_pshmnet_network_depth = GASNETI_PSHM_NETWORK_DEPTH_MAX;
   }
 
+  /* Largest size class, plus space for the smaller ones */
   pernode = GASNETI_PSHMNET_ALLOC_MAXSZ * gasneti_pshmnet_network_depth;
+  pernode += pernode / GASNETI_PSHMNET_ALLOC_SMALL_RATIO;
   gasneti_assert(pernode > 0);
 
   /* round up to multiple of allocator page size */
@@ -552,10 +957,42 @@ static size_t gasneti_pshmnet_memory_needed_pernode(gasneti_pshm_rank_t nodes)
   return round_up_to_pshmpage(gasneti_pshmnet_queue_mem);
 }
 
+static int gasneti_pshmnet_use_spsc(void)
+{
+  static int spsc = -1;
+  if_pf (spsc < 0) {
+    spsc = gasneti_getenv_yesno_withdefault("GASNET_PSHM_NETWORK_SPSC", 0);
+  }
+  return spsc;
+}
+
+/* Each node's queue head (and SPSC rings) on separate pages if they are NUMA-placed */
+static size_t gasneti_pshmnet_queue_stride(void)
+{
+  const size_t sz = sizeof(gasneti_pshmnet_queue_t);
+  return gasneti_pshm_numa_enabled() ? round_up_to_pshmpage(sz) : sz;
+}
+
+static size_t gasneti_pshmnet_queues_len(gasneti_pshm_rank_t nodes)
+{
+  return GASNETI_ALIGNUP(nodes * gasneti_pshmnet_queue_stride(), GASNETI_CACHE_LINE_BYTES);
+}
+
+static size_t gasneti_pshmnet_spsc_stride(gasneti_pshm_rank_t nodes)
+{
+  const size_t sz = GASNETI_PSHMNET_SPSC_FLAGSZ(nodes) + nodes * sizeof(gasneti_pshmnet_ring_t);
+  return gasneti_pshm_numa_enabled() ? round_up_to_pshmpage(sz) : sz;
+}
+
 static size_t gasneti_pshmnet_memory_needed_once(gasneti_pshm_rank_t nodes)
 {
   /* Space for the queue headers */
-  return round_up_to_pshmpage(nodes * sizeof(gasneti_pshmnet_queue_t));
+  size_t once = gasneti_pshmnet_queues_len(nodes);
+  /* Space for the summary flags and (nodes x nodes) rings, if any */
+  if (gasneti_pshmnet_use_spsc()) {
+    once += nodes * gasneti_pshmnet_spsc_stride(nodes);
+  }
+  return round_up_to_pshmpage(once);
 }
 
 size_t gasneti_pshmnet_memory_needed(gasneti_pshm_rank_t nodes)
@@ -604,36 +1041,84 @@ gasneti_pshmnet_init(void *region, size_t regionlen, gasneti_pshm_rank_t pshmnod
   vnet->nodecount = pshmnodes;
 #if GASNET_PAR || GASNETI_CONDUIT_THREADS
   gasneti_mutex_init(&vnet->lock);
+  gasneti_mutex_init(&vnet->spsc_lock);
 #endif
 
-  /* initialize my own allocator */
   myregion = (void *)((uintptr_t)region + (szpernode * gasneti_pshm_mynode));
   gasneti_assert_align(myregion, GASNETI_PSHMNET_PAGESIZE);
+  vnet->queues = (gasneti_pshmnet_queue_t*)((uintptr_t)region + szpernode * pshmnodes);
+  gasneti_assert_align(vnet->queues, GASNETI_PSHMNET_PAGESIZE);
+  vnet->queue_stride = gasneti_pshmnet_queue_stride();
+  vnet->my_queue = gasneti_pshmnet_queue(vnet, gasneti_pshm_mynode);
+
+  /* place my own memory before first touch */
+  if (gasneti_pshm_numa_enabled()) {
+    gasneti_pshm_numa_place("AM payload region", myregion, szpernode);
+    gasneti_pshm_numa_place("AM queue", vnet->my_queue, vnet->queue_stride);
+    if (gasneti_pshmnet_use_spsc()) {
+      gasneti_pshm_numa_place("AM rings",
+                              (void *)((uintptr_t)vnet->queues + gasneti_pshmnet_queues_len(pshmnodes)
+                                       + gasneti_pshm_mynode * gasneti_pshmnet_spsc_stride(pshmnodes)),
+                              gasneti_pshmnet_spsc_stride(pshmnodes));
+    }
+  }
+
+  /* initialize my own allocator */
   vnet->my_allocator = gasneti_pshmnet_init_allocator(myregion, gasneti_pshmnet_queue_mem);
 
   /* initialize my own queue header */
-  vnet->queues = (gasneti_pshmnet_queue_t*)((uintptr_t)region + szpernode * pshmnodes);
-  gasneti_assert_align(vnet->queues, GASNETI_PSHMNET_PAGESIZE);
-  vnet->my_queue = &vnet->queues[gasneti_pshm_mynode];
   vnet->my_queue->head = 0;
   vnet->my_queue->shead = 0;
+  vnet->my_queue->stail = 0;
   gasneti_pshmnet_tail_init(&vnet->my_queue->tail);
 
+  /* initialize my own flags and rings (as receiver), and private producer state */
+  if (gasneti_pshmnet_use_spsc()) {
+    gasneti_pshm_rank_t i;
+    vnet->spsc_base = (uintptr_t)vnet->queues + gasneti_pshmnet_queues_len(pshmnodes);
+    vnet->spsc_stride = gasneti_pshmnet_spsc_stride(pshmnodes);
+    gasneti_assert_align(vnet->spsc_base, GASNETI_CACHE_LINE_BYTES);
+    gasneti_assert_align(vnet->spsc_stride, GASNETI_CACHE_LINE_BYTES);
+    memset((void *)gasneti_pshmnet_spsc_flags(vnet, gasneti_pshm_mynode), 0, vnet->spsc_stride);
+    vnet->spsc_prod = gasneti_calloc(2 * pshmnodes, sizeof(gasneti_atomic_val_t));
+    vnet->spsc_fill = vnet->spsc_prod + pshmnodes;
+    gasneti_leak(vnet->spsc_prod);
+    for (i = 0; i < pshmnodes; ++i) {
+      gasneti_assert(!gasneti_pshmnet_spsc_ring(vnet, gasneti_pshm_mynode, i)->cons);
+    }
+  } else {
+    vnet->spsc_base = 0;
+    vnet->spsc_prod = NULL;
+    vnet->spsc_fill = NULL;
+  }
+  vnet->spsc_next = 0;
+
   gasneti_leak(vnet);
   return vnet;
 }
 
 
 void * gasneti_pshmnet_get_send_buffer(gasneti_pshmnet_t *vnet, size_t nbytes, 
-                                       gasneti_pshm_rank_t target /* currently unused */)
+                                       gasneti_pshm_rank_t target)
 {
   gasneti_pshmnet_payload_t *p;
   void *retval = NULL;
   
   gasneti_assert(nbytes <= GASNETI_PSHMNET_MAX_PAYLOAD);
 
+  if (vnet->spsc_base) {
+    /* Must be able to reserve a slot in the ring to the target */
+    const gasneti_pshmnet_ring_t *ring =
+            gasneti_pshmnet_spsc_ring(vnet, target, gasneti_pshm_mynode);
+    if (vnet->spsc_prod[target] - ring->cons >= GASNETI_PSHMNET_RING_SLOTS) {
+      return NULL;
+    }
+  }
+
   p = gasneti_pshmnet_alloc(vnet->my_allocator, nbytes);
   if (p != NULL) {
+    /* In SPSC mode, reserve a slot to be assigned at delivery */
+    if (vnet->spsc_base) vnet->spsc_prod[target]++;
     p->next = 0;
     p->from = gasneti_pshm_mynode;
     p->allocator = vnet->my_allocator;
@@ -648,12 +1133,33 @@ void gasneti_pshmnet_deliver_send_buffer(gasneti_pshmnet_t *vnet, void *buf,
 {
   gasneti_pshmnet_payload_t *p =
           pshmnet_get_struct_addr_from_field_addr(gasneti_pshmnet_payload_t, data, buf);
-  gasneti_pshmnet_queue_t *q = &vnet->queues[target];
+  gasneti_pshmnet_queue_t *q = gasneti_pshmnet_queue(vnet, target);
   gasneti_atomic_val_t my_offset = gasneti_pshm_offset(p);
   gasneti_atomic_val_t prev_offset;
 
   p->len = nbytes;
 
+  if (vnet->spsc_base) {
+    gasneti_pshmnet_ring_t *ring =
+            gasneti_pshmnet_spsc_ring(vnet, target, gasneti_pshm_mynode);
+    gasneti_atomic_val_t idx;
+    gasneti_local_wmb(); /* payload before slot */
+  #if GASNET_PAR || GASNETI_CONDUIT_THREADS
+    gasneti_mutex_lock(&vnet->spsc_lock);
+  #endif
+    /* Cannot overrun the consumer: every fill was preceded by a reservation */
+    idx = vnet->spsc_fill[target]++;
+    gasneti_assert(idx - ring->cons < GASNETI_PSHMNET_RING_SLOTS);
+    ring->slot[idx & (GASNETI_PSHMNET_RING_SLOTS - 1)] = my_offset;
+  #if GASNET_PAR || GASNETI_CONDUIT_THREADS
+    gasneti_mutex_unlock(&vnet->spsc_lock);
+  #endif
+    gasneti_local_wmb(); /* slot before flag */
+    gasneti_pshmnet_spsc_flags(vnet, target)[gasneti_pshm_mynode] = 1;
+    gasneti_pshm_wakeup_rank(target);
+    return;
+  }
+
   /* Nemesis enqueue: */
   prev_offset = gasneti_pshmnet_tail_swap(&q->tail, my_offset);
   if (prev_offset) {
@@ -662,6 +1168,7 @@ void gasneti_pshmnet_deliver_send_buffer(gasneti_pshmnet_t *vnet, void *buf,
   } else {
     q->head = my_offset;
   }
+  gasneti_pshm_wakeup_rank(target);
 }
 
 GASNETI_INLINE(gasneti_pshmnet_queue_peek)
@@ -670,6 +1177,72 @@ int gasneti_pshmnet_queue_peek(const gasneti_pshmnet_queue_t * const q)
   return q->shead || q->head;
 }
 
+/* Returns non-zero if any summary flag is set, scanning a word at a time */
+GASNETI_INLINE(gasneti_pshmnet_spsc_peek)
+int gasneti_pshmnet_spsc_peek(gasneti_pshmnet_t *vnet)
+{
+  const volatile uint64_t *flags =
+          (const volatile uint64_t *)gasneti_pshmnet_spsc_flags(vnet, gasneti_pshm_mynode);
+  const size_t words = GASNETI_PSHMNET_SPSC_FLAGSZ(vnet->nodecount) / sizeof(uint64_t);
+  size_t i;
+  for (i = 0; i < words; ++i) {
+    if (flags[i]) return 1;
+  }
+  return 0;
+}
+
+GASNETI_INLINE(gasneti_pshmnet_peek)
+int gasneti_pshmnet_peek(gasneti_pshmnet_t *vnet)
+{
+  return vnet->spsc_base ? gasneti_pshmnet_spsc_peek(vnet)
+                         : gasneti_pshmnet_queue_peek(vnet->my_queue);
+}
+
+/* Dequeue up to 'max' messages from the SPSC rings, starting with the
+ * sender following the one most recently drained.
+ * Caller is responsible for serialization.
+ */
+static int gasneti_pshmnet_spsc_recv(gasneti_pshmnet_t *vnet, int max, void *bufs[])
+{
+  volatile uint8_t *flags = gasneti_pshmnet_spsc_flags(vnet, gasneti_pshm_mynode);
+  const gasneti_pshm_rank_t nodes = vnet->nodecount;
+  gasneti_pshm_rank_t sender = vnet->spsc_next;
+  gasneti_pshm_rank_t i;
+  int count = 0;
+
+  for (i = 0; i < nodes; ++i, sender = (sender + 1 == nodes) ? 0 : sender + 1) {
+    gasneti_pshmnet_ring_t *ring;
+    gasneti_atomic_val_t cons;
+
+    if (!flags[sender]) continue;
+
+    ring = gasneti_pshmnet_spsc_ring(vnet, gasneti_pshm_mynode, sender);
+    cons = ring->cons;
+    do {
+      volatile gasneti_atomic_val_t *slot = &ring->slot[cons & (GASNETI_PSHMNET_RING_SLOTS - 1)];
+      gasneti_atomic_val_t offset = *slot;
+      if (!offset) {
+        /* Ring appears empty: clear flag and recheck to avoid a lost wakeup */
+        flags[sender] = 0;
+        gasneti_local_mb();
+        if (!(offset = *slot)) break;
+        flags[sender] = 1;
+      }
+      gasneti_local_rmb(); /* ACQ */
+      bufs[count++] = &((gasneti_pshmnet_payload_t *)gasneti_pshm_addr(offset))->data;
+      *slot = 0;
+      ++cons;
+    } while (count < max);
+    gasneti_local_wmb(); /* clear slots before publishing consumer index */
+    ring->cons = cons;
+
+    if (count == max) break;
+  }
+  vnet->spsc_next = sender;
+
+  return count;
+}
+
 int gasneti_pshmnet_recv(gasneti_pshmnet_t *vnet, void **pbuf, size_t *psize, 
                          gasneti_pshm_rank_t *pfrom)
 {
@@ -677,6 +1250,27 @@ int gasneti_pshmnet_recv(gasneti_pshmnet_t *vnet, void **pbuf, size_t *psize,
   gasneti_pshmnet_payload_t *p = NULL;
   gasneti_pshmnet_queue_t *q = vnet->my_queue;
 
+  if (vnet->spsc_base) {
+    void *buf;
+    int count = 0;
+    if (gasneti_pshmnet_spsc_peek(vnet)) {
+    #if GASNET_PAR || GASNETI_CONDUIT_THREADS
+      gasneti_mutex_lock(&vnet->lock);
+    #endif
+      count = gasneti_pshmnet_spsc_recv(vnet, 1, &buf);
+    #if GASNET_PAR || GASNETI_CONDUIT_THREADS
+      gasneti_mutex_unlock(&vnet->lock);
+    #endif
+    }
+    if (count) {
+      p = pshmnet_get_struct_addr_from_field_addr(gasneti_pshmnet_payload_t, data, buf);
+      *pbuf  = buf;
+      *psize = p->len;
+      *pfrom = p->from;
+    }
+    return !count;
+  }
+
 #if GASNET_PAR || GASNETI_CONDUIT_THREADS
   if (gasneti_pshmnet_queue_peek(q)) {
     gasneti_mutex_lock(&vnet->lock);
@@ -691,14 +1285,19 @@ int gasneti_pshmnet_recv(gasneti_pshmnet_t *vnet, void **pbuf, size_t *psize,
       register gasneti_atomic_val_t next;
       p = gasneti_pshm_addr(head);
       gasneti_local_rmb(); /* ACQ */
-      /* NOTE: Unlike in the Nemesis paper, we loop on *both* p->next and
-       * cas(tail) to allow weaker memory models which may reorder their
-       * respective reads/writes.  This is preferred over adding any memory
-       * fence(s) to the race-free case.
-       */
-      while (GASNETT_PREDICT_FALSE(0 == (next = p->next)) &&
-             GASNETT_PREDICT_FALSE(!gasneti_pshmnet_tail_cas(&q->tail, head, 0))) {
-        GASNETI_WAITHOOK(); /* waituntil() has excess RMB */
+      if_pf (head == q->stail) {
+        /* Last entry of a run detached by gasneti_pshmnet_recv_batch() */
+        next = q->stail = 0;
+      } else {
+        /* NOTE: Unlike in the Nemesis paper, we loop on *both* p->next and
+         * cas(tail) to allow weaker memory models which may reorder their
+         * respective reads/writes.  This is preferred over adding any memory
+         * fence(s) to the race-free case.
+         */
+        while (GASNETT_PREDICT_FALSE(0 == (next = p->next)) &&
+               GASNETT_PREDICT_FALSE(!gasneti_pshmnet_tail_cas(&q->tail, head, 0))) {
+          GASNETI_WAITHOOK(); /* waituntil() has excess RMB */
+        }
       }
       q->shead = next;
     }
@@ -717,6 +1316,59 @@ int gasneti_pshmnet_recv(gasneti_pshmnet_t *vnet, void **pbuf, size_t *psize,
 }
 
 
+int gasneti_pshmnet_recv_batch(gasneti_pshmnet_t *vnet, int max, void *bufs[])
+{
+  gasneti_pshmnet_queue_t *q = vnet->my_queue;
+  int count = 0;
+
+  gasneti_assert(max > 0);
+
+  if (!gasneti_pshmnet_peek(vnet)) return 0;
+
+#if GASNET_PAR || GASNETI_CONDUIT_THREADS
+  gasneti_mutex_lock(&vnet->lock);
+#endif
+  if (vnet->spsc_base) {
+    count = gasneti_pshmnet_spsc_recv(vnet, max, bufs);
+  } else {
+    gasneti_atomic_val_t head = q->shead;
+    if (!head && q->head) {
+      head = q->head;
+      q->head = 0;
+    }
+    if_pt (head) {
+      /* Detach the entire run of ready descriptors with a single swap of the
+       * tail.  Every entry other than the old tail either has its 'next' set
+       * or has a producer (also within the run) about to set it.
+       * Producers arriving after the swap start a new run via q->head.
+       */
+      if (!q->stail) {
+        q->stail = gasneti_pshmnet_tail_swap(&q->tail, 0);
+        gasneti_assert(q->stail);
+      }
+      do {
+        gasneti_pshmnet_payload_t *p = gasneti_pshm_addr(head);
+        gasneti_local_rmb(); /* ACQ */
+        bufs[count++] = &p->data;
+        if (head == q->stail) {
+          head = q->stail = 0;
+          break;
+        }
+        while (GASNETT_PREDICT_FALSE(0 == (head = p->next))) {
+          GASNETI_WAITHOOK(); /* waituntil() has excess RMB */
+        }
+      } while (count < max);
+    }
+    /* Unconsumed remainder (if any) of the run stays on the shadow head */
+    q->shead = head;
+  }
+#if GASNET_PAR || GASNETI_CONDUIT_THREADS
+  gasneti_mutex_unlock(&vnet->lock);
+#endif
+
+  return count;
+}
+
 /* Note the current behavior if a user forgets to call this function is
  * NASTY--the message stays marked as state==BUSY, which will cause
  * senders to think the queue is full.  This could cause
@@ -752,12 +1404,13 @@ void gasneti_pshmnet_bootstrapBarrier(void)
   if (gasneti_atomic_decrement_and_test(&gasneti_pshm_info->bootstrap_barrier_cnt, 0)) {
     gasneti_atomic_set(&gasneti_pshm_info->bootstrap_barrier_cnt, gasneti_pshm_nodes, 0);
     gasneti_atomic_increment(&gasneti_pshm_info->bootstrap_barrier_gen, GASNETI_ATOMIC_REL);
+    gasneti_pshm_wakeup_all();
   }
 
   target = generation + 1;
   gasneti_assert_always(target < GASNETI_PSHM_BSB_LIMIT); /* Die if we were ever to reach the limit */
 
-  gasneti_waitwhile((curr = gasneti_atomic_read(&gasneti_pshm_info->bootstrap_barrier_gen, 0)) < target);
+  gasneti_pshm_waitwhile((curr = gasneti_atomic_read(&gasneti_pshm_info->bootstrap_barrier_gen, 0)) < target);
   if_pf (curr >= GASNETI_PSHM_BSB_LIMIT) {
     if (gasnetc_pshm_abort_callback) gasnetc_pshm_abort_callback();
     gasnet_exit(1);
@@ -814,6 +1467,7 @@ static void gasneti_pshm_abort_handler(int sig) {
 
   // Force others to exit from barrier:
   gasneti_atomic_set(&gasneti_pshm_info->bootstrap_barrier_gen, GASNETI_PSHM_BSB_LIMIT, 0);
+  gasneti_pshm_wakeup_all();
 
   // Best-effort message if this is not due to gasneti_fatalerror()
   if (sig != SIGABRT) {
@@ -1017,97 +1671,111 @@ void gasneti_pshmnet_bootstrapGather(gasneti_pshmnet_t *vnet, void *src,
 
 static gasneti_pshmnet_allocator_t *gasneti_pshmnet_init_allocator(void *region, size_t len)
 {
-  int count = len >> GASNETI_PSHMNET_PAGESHIFT;
-  gasneti_pshmnet_allocator_block_t *tmp;
+  const size_t large_len = GASNETI_PSHMNET_ALLOC_MAXSZ * gasneti_pshmnet_network_depth;
+  uintptr_t addr = (uintptr_t)region;
+  size_t small_len, size;
+  int i, small_classes = 0;
 
   /* This implementation doesn't need to put allocator within shared memory.
    * If a later one does, consider increasing the size returned by
    * get_queue_mem()
    */
-  gasneti_pshmnet_allocator_t *a = gasneti_malloc(sizeof(gasneti_pshmnet_allocator_t) +
-                                                  (count-1) * sizeof(unsigned int));
+  gasneti_pshmnet_allocator_t *a = gasneti_calloc(1, sizeof(gasneti_pshmnet_allocator_t));
   gasneti_leak(a);
 
   /* make sure we've arranged for page alignment */
   gasneti_assert_align(GASNETI_PSHMNET_ALLOC_MAXSZ, GASNETI_PSHMNET_PAGESIZE);
   gasneti_assert_align(region, GASNETI_PSHMNET_PAGESIZE);
+  gasneti_assert(len >= large_len);
 
-  /* Initial state is one large free block */
-  a->next = 0;
-  a->count = count;
-  a->length[0] = count;
-  a->region = tmp = region;
-  gasneti_atomic_set(&tmp->in_use, 0, 0);
+  /* Count the small classes: each strictly smaller than the largest */
+  for (size = (size_t)1 << GASNETI_PSHMNET_ALLOC_MINSHIFT;
+       size < GASNETI_PSHMNET_ALLOC_MAXSZ;
+       size <<= GASNETI_PSHMNET_ALLOC_CLASSSHIFT) {
+    ++small_classes;
+  }
+  gasneti_assert(small_classes < GASNETI_PSHMNET_ALLOC_MAXCLASSES);
+  gasneti_assert((1 << GASNETI_PSHMNET_ALLOC_MINSHIFT) >=
+                 offsetof(gasneti_pshmnet_allocator_block_t, payload.data) +
+                 sizeof(gasneti_AMPSHM_shortmsg_t));
+
+  /* Lay out the largest class first, since it is page-aligned */
+  a->region = region;
+  a->num_classes = small_classes + 1;
+  a->sizeclass[small_classes].base = addr;
+  a->sizeclass[small_classes].size = GASNETI_PSHMNET_ALLOC_MAXSZ;
+  a->sizeclass[small_classes].count = gasneti_pshmnet_network_depth;
+  addr += large_len;
+
+  /* Smaller classes split the remainder equally.  A class whose size exceeds its
+     share gets no blocks, and allocations in that class spill upward. */
+  small_len = (len - large_len) / (small_classes ? small_classes : 1);
+  for (i = 0, size = (size_t)1 << GASNETI_PSHMNET_ALLOC_MINSHIFT;
+       i < small_classes;
+       ++i, size <<= GASNETI_PSHMNET_ALLOC_CLASSSHIFT) {
+    gasneti_pshmnet_sizeclass_t *sc = &a->sizeclass[i];
+    gasneti_assert_align(size, GASNETI_CACHE_LINE_BYTES);
+    sc->base = addr;
+    sc->size = size;
+    sc->count = small_len / size;
+    addr += sc->count * size;
+  }
+  gasneti_assert(addr <= (uintptr_t)region + len);
+
+  /* Initial state is all blocks free */
+  for (i = 0; i < a->num_classes; ++i) {
+    gasneti_pshmnet_sizeclass_t *sc = &a->sizeclass[i];
+    unsigned int j;
+    gasneti_weakatomic_set(&sc->next, 0, 0);
+    for (j = 0; j < sc->count; ++j) {
+      gasneti_pshmnet_allocator_block_t *block =
+              (gasneti_pshmnet_allocator_block_t *)(sc->base + j * sc->size);
+      gasneti_atomic_set(&block->in_use, 0, 0);
+    }
+  }
 
   return a;
 }
 
 
-/* Basic page-granular first-fit allocator
-   This allocator is NOT thread-safe - the callers are responsible for serialization. */
+/* Size-class ring allocator
+   Lock-free where atomic compare-and-swap is available (see above). */
 static gasneti_pshmnet_payload_t *
 gasneti_pshmnet_alloc(gasneti_pshmnet_allocator_t *a, size_t nbytes)
 {
-  void *retval = NULL;
-  unsigned int curr;
-  unsigned int needed;
-  int remain;
-  void *region = a->region;
+  int c;
 
   nbytes += offsetof(gasneti_pshmnet_allocator_block_t, payload.data);
   gasneti_assert(nbytes <= GASNETI_PSHMNET_ALLOC_MAXSZ);
 
-  needed = (nbytes + GASNETI_PSHMNET_PAGESIZE - 1) >> GASNETI_PSHMNET_PAGESHIFT;
-  gasneti_assert(needed <= GASNETI_PSHMNET_ALLOC_MAXPG);
-
-  curr = a->next;
-  remain = a->count;
-  do {
-    unsigned int length = a->length[curr];
-    gasneti_pshmnet_allocator_block_t *next_block;
-    gasneti_pshmnet_allocator_block_t * const block = 
-            (gasneti_pshmnet_allocator_block_t*)
-                      ((uintptr_t)region + (curr << GASNETI_PSHMNET_PAGESHIFT));
-
-    if (!gasneti_atomic_read(&block->in_use, GASNETI_ATOMIC_ACQ)) {
-      while (length < needed) {
-        unsigned int next = curr + length;
-        gasneti_assert (next <= a->count);
-        if (next == a->count) break; /* hit end of region */
-        next_block = (gasneti_pshmnet_allocator_block_t*)
-                     ((uintptr_t)block + (length << GASNETI_PSHMNET_PAGESHIFT));
-        if (gasneti_atomic_read(&next_block->in_use, GASNETI_ATOMIC_ACQ)) break; /* hit busy block */
-        length += a->length[next];
-      }
-
-      if (length >= needed) {
-        unsigned int next = curr + needed;
-
-        if (length > needed) { /* Split it */
-          gasneti_assert (next < a->count);
-          a->length[next] = length - needed;
-          next_block = (gasneti_pshmnet_allocator_block_t*)
-                       ((uintptr_t)block + (needed << GASNETI_PSHMNET_PAGESHIFT));
-          gasneti_atomic_set(&next_block->in_use, 0, 0);
-        }
-
-        a->length[curr] = needed;
-        gasneti_atomic_set(&block->in_use, 1, 0);
-        retval = &block->payload;
+  /* Find the smallest class which fits */
+  for (c = 0; a->sizeclass[c].size < nbytes; ++c) {
+    gasneti_assert(c < a->num_classes - 1);
+  }
 
-        if ((curr =next) == a->count) curr = 0;
-        break; /* do {} while (remain); */
+  /* Scan each class in full before spilling upward */
+  for (; c < a->num_classes; ++c) {
+    gasneti_pshmnet_sizeclass_t * const sc = &a->sizeclass[c];
+    unsigned int curr = gasneti_weakatomic_read(&sc->next, 0);
+    unsigned int probe = sc->count;
+
+    if (curr >= sc->count) curr = 0; /* also covers count == 0 */
+    while (probe--) {
+      gasneti_pshmnet_allocator_block_t * const block =
+              (gasneti_pshmnet_allocator_block_t *)(sc->base + curr * sc->size);
+      if (++curr == sc->count) curr = 0;
+      if (!gasneti_atomic_read(&block->in_use, GASNETI_ATOMIC_ACQ) &&
+          gasneti_pshmnet_block_claim(block)) {
+        gasneti_weakatomic_set(&sc->next, curr, 0);
+        GASNETI_STAT_EVENT_VAL(I, PSHMNET_ALLOC, sc->size - nbytes);
+        return &block->payload;
       }
-
-      /* Assume write is cheaper than branching again when length is unchanged */
-      a->length[curr] = length;
     }
+    if (c + 1 < a->num_classes) GASNETI_STAT_EVENT(I, PSHMNET_ALLOC_SPILL);
+  }
 
-    remain -= length;
-    if ((curr += length) == a->count) curr = 0;
-  } while (remain > 0); /* could be negative if merging took us past our starting point */
-  a->next = curr;
-  return retval;
+  GASNETI_STAT_EVENT(I, PSHMNET_ALLOC_FAIL);
+  return NULL;
 }
 
 static void gasneti_pshmnet_free(gasneti_pshmnet_payload_t *p)
@@ -1117,8 +1785,8 @@ static void gasneti_pshmnet_free(gasneti_pshmnet_payload_t *p)
       pshmnet_get_struct_addr_from_field_addr(gasneti_pshmnet_allocator_block_t,
                                               payload, p);
   gasneti_assert(p == &block->payload);
-  /* assert block is page-aligned */
-  gasneti_assert( (((uintptr_t)block) % GASNETI_PSHMNET_PAGESIZE) == 0);
+  /* assert block is cache-line-aligned */
+  gasneti_assert( (((uintptr_t)block) % GASNETI_CACHE_LINE_BYTES) == 0);
 
   gasneti_atomic_set(&block->in_use, 0, GASNETI_ATOMIC_REL);
 }
@@ -1143,9 +1811,64 @@ static void gasneti_pshmnet_free(gasneti_pshmnet_payload_t *p)
                                                GASNETI_AMPSHM_MSG_MEDDATA_SHIFT)
 #define GASNETI_AMPSHM_MSG_LONG_NUMBYTES(msg) (((gasneti_AMPSHM_longmsg_t*)msg)->numbytes)
 #define GASNETI_AMPSHM_MSG_LONG_DATA(msg)     (((gasneti_AMPSHM_longmsg_t*)msg)->longdata)
+#define GASNETI_AMPSHM_MSG_LONG_SRC(msg)      (((gasneti_AMPSHM_longmsg_t*)msg)->longsrc)
+
+#if GASNETI_PSHM_HAVE_NTCOPY
+/* Copy using non-temporal stores, to avoid displacing the cache contents
+ * of both sender and receiver with a payload neither is likely to reuse soon.
+ * Includes the store fence needed to order these weakly-ordered stores.
+ */
+static void gasneti_AMPSHM_memcpy_nt(void *dst, const void *src, size_t nbytes)
+{
+  uintptr_t d = (uintptr_t)dst;
+  uintptr_t s = (uintptr_t)src;
+  size_t head = (16 - (d & 15)) & 15;
+
+  if_pf (nbytes < head + 64) {
+    memcpy(dst, src, nbytes);
+    return;
+  }
+
+  memcpy((void*)d, (void*)s, head);
+  d += head; s += head; nbytes -= head;
+
+  while (nbytes >= 64) {
+    __asm__ __volatile__ (
+        "movdqu      (%1), %%xmm0\n\t"
+        "movdqu    16(%1), %%xmm1\n\t"
+        "movdqu    32(%1), %%xmm2\n\t"
+        "movdqu    48(%1), %%xmm3\n\t"
+        "movntdq  %%xmm0,   (%0)\n\t"
+        "movntdq  %%xmm1, 16(%0)\n\t"
+        "movntdq  %%xmm2, 32(%0)\n\t"
+        "movntdq  %%xmm3, 48(%0)"
+        : : "r" (d), "r" (s) : "xmm0", "xmm1", "xmm2", "xmm3", "memory");
+    d += 64; s += 64; nbytes -= 64;
+  }
+  GASNETI_ASM("sfence");
+
+  memcpy((void*)d, (void*)s, nbytes);
+}
+#endif
+
+/* Copy of an AMLong payload, by either the sender or the receiver */
+GASNETI_INLINE(gasneti_AMPSHM_long_copy)
+void gasneti_AMPSHM_long_copy(void *dst, const void *src, size_t nbytes)
+{
+#if GASNETI_PSHM_HAVE_NTCOPY
+  if (gasneti_pshm_ntcopy_threshold && (nbytes >= gasneti_pshm_ntcopy_threshold)) {
+    gasneti_AMPSHM_memcpy_nt(dst, src, nbytes);
+    return;
+  }
+#endif
+  memcpy(dst, src, nbytes);
+}
 
-#define GASNETI_AMPSHM_MAX_REPLY_PER_POLL 10
-#define GASNETI_AMPSHM_MAX_REQUEST_PER_POLL 10
+/* Per-poll limits adapt to queue depth: a poll which leaves messages
+ * queued doubles the limit for the next poll, and one which drains the
+ * queue with room to spare halves it. */
+#define GASNETI_AMPSHM_MIN_PER_POLL 10
+#define GASNETI_AMPSHM_MAX_PER_POLL 80
 
 #ifndef GASNETC_ENTERING_HANDLER_HOOK
   /* extern void enterHook(int cat, int isReq, int handlerId, gasnet_token_t *token,
@@ -1160,12 +1883,9 @@ static void gasneti_pshmnet_free(gasneti_pshmnet_payload_t *p)
 #endif
 
 /* ------------------------------------------------------------------------------------ */
-GASNETI_INLINE(gasneti_AMPSHM_service_incoming_msg)
-int gasneti_AMPSHM_service_incoming_msg(gasneti_pshmnet_t *vnet, int isReq)
+GASNETI_INLINE(gasneti_AMPSHM_run_handler)
+void gasneti_AMPSHM_run_handler(void *msg, int isReq)
 {
-  void *msg;
-  size_t msgsz;
-  gasneti_pshm_rank_t from;
   int category;
   gasnetc_handler_t handler_id;
   gasneti_handler_fn_t handler_fn;
@@ -1173,11 +1893,6 @@ int gasneti_AMPSHM_service_incoming_msg(gasneti_pshmnet_t *vnet, int isReq)
   gasnet_handlerarg_t *args;
   gasnet_token_t token;
 
-  gasneti_assert(vnet != NULL);
-
-  if (gasneti_pshmnet_recv(vnet, &msg, &msgsz, &from))
-    return -1;
-
   token = gasnetc_token_create(GASNETI_AMPSHM_MSG_SOURCE(msg), isReq);
   category = GASNETI_AMPSHM_MSG_CATEGORY(msg);
   gasneti_assert((category == gasnetc_Short) || 
@@ -1208,6 +1923,11 @@ int gasneti_AMPSHM_service_incoming_msg(gasneti_pshmnet_t *vnet, int isReq)
       { 
         void * data = GASNETI_AMPSHM_MSG_LONG_DATA(msg);
         size_t nbytes = GASNETI_AMPSHM_MSG_LONG_NUMBYTES(msg);
+        void * src = GASNETI_AMPSHM_MSG_LONG_SRC(msg);
+        if (src) { /* Deferred copy: pull from sender's cross-mapped segment */
+          gasnet_node_t source = GASNETI_AMPSHM_MSG_SOURCE(msg);
+          gasneti_AMPSHM_long_copy(data, gasneti_pshm_addr2local(source, src), nbytes);
+        }
         GASNETC_ENTERING_HANDLER_HOOK(category,isReq,handler_id,token,data,nbytes,numargs,args);
         GASNETI_RUN_HANDLER_LONG(
             isReq,handler_id,handler_fn,token,args,numargs,data,nbytes);
@@ -1216,47 +1936,238 @@ int gasneti_AMPSHM_service_incoming_msg(gasneti_pshmnet_t *vnet, int isReq)
   }
   GASNETC_LEAVING_HANDLER_HOOK(category,isReq);
   gasnetc_token_destroy(token);
-  gasneti_pshmnet_recv_release(vnet, msg);
-  return 0;
+}
+
+/* Receive and run a batch of messages.  Each buffer is released as soon as
+ * its handler returns, rather than holding handled buffers (which senders
+ * may be waiting to reuse) until the end of the batch. */
+GASNETI_INLINE(gasneti_AMPSHM_service_incoming_msgs)
+void gasneti_AMPSHM_service_incoming_msgs(gasneti_pshmnet_t *vnet, int isReq)
+{
+  static int poll_limit[2] = { GASNETI_AMPSHM_MIN_PER_POLL, GASNETI_AMPSHM_MIN_PER_POLL };
+  void *msgs[GASNETI_AMPSHM_MAX_PER_POLL];
+  const int limit = poll_limit[isReq];
+  int i, count;
+
+  gasneti_assert(vnet != NULL);
+
+  count = gasneti_pshmnet_recv_batch(vnet, limit, msgs);
+  if (!count) return;
+  gasneti_pshm_waithook_reset();
+
+  for (i = 0; i < count - 1; ++i) {
+    GASNETI_PREFETCH_READ_HINT(msgs[i+1]);
+    gasneti_AMPSHM_run_handler(msgs[i], isReq);
+    gasneti_pshmnet_recv_release(vnet, msgs[i]);
+  }
+  gasneti_AMPSHM_run_handler(msgs[i], isReq);
+  gasneti_pshmnet_recv_release(vnet, msgs[i]);
+
+  /* Benign race in PAR mode: the limit is only a heuristic */
+  if (count == limit) {
+    if (gasneti_pshmnet_peek(vnet))
+      poll_limit[isReq] = MIN(2 * limit, GASNETI_AMPSHM_MAX_PER_POLL);
+  } else if (count < limit / 2) {
+    poll_limit[isReq] = MAX(limit / 2, GASNETI_AMPSHM_MIN_PER_POLL);
+  }
 }
 
 /* ------------------------------------------------------------------------------------ */
 int gasneti_AMPSHMPoll(int repliesOnly)
 {
-  int i = 0;
-
 #if 0
   /* We skip CHECKATTACH to allow "early" internal use by conduits. */
   GASNETI_CHECKATTACH();
 #endif
 
-  if (gasneti_pshmnet_queue_peek(gasneti_reply_pshmnet->my_queue)) {
-    for (i = 0; i < GASNETI_AMPSHM_MAX_REPLY_PER_POLL; i++) 
-      if (gasneti_AMPSHM_service_incoming_msg(gasneti_reply_pshmnet, 0))
-        break;
+  if (gasneti_pshmnet_peek(gasneti_reply_pshmnet)) {
+    gasneti_AMPSHM_service_incoming_msgs(gasneti_reply_pshmnet, 0);
   }
-  if (!repliesOnly && gasneti_pshmnet_queue_peek(gasneti_request_pshmnet->my_queue)) {
-    for (i = 0; i < GASNETI_AMPSHM_MAX_REQUEST_PER_POLL; i++) 
-      if (gasneti_AMPSHM_service_incoming_msg(gasneti_request_pshmnet, 1))
-        break;
+  if (!repliesOnly && gasneti_pshmnet_peek(gasneti_request_pshmnet)) {
+    gasneti_AMPSHM_service_incoming_msgs(gasneti_request_pshmnet, 1);
   }
   return GASNET_OK;
 }
 
+/* ------------------------------------------------------------------------------------ */
+/*
+ * Blocking waits
+ * ==============
+ * Under GASNET_WAIT_SPINBLOCK a waiting process first spins for a number of
+ * wait-loop iterations calibrated to last GASNET_PSHM_SPIN_USEC, and then sleeps
+ * on its futex word until a PSHM message is delivered to it.  The count is reset
+ * only by receipt of a message, not by the passage of time, so that preemption
+ * by co-scheduled processes does not keep an idle process from sleeping.
+ * Under GASNET_WAIT_BLOCK there is no spin phase.
+ * Since a waiter may also await events which do not send a message (e.g. direct
+ * shared-memory stores by peers, or another thread of this process), each sleep
+ * is bounded.  The bound starts small and doubles up to GASNET_PSHM_SLEEP_MAX_USEC
+ * for as long as sleeps end without a wakeup.
+ * These are heuristics, and the unsynchronized state is benign in PAR mode.
+ */
+static void gasneti_pshm_waithook_init(void) {
+#if GASNETI_PSHM_FUTEX
+  const uint64_t spin_us = gasneti_getenv_int_withdefault("GASNET_PSHM_SPIN_USEC", 100, 0);
+  const uint64_t sleep_us = gasneti_getenv_int_withdefault("GASNET_PSHM_SLEEP_MAX_USEC", 1000, 0);
+  const int calib_iters = 1000;
+  gasneti_tick_t start;
+  uint64_t ns;
+  int i;
+
+  /* Calibrate: time an idle wait-loop iteration (an empty poll) */
+  start = gasneti_ticks_now();
+  for (i = 0; i < calib_iters; ++i) {
+    (void)gasneti_pshmnet_peek(gasneti_reply_pshmnet);
+    (void)gasneti_pshmnet_peek(gasneti_request_pshmnet);
+    gasneti_compiler_fence();
+    gasneti_spinloop_hint();
+  }
+  ns = MAX(1, gasneti_ticks_to_ns(gasneti_ticks_now() - start));
+
+  gasneti_pshm_spin_iters = (spin_us * 1000 * calib_iters) / ns;
+  gasneti_pshm_sleep_max_ns = sleep_us * 1000;
+  GASNETI_TRACE_PRINTF(I, ("PSHM blocking wait: spin %"PRIu64" iterations, then sleep up to %"PRIu64" ns",
+                           gasneti_pshm_spin_iters, gasneti_pshm_sleep_max_ns));
+#endif
+}
+
+extern void gasneti_pshm_waithook(void) {
+#if GASNETI_PSHM_FUTEX
+  if_pf (!gasneti_pshm_wakeup || !gasneti_pshm_sleep_max_ns) {
+    gasneti_sched_yield(); /* not (yet) initialized, or disabled */
+    return;
+  }
+
+  if ((gasneti_wait_mode == GASNET_WAIT_SPINBLOCK) &&
+      (gasneti_pshm_idle_iters < gasneti_pshm_spin_iters)) {
+    ++gasneti_pshm_idle_iters;
+    return;
+  }
+
+  {
+    gasneti_pshm_wakeup_t * const w = &gasneti_pshm_wakeup[gasneti_pshm_mynode];
+    const uint32_t seq = w->w.seq;
+    const uint64_t ns = MIN(gasneti_pshm_sleep_ns, gasneti_pshm_sleep_max_ns);
+    struct timespec ts;
+
+    if_pf (!gasneti_atomic_read(&gasneti_pshm_info->sleepers_seen, 0)) {
+      gasneti_atomic_set(&gasneti_pshm_info->sleepers_seen, 1, GASNETI_ATOMIC_REL);
+    }
+    gasneti_atomic_increment(&w->w.sleeping, 0);
+    /* Order 'sleepers_seen' and 'sleeping' before our final check for messages.
+     * A sender fences between its message and its reads of both, so either we
+     * see its message or it sees us asleep. */
+    gasneti_local_mb();
+    if (!gasneti_pshmnet_peek(gasneti_reply_pshmnet) &&
+        !gasneti_pshmnet_peek(gasneti_request_pshmnet)) {
+      ts.tv_sec = ns / 1000000000;
+      ts.tv_nsec = ns % 1000000000;
+      (void)syscall(SYS_futex, &w->w.seq, FUTEX_WAIT, seq, &ts, NULL, 0);
+    }
+    gasneti_atomic_decrement(&w->w.sleeping, 0);
+
+    if (w->w.seq != seq) {
+      gasneti_pshm_waithook_reset(); /* woken: spin again before the next sleep */
+    } else {
+      gasneti_pshm_sleep_ns = 2 * ns;  /* timed out: sleep longer next time */
+    }
+  }
+#else
+  gasneti_sched_yield();
+#endif
+}
+
+/* Wake one or all sleeping processes in the supernode, for use when an event
+ * other than PSHM message delivery may end their waits */
+extern void gasneti_pshm_wakeup_one(gasneti_pshm_rank_t rank) {
+  gasneti_assert(rank < gasneti_pshm_nodes);
+  if (gasneti_pshm_wakeup) gasneti_pshm_wakeup_rank(rank);
+}
+
+extern void gasneti_pshm_wakeup_all(void) {
+#if GASNETI_PSHM_FUTEX
+  if (!gasneti_pshm_wakeup) return;
+  gasneti_local_mb(); /* order caller's stores before reading 'sleepers_seen' and 'sleeping' */
+  if_pf (gasneti_atomic_read(&gasneti_pshm_info->sleepers_seen, 0)) {
+    gasneti_pshm_rank_t i;
+    for (i = 0; i < gasneti_pshm_nodes; ++i) {
+      gasneti_pshm_wakeup_t * const w = &gasneti_pshm_wakeup[i];
+      if (gasneti_atomic_read(&w->w.sleeping, 0)) {
+        w->w.seq++;
+        (void)syscall(SYS_futex, &w->w.seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+      }
+    }
+  }
+#endif
+}
+
 /* ------------------------------------------------------------------------------------ */
 /*
  * Active Message Request Functions
  * ================================
  */
 
-/* Loopback AMs use buffers from this free pool.
- * Worst case this pool grows to two per threads (one request and one reply).
- * TODO: per-thread buffers (as in smp-conduit) would remove contention, but
- * requires mofiying the conduit-specific code for threaddata.
+/* Loopback AMs use buffers cached in the threaddata: one for requests and
+ * one for replies.  A buffer is taken out of its slot while in use, so a
+ * nested loopback AM on the same thread (such as a reply from within a
+ * Request handler) never finds its own buffer busy.
+ * The global free pool is used only as overflow: it supplies buffers when a
+ * slot is empty, and takes back buffers that do not fit in the slot or that
+ * are cached by an exiting thread.
  */
 static gasneti_lifo_head_t loopback_freepool = GASNETI_LIFO_INITIALIZER;
 
-int gasnetc_AMPSHM_ReqRepGeneric(int category, int isReq, gasnet_node_t dest,
+static void gasneti_AMPSHM_loopback_cleanup(void *_td) {
+  gasneti_threaddata_t *mythread = (gasneti_threaddata_t *)_td;
+  int i;
+  for (i = 0; i < 2; ++i) {
+    void *msg = mythread->pshm_loopback_buf[i];
+    if (msg) {
+      mythread->pshm_loopback_buf[i] = NULL;
+      gasneti_lifo_push(&loopback_freepool, msg);
+    }
+  }
+  mythread->pshm_loopback_cleanup = 0;
+}
+
+GASNETI_INLINE(gasneti_AMPSHM_loopback_get)
+void *gasneti_AMPSHM_loopback_get(gasneti_threaddata_t * const mythread, int isReq) {
+  void *msg;
+
+  gasneti_assert((isReq == 0) || (isReq == 1));
+  msg = mythread->pshm_loopback_buf[isReq];
+  if_pt (msg) {
+    mythread->pshm_loopback_buf[isReq] = NULL;
+    return msg;
+  }
+
+  msg = gasneti_lifo_pop(&loopback_freepool);
+  if_pf (msg == NULL) {
+    /* Grow the free pool with buffers sized and aligned for the largest Medium */
+    void *tmp = gasneti_malloc(sizeof(gasneti_AMPSHM_medmsg_t)+7);
+    gasneti_leak(tmp);
+    uintptr_t offset = (uintptr_t)GASNETI_AMPSHM_MSG_MED_DATA(tmp) & 7;
+    /* Align the (macro-adjusted) Medium payload field, not the msg itself */
+    msg = (void*)((uintptr_t)tmp + (offset ? (8-offset) : 0));
+  }
+  if_pf (!mythread->pshm_loopback_cleanup) {
+    mythread->pshm_loopback_cleanup = 1;
+    gasnete_register_threadcleanup(gasneti_AMPSHM_loopback_cleanup, mythread);
+  }
+  return msg;
+}
+
+GASNETI_INLINE(gasneti_AMPSHM_loopback_put)
+void gasneti_AMPSHM_loopback_put(gasneti_threaddata_t * const mythread, int isReq, void *msg) {
+  if_pt (!mythread->pshm_loopback_buf[isReq]) {
+    mythread->pshm_loopback_buf[isReq] = msg;
+  } else {
+    gasneti_lifo_push(&loopback_freepool, msg);
+  }
+}
+
+GASNETI_INLINE(gasneti_AMPSHM_ReqRepGeneric)
+int gasneti_AMPSHM_ReqRepGeneric(int category, int isReq, int isAsync, gasnet_node_t dest,
                                  gasnetc_handler_t handler, void *source_addr, size_t nbytes, 
                                  void *dest_addr, int numargs, va_list argptr) 
 {
@@ -1266,20 +2177,14 @@ int gasnetc_AMPSHM_ReqRepGeneric(int category, int isReq, gasnet_node_t dest,
   int i;
   void *msg;
   int loopback = (dest == gasneti_mynode);
+  gasneti_threaddata_t *mythread = NULL;
 
   gasneti_assert(vnet != NULL);
   gasneti_assert(target < gasneti_pshm_nodes);
 
   if (loopback) {
-    msg = gasneti_lifo_pop(&loopback_freepool);
-    if_pf (msg == NULL) {
-      /* Grow the free pool with buffers sized and aligned for the largest Medium */
-      void *tmp = gasneti_malloc(sizeof(gasneti_AMPSHM_medmsg_t)+7);
-      gasneti_leak(tmp);
-      uintptr_t offset = (uintptr_t)GASNETI_AMPSHM_MSG_MED_DATA(tmp) & 7;
-      /* Align the (macro-adjusted) Medium payload field, not the msg itself */
-      msg = (void*)((uintptr_t)tmp + (offset ? (8-offset) : 0));
-    }
+    mythread = _gasneti_mythread_slow();
+    msg = gasneti_AMPSHM_loopback_get(mythread, isReq);
   } else {
     static gasneti_mutex_t req_lock = GASNETI_MUTEX_INITIALIZER;
     static gasneti_mutex_t rep_lock = GASNETI_MUTEX_INITIALIZER;
@@ -1340,8 +2245,20 @@ int gasnetc_AMPSHM_ReqRepGeneric(int category, int isReq, gasnet_node_t dest,
       GASNETI_AMPSHM_MSG_LONG_DATA(msg) = dest_addr; 
       GASNETI_AMPSHM_MSG_LONG_NUMBYTES(msg) = nbytes;
       gasneti_assert( GASNETI_AMPSHM_MSG_LONG_NUMBYTES(msg) == nbytes ); /* truncation check */
+    #if !GASNET_SEGMENT_EVERYTHING
+      /* LongAsync source must not be modified until the (mandatory) reply
+       * handler runs.  So, the receiver can perform the copy (before running
+       * the request handler) if the source is in our cross-mapped segment. */
+      if (isAsync && !loopback &&
+          gasneti_pshm_longasync_threshold && (nbytes >= gasneti_pshm_longasync_threshold) &&
+          gasneti_in_fullsegment(gasneti_mynode, source_addr, nbytes)) {
+        GASNETI_AMPSHM_MSG_LONG_SRC(msg) = source_addr;
+        break;
+      }
+    #endif
+      GASNETI_AMPSHM_MSG_LONG_SRC(msg) = NULL;
       /* deliver_msg call, below, contains write flush, so don't need here */
-      memcpy(local_dest_addr, source_addr, nbytes);
+      gasneti_AMPSHM_long_copy(local_dest_addr, source_addr, nbytes);
       break;
     }
   }
@@ -1371,7 +2288,7 @@ int gasnetc_AMPSHM_ReqRepGeneric(int category, int isReq, gasnet_node_t dest,
         break;
     }
     GASNETC_LEAVING_HANDLER_HOOK(category,isReq);
-    gasneti_lifo_push(&loopback_freepool, msg);
+    gasneti_AMPSHM_loopback_put(mythread, isReq, msg);
     gasnetc_token_destroy(token);
   } else {
     gasneti_pshmnet_deliver_send_buffer(vnet, msg, msgsz, target);
@@ -1379,4 +2296,20 @@ int gasnetc_AMPSHM_ReqRepGeneric(int category, int isReq, gasnet_node_t dest,
   return GASNET_OK;
 }
 
+int gasnetc_AMPSHM_ReqRepGeneric(int category, int isReq, gasnet_node_t dest,
+                                 gasnetc_handler_t handler, void *source_addr, size_t nbytes, 
+                                 void *dest_addr, int numargs, va_list argptr) 
+{
+  return gasneti_AMPSHM_ReqRepGeneric(category, isReq, 0, dest, handler, source_addr,
+                                      nbytes, dest_addr, numargs, argptr);
+}
+
+int gasnetc_AMPSHM_RequestLongAsync(gasnet_node_t dest, gasnetc_handler_t handler,
+                                    void *source_addr, size_t nbytes, void *dest_addr,
+                                    int numargs, va_list argptr)
+{
+  return gasneti_AMPSHM_ReqRepGeneric(gasnetc_Long, 1, 1, dest, handler, source_addr,
+                                      nbytes, dest_addr, numargs, argptr);
+}
+
 #endif /* GASNET_PSHM */
@@ -62,6 +62,25 @@ extern void *gasneti_pshm_init(gasneti_bootstrapBroadcastfn_t localbcastfn, size
 /* Unmap all pshm segments */
 extern void gasneti_pshm_fini(void);
 
+/* NUMA-aware placement of memory owned by this process (page-aligned range),
+   and optional diagnostic dump (GASNET_PSHM_NUMA_DUMP) of placements to date */
+extern void gasneti_pshm_numa_place(const char *what, void *addr, uintptr_t len);
+extern void gasneti_pshm_numa_dump_placement(void);
+
+/* Blocking waits for GASNET_WAIT_BLOCK and GASNET_WAIT_SPINBLOCK:
+   gasneti_pshm_waithook() spins or yields briefly, and then sleeps (bounded)
+   awaiting PSHM message delivery to this process (see GASNETI_WAITHOOK_BLOCK).
+   gasneti_pshm_wakeup_one() and gasneti_pshm_wakeup_all() wake the given
+   (supernode) rank, or all sleepers, for use by code which ends waits by
+   means other than PSHM messages (such as the PSHM barrier). */
+extern void gasneti_pshm_waithook(void);
+extern void gasneti_pshm_wakeup_one(gasneti_pshm_rank_t rank);
+extern void gasneti_pshm_wakeup_all(void);
+
+/* Identifier of the L3 cache or processor package to which this process is
+   bound (from sysfs), or -1 if unknown or not bound within one */
+extern int gasneti_pshm_cpu_domain(void);
+
 /*  PSHMnets needed for PSHM active messages.
  *
  * - Conduits using GASNET_PSHM must initialize these two vnets
@@ -261,6 +280,18 @@ int gasneti_pshmnet_recv(gasneti_pshmnet_t *vnet, void **pbuf, size_t *psize,
 extern
 void gasneti_pshmnet_recv_release(gasneti_pshmnet_t *vnet, void *buf); 
 
+/* Batched receipt of up to 'max' messages from any sender(s).
+ * The entire run of ready messages is detached with a single atomic, and
+ * any excess beyond 'max' is retained for subsequent receive calls.
+ * - 'bufs': array (length >= max) which will hold pointers to the messages
+ *
+ * returns the number of messages received (possibly zero).
+ * Message sizes and senders are not reported: they must be carried in the
+ * messages themselves if needed.
+ */
+extern
+int gasneti_pshmnet_recv_batch(gasneti_pshmnet_t *vnet, int max, void *bufs[]);
+
 /*******************************************************************************
  * AMPSHM: Active Messages over PSHMnet
  *******************************************************************************/
@@ -275,6 +306,12 @@ int gasnetc_AMPSHM_ReqRepGeneric(int category, int isReq, gasnet_node_t dest,
                                  gasnetc_handler_t handler, void *source_addr, size_t nbytes, 
                                  void *dest_addr, int numargs, va_list argptr);
 
+/* Don't call this function directly: internal pshm function */
+extern
+int gasnetc_AMPSHM_RequestLongAsync(gasnet_node_t dest, gasnetc_handler_t handler,
+                                    void *source_addr, size_t nbytes, void *dest_addr,
+                                    int numargs, va_list argptr);
+
 /* Generic AM handler for PSHMnet.
  * Divert your conduit's regular AM requests to this function if a call to
  * gasneti_pshm_in_supernode(dest) is nonzero */ 
@@ -288,6 +325,21 @@ int gasneti_AMPSHM_RequestGeneric(int category, gasnet_node_t dest,
                                       nbytes, dest_addr, numargs, argptr); 
 }
 
+/* Generic AMLongAsync handler for PSHMnet.
+ * Divert your conduit's AMRequestLongAsync calls to this function if a call to
+ * gasneti_pshm_in_supernode(dest) is nonzero.  Payloads at or above
+ * GASNET_PSHM_LONGASYNC_THRESHOLD with a source in the local segment are copied
+ * by the receiver, rather than the sender. */ 
+GASNETI_INLINE(gasneti_AMPSHM_RequestLongAsyncGeneric)
+int gasneti_AMPSHM_RequestLongAsyncGeneric(gasnet_node_t dest, 
+                                  gasnetc_handler_t handler, void *source_addr, size_t nbytes,
+                                  void *dest_addr, int numargs, va_list argptr) 
+{
+  gasneti_assert(gasneti_pshm_in_supernode(dest));
+  return gasnetc_AMPSHM_RequestLongAsync(dest, handler, source_addr,
+                                         nbytes, dest_addr, numargs, argptr); 
+}
+
 /* Generic AM handler for PSHMnet.
  * Divert your conduit's regular AM replies to this function if a call to
  * gasneti_pshm_in_supernode(dest) or gasnetc_token_is_pshm(token) is nonzero */ 
@@ -329,7 +381,8 @@ typedef struct {
         } wmb;
         uint64_t volatile u64;
       } u;
-      char _pad[GASNETI_CACHE_PAD(sizeof(union gasneti_pshm_barrier_node_u))];
+      gasneti_atomic_t release; /* state passed down the tree, if tree-based release */
+      char _pad[GASNETI_CACHE_PAD(sizeof(union gasneti_pshm_barrier_node_u) + sizeof(gasneti_atomic_t))];
     } node[1]; /* VLA */
 } gasneti_pshm_barrier_t;
 
@@ -648,6 +648,10 @@ extern void gasneti_trace_finish(void);
                                                           \
         CNT(I, AMPOLL, cnt)                               \
                                                           \
+        VAL(I, PSHMNET_ALLOC, unused bytes)               \
+        CNT(I, PSHMNET_ALLOC_SPILL, cnt)                  \
+        CNT(I, PSHMNET_ALLOC_FAIL, cnt)                   \
+                                                          \
         VAL(I, GASNET_MALLOC, sz)                         \
         VAL(I, GASNET_FREE, sz)                           \
                                                           \
@@ -3169,6 +3169,8 @@ static void gasnetc_exit_body(void) {
     }
   }
 
+  gasnete_coll_fini(); /* stop the collectives progress thread, if any */
+
 #if GASNETC_USE_RCV_THREAD
   /* Stop AM receive thread, if applicable (won't kill self) */
   gasnetc_sndrcv_stop_thread(0);
@@ -459,6 +459,7 @@ extern void gasnetc_exit(int exitcode) {
     static gasneti_mutex_t exit_lock = GASNETI_MUTEX_INITIALIZER;
     gasneti_mutex_lock(&exit_lock);
   }
+  gasnete_coll_fini(); /* stop the collectives progress thread, if any */
 
   GASNETI_TRACE_PRINTF(C,("gasnet_exit(%i)\n", exitcode));
 
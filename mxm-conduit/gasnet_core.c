@@ -1979,6 +1979,8 @@ static void gasnetc_exit_body(void)
         }
     }
 
+    gasnete_coll_fini(); /* stop the collectives progress thread, if any */
+
     /* read exit code, stored by first caller to gasnetc_exit_head() */
     exitcode = gasneti_atomic_read(&gasnetc_exit_code, GASNETI_ATOMIC_RMB_PRE);
 
@@ -2396,9 +2398,9 @@ extern int gasnetc_AMRequestLongAsyncM( gasnet_node_t dest,        /* destinatio
 #if GASNET_PSHM
     /* (###) If your conduit will support PSHM, let it check the dest first. */
     if_pt (gasneti_pshm_in_supernode(dest)) {
-        retval = gasneti_AMPSHM_RequestGeneric(gasnetc_Long, dest, handler,
-                                               source_addr, nbytes, dest_addr,
-                                               numargs, argptr);
+        retval = gasneti_AMPSHM_RequestLongAsyncGeneric(dest, handler,
+                                                        source_addr, nbytes, dest_addr,
+                                                        numargs, argptr);
     }
     else
 #endif
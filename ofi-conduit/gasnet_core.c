@@ -351,6 +351,7 @@ extern void gasnetc_exit(int exitcode) {
     static gasneti_mutex_t exit_lock = GASNETI_MUTEX_INITIALIZER;
     gasneti_mutex_lock(&exit_lock);
   }
+  gasnete_coll_fini(); /* stop the collectives progress thread, if any */
 
   GASNETI_TRACE_PRINTF(C,("gasnet_exit(%i)\n", exitcode));
 
@@ -547,9 +548,9 @@ extern int gasnetc_AMRequestLongAsyncM( gasnet_node_t dest,        /* destinatio
   va_start(argptr, numargs); /*  pass in last argument */
 #if GASNET_PSHM
   if_pt (gasneti_pshm_in_supernode(dest)) {
-    retval = gasneti_AMPSHM_RequestGeneric(gasnetc_Long, dest, handler,
-                                           source_addr, nbytes, dest_addr,
-                                           numargs, argptr);
+    retval = gasneti_AMPSHM_RequestLongAsyncGeneric(dest, handler,
+                                                    source_addr, nbytes, dest_addr,
+                                                    numargs, argptr);
   } else
 #endif
   {
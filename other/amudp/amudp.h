@@ -116,6 +116,7 @@ typedef int op_t;
 
 // programmatic tuning knobs
 extern int AMUDP_PoliteSync; /* set to non-zero for polite blocking while awaiting send resources */
+extern int AMUDP_PoliteSpin_us; /* with AMUDP_PoliteSync, poll this long (in us) before blocking */
 extern int AMX_VerboseErrors; /* set to non-zero for verbose error reporting */
 extern int AMX_SilentMode; /* set to non-zero to silence any non-error output */
 extern const char *AMX_ProcessLabel; /* human-readable label for this process */
@@ -894,18 +894,24 @@ extern int AM_Poll(eb_t eb) {
   return AM_OK;
 }
 // poll/block eb while awaiting resource cond
+// with AMUDP_PoliteSync, block only after polling for AMUDP_PoliteSpin_us
 // upon error, execute cleanup and return it
-#define BLOCKUNTIL(eb, cond, cleanup) while (!(cond)) { \
-   int _retval = AM_OK;                                 \
-   if (AMUDP_PoliteSync) {                              \
-      _retval = AMUDP_Block(eb);                        \
-   }                                                    \
-   if_pt (_retval == AM_OK) _retval = AM_Poll(eb);      \
-   if_pf (_retval != AM_OK) {                           \
-     cleanup;                                           \
-     AMX_RETURN(_retval);                               \
-   }                                                    \
-  }
+#define BLOCKUNTIL(eb, cond, cleanup) do {                 \
+  amx_tick_t _spinend = 0;                                 \
+  while (!(cond)) {                                        \
+   int _retval = AM_OK;                                    \
+   if (AMUDP_PoliteSync) {                                 \
+      amx_tick_t const _now = AMX_getCPUTicks();           \
+      if (!_spinend) _spinend = _now + AMX_us2ticks(AMUDP_PoliteSpin_us); \
+      if (_now >= _spinend) _retval = AMUDP_Block(eb);     \
+   }                                                       \
+   if_pt (_retval == AM_OK) _retval = AM_Poll(eb);         \
+   if_pf (_retval != AM_OK) {                              \
+     cleanup;                                              \
+     AMX_RETURN(_retval);                                  \
+   }                                                       \
+  }                                                        \
+ } while (0)
 #define TRANSID_TO_NODEID(ep, transid) (                       \
   AMX_PREDICT_TRUE(!(ep)->translation) ? (amudp_node_t)(transid) : \
     (AMX_assert((transid) < (ep)->translationsz),              \
@@ -220,6 +220,7 @@ myxml_node_t* myxml_loadTreeHelper(FILE *instream, myxml_node_t *parent_node) {
   SAFE_READ(&temp, sizeof(uint32_t), instream);
   temp = MYNTOHL(temp);
   
+  curr_node->value = NULL;
   if(temp > 0) {
     curr_node->value = (char*) gasneti_malloc(temp);
     SAFE_READ(curr_node->value, temp, instream);
@@ -302,6 +303,7 @@ myxml_node_t* myxml_loadTreeHelper_bytestream(myxml_bytestream_t *instream, myxm
   SAFE_READ_BYTES(&temp, sizeof(uint32_t), instream);
   temp = MYNTOHL(temp);
   
+  curr_node->value = NULL;
   if(temp > 0) {
     curr_node->value = (char*) gasneti_malloc(temp);
     SAFE_READ_BYTES(curr_node->value, temp, instream);
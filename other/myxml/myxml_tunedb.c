@@ -0,0 +1,482 @@
+/*   $Source: bitbucket.org:berkeleylab/gasnet.git/other/myxml/myxml_tunedb.c $
+ * Description: converts and merges collective tuning files and binary tuning databases
+ * Terms of use are as specified in license.txt
+ */
+
+/* Builds binary tuning databases (extended-ref/coll/gasnet_tunedb.h) from the
+   XML tuning files written by gasnet_coll_dumpTuningState(), merges several
+   runs into one database, and converts a database back into an XML tuning
+   file.  Like myxml_bintoxml it is built stand-alone, e.g.
+     cc -o myxml_tunedb myxml_tunedb.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#define gasneti_malloc(SZ) malloc(SZ)
+#define gasneti_calloc(N,SZ) calloc(N,SZ)
+#define gasneti_realloc(PTR,SZ) realloc(PTR,SZ)
+#define gasneti_free(PTR) free(PTR)
+#define gasneti_assert_always(COND) do{if(!(COND)){ fprintf(stderr, "fatalERROR: %s:%d\n", __FILE__, __LINE__); exit(1);}}while(0)
+#include "./myxml.h"
+#include "./myxml.c"
+#include "../../extended-ref/coll/gasnet_tunedb.h"
+
+#define FATAL(...) do { fprintf(stderr, "myxml_tunedb: " __VA_ARGS__); fprintf(stderr, "\n"); exit(1); } while(0)
+
+/* the tags of the levels below "machine", as written by gasnete_coll_dumpTuningState() */
+static const char *level_tags[GASNETE_COLL_TUNEDB_LEVELS] =
+  {"num_nodes", "threads_per_node", "sync_mode", "address_mode", "collective", "root", "size"};
+#define LEVEL_SYNCMODE 2
+#define LEVEL_ADDRMODE 3
+#define LEVEL_OPTYPE   4
+#define LEVEL_SIZE     (GASNETE_COLL_TUNEDB_LEVELS-1)
+
+/* indexed by the values of gasnete_coll_syncmode_t, gasnete_coll_addr_mode_t and gasnet_coll_optype_t */
+static const char *syncmode_names[] = {"no/no", "no/my", "no/all", "my/no", "my/my", "my/all", "all/no", "all/my", "all/all"};
+static const char *addrmode_names[] = {"single", "local", "thread_local"};
+static const char *optype_names[] = {"broadcast", "broadcastM", "scatter", "scatterM", "gather", "gatherM",
+                                     "gather_all", "gather_allM", "exchange", "exchangeM",
+                                     "reduce", "reduceM", "allreduce", "allreduceM"};
+#define NUM_NAMES(ARR) (sizeof(ARR)/sizeof(ARR[0]))
+
+/*************************/
+/***IN-MEMORY DATABASE****/
+/*************************/
+
+typedef struct tdb_node_t_ {
+  uint32_t start;
+  struct tdb_node_t_ *children; /* sorted by start */
+  int num_children;
+  /* on the size level only */
+  int tuned;
+  uint32_t fn_idx;
+  char *alg_name;
+  char *tree_type;
+  uint32_t num_params;
+  uint32_t params[GASNETE_COLL_TUNEDB_MAX_PARAMS];
+} tdb_node_t;
+
+typedef struct {
+  char *config;
+  tdb_node_t root;
+} tdb_machine_t;
+
+static tdb_machine_t *machines;
+static int num_machines;
+static int num_replaced;
+
+static char *dup_str(const char *str) {
+  char *ret;
+  if(!str) return NULL;
+  ret = malloc(strlen(str)+1);
+  strcpy(ret, str);
+  return ret;
+}
+
+static tdb_node_t *find_or_add_child(tdb_node_t *parent, uint32_t start) {
+  int i;
+  for(i=0; i<parent->num_children && parent->children[i].start < start; i++) ;
+  if(i<parent->num_children && parent->children[i].start == start) return &parent->children[i];
+  parent->children = realloc(parent->children, sizeof(tdb_node_t)*(parent->num_children+1));
+  memmove(&parent->children[i+1], &parent->children[i], sizeof(tdb_node_t)*(parent->num_children-i));
+  parent->num_children++;
+  memset(&parent->children[i], 0, sizeof(tdb_node_t));
+  parent->children[i].start = start;
+  return &parent->children[i];
+}
+
+/* later inputs take precedence, so a merge keeps the most recent tuning of every key */
+static void add_leaf(const char *config, const uint32_t *key, uint32_t fn_idx, const char *alg_name,
+                     const char *tree_type, uint32_t num_params, const uint32_t *params) {
+  tdb_node_t *node;
+  int i;
+
+  for(i=0; i<num_machines && strcmp(machines[i].config, config); i++) ;
+  if(i==num_machines) {
+    machines = realloc(machines, sizeof(tdb_machine_t)*(num_machines+1));
+    memset(&machines[i], 0, sizeof(tdb_machine_t));
+    machines[i].config = dup_str(config);
+    num_machines++;
+  }
+  node = &machines[i].root;
+  for(i=0; i<GASNETE_COLL_TUNEDB_LEVELS; i++) {
+    node = find_or_add_child(node, key[i]);
+  }
+  if(num_params > GASNETE_COLL_TUNEDB_MAX_PARAMS) FATAL("too many tuning parameters (%u)", (unsigned int)num_params);
+  if(node->tuned) num_replaced++;
+  node->tuned = 1;
+  free(node->alg_name);
+  free(node->tree_type);
+  node->fn_idx = fn_idx;
+  node->alg_name = dup_str(alg_name);
+  node->tree_type = dup_str(tree_type);
+  node->num_params = num_params;
+  memcpy(node->params, params, sizeof(uint32_t)*num_params);
+}
+
+/*********************/
+/***XML TUNING FILES**/
+/*********************/
+
+static uint32_t name_to_value(const char **names, size_t num_names, const char *str, const char *tag) {
+  size_t i;
+  for(i=0; i<num_names; i++) {
+    if(!strcmp(names[i], str)) return (uint32_t)i;
+  }
+  FATAL("unknown %s \"%s\"", tag, str);
+  return 0; /* NOT REACHED */
+}
+
+static void read_xml_helper(const char *config, myxml_node_t *parent, uint32_t *key, int level) {
+  int i, j;
+
+  for(i=0; i<MYXML_NUM_CHILDREN(parent); i++) {
+    myxml_node_t *child = MYXML_CHILDREN(parent)[i];
+    const char *val;
+
+    if(strcmp(MYXML_TAG(child), level_tags[level]) || MYXML_NUM_ATTRIBUTES(child) < 1) {
+      FATAL("expected a %s element, found %s", level_tags[level], MYXML_TAG(child));
+    }
+    val = MYXML_ATTRIBUTES(child)[0].attribute_value;
+    switch(level) {
+      case LEVEL_SYNCMODE: key[level] = name_to_value(syncmode_names, NUM_NAMES(syncmode_names), val, "sync_mode"); break;
+      case LEVEL_ADDRMODE: key[level] = name_to_value(addrmode_names, NUM_NAMES(addrmode_names), val, "address_mode"); break;
+      case LEVEL_OPTYPE: key[level] = name_to_value(optype_names, NUM_NAMES(optype_names), val, "collective"); break;
+      default: key[level] = (uint32_t)strtoul(val, NULL, 10); break;
+    }
+
+    if(level == LEVEL_SIZE) {
+      /* Best_Alg holds "fn_idx (name)", then Best_Tree, Num_Params and param_0.. */
+      myxml_node_t **fields = MYXML_CHILDREN(child);
+      uint32_t params[GASNETE_COLL_TUNEDB_MAX_PARAMS];
+      uint32_t num_params;
+      char *alg_name = NULL;
+      const char *open_paren, *close_paren;
+
+      if(MYXML_NUM_CHILDREN(child) < 3 || strcmp(MYXML_TAG(fields[0]), "Best_Alg") ||
+         strcmp(MYXML_TAG(fields[1]), "Best_Tree") || strcmp(MYXML_TAG(fields[2]), "Num_Params") ||
+         !MYXML_VALUE(fields[0]) || !MYXML_VALUE(fields[2])) {
+        FATAL("malformed size entry %u", (unsigned int)key[level]);
+      }
+      num_params = (uint32_t)atoi(MYXML_VALUE(fields[2]));
+      if(num_params > GASNETE_COLL_TUNEDB_MAX_PARAMS || MYXML_NUM_CHILDREN(child) < 3 + (int)num_params) {
+        FATAL("malformed parameters for size entry %u", (unsigned int)key[level]);
+      }
+      for(j=0; j<(int)num_params; j++) {
+        if(!MYXML_VALUE(fields[3+j])) FATAL("malformed parameters for size entry %u", (unsigned int)key[level]);
+        params[j] = (uint32_t)strtoul(MYXML_VALUE(fields[3+j]), NULL, 10);
+      }
+      open_paren = strchr(MYXML_VALUE(fields[0]), '(');
+      close_paren = strrchr(MYXML_VALUE(fields[0]), ')');
+      if(open_paren && close_paren > open_paren) {
+        alg_name = malloc(close_paren - open_paren);
+        memcpy(alg_name, open_paren+1, close_paren - open_paren - 1);
+        alg_name[close_paren - open_paren - 1] = '\0';
+      }
+      add_leaf(config, key, (uint32_t)atoi(MYXML_VALUE(fields[0])), alg_name,
+               (MYXML_VALUE(fields[1]) && MYXML_VALUE(fields[1])[0]) ? MYXML_VALUE(fields[1]) : NULL,
+               num_params, params);
+      free(alg_name);
+    } else {
+      read_xml_helper(config, child, key, level+1);
+    }
+  }
+}
+
+static void read_xml(const char *filename, FILE *fp) {
+  uint32_t key[GASNETE_COLL_TUNEDB_LEVELS];
+  myxml_node_t *root = myxml_loadTreeBIN(fp);
+
+  if(strcmp(MYXML_TAG(root), "machine") || MYXML_NUM_ATTRIBUTES(root) < 1) {
+    FATAL("%s: expected machine as the root of the tree", filename);
+  }
+  read_xml_helper(MYXML_ATTRIBUTES(root)[0].attribute_value, root, key, 0);
+  myxml_destroyTree(root);
+}
+
+static void write_xml_helper(myxml_node_t *parent, const tdb_node_t *list, int num, int level) {
+  int i, j;
+
+  for(i=0; i<num; i++) {
+    const tdb_node_t *node = &list[i];
+    myxml_node_t *temp_xml;
+    char buffer[512];
+
+    switch(level) {
+      case LEVEL_SYNCMODE:
+      case LEVEL_ADDRMODE:
+      case LEVEL_OPTYPE: {
+        const char **names = (level == LEVEL_SYNCMODE ? syncmode_names : (level == LEVEL_ADDRMODE ? addrmode_names : optype_names));
+        size_t num_names = (level == LEVEL_SYNCMODE ? NUM_NAMES(syncmode_names) :
+                            (level == LEVEL_ADDRMODE ? NUM_NAMES(addrmode_names) : NUM_NAMES(optype_names)));
+        if(node->start >= num_names) FATAL("unknown %s value %u", level_tags[level], (unsigned int)node->start);
+        temp_xml = myxml_createNode(parent, level_tags[level], "val", names[node->start], NULL);
+        break;
+      }
+      default:
+        temp_xml = myxml_createNodeInt(parent, level_tags[level], "val", (int)node->start, NULL);
+        break;
+    }
+
+    if(level == LEVEL_SIZE) {
+      if(node->alg_name) sprintf(buffer, "%u (%.400s)", (unsigned int)node->fn_idx, node->alg_name);
+      else sprintf(buffer, "%u", (unsigned int)node->fn_idx);
+      myxml_createNode(temp_xml, "Best_Alg", NULL, NULL, buffer);
+      myxml_createNode(temp_xml, "Best_Tree", NULL, NULL, node->tree_type ? node->tree_type : "");
+      sprintf(buffer, "%u", (unsigned int)node->num_params);
+      myxml_createNode(temp_xml, "Num_Params", NULL, NULL, buffer);
+      for(j=0; j<(int)node->num_params; j++) {
+        char tag[32];
+        sprintf(tag, "param_%d", j);
+        sprintf(buffer, "%u", (unsigned int)node->params[j]);
+        myxml_createNode(temp_xml, tag, NULL, NULL, buffer);
+      }
+    } else {
+      write_xml_helper(temp_xml, node->children, node->num_children, level+1);
+    }
+  }
+}
+
+/**************************/
+/***BINARY TUNING DATABASE*/
+/**************************/
+
+static char *db_image;
+static size_t db_size;
+static const gasnete_coll_tunedb_header_t *db_hdr;
+
+static const char *db_str(uint32_t offset) {
+  if(offset == GASNETE_COLL_TUNEDB_NONE) return NULL;
+  if(offset >= db_hdr->strings_size) FATAL("corrupt string offset %u", (unsigned int)offset);
+  return db_image + db_hdr->strings_offset + offset;
+}
+
+static void read_db_helper(const char *config, uint32_t first, uint32_t count, uint32_t *key, int level) {
+  const gasnete_coll_tunedb_entry_t *entries = (const gasnete_coll_tunedb_entry_t *)(db_image + db_hdr->entries_offset);
+  const gasnete_coll_tunedb_leaf_t *leaves = (const gasnete_coll_tunedb_leaf_t *)(db_image + db_hdr->leaves_offset);
+  uint32_t i;
+
+  if((uint64_t)first + count > db_hdr->num_entries) FATAL("corrupt entry list");
+  for(i=first; i<first+count; i++) {
+    key[level] = entries[i].start;
+    if(level == LEVEL_SIZE) {
+      const gasnete_coll_tunedb_leaf_t *leaf;
+      if(entries[i].count || entries[i].first >= db_hdr->num_leaves) FATAL("corrupt leaf index");
+      leaf = &leaves[entries[i].first];
+      if(leaf->num_params > GASNETE_COLL_TUNEDB_MAX_PARAMS) FATAL("corrupt leaf");
+      add_leaf(config, key, leaf->fn_idx, db_str(leaf->alg_name), db_str(leaf->tree_type), leaf->num_params, leaf->params);
+    } else {
+      read_db_helper(config, entries[i].first, entries[i].count, key, level+1);
+    }
+  }
+}
+
+static void read_db(const char *filename, FILE *fp) {
+  const gasnete_coll_tunedb_machine_t *db_machines;
+  uint32_t key[GASNETE_COLL_TUNEDB_LEVELS];
+  uint32_t i;
+
+  fseek(fp, 0L, SEEK_END);
+  db_size = ftell(fp);
+  rewind(fp);
+  db_image = malloc(db_size);
+  if(fread(db_image, 1, db_size, fp) != db_size) FATAL("%s: read error", filename);
+  db_hdr = (const gasnete_coll_tunedb_header_t *)db_image;
+  if(db_hdr->byte_order != GASNETE_COLL_TUNEDB_BYTE_ORDER) FATAL("%s: written on a host of the other byte order", filename);
+  if(db_hdr->version != GASNETE_COLL_TUNEDB_VERSION) FATAL("%s: unsupported version %u", filename, (unsigned int)db_hdr->version);
+  if(db_hdr->file_size != db_size ||
+     db_hdr->machines_offset + (uint64_t)db_hdr->num_machines*sizeof(gasnete_coll_tunedb_machine_t) > db_size ||
+     db_hdr->entries_offset + (uint64_t)db_hdr->num_entries*sizeof(gasnete_coll_tunedb_entry_t) > db_size ||
+     db_hdr->leaves_offset + (uint64_t)db_hdr->num_leaves*sizeof(gasnete_coll_tunedb_leaf_t) > db_size ||
+     db_hdr->strings_offset + (uint64_t)db_hdr->strings_size > db_size ||
+     !db_hdr->strings_size || db_image[db_hdr->strings_offset + db_hdr->strings_size - 1]) {
+    FATAL("%s: truncated or corrupt", filename);
+  }
+
+  db_machines = (const gasnete_coll_tunedb_machine_t *)(db_image + db_hdr->machines_offset);
+  for(i=0; i<db_hdr->num_machines; i++) {
+    read_db_helper(db_str(db_machines[i].config_str), db_machines[i].first, db_machines[i].count, key, 0);
+  }
+  free(db_image);
+}
+
+static gasnete_coll_tunedb_entry_t *out_entries;
+static uint32_t out_num_entries;
+static gasnete_coll_tunedb_leaf_t *out_leaves;
+static uint32_t out_num_leaves;
+static char *out_strings;
+static uint32_t out_strings_size;
+
+static uint32_t add_string(const char *str) {
+  uint32_t offset = 0;
+  if(!str) return GASNETE_COLL_TUNEDB_NONE;
+  while(offset < out_strings_size) {
+    if(!strcmp(out_strings + offset, str)) return offset;
+    offset += strlen(out_strings + offset) + 1;
+  }
+  out_strings = realloc(out_strings, out_strings_size + strlen(str) + 1);
+  strcpy(out_strings + out_strings_size, str);
+  out_strings_size += strlen(str) + 1;
+  return offset;
+}
+
+/* reserves the list before descending so that every list of children is contiguous */
+static uint32_t emit_list(const tdb_node_t *list, int num, int level) {
+  const uint32_t first = out_num_entries;
+  int i;
+
+  out_num_entries += num;
+  out_entries = realloc(out_entries, sizeof(gasnete_coll_tunedb_entry_t)*out_num_entries);
+  for(i=0; i<num; i++) {
+    gasnete_coll_tunedb_entry_t entry;
+    entry.start = list[i].start;
+    if(level == LEVEL_SIZE) {
+      gasnete_coll_tunedb_leaf_t *leaf;
+      out_leaves = realloc(out_leaves, sizeof(gasnete_coll_tunedb_leaf_t)*(out_num_leaves+1));
+      leaf = &out_leaves[out_num_leaves];
+      memset(leaf, 0, sizeof(gasnete_coll_tunedb_leaf_t));
+      leaf->fn_idx = list[i].fn_idx;
+      leaf->alg_name = add_string(list[i].alg_name);
+      leaf->tree_type = add_string(list[i].tree_type);
+      leaf->num_params = list[i].num_params;
+      memcpy(leaf->params, list[i].params, sizeof(uint32_t)*list[i].num_params);
+      entry.first = out_num_leaves++;
+      entry.count = 0;
+    } else {
+      entry.first = emit_list(list[i].children, list[i].num_children, level+1);
+      entry.count = list[i].num_children;
+    }
+    out_entries[first+i] = entry;
+  }
+  return first;
+}
+
+#define ALIGN_UP(X) (((X) + GASNETE_COLL_TUNEDB_ALIGN - 1) & ~(uint64_t)(GASNETE_COLL_TUNEDB_ALIGN - 1))
+
+static void write_section(FILE *fp, uint64_t offset, const void *data, size_t nbytes) {
+  static const char zeros[GASNETE_COLL_TUNEDB_ALIGN];
+  while((uint64_t)ftell(fp) < offset) fwrite(zeros, 1, 1, fp);
+  if(nbytes && fwrite(data, 1, nbytes, fp) != nbytes) FATAL("write error");
+}
+
+static void write_db(const char *filename) {
+  gasnete_coll_tunedb_machine_t *out_machines = calloc(num_machines ? num_machines : 1, sizeof(gasnete_coll_tunedb_machine_t));
+  gasnete_coll_tunedb_header_t hdr;
+  FILE *fp;
+  int i;
+
+  out_num_entries = out_num_leaves = out_strings_size = 0;
+  for(i=0; i<num_machines; i++) {
+    out_machines[i].config_str = add_string(machines[i].config);
+    out_machines[i].first = emit_list(machines[i].root.children, machines[i].root.num_children, 0);
+    out_machines[i].count = machines[i].root.num_children;
+  }
+  if(!out_strings_size) add_string("");
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, GASNETE_COLL_TUNEDB_MAGIC, sizeof(hdr.magic));
+  hdr.version = GASNETE_COLL_TUNEDB_VERSION;
+  hdr.byte_order = GASNETE_COLL_TUNEDB_BYTE_ORDER;
+  hdr.num_machines = num_machines;
+  hdr.num_entries = out_num_entries;
+  hdr.num_leaves = out_num_leaves;
+  hdr.strings_size = out_strings_size;
+  hdr.machines_offset = ALIGN_UP(sizeof(hdr));
+  hdr.entries_offset = ALIGN_UP(hdr.machines_offset + sizeof(gasnete_coll_tunedb_machine_t)*num_machines);
+  hdr.leaves_offset = ALIGN_UP(hdr.entries_offset + sizeof(gasnete_coll_tunedb_entry_t)*out_num_entries);
+  hdr.strings_offset = ALIGN_UP(hdr.leaves_offset + sizeof(gasnete_coll_tunedb_leaf_t)*out_num_leaves);
+  hdr.file_size = hdr.strings_offset + out_strings_size;
+
+  fp = fopen(filename, "wb");
+  if(!fp) FATAL("failed to open output file %s", filename);
+  write_section(fp, 0, &hdr, sizeof(hdr));
+  write_section(fp, hdr.machines_offset, out_machines, sizeof(gasnete_coll_tunedb_machine_t)*num_machines);
+  write_section(fp, hdr.entries_offset, out_entries, sizeof(gasnete_coll_tunedb_entry_t)*out_num_entries);
+  write_section(fp, hdr.leaves_offset, out_leaves, sizeof(gasnete_coll_tunedb_leaf_t)*out_num_leaves);
+  write_section(fp, hdr.strings_offset, out_strings, out_strings_size);
+  if(fclose(fp)) FATAL("write error on %s", filename);
+  printf("wrote %s: %d machine(s), %u entries, %u tuned implementations, %u bytes\n",
+         filename, num_machines, (unsigned int)out_num_entries, (unsigned int)out_num_leaves, (unsigned int)hdr.file_size);
+  free(out_machines);
+}
+
+/*******************/
+/***DRIVER**********/
+/*******************/
+
+static void read_input(const char *filename) {
+  char magic[8];
+  FILE *fp = fopen(filename, "rb");
+  if(!fp) FATAL("failed to open input file %s", filename);
+  if(fread(magic, 1, sizeof(magic), fp) == sizeof(magic) && !memcmp(magic, GASNETE_COLL_TUNEDB_MAGIC, sizeof(magic))) {
+    read_db(filename, fp);
+  } else {
+    rewind(fp);
+    read_xml(filename, fp);
+  }
+  fclose(fp);
+}
+
+static int count_leaves(const tdb_node_t *node, int level) {
+  int i, ret = 0;
+  if(level == GASNETE_COLL_TUNEDB_LEVELS) return 1;
+  for(i=0; i<node->num_children; i++) ret += count_leaves(&node->children[i], level+1);
+  return ret;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "usage: %s merge <out.db> <in> [<in> ...]\n"
+                  "         combine XML tuning files and/or tuning databases into one database;\n"
+                  "         where several inputs tune the same case the last one wins\n"
+                  "       %s export <in> <out.bin> [machine]\n"
+                  "         write the data of one machine (default 0) as an XML tuning file\n"
+                  "       %s list <in>\n"
+                  "         show the machines and node/thread counts in a file\n",
+          argv0, argv0, argv0);
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  int i;
+
+  if(argc < 3) usage(argv[0]);
+  if(!strcmp(argv[1], "merge") && argc >= 4) {
+    for(i=3; i<argc; i++) read_input(argv[i]);
+    if(num_replaced) printf("%d tuned case(s) replaced by later inputs\n", num_replaced);
+    write_db(argv[2]);
+  } else if(!strcmp(argv[1], "export") && (argc == 4 || argc == 5)) {
+    myxml_node_t *root;
+    FILE *fp;
+    int m = (argc == 5 ? atoi(argv[4]) : 0);
+
+    read_input(argv[2]);
+    if(m < 0 || m >= num_machines) FATAL("%s has no machine %d", argv[2], m);
+    if(num_machines > 1) fprintf(stderr, "note: %s holds %d machines, exporting machine %d\n", argv[2], num_machines, m);
+    root = myxml_createNode(NULL, "machine", "CONFIG", machines[m].config, NULL);
+    write_xml_helper(root, machines[m].root.children, machines[m].root.num_children, 0);
+    fp = fopen(argv[3], "w");
+    if(!fp) FATAL("failed to open output file %s", argv[3]);
+    myxml_printTreeBIN(fp, root);
+    fclose(fp);
+    myxml_destroyTree(root);
+  } else if(!strcmp(argv[1], "list") && argc == 3) {
+    read_input(argv[2]);
+    for(i=0; i<num_machines; i++) {
+      const tdb_node_t *nodes = &machines[i].root;
+      int n, p;
+      printf("machine %d: %s\n", i, machines[i].config);
+      for(n=0; n<nodes->num_children; n++) {
+        for(p=0; p<nodes->children[n].num_children; p++) {
+          printf("  nodes %u, threads per node %u: %d tuned case(s)\n",
+                 (unsigned int)nodes->children[n].start, (unsigned int)nodes->children[n].children[p].start,
+                 count_leaves(&nodes->children[n].children[p], 2));
+        }
+      }
+    }
+  } else {
+    usage(argv[0]);
+  }
+  return 0;
+}
@@ -870,6 +870,7 @@ extern void gasnetc_exit(int exitcode) {
         static gasneti_mutex_t exit_lock = GASNETI_MUTEX_INITIALIZER;
         gasneti_mutex_lock(&exit_lock);
     }
+    gasnete_coll_fini(); /* stop the collectives progress thread, if any */
 
     gasnetc_psm_state.exit_in_progress = 1;
 
@@ -1184,7 +1185,7 @@ extern int gasnetc_AMRequestLongAsyncM(gasnet_node_t dest, /* dest node */
     /* (###) If your conduit will support PSHM, let it check the dest first. */
     if_pt (gasneti_pshm_in_supernode(dest)) {
         GASNETC_PSM_PSHM_LOCK();
-        retval = gasneti_AMPSHM_RequestGeneric(gasnetc_Long, dest, handler,
+        retval = gasneti_AMPSHM_RequestLongAsyncGeneric(dest, handler,
                 source_addr, nbytes, dest_addr,
                 numargs, argptr);
         GASNETC_PSM_PSHM_UNLOCK();
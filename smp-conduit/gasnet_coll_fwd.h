@@ -46,10 +46,29 @@
         VAL(W, COLL_REDUCE_NB, cnt)           \
         VAL(W, COLL_REDUCE_M, cnt)            \
         VAL(W, COLL_REDUCE_M_NB, cnt)         \
+        VAL(W, COLL_ALLREDUCE, cnt)           \
+        VAL(W, COLL_ALLREDUCE_NB, cnt)        \
+        VAL(W, COLL_ALLREDUCE_M, cnt)         \
+        VAL(W, COLL_ALLREDUCE_M_NB, cnt)      \
         VAL(W, COLL_SCAN, cnt)                \
         VAL(W, COLL_SCAN_NB, cnt)             \
         VAL(W, COLL_SCAN_M, cnt)              \
-        VAL(W, COLL_SCAN_M_NB, cnt)
+        VAL(W, COLL_SCAN_M_NB, cnt)           \
+        VAL(W, COLL_START, sz)                \
+        VAL(W, COLL_NEIGHBOR_ALLGATHER, sz)   \
+        VAL(W, COLL_NEIGHBOR_ALLGATHER_NB, sz) \
+        VAL(W, COLL_NEIGHBOR_ALLTOALL, sz)    \
+        VAL(W, COLL_NEIGHBOR_ALLTOALL_NB, sz) \
+        VAL(W, COLL_NEIGHBOR_ALLTOALLV, sz)   \
+        VAL(W, COLL_NEIGHBOR_ALLTOALLV_NB, sz) \
+        VAL(W, COLL_GATHERV, sz)              \
+        VAL(W, COLL_GATHERV_NB, sz)           \
+        VAL(W, COLL_SCATTERV, sz)             \
+        VAL(W, COLL_SCATTERV_NB, sz)          \
+        VAL(W, COLL_GATHER_ALLV, sz)          \
+        VAL(W, COLL_GATHER_ALLV_NB, sz)       \
+        VAL(W, COLL_EXCHANGEV, sz)            \
+        VAL(W, COLL_EXCHANGEV_NB, sz)
 #endif
 
 #define GASNETE_COLL_AUXSEG_DECLS \
@@ -825,6 +825,7 @@ extern void gasnetc_exit(int exitcode) {
     static gasneti_mutex_t exit_lock = GASNETI_MUTEX_INITIALIZER;
     gasneti_mutex_lock(&exit_lock);
   }
+  gasnete_coll_fini(); /* stop the collectives progress thread, if any */
 
   GASNETI_TRACE_PRINTF(C,("gasnet_exit(%i)\n", exitcode));
 
@@ -1074,11 +1075,18 @@ extern int gasnetc_AMRequestLongAsyncM( gasnet_node_t dest,        /* destinatio
   GASNETI_COMMON_AMREQUESTLONGASYNC(dest,handler,source_addr,nbytes,dest_addr,numargs);
   va_start(argptr, numargs); /*  pass in last argument */
 
+#if GASNET_PSHM
+    gasneti_AMPoll(); /* ensure progress */
+    retval = gasneti_AMPSHM_RequestLongAsyncGeneric(dest, handler, 
+                                  source_addr, nbytes, dest_addr,
+                                  numargs, argptr);
+#else
     /*  call the generic requestor */
     retval = gasnetc_RequestGeneric(gasnetc_Long, 
                                   dest, handler, 
                                   source_addr, nbytes, dest_addr,
                                   numargs, argptr);
+#endif
   va_end(argptr);
   GASNETI_RETURN(retval);
 }
@@ -137,7 +137,10 @@ extern int gasnetc_AMGetMsgSource(gasnet_token_t token, gasnet_node_t *srcindex)
 
 #define gasnet_AMGetMsgSource  gasnetc_AMGetMsgSource
 
-#if GASNET_PSHM
+#if GASNET_PSHM && GASNET_SEQ
+  /* Only our own polls run handlers, and only after a PSHM message arrives */
+  #define GASNET_BLOCKUNTIL(cond) gasneti_pshm_polluntil(cond)
+#elif GASNET_PSHM
   #define GASNET_BLOCKUNTIL(cond) gasneti_polluntil(cond)
 #else
   #define GASNET_BLOCKUNTIL(cond) do { \
@@ -41,6 +41,14 @@
   #define gasnetc_AMPoll()        GASNET_OK  /* nothing to do */
 #endif
 
+  /* All communication is via PSHM, so waits which end only upon PSHM delivery
+     can sleep until a message arrives (see gasnet_set_waitmode() and
+     GASNET_PSHM_SLEEP_MAX_USEC) */
+#if GASNET_PSHM
+  extern void gasneti_pshm_waithook(void);
+  #define GASNETI_PSHM_WAITHOOK_BLOCK() gasneti_pshm_waithook()
+#endif
+
   /* define to 1 if conduit allows internal GASNet fns to issue put/get for remote
      addrs out of segment - not true when PSHM is used */
 #if 0
@@ -34,15 +34,17 @@ typedef struct _gasnete_op_t *gasnet_handle_t;
 #endif
 
 #if GASNET_PSHM
-#define GASNETE_COLL_CONDUIT_BARRIERS GASNETE_COLL_BARRIER_PSHM
+#define GASNETE_COLL_CONDUIT_BARRIERS GASNETE_COLL_BARRIER_PSHM, GASNETE_COLL_BARRIER_PSHMTREE
 #define GASNETE_BARRIER_DEFAULT "PSHM"
 #define GASNETE_BARRIER_READENV() do { \
     if(GASNETE_ISBARRIER("PSHM")) gasnete_coll_default_barrier_type = GASNETE_COLL_BARRIER_PSHM; \
+    else if(GASNETE_ISBARRIER("PSHMTREE")) gasnete_coll_default_barrier_type = GASNETE_COLL_BARRIER_PSHMTREE; \
   } while (0)
 #define GASNETE_BARRIER_INIT(TEAM, TYPE, NODES, SUPERNODES) do { \
-    if ((TYPE) == GASNETE_COLL_BARRIER_PSHM &&              \
+    if (((TYPE) == GASNETE_COLL_BARRIER_PSHM ||             \
+         (TYPE) == GASNETE_COLL_BARRIER_PSHMTREE) &&        \
         (TEAM) == GASNET_TEAM_ALL) {                        \
-      gasnete_pshmbarrier_init(TEAM);                       \
+      gasnete_pshmbarrier_init(TEAM, ((TYPE) == GASNETE_COLL_BARRIER_PSHMTREE)); \
     }                                                       \
   } while (0)
 #endif /* GASNET_PSHM */
@@ -29,6 +29,10 @@ options that is covered testcoll
 #define GATHER_ALL_ENABLED 0
 #define EXCHANGE_ENABLED 0
 #define REDUCE_ENABLED 0
+#define ALLREDUCE_ENABLED 0
+#define PERSISTENT_ENABLED 0
+#define NEIGHBOR_ENABLED 0
+#define VCOLL_ENABLED 0
 #endif
 
 #ifndef ALL_ADDR_MODE_ENABLED 
@@ -165,7 +169,263 @@ void int_reduce_fn(void *results, size_t result_count,
   }
   
 }
+/* allreduceM exercises the library-provided operator instead of int_reduce_fn */
+#define INT_SUM_BUILTIN GASNET_COLL_FN_BUILTIN(GASNET_COLL_TYPE_INT32, GASNET_COLL_OP_SUM)
 gasnet_coll_fn_entry_t fntable;
+#if NEIGHBOR_ENABLED || ALL_COLL_ENABLED
+/* Neighborhood collectives are called once per node, so this requires threads_per_node == 1.
+   The graph connects each node to the nodes at distance 1 and 2 (mod nodes) and to itself,
+   with the destinations listed in a different order than the sources. */
+#define NBR_VAL(s,d,e,k) ((int)((s)*7919 + (d)*104729 + (e) + 31*(k)))
+#define NBR_COUNT(s,d,nelem) (((nelem)*(1 + ((s)+(d))%3) + 2)/3)
+void run_NEIGHBOR_test(thread_data_t *td, int *dst, int *src, size_t nelem, int flags) {
+  gasnet_node_t srcs[5], dsts[5];
+  size_t indeg = 0, outdeg = 0;
+  size_t dst_counts[5], dst_offsets[5], src_counts[5], src_offsets[5];
+  gasnet_coll_graph_t graph;
+  gasnett_tick_t begin, end;
+  char flag_str[8];
+  int dist, i, j, k;
+  size_t e;
+  static const int dists[5] = { 0, -1, 1, -2, 2 };
+
+  fill_flag_str(flags, flag_str);
+  for(i=0; i<5; i++) {
+    gasnet_node_t peer = (gasnet_node_t)(((int)mynode + (int)nodes + dists[i] % (int)nodes) % (int)nodes);
+    for(j=0; j<indeg; j++) if(srcs[j] == peer) break;
+    if(j == indeg) srcs[indeg++] = peer;
+  }
+  for(i=0; i<indeg; i++) dsts[i] = srcs[indeg-1-i];
+  outdeg = indeg;
+  graph = gasnet_coll_graph_create(GASNET_TEAM_ALL, indeg, srcs, outdeg, dsts);
+
+  for(k=0; k<outer_verification_iters; k++) {
+    /* NEIGHBOR_ALLGATHER */
+    COLL_BARRIER();
+    for(e=0; e<nelem; e++) src[e] = NBR_VAL(mynode, 0, e, k);
+    for(e=0; e<nelem*indeg; e++) dst[e] = -1;
+    COLL_BARRIER();
+    gasnet_coll_neighbor_allgather(graph, dst, src, sizeof(int)*nelem, flags);
+    COLL_BARRIER();
+    for(i=0; i<indeg; i++) {
+      for(e=0; e<nelem; e++) {
+        int expected = NBR_VAL(srcs[i], 0, e, k);
+        if(dst[i*nelem+e] != expected) {
+          MSG("%d> neighbor_allgather verification from %d @ %d ... expected %d got %d", (int) td->mythread, (int)srcs[i], (int)e, expected, dst[i*nelem+e]);
+          ERROR_EXIT();
+        }
+      }
+    }
+
+    /* NEIGHBOR_ALLTOALL */
+    COLL_BARRIER();
+    for(j=0; j<outdeg; j++) for(e=0; e<nelem; e++) src[j*nelem+e] = NBR_VAL(mynode, dsts[j], e, k);
+    for(e=0; e<nelem*indeg; e++) dst[e] = -1;
+    COLL_BARRIER();
+    gasnet_coll_wait_sync(gasnet_coll_neighbor_alltoall_nb(graph, dst, src, sizeof(int)*nelem, flags));
+    COLL_BARRIER();
+    for(i=0; i<indeg; i++) {
+      for(e=0; e<nelem; e++) {
+        int expected = NBR_VAL(srcs[i], mynode, e, k);
+        if(dst[i*nelem+e] != expected) {
+          MSG("%d> neighbor_alltoall verification from %d @ %d ... expected %d got %d", (int) td->mythread, (int)srcs[i], (int)e, expected, dst[i*nelem+e]);
+          ERROR_EXIT();
+        }
+      }
+    }
+
+    /* NEIGHBOR_ALLTOALLV: blocks of varying length, leaving gaps between them */
+    COLL_BARRIER();
+    for(i=0; i<indeg; i++) {
+      dst_counts[i] = sizeof(int)*NBR_COUNT(srcs[i], mynode, nelem);
+      dst_offsets[i] = sizeof(int)*i*nelem;
+    }
+    for(j=0; j<outdeg; j++) {
+      src_counts[j] = sizeof(int)*NBR_COUNT(mynode, dsts[j], nelem);
+      src_offsets[j] = sizeof(int)*(outdeg-1-j)*nelem;
+      for(e=0; e<nelem; e++) src[(outdeg-1-j)*nelem+e] = NBR_VAL(mynode, dsts[j], e, k+1);
+    }
+    for(e=0; e<nelem*indeg; e++) dst[e] = -1;
+    COLL_BARRIER();
+    gasnet_coll_neighbor_alltoallv(graph, dst, dst_counts, dst_offsets, src, src_counts, src_offsets, flags);
+    COLL_BARRIER();
+    for(i=0; i<indeg; i++) {
+      size_t count = NBR_COUNT(srcs[i], mynode, nelem);
+      for(e=0; e<nelem; e++) {
+        int expected = (e < count) ? NBR_VAL(srcs[i], mynode, e, k+1) : -1;
+        if(dst[i*nelem+e] != expected) {
+          MSG("%d> neighbor_alltoallv verification from %d @ %d ... expected %d got %d", (int) td->mythread, (int)srcs[i], (int)e, expected, dst[i*nelem+e]);
+          ERROR_EXIT();
+        }
+      }
+    }
+  }
+
+  COLL_BARRIER();
+  begin = gasnett_ticks_now();
+  if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+  for(i=0; i<performance_iters; i++) { 
+    gasnet_coll_neighbor_alltoall(graph, dst, src, sizeof(int)*nelem, flags);
+  }
+  if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+  end =  gasnett_ticks_now() - begin;
+  COLL_BARRIER();
+  print_timer(td,  "neighbor_alltoall", (flags & GASNET_COLL_SINGLE) ? "SINGLE" : "LOCAL",
+              (flags & GASNET_COLL_DST_IN_SEGMENT) ? "SINGLE-addr" : "non-segment", flag_str, nelem, end);  
+
+  gasnet_coll_graph_free(graph);
+
+  /* A one-directional chain: the first node has no in-neighbors and the last
+     no out-neighbors, and the alltoallv moves no data at all */
+  indeg = (mynode > 0);
+  outdeg = (mynode + 1 < nodes);
+  srcs[0] = mynode - 1;
+  dsts[0] = mynode + 1;
+  graph = gasnet_coll_graph_create(GASNET_TEAM_ALL, indeg, srcs, outdeg, dsts);
+  for(k=0; k<outer_verification_iters; k++) {
+    COLL_BARRIER();
+    for(e=0; e<nelem; e++) src[e] = NBR_VAL(mynode, 0, e, k);
+    for(e=0; e<nelem; e++) dst[e] = -1;
+    COLL_BARRIER();
+    gasnet_coll_neighbor_allgather(graph, dst, src, sizeof(int)*nelem, flags);
+    gasnet_coll_neighbor_alltoall(graph, dst, src, sizeof(int)*nelem, flags);
+    COLL_BARRIER();
+    for(e=0; e<nelem; e++) {
+      int expected = indeg ? NBR_VAL(srcs[0], 0, e, k) : -1;
+      if(dst[e] != expected) {
+        MSG("%d> neighbor chain verification @ %d ... expected %d got %d", (int) td->mythread, (int)e, expected, dst[e]);
+        ERROR_EXIT();
+      }
+    }
+    dst_counts[0] = dst_offsets[0] = src_counts[0] = src_offsets[0] = 0;
+    COLL_BARRIER();
+    gasnet_coll_neighbor_alltoallv(graph, dst, dst_counts, dst_offsets, src, src_counts, src_offsets, flags);
+    COLL_BARRIER();
+  }
+  gasnet_coll_graph_free(graph);
+}
+#endif
+
+#if VCOLL_ENABLED || ALL_COLL_ENABLED
+/* Variable-count collectives are also called once per node.  Block lengths are
+   skewed from 0 to nelem elements and the blocks are nelem apart, leaving gaps. */
+#define VCOLL_VAL(s,d,e,k) ((int)((s)*7919 + (d)*104729 + (e) + 31*(k)))
+#define VCOLL_COUNT(s,d,nelem) (((nelem)*(((s) + 2*(d)) % 5))/4)
+void run_VCOLL_check(thread_data_t *td, const char *coll_str, int *dst, size_t nelem,
+                     const size_t *counts, int (*expected_fn)(gasnet_node_t, size_t, int), int k) {
+  gasnet_node_t r;
+  size_t e;
+  for(r=0; r<nodes; r++) {
+    for(e=0; e<nelem; e++) {
+      int expected = (e < counts[r]/sizeof(int)) ? (*expected_fn)(r, e, k) : -1;
+      if(dst[r*nelem+e] != expected) {
+        MSG("%d> %s verification for block %d @ %d ... expected %d got %d", (int) td->mythread, coll_str, (int)r, (int)e, expected, dst[r*nelem+e]);
+        ERROR_EXIT();
+      }
+    }
+  }
+}
+int vcoll_from_root(gasnet_node_t r, size_t e, int k) { return VCOLL_VAL(r, 0, e, k); }
+int vcoll_to_me(gasnet_node_t r, size_t e, int k) { return VCOLL_VAL(r, mynode, e, k); }
+
+void run_VCOLL_test(thread_data_t *td, int *dst, int *src, size_t nelem, int flags) {
+  size_t *counts = test_malloc(4*nodes*sizeof(size_t));
+  size_t *offsets = counts + nodes;
+  size_t *src_counts = counts + 2*nodes;
+  size_t *src_offsets = counts + 3*nodes;
+  const gasnet_node_t gath_root = nodes-1, scat_root = nodes/2;
+  gasnett_tick_t begin, end;
+  char flag_str[8];
+  gasnet_node_t r;
+  size_t e;
+  int i, k;
+
+  fill_flag_str(flags, flag_str);
+  for(r=0; r<nodes; r++) offsets[r] = src_offsets[r] = sizeof(int)*r*nelem;
+
+  for(k=0; k<outer_verification_iters; k++) {
+    /* GATHERV */
+    COLL_BARRIER();
+    for(r=0; r<nodes; r++) counts[r] = sizeof(int)*VCOLL_COUNT(r, gath_root, nelem);
+    for(e=0; e<nelem; e++) src[e] = VCOLL_VAL(mynode, 0, e, k);
+    for(e=0; e<nelem*nodes; e++) dst[e] = -1;
+    COLL_BARRIER();
+    gasnet_coll_gatherv(GASNET_TEAM_ALL, gath_root, dst, counts, offsets, src, flags);
+    COLL_BARRIER();
+    if(mynode == gath_root) run_VCOLL_check(td, "gatherv", dst, nelem, counts, &vcoll_from_root, k);
+
+    /* SCATTERV */
+    COLL_BARRIER();
+    for(r=0; r<nodes; r++) {
+      counts[r] = sizeof(int)*VCOLL_COUNT(scat_root, r, nelem);
+      if(mynode == scat_root) for(e=0; e<nelem; e++) src[r*nelem+e] = VCOLL_VAL(scat_root, r, e, k);
+    }
+    for(e=0; e<nelem; e++) dst[e] = -1;
+    COLL_BARRIER();
+    gasnet_coll_wait_sync(gasnet_coll_scatterv_nb(GASNET_TEAM_ALL, dst, scat_root, src, counts, offsets, flags));
+    COLL_BARRIER();
+    for(e=0; e<nelem; e++) {
+      int expected = (e < counts[mynode]/sizeof(int)) ? VCOLL_VAL(scat_root, mynode, e, k) : -1;
+      if(dst[e] != expected) {
+        MSG("%d> scatterv verification @ %d ... expected %d got %d", (int) td->mythread, (int)e, expected, dst[e]);
+        ERROR_EXIT();
+      }
+    }
+
+    /* GATHER_ALLV */
+    COLL_BARRIER();
+    for(r=0; r<nodes; r++) counts[r] = sizeof(int)*VCOLL_COUNT(r, k, nelem);
+    for(e=0; e<nelem; e++) src[e] = VCOLL_VAL(mynode, 0, e, k);
+    for(e=0; e<nelem*nodes; e++) dst[e] = -1;
+    COLL_BARRIER();
+    gasnet_coll_gather_allv(GASNET_TEAM_ALL, dst, counts, offsets, src, flags);
+    COLL_BARRIER();
+    run_VCOLL_check(td, "gather_allv", dst, nelem, counts, &vcoll_from_root, k);
+
+    /* EXCHANGEV */
+    COLL_BARRIER();
+    for(r=0; r<nodes; r++) {
+      counts[r] = sizeof(int)*VCOLL_COUNT(r, mynode, nelem);
+      src_counts[r] = sizeof(int)*VCOLL_COUNT(mynode, r, nelem);
+      for(e=0; e<nelem; e++) src[r*nelem+e] = VCOLL_VAL(mynode, r, e, k);
+    }
+    for(e=0; e<nelem*nodes; e++) dst[e] = -1;
+    COLL_BARRIER();
+    gasnet_coll_exchangev(GASNET_TEAM_ALL, dst, counts, offsets, src, src_counts, src_offsets, flags);
+    COLL_BARRIER();
+    run_VCOLL_check(td, "exchangev", dst, nelem, counts, &vcoll_to_me, k);
+  }
+
+  COLL_BARRIER();
+  begin = gasnett_ticks_now();
+  if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+  for(i=0; i<performance_iters; i++) { 
+    gasnet_coll_exchangev(GASNET_TEAM_ALL, dst, counts, offsets, src, src_counts, src_offsets, flags);
+  }
+  if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+  end =  gasnett_ticks_now() - begin;
+  COLL_BARRIER();
+  print_timer(td,  "exchangev", (flags & GASNET_COLL_SINGLE) ? "SINGLE" : "LOCAL",
+              (flags & GASNET_COLL_DST_IN_SEGMENT) ? "SINGLE-addr" : "non-segment", flag_str, nelem, end);  
+
+  /* counts[] must be the same everywhere for gather_allv */
+  for(r=0; r<nodes; r++) counts[r] = sizeof(int)*VCOLL_COUNT(r, 0, nelem);
+  COLL_BARRIER();
+  begin = gasnett_ticks_now();
+  if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+  for(i=0; i<performance_iters; i++) { 
+    gasnet_coll_gather_allv(GASNET_TEAM_ALL, dst, counts, offsets, src, flags);
+  }
+  if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+  end =  gasnett_ticks_now() - begin;
+  COLL_BARRIER();
+  print_timer(td,  "gather_allv", (flags & GASNET_COLL_SINGLE) ? "SINGLE" : "LOCAL",
+              (flags & GASNET_COLL_DST_IN_SEGMENT) ? "SINGLE-addr" : "non-segment", flag_str, nelem, end);  
+
+  test_free(counts);
+}
+#endif
+
 void run_SINGLE_ADDR_test(thread_data_t *td, uint8_t **dst_arr, uint8_t **src_arr, size_t nelem, int root_thread, int in_flags) {
   /* all threads pass the same pointers for src and dest*/
   int i,j,t,k;
@@ -536,6 +796,149 @@ void run_SINGLE_ADDR_test(thread_data_t *td, uint8_t **dst_arr, uint8_t **src_ar
  #endif
 #endif
 
+#if ALLREDUCE_ENABLED || ALL_COLL_ENABLED  
+  /*ALLREDUCE*/
+  for(k=0; k<outer_verification_iters; k++) {
+    COLL_BARRIER();
+    for(i=0; i<inner_verification_iters; i++) {
+      for(j=0; j<nelem; j++) {
+        src[i*nelem+j] = (42*(i+1)+j);
+        dst[i*nelem+j] = -1;
+      }
+    }
+    if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();} 
+    for(i=0; i<inner_verification_iters; i++) {
+      gasnet_coll_allreduce(GASNET_TEAM_ALL, dst+i*nelem, src+i*nelem, sizeof(int), nelem, 0, 0, flags);
+    }
+    if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+    
+    for(i=0; i<inner_verification_iters; i++) {
+      for(j=0; j<nelem; j++) {
+        int expected = (42*(i+1)+j)*THREADS;
+        if(dst[i*nelem+j] != expected) {
+          MSG("%d> allreduce verification @ iteration: %d,%d ... expected %d got %d", td->mythread, i, j, expected, dst[i*nelem+j]);
+          ERROR_EXIT();
+        }
+      }
+    }
+  }
+
+  COLL_BARRIER();
+  begin = gasnett_ticks_now();
+  if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+  for(i=0; i<performance_iters; i++) { 
+    gasnet_coll_allreduce(GASNET_TEAM_ALL, dst, src, sizeof(int), nelem, 0, 0, flags);
+  }
+  if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+  end =  gasnett_ticks_now() - begin;
+  COLL_BARRIER();  
+
+  print_timer(td,  "allreduce", output_str,  "SINGLE-addr", flag_str, nelem, end);  
+
+ #if NB_TESTS_ENABLED
+  COLL_BARRIER();
+  begin = gasnett_ticks_now();
+  if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+  for(i=0; i<performance_iters; i++) { 
+    handles[i] = gasnet_coll_allreduce_nb(GASNET_TEAM_ALL, dst, src, sizeof(int), nelem, 0, 0, flags);
+  }
+  for(i=0; i<performance_iters; i++) { 
+    gasnet_coll_wait_sync(handles[i]);
+  }
+  if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+  end =  gasnett_ticks_now() - begin;
+  COLL_BARRIER();  
+  print_timer(td,  "allreduce_NB", output_str,  "SINGLE-addr", flag_str, nelem, end);  
+ #endif
+#endif
+
+#if PERSISTENT_ENABLED || ALL_COLL_ENABLED
+  /*PERSISTENT BROADCAST/ALLREDUCE*/
+  {
+    gasnet_coll_plan_t bcast_plan = gasnet_coll_broadcast_init(GASNET_TEAM_ALL, dst, root_thread, src, sizeof(int)*nelem, flags);
+    gasnet_coll_plan_t allreduce_plan = gasnet_coll_allreduce_init(GASNET_TEAM_ALL, dst+nelem, src+nelem, sizeof(int), nelem, 0, 0, flags);
+
+    /* the same plans are restarted with fresh data in the (fixed) buffers */
+    for(k=0; k<outer_verification_iters*inner_verification_iters; k++) {
+      COLL_BARRIER();
+      for(j=0; j<nelem; j++) {
+        if(td->mythread == root_thread) src[j] = 42*(k+1)+j;
+        src[nelem+j] = 17*(k+1)+j;
+        dst[j] = dst[nelem+j] = -1;
+      }
+      if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+      gasnet_coll_wait_sync(gasnet_coll_start(bcast_plan));
+      gasnet_coll_wait_sync(gasnet_coll_start(allreduce_plan));
+      if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+
+      for(j=0; j<nelem; j++) {
+        if(dst[j] != 42*(k+1)+j) {
+          MSG("%d> persistent broadcast verification @ iteration: %d,%d ... expected %d got %d", (int) td->mythread, k, j, 42*(k+1)+j, dst[j]);
+          ERROR_EXIT();
+        }
+        if(dst[nelem+j] != (17*(k+1)+j)*THREADS) {
+          MSG("%d> persistent allreduce verification @ iteration: %d,%d ... expected %d got %d", (int) td->mythread, k, j, (int)((17*(k+1)+j)*THREADS), dst[nelem+j]);
+          ERROR_EXIT();
+        }
+      }
+    }
+
+    COLL_BARRIER();
+    begin = gasnett_ticks_now();
+    if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+    for(i=0; i<performance_iters; i++) { 
+      gasnet_coll_wait_sync(gasnet_coll_start(bcast_plan));
+    }
+    if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+    end =  gasnett_ticks_now() - begin;
+    COLL_BARRIER();
+    print_timer(td,  "broadcast_PERSISTENT", output_str,  "SINGLE-addr", flag_str, nelem, end);  
+
+    COLL_BARRIER();
+    begin = gasnett_ticks_now();
+    if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+    for(i=0; i<performance_iters; i++) { 
+      gasnet_coll_wait_sync(gasnet_coll_start(allreduce_plan));
+    }
+    if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+    end =  gasnett_ticks_now() - begin;
+    COLL_BARRIER();
+    print_timer(td,  "allreduce_PERSISTENT", output_str,  "SINGLE-addr", flag_str, nelem, end);  
+
+    gasnet_coll_plan_free(bcast_plan);
+    gasnet_coll_plan_free(allreduce_plan);
+  }
+#endif
+
+#if NEIGHBOR_ENABLED || ALL_COLL_ENABLED
+  /*NEIGHBOR ALLGATHER/ALLTOALL/ALLTOALLV*/
+  if(threads_per_node == 1) {
+    run_NEIGHBOR_test(td, dst, src, nelem, flags);
+    if(!(flags & GASNET_COLL_SINGLE)) {
+      /* buffers outside the segment take the AMMedium path */
+      int *tmp_dst = test_malloc(sizeof(int)*nelem*nodes);
+      int *tmp_src = test_malloc(sizeof(int)*nelem*nodes);
+      run_NEIGHBOR_test(td, tmp_dst, tmp_src, nelem, in_flags);
+      test_free(tmp_dst);
+      test_free(tmp_src);
+    }
+  }
+#endif
+
+#if VCOLL_ENABLED || ALL_COLL_ENABLED
+  /*GATHERV/SCATTERV/GATHER_ALLV/EXCHANGEV*/
+  if(threads_per_node == 1) {
+    run_VCOLL_test(td, dst, src, nelem, flags);
+    if(!(flags & GASNET_COLL_SINGLE)) {
+      int *tmp_dst = test_malloc(sizeof(int)*nelem*nodes);
+      int *tmp_src = test_malloc(sizeof(int)*nelem*nodes);
+      run_VCOLL_test(td, tmp_dst, tmp_src, nelem, in_flags);
+      test_free(tmp_dst);
+      test_free(tmp_src);
+    }
+  }
+#endif
+
   if(td->my_local_thread==0 && VERBOSE_VERIFICATION_OUTPUT) MSG0("%c: %s/SINGLE-addr sync_mode: %s size: %"PRIuPTR" bytes root: %d.  PASS", 
                                                                  TEST_SECTION_NAME(), output_str, flag_str, (uintptr_t) (sizeof(int)*nelem), root_thread);
   
@@ -946,6 +1349,67 @@ void run_MULTI_ADDR_test(thread_data_t *td, uint8_t **dst_arr, uint8_t **src_arr
   print_timer(td,  "reduceM_NB", output_str,  "MULTI-addr", flag_str, nelem, end);  
  #endif
 #endif
+
+#if ALLREDUCE_ENABLED || ALL_COLL_ENABLED  
+  /*ALLREDUCE*/
+  for(k=0; k<outer_verification_iters; k++) {
+    COLL_BARRIER();
+    for(i=0; i<inner_verification_iters; i++) {
+      for(j=0; j<nelem; j++) {
+        mysrc[i*nelem+j] = (42*(i+1)+j);
+        mydest[i*nelem+j] = -1;
+      }
+    }
+    if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();} 
+    curr_src_arr = tmp_src;
+    curr_dst_arr = tmp_dest;
+    for(i=0; i<inner_verification_iters; i++) {
+      scale_ptrM((void**) curr_src_arr, (void**) src_arr, nelem*i, sizeof(int), num_addrs);
+      scale_ptrM((void**) curr_dst_arr, (void**) dst_arr, nelem*i, sizeof(int), num_addrs);
+      gasnet_coll_allreduceM(GASNET_TEAM_ALL, (void**)curr_dst_arr, (void**)curr_src_arr, sizeof(int), nelem, INT_SUM_BUILTIN, 0, flags);
+      curr_src_arr +=num_addrs;
+      curr_dst_arr +=num_addrs;
+    }
+    if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+    
+    for(i=0; i<inner_verification_iters; i++) {
+      for(j=0; j<nelem; j++) {
+        int expected = (42*(i+1)+j)*THREADS;
+        if(mydest[i*nelem+j] != expected) {
+          MSG("%d> allreduceM verification @ iteration: %d,%d,%d ... expected %d got %d", td->mythread, k, i, j, expected, mydest[i*nelem+j]);
+          ERROR_EXIT();
+        }
+      }
+    }
+  }
+
+  COLL_BARRIER();
+  begin = gasnett_ticks_now();
+  if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+  for(i=0; i<performance_iters; i++) { 
+    gasnet_coll_allreduceM(GASNET_TEAM_ALL, (void**)dst_arr, (void**)src_arr, sizeof(int), nelem, INT_SUM_BUILTIN, 0, flags);
+  }
+  if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+  end =  gasnett_ticks_now() - begin;
+  COLL_BARRIER();  
+  print_timer(td,  "allreduceM", output_str,  "MULTI-addr", flag_str, nelem, end);  
+
+ #if NB_TESTS_ENABLED
+  COLL_BARRIER();
+  begin = gasnett_ticks_now();
+  if(flags & GASNET_COLL_IN_NOSYNC) {COLL_BARRIER();}
+  for(i=0; i<performance_iters; i++) { 
+    handles[i] = gasnet_coll_allreduceM_nb(GASNET_TEAM_ALL, (void**)dst_arr, (void**)src_arr, sizeof(int), nelem, INT_SUM_BUILTIN, 0, flags);
+  }
+  for(i=0; i<performance_iters; i++) {
+    gasnet_coll_wait_sync(handles[i]);
+  }
+  if(flags & GASNET_COLL_OUT_NOSYNC) {COLL_BARRIER();}
+  end =  gasnett_ticks_now() - begin;
+  COLL_BARRIER();  
+  print_timer(td,  "allreduceM_NB", output_str,  "MULTI-addr", flag_str, nelem, end);  
+ #endif
+#endif
   
   if(td->my_local_thread==0  && VERBOSE_VERIFICATION_OUTPUT) MSG0("%c: %s/MULTI-addr sync_mode: %s size: %"PRIuPTR" bytes root: %d.  PASS", 
                                                                   TEST_SECTION_NAME(), output_str, flag_str, (uintptr_t) (sizeof(int)*nelem), (int) root_thread);
@@ -320,6 +320,11 @@ extern int gasnet_init(int *argc, char ***argv) {
 extern void _gasnetc_set_waitmode(int wait_mode) {
   if (wait_mode == GASNET_WAIT_BLOCK) {
     AMUDP_PoliteSync = 1;
+    AMUDP_PoliteSpin_us = 0;
+  } else if (wait_mode == GASNET_WAIT_SPINBLOCK) {
+    /* poll for a while before blocking in select() */
+    AMUDP_PoliteSync = 1;
+    AMUDP_PoliteSpin_us = gasneti_getenv_int_withdefault("GASNET_UDP_SPIN_USEC", 100, 0);
   } else {
     AMUDP_PoliteSync = 0;
   }
@@ -581,6 +586,7 @@ extern void gasnetc_exit(int exitcode) {
     static gasneti_mutex_t exit_lock = GASNETI_MUTEX_INITIALIZER;
     gasneti_mutex_lock(&exit_lock);
   }
+  gasnete_coll_fini(); /* stop the collectives progress thread, if any */
 
   GASNETI_TRACE_PRINTF(C,("gasnet_exit(%i)\n", exitcode));
 